@@ -0,0 +1,541 @@
+#include "AnimationClip.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	const float InvSqrt2 = 0.70710678f;
+	const float QuantizeMax = 32767.0f;
+
+	// Frame 이하인 마지막 키 번호. 키는 항상 0번 프레임부터 있다.
+	template<typename KeyType>
+	uint32_t FindKey(const KeyType* Keys, uint32_t Count, float Frame)
+	{
+		uint32_t Low = 0;
+		uint32_t High = Count;
+		while (High - Low > 1)
+		{
+			uint32_t Mid = (Low + High) / 2;
+			if ((float)Keys[Mid].Frame <= Frame)
+			{
+				Low = Mid;
+			}
+			else
+			{
+				High = Mid;
+			}
+		}
+		return Low;
+	}
+
+	float GetInterpolationFactor(uint32_t Start, uint32_t End, float Frame)
+	{
+		return End == Start ? 0.0f : (Frame - (float)Start) / (float)(End - Start);
+	}
+
+	// 같은 반구로 맞춘 쿼터니언끼리는 nlerp로 충분하다.
+	XMVECTOR InterpolateRotation(FXMVECTOR A, FXMVECTOR B, float T)
+	{
+		XMVECTOR Target = XMVectorGetX(XMVector4Dot(A, B)) < 0.0f ? XMVectorNegate(B) : B;
+		return XMQuaternionNormalize(XMVectorLerp(A, Target, T));
+	}
+
+	// acos는 내적이 1 근처일 때 float 해상도가 0.0007 라디안 정도라 양자화 오차를 못 잰다.
+	// 단위 쿼터니언 사이 거리 |A - B| = 2sin(θ/4)로 각도를 구한다.
+	float GetRotationError(FXMVECTOR A, FXMVECTOR B)
+	{
+		XMVECTOR Target = XMVectorGetX(XMVector4Dot(A, B)) < 0.0f ? XMVectorNegate(B) : B;
+		float Chord = XMVectorGetX(XMVector4Length(XMVectorSubtract(A, Target)));
+		return 4.0f * asinf(std::min(Chord * 0.5f, 1.0f));
+	}
+
+	// Start와 End 키 사이를 보간해서 가운데 프레임이 전부 허용 오차 안이면 가운데 키를 버린다.
+	template<typename WithinToleranceFunc>
+	void ReduceKeys(uint32_t FrameCount, WithinToleranceFunc IsWithinTolerance, std::vector<uint32_t>& OutKeys)
+	{
+		OutKeys.clear();
+		OutKeys.push_back(0);
+
+		if (FrameCount < 2)
+		{
+			return;
+		}
+
+		// 채널 전체가 상수면 키 하나로 끝낸다.
+		bool bConstant = true;
+		for (uint32_t Frame = 1; Frame < FrameCount && bConstant; Frame++)
+		{
+			bConstant = IsWithinTolerance(0, 0, Frame);
+		}
+
+		if (bConstant)
+		{
+			return;
+		}
+
+		uint32_t Start = 0;
+		for (uint32_t End = 2; End < FrameCount; End++)
+		{
+			for (uint32_t Frame = Start + 1; Frame < End; Frame++)
+			{
+				if (false == IsWithinTolerance(Start, End, Frame))
+				{
+					OutKeys.push_back(End - 1);
+					Start = End - 1;
+					break;
+				}
+			}
+		}
+
+		OutKeys.push_back(FrameCount - 1);
+	}
+
+	// 키 4개의 smallest-three를 한 번에 푼다. 결과는 성분별로 X, Y, Z, W 레인 4개씩.
+	void UnpackRotations(const RotationKey* const Keys[4], XMVECTOR& OutX, XMVECTOR& OutY, XMVECTOR& OutZ, XMVECTOR& OutW)
+	{
+		XMVECTORU32 Largest;
+		XMVECTORU32 QuantizedA;
+		XMVECTORU32 QuantizedB;
+		XMVECTORU32 QuantizedC;
+
+		for (int Lane = 0; Lane < 4; Lane++)
+		{
+			const uint16_t* Packed = Keys[Lane]->Packed;
+			const uint32_t Low = (uint32_t)Packed[0] | ((uint32_t)Packed[1] << 16);
+
+			Largest.u[Lane] = Low & 3;
+			QuantizedA.u[Lane] = (Low >> 2) & 0x7FFF;
+			QuantizedB.u[Lane] = (Low >> 17) & 0x7FFF;
+			QuantizedC.u[Lane] = (uint32_t)Packed[2] & 0x7FFF;
+		}
+
+		const XMVECTOR Scale = XMVectorReplicate(2.0f * InvSqrt2 / QuantizeMax);
+		const XMVECTOR Bias = XMVectorReplicate(-InvSqrt2);
+
+		XMVECTOR A = XMVectorMultiplyAdd(XMConvertVectorUIntToFloat(QuantizedA.v, 0), Scale, Bias);
+		XMVECTOR B = XMVectorMultiplyAdd(XMConvertVectorUIntToFloat(QuantizedB.v, 0), Scale, Bias);
+		XMVECTOR C = XMVectorMultiplyAdd(XMConvertVectorUIntToFloat(QuantizedC.v, 0), Scale, Bias);
+
+		XMVECTOR LengthSq = XMVectorMultiplyAdd(A, A, XMVectorMultiplyAdd(B, B, XMVectorMultiply(C, C)));
+		XMVECTOR Big = XMVectorSqrt(XMVectorMax(XMVectorZero(), XMVectorSubtract(XMVectorSplatOne(), LengthSq)));
+
+		// 레인마다 버린 성분 자리에 Big을 넣고 나머지를 한 칸씩 민다.
+		XMVECTOR Is0 = XMVectorEqualInt(Largest.v, XMVectorSplatConstantInt(0));
+		XMVECTOR Is1 = XMVectorEqualInt(Largest.v, XMVectorSplatConstantInt(1));
+		XMVECTOR Is2 = XMVectorEqualInt(Largest.v, XMVectorSplatConstantInt(2));
+		XMVECTOR Is3 = XMVectorEqualInt(Largest.v, XMVectorSplatConstantInt(3));
+
+		OutX = XMVectorSelect(A, Big, Is0);
+		OutY = XMVectorSelect(XMVectorSelect(B, Big, Is1), A, Is0);
+		OutZ = XMVectorSelect(XMVectorSelect(C, Big, Is2), B, XMVectorOrInt(Is0, Is1));
+		OutW = XMVectorSelect(C, Big, Is3);
+	}
+
+	// Frame을 감싸는 두 키와 보간 비율. 마지막 키 뒤면 두 키가 같고 비율은 0.
+	float FindVectorKeys(const VectorKey* Keys, uint32_t Count, float Frame, XMVECTOR& OutA, XMVECTOR& OutB)
+	{
+		uint32_t Index = FindKey(Keys, Count, Frame);
+		uint32_t Next = std::min(Index + 1, Count - 1);
+
+		OutA = XMLoadFloat3(&Keys[Index].Value);
+		OutB = XMLoadFloat3(&Keys[Next].Value);
+		return GetInterpolationFactor(Keys[Index].Frame, Keys[Next].Frame, Frame);
+	}
+
+	XMVECTOR SampleVectorKeys(const VectorKey* Keys, uint32_t Count, float Frame)
+	{
+		uint32_t Index = FindKey(Keys, Count, Frame);
+		XMVECTOR Value = XMLoadFloat3(&Keys[Index].Value);
+
+		if (Index + 1 < Count)
+		{
+			float T = GetInterpolationFactor(Keys[Index].Frame, Keys[Index + 1].Frame, Frame);
+			Value = XMVectorLerp(Value, XMLoadFloat3(&Keys[Index + 1].Value), T);
+		}
+
+		return Value;
+	}
+
+	void CompressVectorChannel(const std::vector<XMFLOAT3>& Samples, float Tolerance, std::vector<uint32_t>& Keys, std::vector<VectorKey>& OutKeys, uint32_t& OutStart, uint32_t& OutCount)
+	{
+		ReduceKeys((uint32_t)Samples.size(), [&Samples, Tolerance](uint32_t Start, uint32_t End, uint32_t Frame)
+		{
+			float T = GetInterpolationFactor(Start, End, (float)Frame);
+			XMVECTOR Interpolated = XMVectorLerp(XMLoadFloat3(&Samples[Start]), XMLoadFloat3(&Samples[End]), T);
+			XMVECTOR Error = XMVector3Length(XMVectorSubtract(Interpolated, XMLoadFloat3(&Samples[Frame])));
+			return XMVectorGetX(Error) <= Tolerance;
+		}, Keys);
+
+		OutStart = (uint32_t)OutKeys.size();
+		OutCount = (uint32_t)Keys.size();
+
+		for (uint32_t Key : Keys)
+		{
+			VectorKey NewKey;
+			NewKey.Value = Samples[Key];
+			NewKey.Frame = Key;
+			OutKeys.push_back(NewKey);
+		}
+	}
+}
+
+const float AnimationClip::RotationQuantizationError = 0.00015f;
+
+XMMATRIX BoneTransform::ToMatrix() const
+{
+	XMVECTOR Zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+	return XMMatrixAffineTransformation(XMLoadFloat3(&Scale), Zero, XMLoadFloat4(&Rotation), XMLoadFloat3(&Translation));
+}
+
+AnimationClip::AnimationClip(const AnimationClipInfo& InInfo,
+	ArrayView<AnimationTrack> InTracks,
+	ArrayView<RotationKey> InRotations,
+	ArrayView<VectorKey> InTranslations,
+	ArrayView<VectorKey> InScales)
+	:
+	Info(InInfo),
+	Tracks(InTracks),
+	Rotations(InRotations),
+	Translations(InTranslations),
+	Scales(InScales)
+{
+}
+
+AnimationClip::AnimationClip(const AnimationClipData& Data)
+	:
+	AnimationClip(Data.Info, Data.Tracks, Data.Rotations, Data.Translations, Data.Scales)
+{
+}
+
+void AnimationClip::Compress(const std::vector<BoneTransform>& Poses,
+	uint32_t FrameCount,
+	uint32_t BoneCount,
+	float FrameRate,
+	const AnimationCompressionSettings& Settings,
+	AnimationClipData& OutData)
+{
+	assert(Poses.size() == (size_t)FrameCount * BoneCount);
+	assert(FrameCount <= UINT16_MAX);
+
+	OutData = AnimationClipData();
+	OutData.Info.FrameCount = FrameCount;
+	OutData.Info.BoneCount = BoneCount;
+	OutData.Info.FrameRate = FrameRate;
+
+	if (0 == FrameCount)
+	{
+		return;
+	}
+
+	OutData.Tracks.resize(BoneCount);
+
+	// 양자화 오차보다 작은 허용치는 모든 프레임을 키로 남기기만 하고 오차는 줄지 않는다.
+	const float RotationTolerance = std::max(Settings.RotationTolerance, RotationQuantizationError);
+
+	std::vector<XMFLOAT4> RotationSamples(FrameCount);
+	std::vector<XMFLOAT4> QuantizedRotations(FrameCount);
+	std::vector<XMFLOAT3> TranslationSamples(FrameCount);
+	std::vector<XMFLOAT3> ScaleSamples(FrameCount);
+	std::vector<uint32_t> Keys;
+
+	for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+	{
+		// 보간이 먼 길로 돌지 않게 앞 프레임과 같은 반구로 맞춘다.
+		XMVECTOR Previous = XMLoadFloat4(&Poses[Bone].Rotation);
+		for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+		{
+			const BoneTransform& Pose = Poses[(size_t)Frame * BoneCount + Bone];
+
+			XMVECTOR Rotation = XMQuaternionNormalize(XMLoadFloat4(&Pose.Rotation));
+			if (XMVectorGetX(XMVector4Dot(Rotation, Previous)) < 0.0f)
+			{
+				Rotation = XMVectorNegate(Rotation);
+			}
+			Previous = Rotation;
+
+			uint16_t Packed[3];
+			PackRotation(Rotation, Packed);
+
+			XMStoreFloat4(&RotationSamples[Frame], Rotation);
+			XMStoreFloat4(&QuantizedRotations[Frame], UnpackRotation(Packed));
+			TranslationSamples[Frame] = Pose.Translation;
+			ScaleSamples[Frame] = Pose.Scale;
+		}
+
+		AnimationTrack& Track = OutData.Tracks[Bone];
+
+		// 런타임이 보간하는 건 양자화된 키라서 그 값으로 보간해서 원본과 비교한다.
+		ReduceKeys(FrameCount, [&RotationSamples, &QuantizedRotations, RotationTolerance](uint32_t Start, uint32_t End, uint32_t Frame)
+		{
+			float T = GetInterpolationFactor(Start, End, (float)Frame);
+			XMVECTOR Interpolated = InterpolateRotation(XMLoadFloat4(&QuantizedRotations[Start]), XMLoadFloat4(&QuantizedRotations[End]), T);
+			return GetRotationError(Interpolated, XMLoadFloat4(&RotationSamples[Frame])) <= RotationTolerance;
+		}, Keys);
+
+		Track.RotationStart = (uint32_t)OutData.Rotations.size();
+		Track.RotationCount = (uint32_t)Keys.size();
+
+		for (uint32_t Key : Keys)
+		{
+			RotationKey NewKey;
+			NewKey.Frame = (uint16_t)Key;
+			PackRotation(XMLoadFloat4(&RotationSamples[Key]), NewKey.Packed);
+			OutData.Rotations.push_back(NewKey);
+		}
+
+		CompressVectorChannel(TranslationSamples, Settings.TranslationTolerance, Keys, OutData.Translations, Track.TranslationStart, Track.TranslationCount);
+		CompressVectorChannel(ScaleSamples, Settings.ScaleTolerance, Keys, OutData.Scales, Track.ScaleStart, Track.ScaleCount);
+	}
+}
+
+void AnimationClip::PackRotation(FXMVECTOR Rotation, uint16_t OutPacked[3])
+{
+	XMFLOAT4 Quaternion;
+	XMStoreFloat4(&Quaternion, XMQuaternionNormalize(Rotation));
+
+	const float Components[4] = { Quaternion.x, Quaternion.y, Quaternion.z, Quaternion.w };
+
+	int Largest = 0;
+	for (int i = 1; i < 4; i++)
+	{
+		if (fabsf(Components[i]) > fabsf(Components[Largest]))
+		{
+			Largest = i;
+		}
+	}
+
+	// q와 -q는 같은 회전이니까 제일 큰 성분이 양수가 되게 뒤집고 그 성분은 버린다.
+	const float Sign = Components[Largest] < 0.0f ? -1.0f : 1.0f;
+
+	uint64_t Bits = (uint64_t)Largest;
+	int Shift = 2;
+	for (int i = 0; i < 4; i++)
+	{
+		if (i == Largest)
+		{
+			continue;
+		}
+
+		float Normalized = std::max(-1.0f, std::min(1.0f, Components[i] * Sign / InvSqrt2));
+		uint64_t Quantized = (uint64_t)((Normalized * 0.5f + 0.5f) * QuantizeMax + 0.5f);
+
+		Bits |= Quantized << Shift;
+		Shift += 15;
+	}
+
+	OutPacked[0] = (uint16_t)(Bits & 0xFFFF);
+	OutPacked[1] = (uint16_t)((Bits >> 16) & 0xFFFF);
+	OutPacked[2] = (uint16_t)((Bits >> 32) & 0xFFFF);
+}
+
+XMVECTOR AnimationClip::UnpackRotation(const uint16_t Packed[3])
+{
+	const uint64_t Bits = (uint64_t)Packed[0] | ((uint64_t)Packed[1] << 16) | ((uint64_t)Packed[2] << 32);
+	const int Largest = (int)(Bits & 3);
+
+	XMVECTORU32 Quantized = { { {
+		(uint32_t)((Bits >> 2) & 0x7FFF),
+		(uint32_t)((Bits >> 17) & 0x7FFF),
+		(uint32_t)((Bits >> 32) & 0x7FFF),
+		0 } } };
+
+	// [0, 32767] -> [-1/sqrt2, 1/sqrt2]
+	XMVECTOR Small = XMConvertVectorUIntToFloat(Quantized.v, 0);
+	Small = XMVectorMultiplyAdd(Small, XMVectorReplicate(2.0f * InvSqrt2 / QuantizeMax), XMVectorReplicate(-InvSqrt2));
+	Small = XMVectorSetW(Small, 0.0f);
+
+	const float LargestValue = sqrtf(std::max(0.0f, 1.0f - XMVectorGetX(XMVector3Dot(Small, Small))));
+
+	XMFLOAT3 Rest;
+	XMStoreFloat3(&Rest, Small);
+
+	switch (Largest)
+	{
+	case 0:
+		return XMVectorSet(LargestValue, Rest.x, Rest.y, Rest.z);
+	case 1:
+		return XMVectorSet(Rest.x, LargestValue, Rest.y, Rest.z);
+	case 2:
+		return XMVectorSet(Rest.x, Rest.y, LargestValue, Rest.z);
+	default:
+		return XMVectorSet(Rest.x, Rest.y, Rest.z, LargestValue);
+	}
+}
+
+void AnimationClip::Sample(float Frame, BoneTransform* OutPose, uint32_t MaxBoneCount) const
+{
+	if (false == IsValid())
+	{
+		return;
+	}
+
+	Frame = std::max(0.0f, std::min(Frame, (float)(Info.FrameCount - 1)));
+
+	const uint32_t BoneCount = std::min(Info.BoneCount, MaxBoneCount);
+
+	uint32_t Bone = 0;
+	for (; Bone + 4 <= BoneCount; Bone += 4)
+	{
+		SampleGroup(Frame, Bone, OutPose + Bone);
+	}
+
+	for (; Bone < BoneCount; Bone++)
+	{
+		SampleBone(Frame, Bone, OutPose[Bone]);
+	}
+}
+
+void AnimationClip::SampleScalar(float Frame, BoneTransform* OutPose, uint32_t MaxBoneCount) const
+{
+	if (false == IsValid())
+	{
+		return;
+	}
+
+	Frame = std::max(0.0f, std::min(Frame, (float)(Info.FrameCount - 1)));
+
+	const uint32_t BoneCount = std::min(Info.BoneCount, MaxBoneCount);
+	for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+	{
+		SampleBone(Frame, Bone, OutPose[Bone]);
+	}
+}
+
+void AnimationClip::SampleGroup(float Frame, uint32_t FirstBone, BoneTransform* OutPose) const
+{
+	// 키 찾기만 뼈마다 하고, 푸는 것과 보간은 뼈 4개를 성분별 레인에 모아서 한 번에 한다.
+	const RotationKey* RotationA[4];
+	const RotationKey* RotationB[4];
+	XMVECTORF32 RotationT;
+	XMVECTORF32 TranslationT;
+	XMVECTORF32 ScaleT;
+	XMMATRIX TranslationA;
+	XMMATRIX TranslationB;
+	XMMATRIX ScaleA;
+	XMMATRIX ScaleB;
+
+	for (int Lane = 0; Lane < 4; Lane++)
+	{
+		const AnimationTrack& Track = Tracks[FirstBone + Lane];
+
+		const RotationKey* RotationKeys = Rotations.data() + Track.RotationStart;
+		uint32_t Index = FindKey(RotationKeys, Track.RotationCount, Frame);
+		uint32_t Next = std::min(Index + 1, Track.RotationCount - 1);
+
+		RotationA[Lane] = &RotationKeys[Index];
+		RotationB[Lane] = &RotationKeys[Next];
+		RotationT.f[Lane] = GetInterpolationFactor(RotationKeys[Index].Frame, RotationKeys[Next].Frame, Frame);
+
+		TranslationT.f[Lane] = FindVectorKeys(Translations.data() + Track.TranslationStart, Track.TranslationCount, Frame, TranslationA.r[Lane], TranslationB.r[Lane]);
+		ScaleT.f[Lane] = FindVectorKeys(Scales.data() + Track.ScaleStart, Track.ScaleCount, Frame, ScaleA.r[Lane], ScaleB.r[Lane]);
+	}
+
+	XMVECTOR AX, AY, AZ, AW;
+	XMVECTOR BX, BY, BZ, BW;
+	UnpackRotations(RotationA, AX, AY, AZ, AW);
+	UnpackRotations(RotationB, BX, BY, BZ, BW);
+
+	// 반대 반구인 레인은 B를 뒤집어서 nlerp한다.
+	XMVECTOR Dot = XMVectorMultiplyAdd(AX, BX, XMVectorMultiplyAdd(AY, BY, XMVectorMultiplyAdd(AZ, BZ, XMVectorMultiply(AW, BW))));
+	XMVECTOR Flip = XMVectorLess(Dot, XMVectorZero());
+	BX = XMVectorSelect(BX, XMVectorNegate(BX), Flip);
+	BY = XMVectorSelect(BY, XMVectorNegate(BY), Flip);
+	BZ = XMVectorSelect(BZ, XMVectorNegate(BZ), Flip);
+	BW = XMVectorSelect(BW, XMVectorNegate(BW), Flip);
+
+	XMMATRIX Rotation;
+	Rotation.r[0] = XMVectorLerpV(AX, BX, RotationT.v);
+	Rotation.r[1] = XMVectorLerpV(AY, BY, RotationT.v);
+	Rotation.r[2] = XMVectorLerpV(AZ, BZ, RotationT.v);
+	Rotation.r[3] = XMVectorLerpV(AW, BW, RotationT.v);
+
+	XMVECTOR LengthSq = XMVectorMultiplyAdd(Rotation.r[0], Rotation.r[0], XMVectorMultiplyAdd(Rotation.r[1], Rotation.r[1],
+		XMVectorMultiplyAdd(Rotation.r[2], Rotation.r[2], XMVectorMultiply(Rotation.r[3], Rotation.r[3]))));
+	XMVECTOR InvLength = XMVectorReciprocalSqrt(LengthSq);
+	Rotation.r[0] = XMVectorMultiply(Rotation.r[0], InvLength);
+	Rotation.r[1] = XMVectorMultiply(Rotation.r[1], InvLength);
+	Rotation.r[2] = XMVectorMultiply(Rotation.r[2], InvLength);
+	Rotation.r[3] = XMVectorMultiply(Rotation.r[3], InvLength);
+
+	// 이동과 스케일도 성분별로 돌려서 한 번에 lerp한다.
+	TranslationA = XMMatrixTranspose(TranslationA);
+	TranslationB = XMMatrixTranspose(TranslationB);
+	ScaleA = XMMatrixTranspose(ScaleA);
+	ScaleB = XMMatrixTranspose(ScaleB);
+
+	XMMATRIX Translation;
+	XMMATRIX Scale;
+	for (int Axis = 0; Axis < 3; Axis++)
+	{
+		Translation.r[Axis] = XMVectorLerpV(TranslationA.r[Axis], TranslationB.r[Axis], TranslationT.v);
+		Scale.r[Axis] = XMVectorLerpV(ScaleA.r[Axis], ScaleB.r[Axis], ScaleT.v);
+	}
+	Translation.r[3] = XMVectorZero();
+	Scale.r[3] = XMVectorZero();
+
+	Rotation = XMMatrixTranspose(Rotation);
+	Translation = XMMatrixTranspose(Translation);
+	Scale = XMMatrixTranspose(Scale);
+
+	for (int Lane = 0; Lane < 4; Lane++)
+	{
+		BoneTransform& Out = OutPose[Lane];
+		XMStoreFloat4(&Out.Rotation, Rotation.r[Lane]);
+		XMStoreFloat3(&Out.Translation, Translation.r[Lane]);
+		XMStoreFloat3(&Out.Scale, Scale.r[Lane]);
+	}
+}
+
+void AnimationClip::SampleBone(float Frame, uint32_t Bone, BoneTransform& OutTransform) const
+{
+	const AnimationTrack& Track = Tracks[Bone];
+
+	const RotationKey* RotationKeys = Rotations.data() + Track.RotationStart;
+	uint32_t Index = FindKey(RotationKeys, Track.RotationCount, Frame);
+
+	XMVECTOR Rotation = UnpackRotation(RotationKeys[Index].Packed);
+	if (Index + 1 < Track.RotationCount)
+	{
+		float T = GetInterpolationFactor(RotationKeys[Index].Frame, RotationKeys[Index + 1].Frame, Frame);
+		Rotation = InterpolateRotation(Rotation, UnpackRotation(RotationKeys[Index + 1].Packed), T);
+	}
+
+	XMStoreFloat4(&OutTransform.Rotation, Rotation);
+	XMStoreFloat3(&OutTransform.Translation, SampleVectorKeys(Translations.data() + Track.TranslationStart, Track.TranslationCount, Frame));
+	XMStoreFloat3(&OutTransform.Scale, SampleVectorKeys(Scales.data() + Track.ScaleStart, Track.ScaleCount, Frame));
+}
+
+bool AnimationClip::IsValid() const
+{
+	return Info.FrameCount > 0 && Tracks.size() == Info.BoneCount;
+}
+
+uint32_t AnimationClip::GetFrameCount() const
+{
+	return Info.FrameCount;
+}
+
+uint32_t AnimationClip::GetBoneCount() const
+{
+	return Info.BoneCount;
+}
+
+float AnimationClip::GetFrameRate() const
+{
+	return Info.FrameRate;
+}
+
+float AnimationClip::GetDuration() const
+{
+	return Info.FrameCount > 1 ? (float)(Info.FrameCount - 1) / Info.FrameRate : 0.0f;
+}
+
+size_t AnimationClip::GetByteSize() const
+{
+	return sizeof(AnimationClipInfo)
+		+ Tracks.size() * sizeof(AnimationTrack)
+		+ Rotations.size() * sizeof(RotationKey)
+		+ Translations.size() * sizeof(VectorKey)
+		+ Scales.size() * sizeof(VectorKey);
+}
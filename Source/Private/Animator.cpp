@@ -0,0 +1,428 @@
+#include "Animator.h"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include "JobSystem.h"
+#include "DualQuaternion.h"
+
+// 1로 바꾸면 처음 UpdatePalettes 때 캐릭터 1000/10000개의 재생 + 팔레트 계산 시간을 포즈 공유 여부별로 재서 출력한다.
+#define ANIMATOR_BENCHMARK 0
+
+namespace
+{
+	// 포즈 하나가 본 수십 개 정도라 이보다 잘게 나누면 나누는 비용이 더 든다.
+	const size_t PalettePosesPerJob = 16;
+
+	inline void EncodeBone(FXMMATRIX Matrix, AnimationData& Out)
+	{
+#if SKINNING_DUAL_QUATERNION
+		XMVECTOR Real;
+		XMVECTOR Dual;
+		DualQuaternion::FromMatrix(Matrix, Real, Dual);
+		XMStoreFloat4(&Out.Real, Real);
+		XMStoreFloat4(&Out.Dual, Dual);
+#else
+		XMStoreFloat4x4(&Out.FinalTransform, Matrix);
+#endif
+	}
+}
+
+void Animator::Init(const Skeleton& InSkeleton)
+{
+	Skel = InSkeleton;
+	Clips.clear();
+	States.clear();
+	HeldPoses.clear();
+	PoseSlots.clear();
+	PreviousPoseSlots.clear();
+
+	Scratches.resize(JobSystem::Get()->GetThreadCount());
+	for (PoseScratch& Scratch : Scratches)
+	{
+		Scratch.LocalPose.resize(Skel.GetBoneCount());
+		Scratch.ModelPose.resize(Skel.GetBoneCount());
+		Scratch.Palette.resize(Skel.GetBoneCount());
+	}
+
+	UpdateLodBoneCounts();
+}
+
+uint32_t Animator::AddClip(const AnimationClip& Clip)
+{
+	assert(Clip.GetBoneCount() == Skel.GetBoneCount());
+
+	Clips.push_back(Clip);
+	return (uint32_t)Clips.size() - 1;
+}
+
+uint32_t Animator::AddInstance(const AnimationState& State)
+{
+	assert(State.ClipIndex < Clips.size());
+
+	States.push_back(State);
+	HeldPoses.push_back(HeldPose());
+	return (uint32_t)States.size() - 1;
+}
+
+void Animator::Advance(float DeltaTime)
+{
+	for (AnimationState& State : States)
+	{
+		const float Duration = Clips[State.ClipIndex].GetDuration();
+		if (Duration <= 0.0f)
+		{
+			State.Time = 0.0f;
+			continue;
+		}
+
+		State.Time += DeltaTime * State.PlayRate;
+
+		switch (State.LoopMode)
+		{
+		case AnimationLoopMode::Loop:
+			State.Time = fmodf(State.Time, Duration);
+			break;
+		case AnimationLoopMode::Once:
+			State.Time = MathHelper::Clamp(State.Time, 0.0f, Duration);
+			break;
+		case AnimationLoopMode::PingPong:
+			// 왕복 한 번을 주기로 돌리고 뒤쪽 절반은 샘플링할 때 뒤집는다.
+			State.Time = fmodf(State.Time, 2.0f * Duration);
+			break;
+		}
+
+		if (State.Time < 0.0f)
+		{
+			State.Time += State.LoopMode == AnimationLoopMode::PingPong ? 2.0f * Duration : Duration;
+		}
+	}
+}
+
+void Animator::UpdatePalettes(const std::vector<int>& Instances,
+	const std::vector<float>& ScreenSizes,
+	UploadBuffer<AnimationData>* AnimationBuffer,
+	UINT BaseOffset,
+	UINT Capacity,
+	std::vector<UINT>& OutPaletteOffsets)
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	Clock::time_point Start = Clock::now();
+
+	const UINT BoneCount = GetBoneCount();
+	GatherPoses(Instances, ScreenSizes, BoneCount > 0 ? Capacity / BoneCount : 0, OutPaletteOffsets);
+
+	// 버퍼가 모자라도 다른 오브젝트의 팔레트를 덮어쓰지 않는다. 넘친 인스턴스는 GatherPoses가 마지막 포즈를 빌려주고 Stats에 세어 둔다.
+
+	for (UINT& Offset : OutPaletteOffsets)
+	{
+		Offset += BaseOffset;
+	}
+
+	WritePalettes([AnimationBuffer, BaseOffset](UINT Index, const AnimationData& Data)
+	{
+		AnimationBuffer->CopyData(BaseOffset + Index, Data);
+	});
+
+	Stats.PaletteMs = std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+
+	// 실제로 샘플링한 뼈 수를 전체 포즈 단위로 환산해서, 다 따로 계산했으면 걸렸을 시간과 비교한다.
+	size_t SampledBoneCount = 0;
+	for (const PoseScratch& Scratch : Scratches)
+	{
+		SampledBoneCount += Scratch.SampledBoneCount;
+	}
+
+	const double FullPoseCount = GetBoneCount() > 0 ? (double)SampledBoneCount / GetBoneCount() : 0.0;
+	if (FullPoseCount > 0.0)
+	{
+		MsPerFullPose = Stats.PaletteMs / FullPoseCount;
+	}
+	Stats.SavedMs = MathHelper::Max(0.0, MsPerFullPose * ((double)Stats.PosedInstanceCount - FullPoseCount));
+
+	++FrameIndex;
+
+#if ANIMATOR_BENCHMARK
+	static bool bBenchmarked = false;
+	if (false == bBenchmarked)
+	{
+		bBenchmarked = true;
+
+		const UINT BoneCount = GetBoneCount();
+		const size_t CharacterCounts[] = { 1000, 10000 };
+		// LOD 0만 쓰니까 LOD 0의 간격을 바꿔가며 공유 효과를 본다.
+		const float Quantizations[] = { 0.0f, LodSettings.PoseQuantizations[AnimationLodSettings::LodCount - 1] };
+		for (size_t CharacterCount : CharacterCounts)
+		{
+			for (float Quantization : Quantizations)
+			{
+				Animator Crowd;
+				Crowd.Init(Skel);
+				AnimationLodSettings CrowdSettings = LodSettings;
+				CrowdSettings.PoseQuantizations[0] = Quantization;
+				Crowd.SetLodSettings(CrowdSettings);
+				for (const AnimationClip& Clip : Clips)
+				{
+					Crowd.AddClip(Clip);
+				}
+
+				std::vector<int> CrowdInstances(CharacterCount);
+				for (size_t i = 0; i < CharacterCount; i++)
+				{
+					AnimationState State;
+					State.ClipIndex = (uint32_t)(i % Clips.size());
+					State.Time = MathHelper::RandF(0.0f, Clips[State.ClipIndex].GetDuration());
+					State.PlayRate = MathHelper::RandF(0.8f, 1.2f);
+					Crowd.AddInstance(State);
+					CrowdInstances[i] = (int)i;
+				}
+
+				std::vector<AnimationData> CrowdPalettes(CharacterCount * BoneCount);
+				std::vector<UINT> CrowdOffsets;
+				const std::vector<float> NoScreenSizes;
+
+				const int Iterations = 10;
+				Clock::time_point BenchmarkStart = Clock::now();
+				for (int Iteration = 0; Iteration < Iterations; Iteration++)
+				{
+					Crowd.Advance(1.0f / 60.0f);
+					Crowd.GatherPoses(CrowdInstances, NoScreenSizes, CharacterCount, CrowdOffsets);
+					Crowd.WritePalettes([&CrowdPalettes](UINT Index, const AnimationData& Data)
+					{
+						CrowdPalettes[Index] = Data;
+					});
+				}
+				const double Ms = std::chrono::duration<double, std::milli>(Clock::now() - BenchmarkStart).count() / Iterations;
+
+				char Message[256];
+				sprintf_s(Message, "[Animator] %zu characters x %u bones, quantization %.2f frames: %zu unique poses, %.3fms per frame on %u threads\n",
+					CharacterCount, BoneCount, Quantization, Crowd.GetStats().UniquePoseCount, Ms, JobSystem::Get()->GetThreadCount());
+				OutputDebugStringA(Message);
+			}
+		}
+	}
+#endif
+}
+
+void Animator::ComputeInstancePalette(size_t Instance, XMMATRIX* OutPalette)
+{
+	PoseScratch& Scratch = Scratches[JobSystem::GetThreadIndex()];
+
+	PoseKey Pose;
+	Pose.ClipIndex = States[Instance].ClipIndex;
+	Pose.Frame = GetSampleFrame(States[Instance]);
+
+	ComputePalette(Pose, Scratch);
+	std::copy(Scratch.Palette.begin(), Scratch.Palette.end(), OutPalette);
+}
+
+void Animator::SetLodSettings(const AnimationLodSettings& InSettings)
+{
+	LodSettings = InSettings;
+	UpdateLodBoneCounts();
+}
+
+void Animator::GatherPoses(const std::vector<int>& Instances, const std::vector<float>& ScreenSizes, size_t MaxPoseCount, std::vector<UINT>& OutPaletteOffsets)
+{
+	const UINT BoneCount = GetBoneCount();
+
+	PoseSlots.clear();
+	UniquePoses.clear();
+
+	const size_t PosedInstanceCount = Instances.size();
+	Stats = AnimationStats();
+	Stats.PosedInstanceCount = PosedInstanceCount;
+
+	OutPaletteOffsets.resize(Instances.size());
+	for (size_t i = 0; i < Instances.size(); i++)
+	{
+		const int Instance = Instances[i];
+		const AnimationState& State = States[Instance];
+
+		const uint32_t Lod = ScreenSizes.empty() ? 0 : SelectLod(ScreenSizes[i]);
+		++Stats.LodInstanceCounts[Lod];
+
+		// 같은 간격이어도 인스턴스마다 갱신하는 프레임을 엇갈린다.
+		HeldPose& Held = HeldPoses[Instance];
+		const uint32_t Interval = MathHelper::Max<uint32_t>(LodSettings.UpdateIntervals[Lod], 1);
+		if (false == Held.bValid || Held.ClipIndex != State.ClipIndex || 0 == (FrameIndex + Instance) % Interval)
+		{
+			Held.ClipIndex = State.ClipIndex;
+			Held.Frame = GetSampleFrame(State);
+			Held.bValid = true;
+		}
+		else
+		{
+			++Stats.HeldInstanceCount;
+		}
+
+		PoseKey Pose;
+		Pose.ClipIndex = Held.ClipIndex;
+		Pose.Lod = Lod;
+		Pose.Frame = Held.Frame;
+
+		const float Quantization = LodSettings.PoseQuantizations[Lod];
+
+		uint32_t Step = 0;
+		if (Quantization > 0.0f)
+		{
+			Step = (uint32_t)(Pose.Frame / Quantization + 0.5f);
+			Pose.Frame = Step * Quantization;
+		}
+		else
+		{
+			memcpy(&Step, &Pose.Frame, sizeof(Step));
+		}
+		Pose.Key = ((uint64_t)Pose.ClipIndex << 34) | ((uint64_t)Lod << 32) | Step;
+
+		auto Found = PoseSlots.find(Pose.Key);
+		if (Found != PoseSlots.end())
+		{
+			OutPaletteOffsets[i] = Found->second * BoneCount;
+			continue;
+		}
+
+		if (UniquePoses.size() >= MaxPoseCount)
+		{
+			// 자리가 없으면 버퍼 밖에 쓰지 않고 마지막 포즈를 빌려 쓴다.
+			OutPaletteOffsets[i] = UniquePoses.empty() ? 0 : (UINT)(UniquePoses.size() - 1) * BoneCount;
+			++Stats.OverflowInstanceCount;
+			continue;
+		}
+
+		PoseSlots.emplace(Pose.Key, (UINT)UniquePoses.size());
+		OutPaletteOffsets[i] = (UINT)UniquePoses.size() * BoneCount;
+		UniquePoses.push_back(Pose);
+	}
+
+	Stats.UniquePoseCount = UniquePoses.size();
+	Stats.UploadBytes = UniquePoses.size() * BoneCount * sizeof(AnimationData);
+}
+
+template<typename WriteFunc>
+void Animator::WritePalettes(WriteFunc Write)
+{
+	const UINT BoneCount = GetBoneCount();
+
+	Palettes.resize(UniquePoses.size() * BoneCount);
+
+	for (PoseScratch& Scratch : Scratches)
+	{
+		Scratch.ComputedPoseCount = 0;
+		Scratch.SampledBoneCount = 0;
+	}
+
+	JobSystem::Get()->ParallelFor(UniquePoses.size(), PalettePosesPerJob, [&](size_t Begin, size_t End, uint32_t ThreadIndex)
+	{
+		PoseScratch& Scratch = Scratches[ThreadIndex];
+
+		for (size_t i = Begin; i < End; i++)
+		{
+			const PoseKey& Pose = UniquePoses[i];
+			AnimationData* Palette = &Palettes[i * BoneCount];
+
+			// 지난 프레임에 같은 포즈가 있었으면 (갱신을 건너뛴 인스턴스 등) 그대로 가져온다.
+			auto Previous = PreviousPoseSlots.find(Pose.Key);
+			if (Previous != PreviousPoseSlots.end())
+			{
+				memcpy(Palette, &PreviousPalettes[Previous->second * BoneCount], BoneCount * sizeof(AnimationData));
+			}
+			else
+			{
+				ComputePalette(Pose, Scratch);
+				for (UINT Bone = 0; Bone < BoneCount; Bone++)
+				{
+					EncodeBone(Scratch.Palette[Bone], Palette[Bone]);
+				}
+
+				++Scratch.ComputedPoseCount;
+				Scratch.SampledBoneCount += LodBoneCounts[Pose.Lod];
+			}
+
+			for (UINT Bone = 0; Bone < BoneCount; Bone++)
+			{
+				Write((UINT)i * BoneCount + Bone, Palette[Bone]);
+			}
+		}
+	});
+
+	for (const PoseScratch& Scratch : Scratches)
+	{
+		Stats.ComputedPoseCount += Scratch.ComputedPoseCount;
+	}
+
+	PoseSlots.swap(PreviousPoseSlots);
+	Palettes.swap(PreviousPalettes);
+}
+
+void Animator::ComputePalette(const PoseKey& Pose, PoseScratch& Scratch) const
+{
+	// 샘플링하지 않는 깊은 뼈는 바인드 포즈로 부모를 따라가게 한다.
+	const uint32_t SampledBoneCount = LodBoneCounts[Pose.Lod];
+	Clips[Pose.ClipIndex].Sample(Pose.Frame, Scratch.LocalPose.data(), SampledBoneCount);
+
+	ArrayView<BoneTransform> BindPose = Skel.GetBindPose();
+	for (uint32_t Bone = SampledBoneCount; Bone < GetBoneCount(); Bone++)
+	{
+		Scratch.LocalPose[Bone] = BindPose[Bone];
+	}
+
+	Skel.ComposePalette(Scratch.LocalPose.data(), Scratch.ModelPose.data(), Scratch.Palette.data());
+}
+
+float Animator::GetSampleFrame(const AnimationState& State) const
+{
+	const AnimationClip& Clip = Clips[State.ClipIndex];
+
+	float Time = State.Time;
+	if (State.LoopMode == AnimationLoopMode::PingPong && Time > Clip.GetDuration())
+	{
+		Time = 2.0f * Clip.GetDuration() - Time;
+	}
+
+	return Time * Clip.GetFrameRate();
+}
+
+uint32_t Animator::SelectLod(float ScreenSize) const
+{
+	uint32_t Lod = 0;
+	while (Lod + 1 < AnimationLodSettings::LodCount && ScreenSize < LodSettings.ScreenSizes[Lod])
+	{
+		++Lod;
+	}
+	return Lod;
+}
+
+void Animator::UpdateLodBoneCounts()
+{
+	for (uint32_t Lod = 0; Lod < AnimationLodSettings::LodCount; Lod++)
+	{
+		// 뿌리 뼈는 항상 평가한다.
+		LodBoneCounts[Lod] = MathHelper::Max<uint32_t>(Skel.GetBoneCountUpToDepth(LodSettings.MaxBoneDepths[Lod]), MathHelper::Min<uint32_t>(1, GetBoneCount()));
+	}
+
+	// 뼈 구성이 바뀌면 지난 팔레트는 못 쓴다.
+	PreviousPoseSlots.clear();
+}
+
+AnimationState& Animator::GetState(size_t Instance)
+{
+	return States[Instance];
+}
+
+size_t Animator::GetInstanceCount() const
+{
+	return States.size();
+}
+
+uint32_t Animator::GetBoneCount() const
+{
+	return Skel.GetBoneCount();
+}
+
+const AnimationStats& Animator::GetStats() const
+{
+	return Stats;
+}
@@ -0,0 +1,805 @@
+#include "BlockCompression.h"
+#include "BlockDecoder.h"
+#include <emmintrin.h>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "JobSystem.h"
+
+namespace
+{
+	const uint8_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	int Clamp(int Value, int Low, int High)
+	{
+		return Value < Low ? Low : (Value > High ? High : Value);
+	}
+
+	// RGBA 16픽셀에서 채널 하나만 16바이트로 모은다.
+	__m128i GatherChannel(const uint8_t* Pixels, int Channel)
+	{
+		const __m128i Mask = _mm_set1_epi32(0xFF);
+		const __m128i Shift = _mm_cvtsi32_si128(Channel * 8);
+
+		__m128i Values[4];
+		for (int i = 0; i < 4; i++)
+		{
+			Values[i] = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128((const __m128i*)(Pixels + i * 16)), Shift), Mask);
+		}
+
+		return _mm_packus_epi16(_mm_packs_epi32(Values[0], Values[1]), _mm_packs_epi32(Values[2], Values[3]));
+	}
+
+	// 16픽셀을 Origin에서 Axis 방향으로 투영한 내적. 4픽셀씩 16비트 곱셈 두 번으로 끝낸다.
+	void ProjectPixels(const uint8_t* Pixels, const int* Origin, const int* Axis, __m128i* OutDots)
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i AxisVector = _mm_setr_epi16(
+			(short)Axis[0], (short)Axis[1], (short)Axis[2], (short)Axis[3],
+			(short)Axis[0], (short)Axis[1], (short)Axis[2], (short)Axis[3]);
+		const __m128i Base = _mm_set1_epi32(Origin[0] * Axis[0] + Origin[1] * Axis[1] + Origin[2] * Axis[2] + Origin[3] * Axis[3]);
+
+		for (int i = 0; i < 4; i++)
+		{
+			const __m128i Packed = _mm_loadu_si128((const __m128i*)(Pixels + i * 16));
+
+			// 픽셀마다 (R*X + G*Y, B*Z + A*W) 두 개가 나오고, 짝수 칸과 홀수 칸을 더하면 내적이 된다.
+			const __m128i Low = _mm_madd_epi16(_mm_unpacklo_epi8(Packed, Zero), AxisVector);
+			const __m128i High = _mm_madd_epi16(_mm_unpackhi_epi8(Packed, Zero), AxisVector);
+			const __m128i Even = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(Low), _mm_castsi128_ps(High), _MM_SHUFFLE(2, 0, 2, 0)));
+			const __m128i Odd = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(Low), _mm_castsi128_ps(High), _MM_SHUFFLE(3, 1, 3, 1)));
+
+			OutDots[i] = _mm_sub_epi32(_mm_add_epi32(Even, Odd), Base);
+		}
+	}
+
+	// 인덱스는 그대로 두고 끝점만 최소제곱으로 다시 맞춘다. Weights는 끝점 End 쪽 가중치.
+	bool RefineEndpoints(const uint8_t* Pixels, const float* Weights, int ChannelCount, float* OutStart, float* OutEnd)
+	{
+		float AA = 0.0f;
+		float BB = 0.0f;
+		float AB = 0.0f;
+		float AX[4] = {};
+		float BX[4] = {};
+
+		for (int i = 0; i < 16; i++)
+		{
+			const float B = Weights[i];
+			const float A = 1.0f - B;
+
+			AA += A * A;
+			BB += B * B;
+			AB += A * B;
+
+			for (int Channel = 0; Channel < ChannelCount; Channel++)
+			{
+				AX[Channel] += A * Pixels[i * 4 + Channel];
+				BX[Channel] += B * Pixels[i * 4 + Channel];
+			}
+		}
+
+		const float Determinant = AA * BB - AB * AB;
+		if (std::fabs(Determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		const float InvDeterminant = 1.0f / Determinant;
+		for (int Channel = 0; Channel < ChannelCount; Channel++)
+		{
+			OutStart[Channel] = std::min(std::max((AX[Channel] * BB - BX[Channel] * AB) * InvDeterminant, 0.0f), 255.0f);
+			OutEnd[Channel] = std::min(std::max((BX[Channel] * AA - AX[Channel] * AB) * InvDeterminant, 0.0f), 255.0f);
+		}
+
+		return true;
+	}
+
+	void WriteLittleEndian(uint8_t* Destination, uint64_t Value, int ByteCount)
+	{
+		for (int i = 0; i < ByteCount; i++)
+		{
+			Destination[i] = (uint8_t)(Value >> (i * 8));
+		}
+	}
+
+	uint64_t ReadLittleEndian(const uint8_t* Source, int ByteCount)
+	{
+		uint64_t Value = 0;
+		for (int i = 0; i < ByteCount; i++)
+		{
+			Value |= (uint64_t)Source[i] << (i * 8);
+		}
+		return Value;
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	// BC4 한 채널 (BC3 알파, BC5 두 채널도 같은 블록)
+
+	void EncodeSingleChannel(__m128i Values, uint8_t* Block)
+	{
+		__m128i Min = _mm_min_epu8(Values, _mm_srli_si128(Values, 8));
+		__m128i Max = _mm_max_epu8(Values, _mm_srli_si128(Values, 8));
+		Min = _mm_min_epu8(Min, _mm_srli_si128(Min, 4));
+		Max = _mm_max_epu8(Max, _mm_srli_si128(Max, 4));
+		Min = _mm_min_epu8(Min, _mm_srli_si128(Min, 2));
+		Max = _mm_max_epu8(Max, _mm_srli_si128(Max, 2));
+		Min = _mm_min_epu8(Min, _mm_srli_si128(Min, 1));
+		Max = _mm_max_epu8(Max, _mm_srli_si128(Max, 1));
+
+		const int MinValue = _mm_cvtsi128_si32(Min) & 0xFF;
+		const int MaxValue = _mm_cvtsi128_si32(Max) & 0xFF;
+
+		// 끝점0 > 끝점1이면 사이 값 6개를 쓰는 8단계 모드다.
+		Block[0] = (uint8_t)MaxValue;
+		Block[1] = (uint8_t)MinValue;
+
+		if (MaxValue == MinValue)
+		{
+			memset(Block + 2, 0, 6);
+			return;
+		}
+
+		// Max에서 떨어진 거리 * 7 / Range를 반올림한 값 t를 임계값 비교 7번으로 센다.
+		const int Range = MaxValue - MinValue;
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i MaxVector = _mm_set1_epi16((short)MaxValue);
+		const __m128i Fourteen = _mm_set1_epi16(14);
+
+		const __m128i Low = _mm_mullo_epi16(_mm_sub_epi16(MaxVector, _mm_unpacklo_epi8(Values, Zero)), Fourteen);
+		const __m128i High = _mm_mullo_epi16(_mm_sub_epi16(MaxVector, _mm_unpackhi_epi8(Values, Zero)), Fourteen);
+
+		__m128i StepLow = Zero;
+		__m128i StepHigh = Zero;
+		for (int Step = 1; Step <= 7; Step++)
+		{
+			const __m128i Threshold = _mm_set1_epi16((short)((2 * Step - 1) * Range - 1));
+			StepLow = _mm_sub_epi16(StepLow, _mm_cmpgt_epi16(Low, Threshold));
+			StepHigh = _mm_sub_epi16(StepHigh, _mm_cmpgt_epi16(High, Threshold));
+		}
+
+		uint16_t Steps[16];
+		_mm_storeu_si128((__m128i*)Steps, StepLow);
+		_mm_storeu_si128((__m128i*)(Steps + 8), StepHigh);
+
+		// t가 0이면 끝점0, 7이면 끝점1, 나머지는 t + 1번 사이 값
+		uint64_t Indices = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			const uint64_t Index = Steps[i] == 0 ? 0 : (Steps[i] == 7 ? 1 : Steps[i] + 1);
+			Indices |= Index << (i * 3);
+		}
+
+		WriteLittleEndian(Block + 2, Indices, 6);
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	// BC1 색
+
+	uint16_t PackRGB565(const float* Color)
+	{
+		const int R = Clamp((int)(Color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+		const int G = Clamp((int)(Color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+		const int B = Clamp((int)(Color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+		return (uint16_t)((R << 11) | (G << 5) | B);
+	}
+
+	void UnpackRGB565(uint16_t Packed, int* Color)
+	{
+		const int R = (Packed >> 11) & 31;
+		const int G = (Packed >> 5) & 63;
+		const int B = Packed & 31;
+
+		Color[0] = (R << 3) | (R >> 2);
+		Color[1] = (G << 2) | (G >> 4);
+		Color[2] = (B << 3) | (B >> 2);
+		Color[3] = 0;
+	}
+
+	// 끝점 두 개로 4색 블록을 만들고 제곱 오차를 돌려준다.
+	uint32_t BuildColorBlock(const uint8_t* Pixels, const float* Start, const float* End, uint8_t* Block)
+	{
+		uint16_t Color0 = PackRGB565(Start);
+		uint16_t Color1 = PackRGB565(End);
+
+		// Color0 > Color1이어야 4색 모드다. 같으면 전부 0번을 쓴다.
+		if (Color0 < Color1)
+		{
+			std::swap(Color0, Color1);
+		}
+
+		int Palette[4][4];
+		UnpackRGB565(Color0, Palette[0]);
+		UnpackRGB565(Color1, Palette[1]);
+		for (int Channel = 0; Channel < 3; Channel++)
+		{
+			Palette[2][Channel] = (2 * Palette[0][Channel] + Palette[1][Channel]) / 3;
+			Palette[3][Channel] = (Palette[0][Channel] + 2 * Palette[1][Channel]) / 3;
+		}
+
+		const int Axis[4] = { Palette[1][0] - Palette[0][0], Palette[1][1] - Palette[0][1], Palette[1][2] - Palette[0][2], 0 };
+		const int LengthSquared = Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2];
+
+		uint32_t Steps[16] = {};
+		if (LengthSquared > 0)
+		{
+			__m128i Dots[4];
+			ProjectPixels(Pixels, Palette[0], Axis, Dots);
+
+			// 내적 * 3 / 길이 제곱을 반올림한 t. 6 * 내적을 (2t - 1) * 길이 제곱과 비교한다.
+			for (int i = 0; i < 4; i++)
+			{
+				const __m128i Scaled = _mm_add_epi32(_mm_slli_epi32(Dots[i], 2), _mm_slli_epi32(Dots[i], 1));
+
+				__m128i Step = _mm_setzero_si128();
+				for (int Threshold = 1; Threshold <= 5; Threshold += 2)
+				{
+					Step = _mm_sub_epi32(Step, _mm_cmpgt_epi32(Scaled, _mm_set1_epi32(Threshold * LengthSquared - 1)));
+				}
+
+				_mm_storeu_si128((__m128i*)(Steps + i * 4), Step);
+			}
+		}
+
+		// t 순서(끝점0 -> 끝점1)를 BC1 인덱스 순서로
+		static const uint32_t StepToIndex[4] = { 0, 2, 3, 1 };
+
+		uint32_t Indices = 0;
+		uint32_t Error = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			const uint32_t Index = StepToIndex[Steps[i]];
+			Indices |= Index << (i * 2);
+
+			for (int Channel = 0; Channel < 3; Channel++)
+			{
+				const int Difference = Pixels[i * 4 + Channel] - Palette[Index][Channel];
+				Error += Difference * Difference;
+			}
+		}
+
+		WriteLittleEndian(Block, Color0, 2);
+		WriteLittleEndian(Block + 2, Color1, 2);
+		WriteLittleEndian(Block + 4, Indices, 4);
+
+		return Error;
+	}
+
+	void EncodeColorBlock(const uint8_t* Pixels, uint8_t* Block)
+	{
+		__m128i Min = _mm_loadu_si128((const __m128i*)Pixels);
+		__m128i Max = Min;
+		for (int i = 1; i < 4; i++)
+		{
+			const __m128i Packed = _mm_loadu_si128((const __m128i*)(Pixels + i * 16));
+			Min = _mm_min_epu8(Min, Packed);
+			Max = _mm_max_epu8(Max, Packed);
+		}
+		Min = _mm_min_epu8(Min, _mm_srli_si128(Min, 8));
+		Max = _mm_max_epu8(Max, _mm_srli_si128(Max, 8));
+		Min = _mm_min_epu8(Min, _mm_srli_si128(Min, 4));
+		Max = _mm_max_epu8(Max, _mm_srli_si128(Max, 4));
+
+		const uint32_t MinPacked = (uint32_t)_mm_cvtsi128_si32(Min);
+		const uint32_t MaxPacked = (uint32_t)_mm_cvtsi128_si32(Max);
+
+		// 바운딩 박스를 1/16 안으로 당기고, G와 같이 줄어드는 채널은 대각선을 뒤집는다.
+		float Start[3];
+		float End[3];
+		float Center[3];
+		for (int Channel = 0; Channel < 3; Channel++)
+		{
+			const float Low = (float)((MinPacked >> (Channel * 8)) & 0xFF);
+			const float High = (float)((MaxPacked >> (Channel * 8)) & 0xFF);
+			const float Inset = (High - Low) / 16.0f;
+
+			Start[Channel] = High - Inset;
+			End[Channel] = Low + Inset;
+			Center[Channel] = (Low + High) * 0.5f;
+		}
+
+		float CovarianceRG = 0.0f;
+		float CovarianceBG = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			const float G = Pixels[i * 4 + 1] - Center[1];
+			CovarianceRG += (Pixels[i * 4 + 0] - Center[0]) * G;
+			CovarianceBG += (Pixels[i * 4 + 2] - Center[2]) * G;
+		}
+
+		if (CovarianceRG < 0.0f)
+		{
+			std::swap(Start[0], End[0]);
+		}
+		if (CovarianceBG < 0.0f)
+		{
+			std::swap(Start[2], End[2]);
+		}
+
+		uint8_t Best[8];
+		uint32_t BestError = BuildColorBlock(Pixels, Start, End, Best);
+
+		for (int Iteration = 0; Iteration < 2 && BestError > 0; Iteration++)
+		{
+			static const float IndexToWeight[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+			const uint32_t Indices = (uint32_t)ReadLittleEndian(Best + 4, 4);
+			float Weights[16];
+			for (int i = 0; i < 16; i++)
+			{
+				Weights[i] = IndexToWeight[(Indices >> (i * 2)) & 3];
+			}
+
+			if (false == RefineEndpoints(Pixels, Weights, 3, Start, End))
+			{
+				break;
+			}
+
+			uint8_t Candidate[8];
+			const uint32_t Error = BuildColorBlock(Pixels, Start, End, Candidate);
+			if (Error >= BestError)
+			{
+				break;
+			}
+
+			memcpy(Best, Candidate, sizeof(Best));
+			BestError = Error;
+		}
+
+		memcpy(Block, Best, sizeof(Best));
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	// BC7 모드 6: RGBA 끝점 7비트 + p비트, 인덱스 4비트
+
+	// 128비트 블록을 64비트 두 개로 다룬다.
+	struct BitWriter
+	{
+		uint64_t Bits[2] = {};
+		uint32_t Position = 0;
+
+		void Write(uint64_t Value, uint32_t Count)
+		{
+			const uint32_t Word = Position >> 6;
+			const uint32_t Offset = Position & 63;
+
+			Bits[Word] |= Value << Offset;
+			if (Offset + Count > 64)
+			{
+				Bits[Word + 1] |= Value >> (64 - Offset);
+			}
+
+			Position += Count;
+		}
+
+		void Store(uint8_t* Block) const
+		{
+			WriteLittleEndian(Block, Bits[0], 8);
+			WriteLittleEndian(Block + 8, Bits[1], 8);
+		}
+	};
+
+	struct BitReader
+	{
+		uint64_t Bits[2] = {};
+		uint32_t Position = 0;
+
+		explicit BitReader(const uint8_t* Block)
+		{
+			Bits[0] = ReadLittleEndian(Block, 8);
+			Bits[1] = ReadLittleEndian(Block + 8, 8);
+		}
+
+		uint32_t Read(uint32_t Count)
+		{
+			const uint32_t Word = Position >> 6;
+			const uint32_t Offset = Position & 63;
+
+			uint64_t Value = Bits[Word] >> Offset;
+			if (Offset + Count > 64)
+			{
+				Value |= Bits[Word + 1] << (64 - Offset);
+			}
+
+			Position += Count;
+			return (uint32_t)(Value & ((1ull << Count) - 1));
+		}
+	};
+
+	// 0~64 가중치에 가장 가까운 BC7 인덱스
+	const uint8_t* GetNearestBC7Index()
+	{
+		static const struct Table
+		{
+			uint8_t Index[65];
+
+			Table()
+			{
+				for (int Weight = 0; Weight <= 64; Weight++)
+				{
+					int Best = 0;
+					for (int i = 1; i < 16; i++)
+					{
+						if (std::abs(BC7Weights[i] - Weight) < std::abs(BC7Weights[Best] - Weight))
+						{
+							Best = i;
+						}
+					}
+					Index[Weight] = (uint8_t)Best;
+				}
+			}
+		} Nearest;
+
+		return Nearest.Index;
+	}
+
+	// p비트 두 가지를 다 해보고 끝점에 더 가까운 쪽을 고른다.
+	void QuantizeBC7Endpoint(const float* Endpoint, int* OutValue, int* OutQuantized, int& OutPBit)
+	{
+		float BestError = -1.0f;
+		for (int PBit = 0; PBit < 2; PBit++)
+		{
+			int Value[4];
+			int Quantized[4];
+			float Error = 0.0f;
+			for (int Channel = 0; Channel < 4; Channel++)
+			{
+				Quantized[Channel] = Clamp((int)((Endpoint[Channel] - PBit) * 0.5f + 0.5f), 0, 127);
+				Value[Channel] = (Quantized[Channel] << 1) | PBit;
+
+				const float Difference = Value[Channel] - Endpoint[Channel];
+				Error += Difference * Difference;
+			}
+
+			if (BestError < 0.0f || Error < BestError)
+			{
+				BestError = Error;
+				OutPBit = PBit;
+				memcpy(OutValue, Value, sizeof(Value));
+				memcpy(OutQuantized, Quantized, sizeof(Quantized));
+			}
+		}
+	}
+
+	uint32_t BuildBC7Block(const uint8_t* Pixels, const float* Start, const float* End, uint8_t* Block)
+	{
+		int Value[2][4];
+		int Quantized[2][4];
+		int PBit[2];
+		QuantizeBC7Endpoint(Start, Value[0], Quantized[0], PBit[0]);
+		QuantizeBC7Endpoint(End, Value[1], Quantized[1], PBit[1]);
+
+		const int Axis[4] = { Value[1][0] - Value[0][0], Value[1][1] - Value[0][1], Value[1][2] - Value[0][2], Value[1][3] - Value[0][3] };
+		const int LengthSquared = Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2] + Axis[3] * Axis[3];
+
+		int32_t Weights[16] = {};
+		if (LengthSquared > 0)
+		{
+			__m128i Dots[4];
+			ProjectPixels(Pixels, Value[0], Axis, Dots);
+
+			// 내적 * 64 / 길이 제곱을 반올림하고 [0, 64]로 자른다.
+			const __m128 Scale = _mm_set1_ps(64.0f / LengthSquared);
+			const __m128i Zero = _mm_setzero_si128();
+			const __m128i SixtyFour = _mm_set1_epi32(64);
+			for (int i = 0; i < 4; i++)
+			{
+				__m128i Weight = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(Dots[i]), Scale));
+				Weight = _mm_and_si128(Weight, _mm_cmpgt_epi32(Weight, Zero));
+				const __m128i Over = _mm_cmpgt_epi32(Weight, SixtyFour);
+				Weight = _mm_or_si128(_mm_andnot_si128(Over, Weight), _mm_and_si128(Over, SixtyFour));
+
+				_mm_storeu_si128((__m128i*)(Weights + i * 4), Weight);
+			}
+		}
+
+		const uint8_t* Nearest = GetNearestBC7Index();
+
+		int Indices[16];
+		for (int i = 0; i < 16; i++)
+		{
+			Indices[i] = Nearest[Weights[i]];
+		}
+
+		// 첫 픽셀 인덱스의 최상위 비트는 저장하지 않으니 0이 되도록 끝점을 바꾼다. 가중치가 대칭이라 결과는 같다.
+		if (Indices[0] & 8)
+		{
+			std::swap(Value[0], Value[1]);
+			std::swap(Quantized[0], Quantized[1]);
+			std::swap(PBit[0], PBit[1]);
+			for (int i = 0; i < 16; i++)
+			{
+				Indices[i] = 15 - Indices[i];
+			}
+		}
+
+		uint32_t Error = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			const int Weight = BC7Weights[Indices[i]];
+			for (int Channel = 0; Channel < 4; Channel++)
+			{
+				const int Decoded = ((64 - Weight) * Value[0][Channel] + Weight * Value[1][Channel] + 32) >> 6;
+				const int Difference = Pixels[i * 4 + Channel] - Decoded;
+				Error += Difference * Difference;
+			}
+		}
+
+		BitWriter Writer;
+		Writer.Write(1 << 6, 7);
+		for (int Channel = 0; Channel < 4; Channel++)
+		{
+			Writer.Write(Quantized[0][Channel], 7);
+			Writer.Write(Quantized[1][Channel], 7);
+		}
+		Writer.Write(PBit[0], 1);
+		Writer.Write(PBit[1], 1);
+
+		Writer.Write(Indices[0], 3);
+		for (int i = 1; i < 16; i++)
+		{
+			Writer.Write(Indices[i], 4);
+		}
+
+		Writer.Store(Block);
+
+		return Error;
+	}
+
+	void EncodeBC7Block(const uint8_t* Pixels, uint8_t* Block)
+	{
+		// 평균과 공분산으로 주축을 잡고, 픽셀을 주축에 투영한 양 끝을 끝점으로 쓴다.
+		float Mean[4] = {};
+		for (int i = 0; i < 16; i++)
+		{
+			for (int Channel = 0; Channel < 4; Channel++)
+			{
+				Mean[Channel] += Pixels[i * 4 + Channel];
+			}
+		}
+		for (int Channel = 0; Channel < 4; Channel++)
+		{
+			Mean[Channel] /= 16.0f;
+		}
+
+		float Covariance[4][4] = {};
+		for (int i = 0; i < 16; i++)
+		{
+			float Offset[4];
+			for (int Channel = 0; Channel < 4; Channel++)
+			{
+				Offset[Channel] = Pixels[i * 4 + Channel] - Mean[Channel];
+			}
+
+			for (int Row = 0; Row < 4; Row++)
+			{
+				for (int Column = 0; Column < 4; Column++)
+				{
+					Covariance[Row][Column] += Offset[Row] * Offset[Column];
+				}
+			}
+		}
+
+		float Axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (int Iteration = 0; Iteration < 8; Iteration++)
+		{
+			float Next[4] = {};
+			float Largest = 0.0f;
+			for (int Row = 0; Row < 4; Row++)
+			{
+				for (int Column = 0; Column < 4; Column++)
+				{
+					Next[Row] += Covariance[Row][Column] * Axis[Column];
+				}
+				Largest = std::max(Largest, std::fabs(Next[Row]));
+			}
+
+			if (Largest < 1e-6f)
+			{
+				break;
+			}
+
+			for (int Channel = 0; Channel < 4; Channel++)
+			{
+				Axis[Channel] = Next[Channel] / Largest;
+			}
+		}
+
+		const float Length = std::sqrt(Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2] + Axis[3] * Axis[3]);
+		for (int Channel = 0; Channel < 4; Channel++)
+		{
+			Axis[Channel] /= Length;
+		}
+
+		float MinProjection = 0.0f;
+		float MaxProjection = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			float Projection = 0.0f;
+			for (int Channel = 0; Channel < 4; Channel++)
+			{
+				Projection += (Pixels[i * 4 + Channel] - Mean[Channel]) * Axis[Channel];
+			}
+			MinProjection = std::min(MinProjection, Projection);
+			MaxProjection = std::max(MaxProjection, Projection);
+		}
+
+		float Start[4];
+		float End[4];
+		for (int Channel = 0; Channel < 4; Channel++)
+		{
+			Start[Channel] = std::min(std::max(Mean[Channel] + Axis[Channel] * MinProjection, 0.0f), 255.0f);
+			End[Channel] = std::min(std::max(Mean[Channel] + Axis[Channel] * MaxProjection, 0.0f), 255.0f);
+		}
+
+		uint8_t Best[16];
+		uint32_t BestError = BuildBC7Block(Pixels, Start, End, Best);
+
+		for (int Iteration = 0; Iteration < 2 && BestError > 0; Iteration++)
+		{
+			BitReader Reader(Best);
+			Reader.Position = 65;
+
+			float Weights[16];
+			Weights[0] = BC7Weights[Reader.Read(3)] / 64.0f;
+			for (int i = 1; i < 16; i++)
+			{
+				Weights[i] = BC7Weights[Reader.Read(4)] / 64.0f;
+			}
+
+			// BuildBC7Block이 끝점을 바꿨을 수 있으니 블록에 적힌 끝점 기준으로 다시 맞춘다.
+			if (false == RefineEndpoints(Pixels, Weights, 4, Start, End))
+			{
+				break;
+			}
+
+			uint8_t Candidate[16];
+			const uint32_t Error = BuildBC7Block(Pixels, Start, End, Candidate);
+			if (Error >= BestError)
+			{
+				break;
+			}
+
+			memcpy(Best, Candidate, sizeof(Best));
+			BestError = Error;
+		}
+
+		memcpy(Block, Best, sizeof(Best));
+	}
+}
+
+void BlockCompression::EncodeBlock(BCFormat Format, const uint8_t* Pixels, uint8_t* Block)
+{
+	switch (Format)
+	{
+	case BCFormat::BC1:
+		EncodeColorBlock(Pixels, Block);
+		break;
+
+	case BCFormat::BC3:
+		EncodeSingleChannel(GatherChannel(Pixels, 3), Block);
+		EncodeColorBlock(Pixels, Block + 8);
+		break;
+
+	case BCFormat::BC4:
+		EncodeSingleChannel(GatherChannel(Pixels, 0), Block);
+		break;
+
+	case BCFormat::BC5:
+		EncodeSingleChannel(GatherChannel(Pixels, 0), Block);
+		EncodeSingleChannel(GatherChannel(Pixels, 1), Block + 8);
+		break;
+
+	case BCFormat::BC7:
+		EncodeBC7Block(Pixels, Block);
+		break;
+	}
+}
+
+void BlockCompression::DecodeBlock(BCFormat Format, const uint8_t* Block, uint8_t* Pixels)
+{
+	BlockDecoder::DecodeBlock(GetDXGIFormat(Format, false), Block, Pixels);
+}
+
+void BlockCompression::EncodeSurface(BCFormat Format, const uint8_t* Pixels, uint32_t Width, uint32_t Height, size_t RowPitch, uint8_t* OutBlocks)
+{
+	const uint32_t BlocksWide = std::max<uint32_t>(1, (Width + 3) / 4);
+	const uint32_t BlocksHigh = std::max<uint32_t>(1, (Height + 3) / 4);
+	const uint32_t BlockBytes = GetBlockBytes(Format);
+
+	auto EncodeRows = [=](size_t Begin, size_t End, uint32_t ThreadIndex)
+	{
+		uint8_t Tile[64];
+
+		for (size_t BlockY = Begin; BlockY < End; BlockY++)
+		{
+			uint8_t* Destination = OutBlocks + BlockY * BlocksWide * BlockBytes;
+
+			for (uint32_t BlockX = 0; BlockX < BlocksWide; BlockX++)
+			{
+				const bool bInterior = (BlockX + 1) * 4 <= Width && (BlockY + 1) * 4 <= Height;
+
+				for (uint32_t Y = 0; Y < 4; Y++)
+				{
+					const uint32_t SourceY = std::min<uint32_t>((uint32_t)BlockY * 4 + Y, Height - 1);
+					const uint8_t* Row = Pixels + SourceY * RowPitch;
+
+					if (bInterior)
+					{
+						memcpy(Tile + Y * 16, Row + BlockX * 16, 16);
+						continue;
+					}
+
+					for (uint32_t X = 0; X < 4; X++)
+					{
+						const uint32_t SourceX = std::min<uint32_t>(BlockX * 4 + X, Width - 1);
+						memcpy(Tile + (Y * 4 + X) * 4, Row + SourceX * 4, 4);
+					}
+				}
+
+				EncodeBlock(Format, Tile, Destination + BlockX * BlockBytes);
+			}
+		}
+	};
+
+	if (JobSystem::Get())
+	{
+		JobSystem::Get()->ParallelFor(BlocksHigh, 1, EncodeRows);
+	}
+	else
+	{
+		EncodeRows(0, BlocksHigh, 0);
+	}
+}
+
+void BlockCompression::DecodeSurface(BCFormat Format, const uint8_t* Blocks, uint32_t Width, uint32_t Height, uint8_t* OutPixels, size_t RowPitch)
+{
+	BlockDecoder::DecodeSurface(GetDXGIFormat(Format, false), Blocks, 0, Width, Height, OutPixels, RowPitch);
+}
+
+uint32_t BlockCompression::GetBlockBytes(BCFormat Format)
+{
+	return Format == BCFormat::BC1 || Format == BCFormat::BC4 ? 8 : 16;
+}
+
+size_t BlockCompression::GetSurfaceBytes(BCFormat Format, uint32_t Width, uint32_t Height)
+{
+	const size_t BlocksWide = std::max<uint32_t>(1, (Width + 3) / 4);
+	const size_t BlocksHigh = std::max<uint32_t>(1, (Height + 3) / 4);
+	return BlocksWide * BlocksHigh * GetBlockBytes(Format);
+}
+
+uint32_t BlockCompression::GetDXGIFormat(BCFormat Format, bool bSRGB)
+{
+	// DXGI_FORMAT_BC1_UNORM(71) ~ DXGI_FORMAT_BC7_UNORM_SRGB(99). BC4, BC5는 sRGB가 없다.
+	switch (Format)
+	{
+	case BCFormat::BC1:
+		return bSRGB ? 72 : 71;
+	case BCFormat::BC3:
+		return bSRGB ? 78 : 77;
+	case BCFormat::BC4:
+		return 80;
+	case BCFormat::BC5:
+		return 83;
+	case BCFormat::BC7:
+		return bSRGB ? 99 : 98;
+	}
+
+	return 0;
+}
+
+uint32_t BlockCompression::GetChannelCount(BCFormat Format)
+{
+	switch (Format)
+	{
+	case BCFormat::BC1:
+		return 3;
+	case BCFormat::BC4:
+		return 1;
+	case BCFormat::BC5:
+		return 2;
+	default:
+		return 4;
+	}
+}
@@ -0,0 +1,1164 @@
+#include "BlockDecoder.h"
+#include <emmintrin.h>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include "JobSystem.h"
+
+namespace
+{
+	enum class BlockKind
+	{
+		Unknown,
+		BC1,
+		BC2,
+		BC3,
+		BC4,
+		BC4Signed,
+		BC5,
+		BC5Signed,
+		BC6H,
+		BC6HSigned,
+		BC7
+	};
+
+	// DXGI_FORMAT_BC1_TYPELESS(70) ~ DXGI_FORMAT_BC7_UNORM_SRGB(99). TYPELESS는 UNORM으로 푼다.
+	BlockKind GetBlockKind(uint32_t Format)
+	{
+		switch (Format)
+		{
+		case 70: case 71: case 72:
+			return BlockKind::BC1;
+		case 73: case 74: case 75:
+			return BlockKind::BC2;
+		case 76: case 77: case 78:
+			return BlockKind::BC3;
+		case 79: case 80:
+			return BlockKind::BC4;
+		case 81:
+			return BlockKind::BC4Signed;
+		case 82: case 83:
+			return BlockKind::BC5;
+		case 84:
+			return BlockKind::BC5Signed;
+		case 94: case 95:
+			return BlockKind::BC6H;
+		case 96:
+			return BlockKind::BC6HSigned;
+		case 97: case 98: case 99:
+			return BlockKind::BC7;
+		default:
+			return BlockKind::Unknown;
+		}
+	}
+
+	uint64_t ReadLittleEndian(const uint8_t* Source, int ByteCount)
+	{
+		uint64_t Value = 0;
+		for (int i = 0; i < ByteCount; i++)
+		{
+			Value |= (uint64_t)Source[i] << (i * 8);
+		}
+		return Value;
+	}
+
+	// 128비트 블록을 앞에서부터 읽는다.
+	struct BitReader
+	{
+		uint64_t Bits[2] = {};
+		uint32_t Position = 0;
+
+		explicit BitReader(const uint8_t* Block)
+		{
+			Bits[0] = ReadLittleEndian(Block, 8);
+			Bits[1] = ReadLittleEndian(Block + 8, 8);
+		}
+
+		uint32_t Read(uint32_t Count)
+		{
+			if (0 == Count)
+			{
+				return 0;
+			}
+
+			const uint32_t Word = Position >> 6;
+			const uint32_t Offset = Position & 63;
+
+			uint64_t Value = Bits[Word] >> Offset;
+			if (Offset + Count > 64)
+			{
+				Value |= Bits[Word + 1] << (64 - Offset);
+			}
+
+			Position += Count;
+			return (uint32_t)(Value & ((1ull << Count) - 1));
+		}
+
+		// 인덱스처럼 길이가 정해진 필드를 한 번에 나눌 때 쓴다. 128비트를 넘는 자리는 0이다.
+		uint64_t Peek() const
+		{
+			const uint32_t Offset = Position & 63;
+			if (Position >= 64)
+			{
+				return Bits[1] >> Offset;
+			}
+			return Offset ? (Bits[0] >> Offset) | (Bits[1] << (64 - Offset)) : Bits[0];
+		}
+	};
+
+	// 픽셀마다 IndexBits, AnchorMask에 켜진 픽셀은 한 비트 적게 읽는다. 합이 64비트를 넘는 모드는 없다.
+	void ReadIndices(BitReader& Reader, uint32_t IndexBits, uint32_t AnchorMask, uint8_t* OutIndices)
+	{
+		uint64_t Bits = Reader.Peek();
+		uint32_t Used = 0;
+
+		for (uint32_t Pixel = 0; Pixel < 16; Pixel++)
+		{
+			const uint32_t Count = IndexBits - ((AnchorMask >> Pixel) & 1);
+			OutIndices[Pixel] = (uint8_t)(Bits & ((1u << Count) - 1));
+			Bits >>= Count;
+			Used += Count;
+		}
+
+		Reader.Position += Used;
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	// 인덱스 선택
+
+	// 2비트 인덱스 16개를 4색 팔레트에서 고른다. 픽셀 4개씩 인덱스 두 비트를 마스크로 펴서 섞는다.
+	__m128i Blend(__m128i Mask, __m128i IfSet, __m128i IfClear)
+	{
+		return _mm_or_si128(_mm_and_si128(Mask, IfSet), _mm_andnot_si128(Mask, IfClear));
+	}
+
+	void SelectColors2Bit(uint32_t Indices, const uint32_t* Palette, uint8_t* OutPixels)
+	{
+		const __m128i Color0 = _mm_set1_epi32((int)Palette[0]);
+		const __m128i Color1 = _mm_set1_epi32((int)Palette[1]);
+		const __m128i Color2 = _mm_set1_epi32((int)Palette[2]);
+		const __m128i Color3 = _mm_set1_epi32((int)Palette[3]);
+		const __m128i LowBits = _mm_setr_epi32(1 << 0, 1 << 2, 1 << 4, 1 << 6);
+		const __m128i HighBits = _mm_setr_epi32(1 << 1, 1 << 3, 1 << 5, 1 << 7);
+
+		for (int i = 0; i < 4; i++)
+		{
+			const __m128i Row = _mm_set1_epi32((int)((Indices >> (i * 8)) & 0xFF));
+			const __m128i Low = _mm_cmpeq_epi32(_mm_and_si128(Row, LowBits), LowBits);
+			const __m128i High = _mm_cmpeq_epi32(_mm_and_si128(Row, HighBits), HighBits);
+
+			const __m128i Color = Blend(High, Blend(Low, Color3, Color2), Blend(Low, Color1, Color0));
+			_mm_storeu_si128((__m128i*)(OutPixels + i * 16), Color);
+		}
+	}
+
+	// 팔레트가 크거나 구역마다 다르면 표에서 바로 읽는 쪽이 비교해서 섞는 것보다 빠르다.
+	void LookupColors(const uint8_t* Indices, const uint32_t* Palette, uint8_t* OutPixels)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			memcpy(OutPixels + i * 4, Palette + Indices[i], 4);
+		}
+	}
+
+	// 채널 네 개(각 16바이트)를 RGBA 16픽셀로 엮는다.
+	void InterleaveChannels(__m128i R, __m128i G, __m128i B, __m128i A, uint8_t* OutPixels)
+	{
+		const __m128i RGLow = _mm_unpacklo_epi8(R, G);
+		const __m128i RGHigh = _mm_unpackhi_epi8(R, G);
+		const __m128i BALow = _mm_unpacklo_epi8(B, A);
+		const __m128i BAHigh = _mm_unpackhi_epi8(B, A);
+
+		_mm_storeu_si128((__m128i*)(OutPixels + 0), _mm_unpacklo_epi16(RGLow, BALow));
+		_mm_storeu_si128((__m128i*)(OutPixels + 16), _mm_unpackhi_epi16(RGLow, BALow));
+		_mm_storeu_si128((__m128i*)(OutPixels + 32), _mm_unpacklo_epi16(RGHigh, BAHigh));
+		_mm_storeu_si128((__m128i*)(OutPixels + 48), _mm_unpackhi_epi16(RGHigh, BAHigh));
+	}
+
+	// 16픽셀의 알파 바이트만 Alpha로 바꾼다.
+	void ReplaceAlpha(__m128i Alpha, uint8_t* Pixels)
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i ColorMask = _mm_set1_epi32(0x00FFFFFF);
+		const __m128i AlphaLow = _mm_unpacklo_epi8(Zero, Alpha);
+		const __m128i AlphaHigh = _mm_unpackhi_epi8(Zero, Alpha);
+		const __m128i Shifted[4] =
+		{
+			_mm_unpacklo_epi16(Zero, AlphaLow), _mm_unpackhi_epi16(Zero, AlphaLow),
+			_mm_unpacklo_epi16(Zero, AlphaHigh), _mm_unpackhi_epi16(Zero, AlphaHigh)
+		};
+
+		for (int i = 0; i < 4; i++)
+		{
+			const __m128i Color = _mm_and_si128(_mm_loadu_si128((const __m128i*)(Pixels + i * 16)), ColorMask);
+			_mm_storeu_si128((__m128i*)(Pixels + i * 16), _mm_or_si128(Color, Shifted[i]));
+		}
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	// BC1 ~ BC5
+
+	uint32_t PackColor(int R, int G, int B, int A)
+	{
+		return (uint32_t)R | ((uint32_t)G << 8) | ((uint32_t)B << 16) | ((uint32_t)A << 24);
+	}
+
+	// BC2, BC3의 색 블록은 항상 4색이다.
+	void DecodeColorBlock(const uint8_t* Block, uint8_t* OutPixels, bool bAllowThreeColor)
+	{
+		const uint32_t Color0 = (uint32_t)ReadLittleEndian(Block, 2);
+		const uint32_t Color1 = (uint32_t)ReadLittleEndian(Block + 2, 2);
+
+		int Endpoints[2][3];
+		const uint32_t Colors[2] = { Color0, Color1 };
+		for (int i = 0; i < 2; i++)
+		{
+			const int R = (Colors[i] >> 11) & 31;
+			const int G = (Colors[i] >> 5) & 63;
+			const int B = Colors[i] & 31;
+			Endpoints[i][0] = (R << 3) | (R >> 2);
+			Endpoints[i][1] = (G << 2) | (G >> 4);
+			Endpoints[i][2] = (B << 3) | (B >> 2);
+		}
+
+		const int* Start = Endpoints[0];
+		const int* End = Endpoints[1];
+
+		uint32_t Palette[4];
+		Palette[0] = PackColor(Start[0], Start[1], Start[2], 255);
+		Palette[1] = PackColor(End[0], End[1], End[2], 255);
+
+		if (Color0 > Color1 || false == bAllowThreeColor)
+		{
+			Palette[2] = PackColor((2 * Start[0] + End[0]) / 3, (2 * Start[1] + End[1]) / 3, (2 * Start[2] + End[2]) / 3, 255);
+			Palette[3] = PackColor((Start[0] + 2 * End[0]) / 3, (Start[1] + 2 * End[1]) / 3, (Start[2] + 2 * End[2]) / 3, 255);
+		}
+		else
+		{
+			Palette[2] = PackColor((Start[0] + End[0]) / 2, (Start[1] + End[1]) / 2, (Start[2] + End[2]) / 2, 255);
+			Palette[3] = 0;
+		}
+
+		SelectColors2Bit((uint32_t)ReadLittleEndian(Block + 4, 4), Palette, OutPixels);
+	}
+
+	// BC3 알파, BC4, BC5가 같이 쓰는 8바이트 채널 블록
+	__m128i DecodeChannelBlock(const uint8_t* Block)
+	{
+		const int Start = Block[0];
+		const int End = Block[1];
+
+		int Palette[8] = { Start, End };
+		if (Start > End)
+		{
+			for (int i = 1; i <= 6; i++)
+			{
+				Palette[i + 1] = ((7 - i) * Start + i * End) / 7;
+			}
+		}
+		else
+		{
+			for (int i = 1; i <= 4; i++)
+			{
+				Palette[i + 1] = ((5 - i) * Start + i * End) / 5;
+			}
+			Palette[6] = 0;
+			Palette[7] = 255;
+		}
+
+		uint8_t Bytes[8];
+		for (int i = 0; i < 8; i++)
+		{
+			Bytes[i] = (uint8_t)Palette[i];
+		}
+
+		const uint64_t Indices = ReadLittleEndian(Block + 2, 6);
+
+		alignas(16) uint8_t Channel[16];
+		for (int i = 0; i < 16; i++)
+		{
+			Channel[i] = Bytes[(Indices >> (i * 3)) & 7];
+		}
+		return _mm_load_si128((const __m128i*)Channel);
+	}
+
+	void DecodeExplicitAlpha(const uint8_t* Block, uint8_t* Pixels)
+	{
+		const uint64_t Bits = ReadLittleEndian(Block, 8);
+
+		// 4비트 값 x를 x * 17로 펼친다. 상위, 하위 니블에 같은 값을 넣는 것과 같다.
+		alignas(16) uint8_t Alpha[16];
+		for (int i = 0; i < 16; i++)
+		{
+			const uint8_t Value = (uint8_t)((Bits >> (i * 4)) & 15);
+			Alpha[i] = (uint8_t)(Value | (Value << 4));
+		}
+
+		ReplaceAlpha(_mm_load_si128((const __m128i*)Alpha), Pixels);
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	// BC7
+
+	struct BC7ModeInfo
+	{
+		uint8_t SubsetCount;
+		uint8_t PartitionBits;
+		uint8_t RotationBits;
+		uint8_t IndexSelectionBits;
+		uint8_t ColorBits;
+		uint8_t AlphaBits;
+		uint8_t EndpointPBits;
+		uint8_t SharedPBits;
+		uint8_t IndexBits;
+		uint8_t SecondaryIndexBits;
+	};
+
+	const BC7ModeInfo BC7Modes[8] =
+	{
+		{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+		{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+		{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+		{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+		{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+		{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+		{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+		{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+	};
+
+	const uint8_t Weights2[4] = { 0, 21, 43, 64 };
+	const uint8_t Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	const uint8_t Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	const uint8_t* GetWeights(uint32_t IndexBits)
+	{
+		return IndexBits == 2 ? Weights2 : (IndexBits == 3 ? Weights3 : Weights4);
+	}
+
+	// 구역이 두 개일 때 픽셀마다 1비트, 세 개일 때 2비트. BC6H도 두 구역 표의 앞 32개를 쓴다.
+	const uint16_t Partitions2[64] =
+	{
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+		0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+		0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+		0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+		0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+	};
+
+	const uint32_t Partitions3[64] =
+	{
+		0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+		0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+		0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+		0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+		0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+		0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+		0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+		0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+	};
+
+	// 구역마다 인덱스 최상위 비트를 생략하는 픽셀. 첫 구역은 항상 0번 픽셀이다.
+	const uint8_t Anchors2[64] =
+	{
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+		15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+		 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+	};
+
+	const uint8_t Anchors3Second[64] =
+	{
+		 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+		 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+		 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+		 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+	};
+
+	const uint8_t Anchors3Third[64] =
+	{
+		15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+		15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+		15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+		15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+	};
+
+	uint32_t GetSubset(uint32_t SubsetCount, uint32_t Partition, uint32_t Pixel)
+	{
+		if (SubsetCount == 2)
+		{
+			return (Partitions2[Partition] >> Pixel) & 1;
+		}
+		if (SubsetCount == 3)
+		{
+			return (Partitions3[Partition] >> (Pixel * 2)) & 3;
+		}
+		return 0;
+	}
+
+	uint32_t GetAnchorMask(uint32_t SubsetCount, uint32_t Partition)
+	{
+		if (SubsetCount == 2)
+		{
+			return 1u | (1u << Anchors2[Partition]);
+		}
+		if (SubsetCount == 3)
+		{
+			return 1u | (1u << Anchors3Second[Partition]) | (1u << Anchors3Third[Partition]);
+		}
+		return 1u;
+	}
+
+	// 끝점 두 개 사이를 가중치 표대로 나눈 RGBA8 팔레트. 16비트 칸에 항목 두 개씩 담아 한 번에 보간한다.
+	void BuildBC7Palette(const int* Start, const int* End, const uint8_t* Weights, uint32_t Count, uint32_t* OutPalette)
+	{
+		const __m128i StartVector = _mm_setr_epi16(
+			(short)Start[0], (short)Start[1], (short)Start[2], (short)Start[3],
+			(short)Start[0], (short)Start[1], (short)Start[2], (short)Start[3]);
+		const __m128i EndVector = _mm_setr_epi16(
+			(short)End[0], (short)End[1], (short)End[2], (short)End[3],
+			(short)End[0], (short)End[1], (short)End[2], (short)End[3]);
+		const __m128i Full = _mm_set1_epi16(64);
+		const __m128i Round = _mm_set1_epi16(32);
+
+		for (uint32_t Entry = 0; Entry < Count; Entry += 2)
+		{
+			const short Weight0 = Weights[Entry];
+			const short Weight1 = Weights[Entry + 1];
+			const __m128i Weight = _mm_setr_epi16(Weight0, Weight0, Weight0, Weight0, Weight1, Weight1, Weight1, Weight1);
+
+			// 255 * 64 + 32도 16비트 안에 들어간다.
+			__m128i Value = _mm_add_epi16(_mm_mullo_epi16(StartVector, _mm_sub_epi16(Full, Weight)), _mm_mullo_epi16(EndVector, Weight));
+			Value = _mm_srli_epi16(_mm_add_epi16(Value, Round), 6);
+
+			_mm_storel_epi64((__m128i*)(OutPalette + Entry), _mm_packus_epi16(Value, Value));
+		}
+	}
+
+	void DecodeBC7Block(const uint8_t* Block, uint8_t* OutPixels)
+	{
+		uint32_t Mode = 0;
+		while (Mode < 8 && 0 == (Block[0] & (1 << Mode)))
+		{
+			Mode++;
+		}
+
+		// 모드 비트가 없는 블록은 스펙대로 0으로 채운다.
+		if (Mode == 8)
+		{
+			memset(OutPixels, 0, 64);
+			return;
+		}
+
+		const BC7ModeInfo& Info = BC7Modes[Mode];
+
+		BitReader Reader(Block);
+		Reader.Position = Mode + 1;
+
+		const uint32_t Partition = Reader.Read(Info.PartitionBits);
+		const uint32_t Rotation = Reader.Read(Info.RotationBits);
+		const uint32_t IndexSelection = Reader.Read(Info.IndexSelectionBits);
+
+		int Endpoints[3][2][4] = {};
+		for (int Channel = 0; Channel < 3; Channel++)
+		{
+			for (uint32_t Subset = 0; Subset < Info.SubsetCount; Subset++)
+			{
+				Endpoints[Subset][0][Channel] = (int)Reader.Read(Info.ColorBits);
+				Endpoints[Subset][1][Channel] = (int)Reader.Read(Info.ColorBits);
+			}
+		}
+
+		for (uint32_t Subset = 0; Subset < Info.SubsetCount; Subset++)
+		{
+			Endpoints[Subset][0][3] = (int)Reader.Read(Info.AlphaBits);
+			Endpoints[Subset][1][3] = (int)Reader.Read(Info.AlphaBits);
+		}
+
+		int PBits[3][2] = {};
+		for (uint32_t Subset = 0; Subset < Info.SubsetCount; Subset++)
+		{
+			if (Info.EndpointPBits)
+			{
+				PBits[Subset][0] = (int)Reader.Read(1);
+				PBits[Subset][1] = (int)Reader.Read(1);
+			}
+			else if (Info.SharedPBits)
+			{
+				PBits[Subset][0] = PBits[Subset][1] = (int)Reader.Read(1);
+			}
+		}
+
+		// p비트를 붙인 뒤 상위 비트를 아래에 반복해서 8비트로 편다.
+		const bool bHasPBit = Info.EndpointPBits || Info.SharedPBits;
+		const int ColorBits = Info.ColorBits + (bHasPBit ? 1 : 0);
+		const int AlphaBits = Info.AlphaBits ? Info.AlphaBits + (bHasPBit ? 1 : 0) : 0;
+
+		for (uint32_t Subset = 0; Subset < Info.SubsetCount; Subset++)
+		{
+			for (int Side = 0; Side < 2; Side++)
+			{
+				int* Endpoint = Endpoints[Subset][Side];
+				for (int Channel = 0; Channel < 4; Channel++)
+				{
+					const int Bits = Channel < 3 ? ColorBits : AlphaBits;
+					if (0 == Bits)
+					{
+						Endpoint[Channel] = 255;
+						continue;
+					}
+
+					int Value = Endpoint[Channel];
+					if (bHasPBit)
+					{
+						Value = (Value << 1) | PBits[Subset][Side];
+					}
+					Endpoint[Channel] = (Value << (8 - Bits)) | (Value >> (2 * Bits - 8));
+				}
+			}
+		}
+
+		uint8_t Indices[16];
+		ReadIndices(Reader, Info.IndexBits, GetAnchorMask(Info.SubsetCount, Partition), Indices);
+
+		if (0 == Info.SecondaryIndexBits)
+		{
+			const uint32_t PaletteSize = 1u << Info.IndexBits;
+
+			uint32_t Palettes[3][16];
+			for (uint32_t Subset = 0; Subset < Info.SubsetCount; Subset++)
+			{
+				BuildBC7Palette(Endpoints[Subset][0], Endpoints[Subset][1], GetWeights(Info.IndexBits), PaletteSize, Palettes[Subset]);
+			}
+
+			if (Info.SubsetCount == 1)
+			{
+				LookupColors(Indices, Palettes[0], OutPixels);
+			}
+			else
+			{
+				for (uint32_t Pixel = 0; Pixel < 16; Pixel++)
+				{
+					memcpy(OutPixels + Pixel * 4, Palettes[GetSubset(Info.SubsetCount, Partition, Pixel)] + Indices[Pixel], 4);
+				}
+			}
+		}
+		else
+		{
+			// 모드 4, 5는 색과 알파 인덱스를 따로 둔다. 모드 4의 선택 비트가 켜지면 둘이 바뀐다.
+			uint8_t SecondaryIndices[16];
+			ReadIndices(Reader, Info.SecondaryIndexBits, 1u, SecondaryIndices);
+
+			const uint32_t ColorIndexBits = IndexSelection ? Info.SecondaryIndexBits : Info.IndexBits;
+			const uint32_t AlphaIndexBits = IndexSelection ? Info.IndexBits : Info.SecondaryIndexBits;
+			const uint8_t* ColorIndices = IndexSelection ? SecondaryIndices : Indices;
+			const uint8_t* AlphaIndices = IndexSelection ? Indices : SecondaryIndices;
+
+			uint32_t ColorPalette[8];
+			uint32_t AlphaPalette[8];
+			BuildBC7Palette(Endpoints[0][0], Endpoints[0][1], GetWeights(ColorIndexBits), 1u << ColorIndexBits, ColorPalette);
+			BuildBC7Palette(Endpoints[0][0], Endpoints[0][1], GetWeights(AlphaIndexBits), 1u << AlphaIndexBits, AlphaPalette);
+
+			alignas(16) uint8_t Alpha[16];
+			LookupColors(ColorIndices, ColorPalette, OutPixels);
+			for (uint32_t Pixel = 0; Pixel < 16; Pixel++)
+			{
+				Alpha[Pixel] = (uint8_t)(AlphaPalette[AlphaIndices[Pixel]] >> 24);
+			}
+			ReplaceAlpha(_mm_load_si128((const __m128i*)Alpha), OutPixels);
+		}
+
+		// 회전은 보간이 끝난 뒤 알파와 채널 하나를 맞바꾼다.
+		if (Rotation)
+		{
+			for (uint32_t Pixel = 0; Pixel < 16; Pixel++)
+			{
+				std::swap(OutPixels[Pixel * 4 + 3], OutPixels[Pixel * 4 + Rotation - 1]);
+			}
+		}
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	// BC6H
+
+	// 끝점 비트가 블록 안에 흩어져 있어서 모드마다 (끝점, 채널, 시작 비트, 비트 수)로 순서대로 적는다.
+	// 끝점 번호는 w, x, y, z 순서로 0~3이고 Field = 끝점 * 3 + 채널이다. bReversed면 읽은 비트를 위에서부터 채운다.
+	struct BC6HSegment
+	{
+		uint8_t Field;
+		uint8_t Low;
+		uint8_t Count;
+		bool bReversed = false;
+	};
+
+	enum : uint8_t
+	{
+		RW, GW, BW, RX, GX, BX, RY, GY, BY, RZ, GZ, BZ
+	};
+
+	struct BC6HModeInfo
+	{
+		uint8_t SubsetCount;
+		bool bTransformed;
+		uint8_t EndpointBits;
+		uint8_t DeltaBits[3];
+		BC6HSegment Segments[24];
+	};
+
+	const BC6HModeInfo BC6HModes[14] =
+	{
+		// 모드 1 (00)
+		{ 2, true, 10, { 5, 5, 5 }, {
+			{ GY, 4, 1 }, { BY, 4, 1 }, { BZ, 4, 1 }, { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 5 }, { GZ, 4, 1 },
+			{ GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 },
+			{ BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		// 모드 2 (01)
+		{ 2, true, 7, { 6, 6, 6 }, {
+			{ GY, 5, 1 }, { GZ, 4, 1 }, { GZ, 5, 1 }, { RW, 0, 7 }, { BZ, 0, 1 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 7 },
+			{ BY, 5, 1 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 7 }, { BZ, 3, 1 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 6 },
+			{ GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		// 모드 3 (00010)
+		{ 2, true, 11, { 5, 4, 4 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 5 }, { RW, 10, 1 }, { GY, 0, 4 }, { GX, 0, 4 }, { GW, 10, 1 },
+			{ BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 4 }, { BW, 10, 1 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 },
+			{ RZ, 0, 5 }, { BZ, 3, 1 } } },
+		// 모드 4 (00110)
+		{ 2, true, 11, { 4, 5, 4 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 1 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 },
+			{ GW, 10, 1 }, { GZ, 0, 4 }, { BX, 0, 4 }, { BW, 10, 1 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 4 }, { BZ, 0, 1 },
+			{ BZ, 2, 1 }, { RZ, 0, 4 }, { GY, 4, 1 }, { BZ, 3, 1 } } },
+		// 모드 5 (01010)
+		{ 2, true, 11, { 4, 4, 5 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 1 }, { BY, 4, 1 }, { GY, 0, 4 }, { GX, 0, 4 },
+			{ GW, 10, 1 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BW, 10, 1 }, { BY, 0, 4 }, { RY, 0, 4 }, { BZ, 1, 1 },
+			{ BZ, 2, 1 }, { RZ, 0, 4 }, { BZ, 4, 1 }, { BZ, 3, 1 } } },
+		// 모드 6 (01110)
+		{ 2, true, 9, { 5, 5, 5 }, {
+			{ RW, 0, 9 }, { BY, 4, 1 }, { GW, 0, 9 }, { GY, 4, 1 }, { BW, 0, 9 }, { BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 },
+			{ GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 },
+			{ BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		// 모드 7 (10010)
+		{ 2, true, 8, { 6, 5, 5 }, {
+			{ RW, 0, 8 }, { GZ, 4, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { BZ, 3, 1 },
+			{ BZ, 4, 1 }, { RX, 0, 6 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 },
+			{ BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		// 모드 8 (10110)
+		{ 2, true, 8, { 5, 6, 5 }, {
+			{ RW, 0, 8 }, { BZ, 0, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { GY, 5, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { GZ, 5, 1 },
+			{ BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 },
+			{ BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		// 모드 9 (11010)
+		{ 2, true, 8, { 5, 5, 6 }, {
+			{ RW, 0, 8 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { BY, 5, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { BZ, 5, 1 },
+			{ BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 6 },
+			{ BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		// 모드 10 (11110)
+		{ 2, false, 6, { 6, 6, 6 }, {
+			{ RW, 0, 6 }, { GZ, 4, 1 }, { BZ, 0, 1 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 6 }, { GY, 5, 1 }, { BY, 5, 1 },
+			{ BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 6 }, { GZ, 5, 1 }, { BZ, 3, 1 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 6 },
+			{ GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		// 모드 11 (00011)
+		{ 1, false, 10, { 10, 10, 10 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 10 }, { GX, 0, 10 }, { BX, 0, 10 } } },
+		// 모드 12 (00111)
+		{ 1, true, 11, { 9, 9, 9 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 9 }, { RW, 10, 1 }, { GX, 0, 9 }, { GW, 10, 1 }, { BX, 0, 9 },
+			{ BW, 10, 1 } } },
+		// 모드 13 (01011)
+		{ 1, true, 12, { 8, 8, 8 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 8 }, { RW, 10, 2, true }, { GX, 0, 8 }, { GW, 10, 2, true }, { BX, 0, 8 },
+			{ BW, 10, 2, true } } },
+		// 모드 14 (01111)
+		{ 1, true, 16, { 4, 4, 4 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 6, true }, { GX, 0, 4 }, { GW, 10, 6, true }, { BX, 0, 4 },
+			{ BW, 10, 6, true } } },
+	};
+
+	// 5비트 모드 값에서 BC6HModes 자리. 예약된 값은 -1.
+	int GetBC6HMode(const uint8_t* Block)
+	{
+		const uint32_t Low = Block[0] & 3;
+		if (Low < 2)
+		{
+			return (int)Low;
+		}
+
+		switch (Block[0] & 31)
+		{
+		case 0x02: return 2;
+		case 0x06: return 3;
+		case 0x0A: return 4;
+		case 0x0E: return 5;
+		case 0x12: return 6;
+		case 0x16: return 7;
+		case 0x1A: return 8;
+		case 0x1E: return 9;
+		case 0x03: return 10;
+		case 0x07: return 11;
+		case 0x0B: return 12;
+		case 0x0F: return 13;
+		default: return -1;
+		}
+	}
+
+	int SignExtend(int Value, int Bits)
+	{
+		const int Shift = 32 - Bits;
+		return (int)((uint32_t)Value << Shift) >> Shift;
+	}
+
+	int UnquantizeBC6H(int Value, int Bits, bool bSigned)
+	{
+		if (false == bSigned)
+		{
+			if (Bits >= 15 || Value == 0)
+			{
+				return Value;
+			}
+			if (Value == (1 << Bits) - 1)
+			{
+				return 0xFFFF;
+			}
+			return ((Value << 16) + 0x8000) >> Bits;
+		}
+
+		if (Bits >= 16)
+		{
+			return Value;
+		}
+
+		const bool bNegative = Value < 0;
+		const int Magnitude = bNegative ? -Value : Value;
+
+		int Result = 0;
+		if (Magnitude == 0)
+		{
+			Result = 0;
+		}
+		else if (Magnitude >= (1 << (Bits - 1)) - 1)
+		{
+			Result = 0x7FFF;
+		}
+		else
+		{
+			Result = ((Magnitude << 15) + 0x4000) >> (Bits - 1);
+		}
+
+		return bNegative ? -Result : Result;
+	}
+
+	// 보간한 16비트 값 4개를 half 비트로 줄인 다음 float로 바꾼다. Inf, NaN은 나오지 않아서 지수를 옮기고 2^112를 곱하면 된다.
+	__m128 FinishBC6H(__m128i Value, bool bSigned)
+	{
+		__m128i Half;
+		if (bSigned)
+		{
+			const __m128i Sign = _mm_srai_epi32(Value, 31);
+			const __m128i Magnitude = _mm_sub_epi32(_mm_xor_si128(Value, Sign), Sign);
+			const __m128i Scaled = _mm_srli_epi32(_mm_sub_epi32(_mm_slli_epi32(Magnitude, 5), Magnitude), 5);
+			Half = _mm_or_si128(Scaled, _mm_and_si128(Sign, _mm_set1_epi32(0x8000)));
+		}
+		else
+		{
+			Half = _mm_srli_epi32(_mm_sub_epi32(_mm_slli_epi32(Value, 5), Value), 6);
+		}
+
+		const __m128i Exponent = _mm_slli_epi32(_mm_and_si128(Half, _mm_set1_epi32(0x7FFF)), 13);
+		const __m128i SignBit = _mm_slli_epi32(_mm_and_si128(Half, _mm_set1_epi32(0x8000)), 16);
+		const __m128 Magnitude = _mm_mul_ps(_mm_castsi128_ps(Exponent), _mm_castsi128_ps(_mm_set1_epi32(0x77800000)));
+
+		return _mm_or_ps(Magnitude, _mm_castsi128_ps(SignBit));
+	}
+
+	void DecodeBC6HBlock(const uint8_t* Block, bool bSigned, float* OutPixels)
+	{
+		const int ModeIndex = GetBC6HMode(Block);
+		if (ModeIndex < 0)
+		{
+			memset(OutPixels, 0, 16 * 4 * sizeof(float));
+			return;
+		}
+
+		const BC6HModeInfo& Info = BC6HModes[ModeIndex];
+
+		BitReader Reader(Block);
+		Reader.Position = ModeIndex < 2 ? 2 : 5;
+
+		int Fields[12] = {};
+		for (const BC6HSegment& Segment : Info.Segments)
+		{
+			if (0 == Segment.Count)
+			{
+				break;
+			}
+
+			const uint32_t Value = Reader.Read(Segment.Count);
+			if (Segment.bReversed)
+			{
+				for (uint32_t Bit = 0; Bit < Segment.Count; Bit++)
+				{
+					Fields[Segment.Field] |= (int)((Value >> Bit) & 1) << (Segment.Low + Segment.Count - 1 - Bit);
+				}
+			}
+			else
+			{
+				Fields[Segment.Field] |= (int)Value << Segment.Low;
+			}
+		}
+
+		const int EndpointCount = Info.SubsetCount * 2;
+		const int Bits = Info.EndpointBits;
+
+		if (bSigned)
+		{
+			for (int Channel = 0; Channel < 3; Channel++)
+			{
+				Fields[Channel] = SignExtend(Fields[Channel], Bits);
+			}
+		}
+
+		// 변환 모드의 나머지 끝점은 w에서의 차이라서 항상 부호가 있다.
+		for (int Endpoint = 1; Endpoint < EndpointCount; Endpoint++)
+		{
+			for (int Channel = 0; Channel < 3; Channel++)
+			{
+				int& Value = Fields[Endpoint * 3 + Channel];
+				if (Info.bTransformed)
+				{
+					Value = SignExtend(Value, Info.DeltaBits[Channel]);
+					Value = (Fields[Channel] + Value) & ((1 << Bits) - 1);
+					if (bSigned)
+					{
+						Value = SignExtend(Value, Bits);
+					}
+				}
+				else if (bSigned)
+				{
+					Value = SignExtend(Value, Bits);
+				}
+			}
+		}
+
+		for (int Field = 0; Field < EndpointCount * 3; Field++)
+		{
+			Fields[Field] = UnquantizeBC6H(Fields[Field], Bits, bSigned);
+		}
+
+		uint32_t Partition = 0;
+		uint32_t IndexBits = 4;
+		if (Info.SubsetCount == 2)
+		{
+			Reader.Position = 77;
+			Partition = Reader.Read(5);
+			IndexBits = 3;
+		}
+
+		// 정수 보간이 float에서도 정확하다(65535 * 64 < 2^24). 결과를 정수로 돌려서 >> 6 한다.
+		alignas(16) float Palettes[2][16][4];
+		const uint8_t* Weights = GetWeights(IndexBits);
+		for (uint32_t Subset = 0; Subset < Info.SubsetCount; Subset++)
+		{
+			const int* Start = Fields + Subset * 6;
+			const int* End = Start + 3;
+			const __m128 StartVector = _mm_setr_ps((float)Start[0], (float)Start[1], (float)Start[2], 0.0f);
+			const __m128 EndVector = _mm_setr_ps((float)End[0], (float)End[1], (float)End[2], 0.0f);
+
+			for (uint32_t Entry = 0; Entry < (1u << IndexBits); Entry++)
+			{
+				const __m128 Weight = _mm_set1_ps((float)Weights[Entry]);
+				const __m128 Sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(StartVector, _mm_sub_ps(_mm_set1_ps(64.0f), Weight)), _mm_mul_ps(EndVector, Weight)), _mm_set1_ps(32.0f));
+				const __m128i Value = _mm_srai_epi32(_mm_cvtps_epi32(Sum), 6);
+
+				__m128 Color = FinishBC6H(Value, bSigned);
+				Color = _mm_or_ps(_mm_and_ps(Color, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+				_mm_store_ps(Palettes[Subset][Entry], Color);
+			}
+		}
+
+		uint8_t Indices[16];
+		ReadIndices(Reader, IndexBits, GetAnchorMask(Info.SubsetCount, Partition), Indices);
+
+		for (uint32_t Pixel = 0; Pixel < 16; Pixel++)
+		{
+			const uint32_t Subset = GetSubset(Info.SubsetCount, Partition, Pixel);
+			_mm_storeu_ps(OutPixels + Pixel * 4, _mm_load_ps(Palettes[Subset][Indices[Pixel]]));
+		}
+	}
+
+	// ---------------------------------------------------------------------------------------------
+
+	void DecodeUnormBlock(BlockKind Kind, const uint8_t* Block, uint8_t* OutPixels)
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i Opaque = _mm_set1_epi8((char)0xFF);
+
+		switch (Kind)
+		{
+		case BlockKind::BC1:
+			DecodeColorBlock(Block, OutPixels, true);
+			break;
+
+		case BlockKind::BC2:
+			DecodeColorBlock(Block + 8, OutPixels, false);
+			DecodeExplicitAlpha(Block, OutPixels);
+			break;
+
+		case BlockKind::BC3:
+			DecodeColorBlock(Block + 8, OutPixels, false);
+			ReplaceAlpha(DecodeChannelBlock(Block), OutPixels);
+			break;
+
+		case BlockKind::BC4:
+			InterleaveChannels(DecodeChannelBlock(Block), Zero, Zero, Opaque, OutPixels);
+			break;
+
+		case BlockKind::BC5:
+			InterleaveChannels(DecodeChannelBlock(Block), DecodeChannelBlock(Block + 8), Zero, Opaque, OutPixels);
+			break;
+
+		case BlockKind::BC7:
+			DecodeBC7Block(Block, OutPixels);
+			break;
+
+		default:
+			memset(OutPixels, 0, 64);
+			break;
+		}
+	}
+
+	// SNORM은 정수로 자르면 음수 쪽 반올림 방향이 구현마다 달라서 스펙대로 float로 보간한다.
+	void DecodeSignedChannels(const uint8_t* Block, int ChannelCount, float* OutPixels)
+	{
+		for (int Pixel = 0; Pixel < 16; Pixel++)
+		{
+			OutPixels[Pixel * 4 + 1] = 0.0f;
+			OutPixels[Pixel * 4 + 2] = 0.0f;
+			OutPixels[Pixel * 4 + 3] = 1.0f;
+		}
+
+		for (int Channel = 0; Channel < ChannelCount; Channel++)
+		{
+			const uint8_t* Source = Block + Channel * 8;
+
+			// -128과 -127은 둘 다 -1.0이다.
+			const float Start = std::max<int>((int8_t)Source[0], -127) / 127.0f;
+			const float End = std::max<int>((int8_t)Source[1], -127) / 127.0f;
+
+			float Palette[8] = { Start, End };
+			if (Start > End)
+			{
+				for (int i = 1; i <= 6; i++)
+				{
+					Palette[i + 1] = ((7 - i) * Start + i * End) / 7.0f;
+				}
+			}
+			else
+			{
+				for (int i = 1; i <= 4; i++)
+				{
+					Palette[i + 1] = ((5 - i) * Start + i * End) / 5.0f;
+				}
+				Palette[6] = -1.0f;
+				Palette[7] = 1.0f;
+			}
+
+			const uint64_t Indices = ReadLittleEndian(Source + 2, 6);
+			for (int Pixel = 0; Pixel < 16; Pixel++)
+			{
+				OutPixels[Pixel * 4 + Channel] = Palette[(Indices >> (Pixel * 3)) & 7];
+			}
+		}
+	}
+
+	void ConvertUnormToFloat(const uint8_t* Pixels, float* OutPixels)
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128 Scale = _mm_set1_ps(1.0f / 255.0f);
+
+		for (int i = 0; i < 4; i++)
+		{
+			const __m128i Packed = _mm_loadu_si128((const __m128i*)(Pixels + i * 16));
+			const __m128i Low = _mm_unpacklo_epi8(Packed, Zero);
+			const __m128i High = _mm_unpackhi_epi8(Packed, Zero);
+			const __m128i Words[4] =
+			{
+				_mm_unpacklo_epi16(Low, Zero), _mm_unpackhi_epi16(Low, Zero),
+				_mm_unpacklo_epi16(High, Zero), _mm_unpackhi_epi16(High, Zero)
+			};
+
+			for (int j = 0; j < 4; j++)
+			{
+				_mm_storeu_ps(OutPixels + (i * 4 + j) * 4, _mm_mul_ps(_mm_cvtepi32_ps(Words[j]), Scale));
+			}
+		}
+	}
+
+	// 블록 행을 JobSystem으로 나눈다. 블록 수가 적으면 잘게 쪼개지 않는다.
+	void ForEachBlockRow(uint32_t BlocksWide, uint32_t BlocksHigh, const std::function<void(uint32_t BlockY)>& Body)
+	{
+		auto DecodeRows = [&Body](size_t Begin, size_t End, uint32_t ThreadIndex)
+		{
+			for (size_t BlockY = Begin; BlockY < End; BlockY++)
+			{
+				Body((uint32_t)BlockY);
+			}
+		};
+
+		if (JobSystem::Get())
+		{
+			JobSystem::Get()->ParallelFor(BlocksHigh, std::max<size_t>(1, 256 / BlocksWide), DecodeRows);
+		}
+		else
+		{
+			DecodeRows(0, BlocksHigh, 0);
+		}
+	}
+}
+
+bool BlockDecoder::IsSupported(uint32_t Format)
+{
+	return GetBlockKind(Format) != BlockKind::Unknown;
+}
+
+bool BlockDecoder::HasUnormOutput(uint32_t Format)
+{
+	switch (GetBlockKind(Format))
+	{
+	case BlockKind::BC1:
+	case BlockKind::BC2:
+	case BlockKind::BC3:
+	case BlockKind::BC4:
+	case BlockKind::BC5:
+	case BlockKind::BC7:
+		return true;
+	default:
+		return false;
+	}
+}
+
+uint32_t BlockDecoder::GetBlockBytes(uint32_t Format)
+{
+	switch (GetBlockKind(Format))
+	{
+	case BlockKind::Unknown:
+		return 0;
+	case BlockKind::BC1:
+	case BlockKind::BC4:
+	case BlockKind::BC4Signed:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+void BlockDecoder::DecodeBlock(uint32_t Format, const uint8_t* Block, uint8_t* OutPixels)
+{
+	DecodeUnormBlock(GetBlockKind(Format), Block, OutPixels);
+}
+
+void BlockDecoder::DecodeBlockFloat(uint32_t Format, const uint8_t* Block, float* OutPixels)
+{
+	const BlockKind Kind = GetBlockKind(Format);
+
+	switch (Kind)
+	{
+	case BlockKind::BC4Signed:
+		DecodeSignedChannels(Block, 1, OutPixels);
+		break;
+
+	case BlockKind::BC5Signed:
+		DecodeSignedChannels(Block, 2, OutPixels);
+		break;
+
+	case BlockKind::BC6H:
+	case BlockKind::BC6HSigned:
+		DecodeBC6HBlock(Block, Kind == BlockKind::BC6HSigned, OutPixels);
+		break;
+
+	default:
+	{
+		alignas(16) uint8_t Pixels[64];
+		DecodeUnormBlock(Kind, Block, Pixels);
+		ConvertUnormToFloat(Pixels, OutPixels);
+		break;
+	}
+	}
+}
+
+bool BlockDecoder::DecodeSurface(uint32_t Format, const uint8_t* Blocks, size_t BlockRowPitch, uint32_t Width, uint32_t Height, uint8_t* OutPixels, size_t RowPitch)
+{
+	if (false == HasUnormOutput(Format))
+	{
+		return false;
+	}
+	if (0 == Width || 0 == Height)
+	{
+		return true;
+	}
+
+	const BlockKind Kind = GetBlockKind(Format);
+	const uint32_t BlockBytes = GetBlockBytes(Format);
+	const uint32_t BlocksWide = std::max<uint32_t>(1, (Width + 3) / 4);
+	const uint32_t BlocksHigh = std::max<uint32_t>(1, (Height + 3) / 4);
+	const size_t SourcePitch = BlockRowPitch ? BlockRowPitch : (size_t)BlocksWide * BlockBytes;
+
+	ForEachBlockRow(BlocksWide, BlocksHigh, [=](uint32_t BlockY)
+	{
+		alignas(16) uint8_t Tile[64];
+		const uint8_t* Source = Blocks + BlockY * SourcePitch;
+		const uint32_t CopyHeight = std::min<uint32_t>(4, Height - BlockY * 4);
+
+		for (uint32_t BlockX = 0; BlockX < BlocksWide; BlockX++)
+		{
+			DecodeUnormBlock(Kind, Source + BlockX * BlockBytes, Tile);
+
+			const uint32_t CopyWidth = std::min<uint32_t>(4, Width - BlockX * 4);
+			for (uint32_t Y = 0; Y < CopyHeight; Y++)
+			{
+				memcpy(OutPixels + (BlockY * 4 + Y) * RowPitch + BlockX * 16, Tile + Y * 16, CopyWidth * 4);
+			}
+		}
+	});
+
+	return true;
+}
+
+bool BlockDecoder::DecodeSurfaceFloat(uint32_t Format, const uint8_t* Blocks, size_t BlockRowPitch, uint32_t Width, uint32_t Height, float* OutPixels, size_t RowPitch)
+{
+	if (false == IsSupported(Format))
+	{
+		return false;
+	}
+	if (0 == Width || 0 == Height)
+	{
+		return true;
+	}
+
+	const uint32_t BlockBytes = GetBlockBytes(Format);
+	const uint32_t BlocksWide = std::max<uint32_t>(1, (Width + 3) / 4);
+	const uint32_t BlocksHigh = std::max<uint32_t>(1, (Height + 3) / 4);
+	const size_t SourcePitch = BlockRowPitch ? BlockRowPitch : (size_t)BlocksWide * BlockBytes;
+	uint8_t* Destination = reinterpret_cast<uint8_t*>(OutPixels);
+
+	ForEachBlockRow(BlocksWide, BlocksHigh, [=](uint32_t BlockY)
+	{
+		alignas(16) float Tile[64];
+		const uint8_t* Source = Blocks + BlockY * SourcePitch;
+		const uint32_t CopyHeight = std::min<uint32_t>(4, Height - BlockY * 4);
+
+		for (uint32_t BlockX = 0; BlockX < BlocksWide; BlockX++)
+		{
+			DecodeBlockFloat(Format, Source + BlockX * BlockBytes, Tile);
+
+			const uint32_t CopyWidth = std::min<uint32_t>(4, Width - BlockX * 4);
+			for (uint32_t Y = 0; Y < CopyHeight; Y++)
+			{
+				memcpy(Destination + (BlockY * 4 + Y) * RowPitch + BlockX * 4 * sizeof(float) * 4, Tile + Y * 16, CopyWidth * sizeof(float) * 4);
+			}
+		}
+	});
+
+	return true;
+}
@@ -0,0 +1,116 @@
+#include "CpuSkinning.h"
+#include "JobSystem.h"
+
+namespace
+{
+	// 4의 배수여야 스레드 경계에서 남는 정점이 생기지 않는다.
+	const size_t SkinVerticesPerJob = 4096;
+
+	// 정점 하나의 영향을 섞은 행렬. 빈 슬롯은 가중치가 0이라 아무 뼈나 가리켜도 결과에 영향이 없다.
+	inline XMMATRIX BlendPalette(const Vertex& V, const XMMATRIX* Palette, uint32_t BoneCount)
+	{
+		const float Weights[4] = { V.BoneWeights.x, V.BoneWeights.y, V.BoneWeights.z, V.BoneWeights.w };
+
+		XMMATRIX Result;
+		Result.r[0] = XMVectorZero();
+		Result.r[1] = XMVectorZero();
+		Result.r[2] = XMVectorZero();
+		Result.r[3] = XMVectorZero();
+
+		for (int k = 0; k < 4; k++)
+		{
+			const XMMATRIX& Bone = Palette[V.BoneIndices[k] < BoneCount ? V.BoneIndices[k] : 0];
+			const XMVECTOR Weight = XMVectorReplicate(Weights[k]);
+
+			Result.r[0] = XMVectorMultiplyAdd(Bone.r[0], Weight, Result.r[0]);
+			Result.r[1] = XMVectorMultiplyAdd(Bone.r[1], Weight, Result.r[1]);
+			Result.r[2] = XMVectorMultiplyAdd(Bone.r[2], Weight, Result.r[2]);
+			Result.r[3] = XMVectorMultiplyAdd(Bone.r[3], Weight, Result.r[3]);
+		}
+
+		return Result;
+	}
+
+	inline void StoreNormalized(FXMVECTOR X, FXMVECTOR Y, FXMVECTOR Z, float* OutX, float* OutY, float* OutZ)
+	{
+		// 4개를 한 번에 정규화한다. 길이가 0인 노멀은 0으로 남긴다.
+		XMVECTOR LengthSq = XMVectorMultiplyAdd(X, X, XMVectorMultiplyAdd(Y, Y, XMVectorMultiply(Z, Z)));
+		XMVECTOR InvLength = XMVectorSelect(XMVectorReciprocalSqrt(LengthSq), XMVectorZero(), XMVectorEqual(LengthSq, XMVectorZero()));
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(OutX), XMVectorMultiply(X, InvLength));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(OutY), XMVectorMultiply(Y, InvLength));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(OutZ), XMVectorMultiply(Z, InvLength));
+	}
+}
+
+void SkinnedVertexStream::Resize(size_t Count)
+{
+	PositionX.resize(Count);
+	PositionY.resize(Count);
+	PositionZ.resize(Count);
+	NormalX.resize(Count);
+	NormalY.resize(Count);
+	NormalZ.resize(Count);
+}
+
+size_t SkinnedVertexStream::Size() const
+{
+	return PositionX.size();
+}
+
+void CpuSkinning::Skin(ArrayView<Vertex> Vertices, const XMMATRIX* Palette, uint32_t BoneCount, SkinnedVertexStream& Out)
+{
+	Out.Resize(Vertices.size());
+
+	JobSystem::Get()->ParallelFor(Vertices.size(), SkinVerticesPerJob, [&](size_t Begin, size_t End, uint32_t ThreadIndex)
+	{
+		SkinRange(Vertices, Palette, BoneCount, Begin, End, Out);
+	});
+}
+
+void CpuSkinning::SkinRange(ArrayView<Vertex> Vertices, const XMMATRIX* Palette, uint32_t BoneCount, size_t Begin, size_t End, SkinnedVertexStream& Out)
+{
+	size_t i = Begin;
+
+	// 4개씩 변환한 뒤 전치해서 성분별 배열에 한 번에 쓴다.
+	for (; i + 4 <= End; i += 4)
+	{
+		XMMATRIX Positions;
+		XMMATRIX Normals;
+
+		for (int Lane = 0; Lane < 4; Lane++)
+		{
+			const Vertex& V = Vertices[i + Lane];
+			XMMATRIX Blended = BlendPalette(V, Palette, BoneCount);
+
+			Positions.r[Lane] = XMVector3Transform(XMLoadFloat3(&V.Pos), Blended);
+			Normals.r[Lane] = XMVector3TransformNormal(XMLoadFloat3(&V.Normal), Blended);
+		}
+
+		Positions = XMMatrixTranspose(Positions);
+		Normals = XMMatrixTranspose(Normals);
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Out.PositionX[i]), Positions.r[0]);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Out.PositionY[i]), Positions.r[1]);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Out.PositionZ[i]), Positions.r[2]);
+		StoreNormalized(Normals.r[0], Normals.r[1], Normals.r[2], &Out.NormalX[i], &Out.NormalY[i], &Out.NormalZ[i]);
+	}
+
+	for (; i < End; i++)
+	{
+		const Vertex& V = Vertices[i];
+		XMMATRIX Blended = BlendPalette(V, Palette, BoneCount);
+
+		XMFLOAT3 Position;
+		XMFLOAT3 Normal;
+		XMStoreFloat3(&Position, XMVector3Transform(XMLoadFloat3(&V.Pos), Blended));
+		XMStoreFloat3(&Normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&V.Normal), Blended)));
+
+		Out.PositionX[i] = Position.x;
+		Out.PositionY[i] = Position.y;
+		Out.PositionZ[i] = Position.z;
+		Out.NormalX[i] = Normal.x;
+		Out.NormalY[i] = Normal.y;
+		Out.NormalZ[i] = Normal.z;
+	}
+}
@@ -0,0 +1,823 @@
+#include "DDSFile.h"
+#include "BlockDecoder.h"
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+	constexpr uint32_t MakeFourCC(char A, char B, char C, char D)
+	{
+		return (uint32_t)(uint8_t)A | ((uint32_t)(uint8_t)B << 8) | ((uint32_t)(uint8_t)C << 16) | ((uint32_t)(uint8_t)D << 24);
+	}
+
+	const uint32_t DDSMagic = MakeFourCC('D', 'D', 'S', ' ');
+
+	const uint32_t PixelFormatFourCC = 0x00000004;
+	const uint32_t PixelFormatRGB = 0x00000040;
+	const uint32_t PixelFormatLuminance = 0x00020000;
+	const uint32_t PixelFormatAlpha = 0x00000002;
+
+	const uint32_t HeaderFlagCaps = 0x00000001;
+	const uint32_t HeaderFlagHeight = 0x00000002;
+	const uint32_t HeaderFlagWidth = 0x00000004;
+	const uint32_t HeaderFlagPixelFormat = 0x00001000;
+	const uint32_t HeaderFlagMipMapCount = 0x00020000;
+	const uint32_t HeaderFlagLinearSize = 0x00080000;
+	const uint32_t HeaderFlagVolume = 0x00800000;
+
+	const uint32_t CapsComplex = 0x00000008;
+	const uint32_t CapsTexture = 0x00001000;
+	const uint32_t CapsMipMap = 0x00400000;
+
+	const uint32_t Caps2CubeMap = 0x00000200;
+	const uint32_t Caps2CubeMapAllFaces = 0x0000FC00 | Caps2CubeMap;
+
+	// DX10 확장 헤더의 D3D10_RESOURCE_DIMENSION / D3D11_RESOURCE_MISC_TEXTURECUBE
+	const uint32_t ResourceDimensionTexture1D = 2;
+	const uint32_t ResourceDimensionTexture2D = 3;
+	const uint32_t ResourceDimensionTexture3D = 4;
+	const uint32_t ResourceMiscTextureCube = 0x4;
+
+	// D3D12_REQ_* 한계. 파일에 적힌 크기를 그대로 믿지 않는다.
+	const uint32_t MaxMipLevels = 15;
+	const uint32_t MaxTexture1DSize = 16384;
+	const uint32_t MaxTexture2DSize = 16384;
+	const uint32_t MaxTexture3DSize = 2048;
+	const uint32_t MaxArraySize = 2048;
+
+#pragma pack(push, 1)
+	struct DDSPixelFormat
+	{
+		uint32_t Size;
+		uint32_t Flags;
+		uint32_t FourCC;
+		uint32_t RGBBitCount;
+		uint32_t RBitMask;
+		uint32_t GBitMask;
+		uint32_t BBitMask;
+		uint32_t ABitMask;
+	};
+
+	struct DDSHeader
+	{
+		uint32_t Size;
+		uint32_t Flags;
+		uint32_t Height;
+		uint32_t Width;
+		uint32_t PitchOrLinearSize;
+		uint32_t Depth;
+		uint32_t MipMapCount;
+		uint32_t Reserved1[11];
+		DDSPixelFormat PixelFormat;
+		uint32_t Caps;
+		uint32_t Caps2;
+		uint32_t Caps3;
+		uint32_t Caps4;
+		uint32_t Reserved2;
+	};
+
+	struct DDSHeaderDXT10
+	{
+		uint32_t DxgiFormat;
+		uint32_t ResourceDimension;
+		uint32_t MiscFlag;
+		uint32_t ArraySize;
+		uint32_t MiscFlags2;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(DDSPixelFormat) == 32, "DDS pixel format must match the file layout");
+	static_assert(sizeof(DDSHeader) == 124, "DDS header must match the file layout");
+	static_assert(sizeof(DDSHeaderDXT10) == 20, "DDS DX10 header must match the file layout");
+
+	// 자주 쓰는 DXGI_FORMAT 값. 나머지는 GetBitsPerPixel에서 구간으로 다룬다.
+	enum : uint32_t
+	{
+		FormatR32G32B32A32Float = 2,
+		FormatR16G16B16A16Float = 10,
+		FormatR16G16B16A16Unorm = 11,
+		FormatR16G16B16A16Snorm = 13,
+		FormatR32G32Float = 16,
+		FormatR10G10B10A2Unorm = 24,
+		FormatR8G8B8A8Unorm = 28,
+		FormatR16G16Float = 34,
+		FormatR16G16Unorm = 35,
+		FormatR32Float = 41,
+		FormatR8G8Unorm = 49,
+		FormatR16Float = 54,
+		FormatR16Unorm = 56,
+		FormatR8Unorm = 61,
+		FormatA8Unorm = 65,
+		FormatR1Unorm = 66,
+		FormatR8G8B8G8Unorm = 68,
+		FormatG8R8G8B8Unorm = 69,
+		FormatBC1Typeless = 70,
+		FormatBC1Unorm = 71,
+		FormatBC2Unorm = 74,
+		FormatBC3Unorm = 77,
+		FormatBC4Typeless = 79,
+		FormatBC4Unorm = 80,
+		FormatBC4Snorm = 81,
+		FormatBC5Unorm = 83,
+		FormatBC5Snorm = 84,
+		FormatB5G6R5Unorm = 85,
+		FormatB5G5R5A1Unorm = 86,
+		FormatB8G8R8A8Unorm = 87,
+		FormatB8G8R8X8Unorm = 88,
+		FormatBC6HTypeless = 94,
+		FormatBC7Srgb = 99,
+		FormatB4G4R4A4Unorm = 115,
+	};
+
+	void SetResult(DDSResult* OutResult, DDSResult Result)
+	{
+		if (OutResult)
+		{
+			*OutResult = Result;
+		}
+	}
+
+	bool IsPacked(uint32_t Format)
+	{
+		return Format == FormatR8G8B8G8Unorm || Format == FormatG8R8G8B8Unorm;
+	}
+
+	bool IsBitMask(const DDSPixelFormat& PixelFormat, uint32_t R, uint32_t G, uint32_t B, uint32_t A)
+	{
+		return PixelFormat.RBitMask == R && PixelFormat.GBitMask == G && PixelFormat.BBitMask == B && PixelFormat.ABitMask == A;
+	}
+
+	// DX10 확장 헤더가 없는 옛날 파일의 픽셀 포맷을 DXGI_FORMAT으로 옮긴다. 모르는 건 0.
+	uint32_t GetLegacyFormat(const DDSPixelFormat& PixelFormat)
+	{
+		if (PixelFormat.Flags & PixelFormatRGB)
+		{
+			switch (PixelFormat.RGBBitCount)
+			{
+			case 32:
+				if (IsBitMask(PixelFormat, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000))
+				{
+					return FormatR8G8B8A8Unorm;
+				}
+				if (IsBitMask(PixelFormat, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000))
+				{
+					return FormatB8G8R8A8Unorm;
+				}
+				if (IsBitMask(PixelFormat, 0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000))
+				{
+					return FormatB8G8R8X8Unorm;
+				}
+				// D3DX가 R/B를 뒤집어서 써놓은 10:10:10:2
+				if (IsBitMask(PixelFormat, 0x3ff00000, 0x000ffc00, 0x000003ff, 0xc0000000))
+				{
+					return FormatR10G10B10A2Unorm;
+				}
+				if (IsBitMask(PixelFormat, 0x0000ffff, 0xffff0000, 0x00000000, 0x00000000))
+				{
+					return FormatR16G16Unorm;
+				}
+				if (IsBitMask(PixelFormat, 0xffffffff, 0x00000000, 0x00000000, 0x00000000))
+				{
+					return FormatR32Float;
+				}
+				break;
+
+			case 16:
+				if (IsBitMask(PixelFormat, 0x7c00, 0x03e0, 0x001f, 0x8000))
+				{
+					return FormatB5G5R5A1Unorm;
+				}
+				if (IsBitMask(PixelFormat, 0xf800, 0x07e0, 0x001f, 0x0000))
+				{
+					return FormatB5G6R5Unorm;
+				}
+				if (IsBitMask(PixelFormat, 0x0f00, 0x00f0, 0x000f, 0xf000))
+				{
+					return FormatB4G4R4A4Unorm;
+				}
+				break;
+			}
+		}
+		else if (PixelFormat.Flags & PixelFormatLuminance)
+		{
+			if (8 == PixelFormat.RGBBitCount && IsBitMask(PixelFormat, 0x000000ff, 0x00000000, 0x00000000, 0x00000000))
+			{
+				return FormatR8Unorm;
+			}
+
+			if (16 == PixelFormat.RGBBitCount)
+			{
+				if (IsBitMask(PixelFormat, 0x0000ffff, 0x00000000, 0x00000000, 0x00000000))
+				{
+					return FormatR16Unorm;
+				}
+				if (IsBitMask(PixelFormat, 0x000000ff, 0x00000000, 0x00000000, 0x0000ff00))
+				{
+					return FormatR8G8Unorm;
+				}
+			}
+		}
+		else if (PixelFormat.Flags & PixelFormatAlpha)
+		{
+			if (8 == PixelFormat.RGBBitCount)
+			{
+				return FormatA8Unorm;
+			}
+		}
+		else if (PixelFormat.Flags & PixelFormatFourCC)
+		{
+			switch (PixelFormat.FourCC)
+			{
+			case MakeFourCC('D', 'X', 'T', '1'):
+				return FormatBC1Unorm;
+			case MakeFourCC('D', 'X', 'T', '2'):
+			case MakeFourCC('D', 'X', 'T', '3'):
+				return FormatBC2Unorm;
+			case MakeFourCC('D', 'X', 'T', '4'):
+			case MakeFourCC('D', 'X', 'T', '5'):
+				return FormatBC3Unorm;
+			case MakeFourCC('A', 'T', 'I', '1'):
+			case MakeFourCC('B', 'C', '4', 'U'):
+				return FormatBC4Unorm;
+			case MakeFourCC('B', 'C', '4', 'S'):
+				return FormatBC4Snorm;
+			case MakeFourCC('A', 'T', 'I', '2'):
+			case MakeFourCC('B', 'C', '5', 'U'):
+				return FormatBC5Unorm;
+			case MakeFourCC('B', 'C', '5', 'S'):
+				return FormatBC5Snorm;
+			case MakeFourCC('R', 'G', 'B', 'G'):
+				return FormatR8G8B8G8Unorm;
+			case MakeFourCC('G', 'R', 'G', 'B'):
+				return FormatG8R8G8B8Unorm;
+
+			// D3DFORMAT 번호가 그대로 들어 있는 경우
+			case 36:
+				return FormatR16G16B16A16Unorm;
+			case 110:
+				return FormatR16G16B16A16Snorm;
+			case 111:
+				return FormatR16Float;
+			case 112:
+				return FormatR16G16Float;
+			case 113:
+				return FormatR16G16B16A16Float;
+			case 114:
+				return FormatR32Float;
+			case 115:
+				return FormatR32G32Float;
+			case 116:
+				return FormatR32G32B32A32Float;
+			}
+		}
+
+		return 0;
+	}
+}
+
+std::unique_ptr<DDSFile> DDSFile::Open(const char* FilePath, DDSResult* OutResult)
+{
+	std::unique_ptr<DDSFile> Texture = std::make_unique<DDSFile>();
+	if (false == Texture->File.Open(FilePath))
+	{
+		SetResult(OutResult, DDSResult::FileNotFound);
+		return nullptr;
+	}
+
+	DDSResult Result = Texture->Parse(Texture->File.GetData(), Texture->File.GetSize());
+	SetResult(OutResult, Result);
+
+	if (Result != DDSResult::Ok)
+	{
+		return nullptr;
+	}
+
+	return Texture;
+}
+
+std::unique_ptr<DDSFile> DDSFile::Open(const wchar_t* FilePath, DDSResult* OutResult)
+{
+	std::unique_ptr<DDSFile> Texture = std::make_unique<DDSFile>();
+	if (false == Texture->File.Open(FilePath))
+	{
+		SetResult(OutResult, DDSResult::FileNotFound);
+		return nullptr;
+	}
+
+	DDSResult Result = Texture->Parse(Texture->File.GetData(), Texture->File.GetSize());
+	SetResult(OutResult, Result);
+
+	if (Result != DDSResult::Ok)
+	{
+		return nullptr;
+	}
+
+	return Texture;
+}
+
+std::unique_ptr<DDSFile> DDSFile::FromMemory(const uint8_t* Data, size_t Size, DDSResult* OutResult)
+{
+	std::unique_ptr<DDSFile> Texture = std::make_unique<DDSFile>();
+
+	DDSResult Result = Texture->Parse(Data, Size);
+	SetResult(OutResult, Result);
+
+	if (Result != DDSResult::Ok)
+	{
+		return nullptr;
+	}
+
+	return Texture;
+}
+
+std::unique_ptr<DDSFile> DDSFile::FromStorage(std::vector<uint8_t>&& Bytes)
+{
+	std::unique_ptr<DDSFile> Texture = std::make_unique<DDSFile>();
+	Texture->Storage = std::move(Bytes);
+
+	if (Texture->Parse(Texture->Storage.data(), Texture->Storage.size()) != DDSResult::Ok)
+	{
+		return nullptr;
+	}
+
+	return Texture;
+}
+
+std::unique_ptr<DDSFile> DDSFile::Create(uint32_t Format, uint32_t Width, uint32_t Height, const std::vector<std::vector<uint8_t>>& Mips)
+{
+	std::unique_ptr<DDSFile> Texture = std::make_unique<DDSFile>();
+	if (false == Serialize(Format, Width, Height, Mips, Texture->Storage))
+	{
+		return nullptr;
+	}
+
+	if (Texture->Parse(Texture->Storage.data(), Texture->Storage.size()) != DDSResult::Ok)
+	{
+		return nullptr;
+	}
+
+	return Texture;
+}
+
+bool DDSFile::Save(const char* FilePath, uint32_t Format, uint32_t Width, uint32_t Height, const std::vector<std::vector<uint8_t>>& Mips)
+{
+	std::vector<uint8_t> Bytes;
+	if (false == Serialize(Format, Width, Height, Mips, Bytes))
+	{
+		return false;
+	}
+
+	std::ofstream Stream(FilePath, std::ios::binary | std::ios::trunc);
+	if (false == Stream.is_open())
+	{
+		return false;
+	}
+
+	Stream.write((const char*)Bytes.data(), Bytes.size());
+	return Stream.good();
+}
+
+uint32_t DDSFile::GetBitsPerPixel(uint32_t Format)
+{
+	// DXGI_FORMAT은 같은 크기끼리 번호가 붙어 있어서 구간으로 나눈다. 비디오 포맷(100~114)은 지원하지 않는다.
+	if (Format >= 1 && Format <= 4)
+	{
+		return 128;
+	}
+	if (Format >= 5 && Format <= 8)
+	{
+		return 96;
+	}
+	if (Format >= 9 && Format <= 22)
+	{
+		return 64;
+	}
+	if ((Format >= 23 && Format <= 47) || Format == 67 || IsPacked(Format) || (Format >= 87 && Format <= 93))
+	{
+		return 32;
+	}
+	if ((Format >= 48 && Format <= 59) || Format == FormatB5G6R5Unorm || Format == FormatB5G5R5A1Unorm || Format == FormatB4G4R4A4Unorm)
+	{
+		return 16;
+	}
+	if (Format >= 60 && Format <= 65)
+	{
+		return 8;
+	}
+	if (Format == FormatR1Unorm)
+	{
+		return 1;
+	}
+	if (IsBlockCompressed(Format))
+	{
+		// BC1, BC4는 4x4 블록이 8바이트, 나머지는 16바이트
+		return (Format <= 72 || (Format >= FormatBC4Typeless && Format <= FormatBC4Snorm)) ? 4 : 8;
+	}
+
+	return 0;
+}
+
+bool DDSFile::IsBlockCompressed(uint32_t Format)
+{
+	return (Format >= FormatBC1Typeless && Format <= FormatBC5Snorm) || (Format >= FormatBC6HTypeless && Format <= FormatBC7Srgb);
+}
+
+const DDSSubresource& DDSFile::GetSubresource(uint32_t Mip, uint32_t ArraySlice) const
+{
+	assert(Mip < MipCount && ArraySlice < ArraySize);
+	return Subresources[Mip + ArraySlice * MipCount];
+}
+
+const uint8_t* DDSFile::GetSubresourceData(uint32_t Mip, uint32_t ArraySlice) const
+{
+	return Data + GetSubresource(Mip, ArraySlice).Offset;
+}
+
+uint32_t DDSFile::GetFirstMipWithin(size_t MaxSize) const
+{
+	if (0 == MaxSize || MipCount <= 1)
+	{
+		return 0;
+	}
+
+	for (uint32_t Mip = 0; Mip < MipCount; Mip++)
+	{
+		const DDSSubresource& Subresource = Subresources[Mip];
+		if (Subresource.Width <= MaxSize && Subresource.Height <= MaxSize && Subresource.Depth <= MaxSize)
+		{
+			return Mip;
+		}
+	}
+
+	return MipCount - 1;
+}
+
+bool DDSFile::DecodeSubresource(uint32_t Mip, uint32_t ArraySlice, std::vector<uint8_t>& OutPixels) const
+{
+	if (false == BlockDecoder::HasUnormOutput(Format))
+	{
+		return false;
+	}
+
+	const DDSSubresource& Subresource = GetSubresource(Mip, ArraySlice);
+	const size_t SliceSize = (size_t)Subresource.Width * Subresource.Height * 4;
+	OutPixels.resize(SliceSize * Subresource.Depth);
+
+	for (uint32_t Slice = 0; Slice < Subresource.Depth; Slice++)
+	{
+		const uint8_t* Blocks = Data + Subresource.Offset + (size_t)Slice * Subresource.SliceBytes;
+		BlockDecoder::DecodeSurface(Format, Blocks, Subresource.RowBytes, Subresource.Width, Subresource.Height, OutPixels.data() + Slice * SliceSize, (size_t)Subresource.Width * 4);
+	}
+
+	return true;
+}
+
+bool DDSFile::DecodeSubresourceFloat(uint32_t Mip, uint32_t ArraySlice, std::vector<float>& OutPixels) const
+{
+	if (false == BlockDecoder::IsSupported(Format))
+	{
+		return false;
+	}
+
+	const DDSSubresource& Subresource = GetSubresource(Mip, ArraySlice);
+	const size_t SliceSize = (size_t)Subresource.Width * Subresource.Height * 4;
+	OutPixels.resize(SliceSize * Subresource.Depth);
+
+	for (uint32_t Slice = 0; Slice < Subresource.Depth; Slice++)
+	{
+		const uint8_t* Blocks = Data + Subresource.Offset + (size_t)Slice * Subresource.SliceBytes;
+		BlockDecoder::DecodeSurfaceFloat(Format, Blocks, Subresource.RowBytes, Subresource.Width, Subresource.Height, OutPixels.data() + Slice * SliceSize, (size_t)Subresource.Width * 4 * sizeof(float));
+	}
+
+	return true;
+}
+
+uint32_t DDSFile::GetWidth() const
+{
+	return Width;
+}
+
+uint32_t DDSFile::GetHeight() const
+{
+	return Height;
+}
+
+uint32_t DDSFile::GetDepth() const
+{
+	return Depth;
+}
+
+uint32_t DDSFile::GetMipCount() const
+{
+	return MipCount;
+}
+
+uint32_t DDSFile::GetArraySize() const
+{
+	return ArraySize;
+}
+
+uint32_t DDSFile::GetFormat() const
+{
+	return Format;
+}
+
+DDSDimension DDSFile::GetDimension() const
+{
+	return Dimension;
+}
+
+bool DDSFile::IsCubeMap() const
+{
+	return bCubeMap;
+}
+
+const uint8_t* DDSFile::GetData() const
+{
+	return Data;
+}
+
+size_t DDSFile::GetSize() const
+{
+	return Size;
+}
+
+bool DDSFile::Serialize(uint32_t Format, uint32_t Width, uint32_t Height, const std::vector<std::vector<uint8_t>>& Mips, std::vector<uint8_t>& Out)
+{
+	if (Mips.empty() || Mips.size() > MaxMipLevels)
+	{
+		return false;
+	}
+
+	DDSHeader Header = {};
+	Header.Size = sizeof(DDSHeader);
+	Header.Flags = HeaderFlagCaps | HeaderFlagHeight | HeaderFlagWidth | HeaderFlagPixelFormat | HeaderFlagLinearSize;
+	Header.Height = Height;
+	Header.Width = Width;
+	Header.PitchOrLinearSize = (uint32_t)Mips[0].size();
+	Header.MipMapCount = (uint32_t)Mips.size();
+	Header.PixelFormat.Size = sizeof(DDSPixelFormat);
+	Header.PixelFormat.Flags = PixelFormatFourCC;
+	Header.PixelFormat.FourCC = MakeFourCC('D', 'X', '1', '0');
+	Header.Caps = CapsTexture;
+
+	if (Mips.size() > 1)
+	{
+		Header.Flags |= HeaderFlagMipMapCount;
+		Header.Caps |= CapsComplex | CapsMipMap;
+	}
+
+	DDSHeaderDXT10 HeaderDXT10 = {};
+	HeaderDXT10.DxgiFormat = Format;
+	HeaderDXT10.ResourceDimension = ResourceDimensionTexture2D;
+	HeaderDXT10.ArraySize = 1;
+
+	size_t TotalBytes = sizeof(DDSMagic) + sizeof(Header) + sizeof(HeaderDXT10);
+	for (const std::vector<uint8_t>& Mip : Mips)
+	{
+		TotalBytes += Mip.size();
+	}
+
+	Out.resize(TotalBytes);
+	uint8_t* Destination = Out.data();
+
+	memcpy(Destination, &DDSMagic, sizeof(DDSMagic));
+	Destination += sizeof(DDSMagic);
+	memcpy(Destination, &Header, sizeof(Header));
+	Destination += sizeof(Header);
+	memcpy(Destination, &HeaderDXT10, sizeof(HeaderDXT10));
+	Destination += sizeof(HeaderDXT10);
+
+	for (const std::vector<uint8_t>& Mip : Mips)
+	{
+		memcpy(Destination, Mip.data(), Mip.size());
+		Destination += Mip.size();
+	}
+
+	return true;
+}
+
+DDSResult DDSFile::Parse(const uint8_t* InData, size_t InSize)
+{
+	if (nullptr == InData || InSize < sizeof(uint32_t))
+	{
+		return DDSResult::InvalidData;
+	}
+
+	uint32_t Magic = 0;
+	memcpy(&Magic, InData, sizeof(Magic));
+	if (Magic != DDSMagic)
+	{
+		return DDSResult::InvalidData;
+	}
+
+	if (InSize < sizeof(uint32_t) + sizeof(DDSHeader))
+	{
+		return DDSResult::Truncated;
+	}
+
+	const DDSHeader* Header = reinterpret_cast<const DDSHeader*>(InData + sizeof(uint32_t));
+	if (Header->Size != sizeof(DDSHeader) || Header->PixelFormat.Size != sizeof(DDSPixelFormat))
+	{
+		return DDSResult::InvalidData;
+	}
+
+	Data = InData;
+	Size = InSize;
+	Width = Header->Width;
+	Height = Header->Height;
+	Depth = Header->Depth;
+	MipCount = std::max<uint32_t>(Header->MipMapCount, 1);
+	ArraySize = 1;
+	bCubeMap = false;
+
+	size_t BitOffset = sizeof(uint32_t) + sizeof(DDSHeader);
+
+	const bool bDXT10Header = (Header->PixelFormat.Flags & PixelFormatFourCC) && Header->PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0');
+	if (bDXT10Header)
+	{
+		if (InSize < BitOffset + sizeof(DDSHeaderDXT10))
+		{
+			return DDSResult::Truncated;
+		}
+
+		const DDSHeaderDXT10* Extension = reinterpret_cast<const DDSHeaderDXT10*>(InData + BitOffset);
+		BitOffset += sizeof(DDSHeaderDXT10);
+
+		Format = Extension->DxgiFormat;
+		ArraySize = Extension->ArraySize;
+		if (0 == ArraySize)
+		{
+			return DDSResult::InvalidData;
+		}
+
+		switch (Extension->ResourceDimension)
+		{
+		case ResourceDimensionTexture1D:
+			if ((Header->Flags & HeaderFlagHeight) && Height != 1)
+			{
+				return DDSResult::InvalidData;
+			}
+			Height = 1;
+			Depth = 1;
+			Dimension = DDSDimension::Texture1D;
+			break;
+
+		case ResourceDimensionTexture2D:
+			if (Extension->MiscFlag & ResourceMiscTextureCube)
+			{
+				ArraySize *= 6;
+				bCubeMap = true;
+			}
+			Depth = 1;
+			Dimension = DDSDimension::Texture2D;
+			break;
+
+		case ResourceDimensionTexture3D:
+			if (0 == (Header->Flags & HeaderFlagVolume))
+			{
+				return DDSResult::InvalidData;
+			}
+			if (ArraySize > 1)
+			{
+				return DDSResult::NotSupported;
+			}
+			Dimension = DDSDimension::Texture3D;
+			break;
+
+		default:
+			return DDSResult::NotSupported;
+		}
+	}
+	else
+	{
+		Format = GetLegacyFormat(Header->PixelFormat);
+
+		if (Header->Flags & HeaderFlagVolume)
+		{
+			Dimension = DDSDimension::Texture3D;
+		}
+		else
+		{
+			if (Header->Caps2 & Caps2CubeMap)
+			{
+				// 면이 빠진 큐브맵은 D3D에서 만들 수 없다.
+				if ((Header->Caps2 & Caps2CubeMapAllFaces) != Caps2CubeMapAllFaces)
+				{
+					return DDSResult::NotSupported;
+				}
+				ArraySize = 6;
+				bCubeMap = true;
+			}
+
+			Depth = 1;
+			Dimension = DDSDimension::Texture2D;
+		}
+	}
+
+	if (0 == Width || 0 == Height || 0 == Depth)
+	{
+		return DDSResult::InvalidData;
+	}
+
+	if (0 == GetBitsPerPixel(Format) || MipCount > MaxMipLevels || ArraySize > MaxArraySize)
+	{
+		return DDSResult::NotSupported;
+	}
+
+	switch (Dimension)
+	{
+	case DDSDimension::Texture1D:
+		if (Width > MaxTexture1DSize)
+		{
+			return DDSResult::NotSupported;
+		}
+		break;
+
+	case DDSDimension::Texture2D:
+		if (Width > MaxTexture2DSize || Height > MaxTexture2DSize)
+		{
+			return DDSResult::NotSupported;
+		}
+		break;
+
+	case DDSDimension::Texture3D:
+		if (Width > MaxTexture3DSize || Height > MaxTexture3DSize || Depth > MaxTexture3DSize)
+		{
+			return DDSResult::NotSupported;
+		}
+		break;
+
+	default:
+		return DDSResult::NotSupported;
+	}
+
+	return BuildLayout(BitOffset);
+}
+
+DDSResult DDSFile::BuildLayout(size_t BitOffset)
+{
+	const uint32_t BitsPerPixel = GetBitsPerPixel(Format);
+	const bool bBlockCompressed = IsBlockCompressed(Format);
+	const bool bPacked = IsPacked(Format);
+
+	Subresources.clear();
+	Subresources.reserve((size_t)MipCount * ArraySize);
+
+	// 파일에는 배열 원소마다 밉 체인이 통째로 이어져 있다.
+	size_t Offset = BitOffset;
+	for (uint32_t Slice = 0; Slice < ArraySize; Slice++)
+	{
+		uint32_t MipWidth = Width;
+		uint32_t MipHeight = Height;
+		uint32_t MipDepth = Depth;
+
+		for (uint32_t Mip = 0; Mip < MipCount; Mip++)
+		{
+			DDSSubresource Subresource;
+			Subresource.Offset = Offset;
+			Subresource.Width = MipWidth;
+			Subresource.Height = MipHeight;
+			Subresource.Depth = MipDepth;
+
+			uint64_t RowBytes = 0;
+			if (bBlockCompressed)
+			{
+				// BitsPerPixel * 16 / 8 = 4x4 블록 하나의 바이트 수
+				RowBytes = (uint64_t)std::max<uint32_t>(1, (MipWidth + 3) / 4) * BitsPerPixel * 2;
+				Subresource.RowCount = std::max<uint32_t>(1, (MipHeight + 3) / 4);
+			}
+			else if (bPacked)
+			{
+				RowBytes = (uint64_t)((MipWidth + 1) >> 1) * 4;
+				Subresource.RowCount = MipHeight;
+			}
+			else
+			{
+				RowBytes = ((uint64_t)MipWidth * BitsPerPixel + 7) / 8;
+				Subresource.RowCount = MipHeight;
+			}
+
+			const uint64_t SliceBytes = RowBytes * Subresource.RowCount;
+			const uint64_t MipBytes = SliceBytes * MipDepth;
+			if (MipBytes > Size - Offset)
+			{
+				return DDSResult::Truncated;
+			}
+
+			Subresource.RowBytes = (uint32_t)RowBytes;
+			Subresource.SliceBytes = (uint32_t)SliceBytes;
+			Subresources.push_back(Subresource);
+
+			Offset += (size_t)MipBytes;
+
+			MipWidth = std::max<uint32_t>(MipWidth >> 1, 1);
+			MipHeight = std::max<uint32_t>(MipHeight >> 1, 1);
+			MipDepth = std::max<uint32_t>(MipDepth >> 1, 1);
+		}
+	}
+
+	return DDSResult::Ok;
+}
@@ -6,6 +6,10 @@
 #include "Framework/GameTimer.h"
 #include "Framework/Camera.h"
 #include "FbxLoader.h"
+#include "TextureStreamer.h"
+#include "TextureManager.h"
+#include "UploadManager.h"
+#include "GpuHeapAllocator.h"
 
 const int gNumFrameResources = 3;
 
@@ -43,6 +47,9 @@ bool DX12::Init(Camera* InCamera, std::vector<GameObject*> InGameObjects)
 
 	ThrowIfFailed(D3DDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&Fence)));
 
+	// OnResize가 깊이 버퍼를 힙에 넣으니 그보다 먼저
+	GpuHeapAllocator::Get()->Init(D3DDevice.Get());
+
 	RTVDescriptorSize = D3DDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 	DSVDescriptorSize = D3DDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
 	CBVSRVUAVDescriptorSize = D3DDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
@@ -81,6 +88,9 @@ bool DX12::Init(Camera* InCamera, std::vector<GameObject*> InGameObjects)
 
 	BuildFrameResources();
 
+	UploadManager::Get()->Init(D3DDevice.Get(), Fence.Get());
+	TextureStreamer::Get()->Init(D3DDevice.Get());
+
 	int InstanceOffset = 0;
 	for (GameObject* GameObject : GameObjects)
 	{
@@ -94,14 +104,41 @@ bool DX12::Init(Camera* InCamera, std::vector<GameObject*> InGameObjects)
 		}
 	}
 
+	// 같은 포맷, 같은 크기의 텍스쳐를 배열로 묶어서 서술자 수와 테이블 바꾸기를 줄인다.
+	TextureManager::Get()->Pack();
+
 	BuildDescriptorHeaps();
 
+	// 메시와 텍스쳐의 처음 업로드를 한 번에 기록한다.
+	UploadManager::Get()->Update(CommandList.Get(), Fence->GetCompletedValue(), CurrentFence + 1);
+
 	ThrowIfFailed(CommandList->Close());
 	ID3D12CommandList* CmdsLists[] = { CommandList.Get() };
 	CommandQueue->ExecuteCommandLists(_countof(CmdsLists), CmdsLists);
 
 	FlushCommandQueue();
 
+	const StagingStats& Staging = UploadManager::Get()->GetStats();
+	char Message[256];
+	sprintf_s(Message, "[UploadManager] uploaded %llu KB in %u allocations, peak staging %llu KB (ring %llu of %llu KB, %u dedicated)\n",
+		(unsigned long long)(Staging.TotalBytes / 1024), Staging.AllocationCount + Staging.DedicatedCount,
+		(unsigned long long)(Staging.PeakBytes / 1024), (unsigned long long)(Staging.PeakRingBytes / 1024),
+		(unsigned long long)(Staging.Capacity / 1024), Staging.DedicatedCount);
+	OutputDebugStringA(Message);
+
+	for (uint32_t Category = 0; Category < (uint32_t)GpuMemoryCategory::Count; Category++)
+	{
+		const GpuMemoryStats Memory = GpuHeapAllocator::Get()->GetStats((GpuMemoryCategory)Category);
+		sprintf_s(Message, "[GpuHeapAllocator] %s: %u allocations, %llu KB (peak %llu KB)\n", GpuHeapAllocator::GetCategoryName((GpuMemoryCategory)Category),
+			Memory.AllocationCount, (unsigned long long)(Memory.Bytes / 1024), (unsigned long long)(Memory.PeakBytes / 1024));
+		OutputDebugStringA(Message);
+	}
+
+	const GpuHeapStats Heaps = GpuHeapAllocator::Get()->GetHeapStats();
+	sprintf_s(Message, "[GpuHeapAllocator] %u heaps, %llu of %llu KB used, largest free block %llu KB\n", Heaps.HeapCount,
+		(unsigned long long)(Heaps.UsedBytes / 1024), (unsigned long long)(Heaps.HeapBytes / 1024), (unsigned long long)(Heaps.LargestFreeBlock / 1024));
+	OutputDebugStringA(Message);
+
 	return true;
 }
 
@@ -139,6 +176,16 @@ void DX12::Draw()
 	ThrowIfFailed(CmdListAlloc->Reset());
 	ThrowIfFailed(CommandList->Reset(CmdListAlloc.Get(), nullptr));
 
+	// 새로 올린 자원을 스트리밍이 복사해 갈 수 있으니 업로드를 먼저 기록한다.
+	UploadManager::Get()->Update(CommandList.Get(), Fence->GetCompletedValue(), CurrentFence + 1);
+
+	// 스트리밍 복사는 이번 프레임 그리기보다 먼저 기록된다.
+	TextureStreamer::Get()->Update(CommandList.Get(), Fence->GetCompletedValue(), CurrentFence + 1);
+
+	// 스트리밍이 텍스쳐를 다시 만들며 생긴 힙의 틈을 조금씩 메운다.
+	TextureManager::Get()->Defragment(CommandList.Get(), Fence->GetCompletedValue(), CurrentFence + 1);
+	UpdateTextureDescriptors();
+
 	CommandList->RSSetViewports(1, &ScreenViewport);
 	CommandList->RSSetScissorRects(1, &ScissorRect);
 
@@ -234,13 +281,9 @@ void DX12::OnResize()
 	OptClear.Format = DepthStencilFormat;
 	OptClear.DepthStencil.Depth = 1.0f;
 	OptClear.DepthStencil.Stencil = 0;
-	ThrowIfFailed(D3DDevice->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_NONE,
-		&DepthStencilDesc,
-		D3D12_RESOURCE_STATE_COMMON,
-		&OptClear,
-		IID_PPV_ARGS(DepthStencilBuffer.GetAddressOf())));
+	// 힙에 넣은 깊이 버퍼는 내용이 정해져 있지 않지만 매 프레임 처음 쓰기 전에 지운다.
+	DepthStencilBuffer = GpuHeapAllocator::Get()->CreateResource(GpuMemoryCategory::DepthStencil, DepthStencilDesc,
+		D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_STATE_COMMON, &OptClear);
 
 	D3D12_DEPTH_STENCIL_VIEW_DESC DSVDesc;
 	ZeroMemory(&DSVDesc, sizeof(DSVDesc));
@@ -474,29 +517,99 @@ void DX12::BuildFrameResources()
 void DX12::BuildDescriptorHeaps()
 {
 	D3D12_DESCRIPTOR_HEAP_DESC SRVHeapDesc = {};
-	SRVHeapDesc.NumDescriptors = (UINT)GameObjects.size();
+	// 같은 텍스쳐를 쓰는 GameObject끼리는 SRV 하나를 같이 쓴다.
+	// 루트 서명이 테이블 전체를 한 범위로 잡으니 힙도 그 크기만큼 만든다. 나중에 늘어난 텍스쳐도 여기 들어간다.
+	TextureTableSize = TextureManager::MaxSrvCount;
+
+	SRVHeapDesc.NumDescriptors = (UINT)(TextureTableSize * gNumFrameResources);
 	SRVHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
 	SRVHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
 	ThrowIfFailed(D3DDevice->CreateDescriptorHeap(&SRVHeapDesc, IID_PPV_ARGS(&SRVHeap)));
 
-	CD3DX12_CPU_DESCRIPTOR_HANDLE DescriptorHandle(SRVHeap->GetCPUDescriptorHandleForHeapStart());
+	BoundTextures.assign(TextureTableSize * gNumFrameResources, nullptr);
+	for (size_t i = 0; i < BoundTextures.size(); i++)
+	{
+		CreateNullTextureDescriptor(i);
+	}
+
+	for (int Frame = 0; Frame < gNumFrameResources; Frame++)
+	{
+		CurFrameResourceIndex = Frame;
+		UpdateTextureDescriptors();
+	}
+
+	CurFrameResourceIndex = 0;
+}
+
+void DX12::UpdateTextureDescriptors()
+{
+	// 앞 프레임이 아직 읽고 있을 수 있으니 지금 프레임 리소스의 테이블만 건드린다.
+	const size_t TableStart = CurFrameResourceIndex * TextureTableSize;
+
+	// 테이블을 만든 뒤에 늘어난 텍스쳐는 자리가 없다.
+	assert(TextureManager::Get()->GetSrvCount() <= (int)TextureTableSize);
 
 	D3D12_SHADER_RESOURCE_VIEW_DESC SRVDesc = {};
 	SRVDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	SRVDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	SRVDesc.Texture2D.MostDetailedMip = 0;
-	SRVDesc.Texture2D.ResourceMinLODClamp = 0.0f;
-
-	for (GameObject* GameObject : GameObjects)
+	// 묶이지 않은 텍스쳐도 한 장짜리 배열로 만들어서 셰이더가 한 가지 타입으로 읽는다.
+	SRVDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+	SRVDesc.Texture2DArray.MostDetailedMip = 0;
+	SRVDesc.Texture2DArray.FirstArraySlice = 0;
+	SRVDesc.Texture2DArray.PlaneSlice = 0;
+	SRVDesc.Texture2DArray.ResourceMinLODClamp = 0.0f;
+
+	for (int i = 0; i < TextureManager::Get()->GetSrvCount(); i++)
 	{
-		ID3D12Resource* Tex = GameObject->GetTexture()->Resource.Get();
-		SRVDesc.Format = Tex->GetDesc().Format;
-		SRVDesc.Texture2D.MipLevels = Tex->GetDesc().MipLevels;
+		Texture* Entry = TextureManager::Get()->GetTexture(i);
+		ID3D12Resource* Tex = Entry ? Entry->Resource.Get() : nullptr;
+		if (BoundTextures[TableStart + i] == Tex)
+		{
+			continue;
+		}
+
+		// 풀린 텍스쳐의 SRV를 남겨두면 지워진 자원을 가리키게 된다.
+		if (nullptr == Tex)
+		{
+			CreateNullTextureDescriptor(TableStart + i);
+			BoundTextures[TableStart + i] = nullptr;
+			continue;
+		}
+
+		CD3DX12_CPU_DESCRIPTOR_HANDLE DescriptorHandle(SRVHeap->GetCPUDescriptorHandleForHeapStart());
+		DescriptorHandle.Offset((INT)(TableStart + i), CBVSRVDescriptorSize);
+
+		const D3D12_RESOURCE_DESC Desc = Tex->GetDesc();
+		SRVDesc.Format = Desc.Format;
+		SRVDesc.Texture2DArray.MipLevels = Desc.MipLevels;
+		SRVDesc.Texture2DArray.ArraySize = Desc.DepthOrArraySize;
 		D3DDevice->CreateShaderResourceView(Tex, &SRVDesc, DescriptorHandle);
-		DescriptorHandle.Offset(1, CBVSRVDescriptorSize);
+
+		BoundTextures[TableStart + i] = Tex;
 	}
 }
 
+void DX12::CreateNullTextureDescriptor(size_t DescriptorIndex)
+{
+	// null SRV도 포맷과 차원은 셰이더가 선언한 것과 맞아야 한다. 읽으면 0이 나온다.
+	D3D12_SHADER_RESOURCE_VIEW_DESC SRVDesc = {};
+	SRVDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	SRVDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	SRVDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+	SRVDesc.Texture2DArray.MipLevels = 1;
+	SRVDesc.Texture2DArray.ArraySize = 1;
+
+	CD3DX12_CPU_DESCRIPTOR_HANDLE DescriptorHandle(SRVHeap->GetCPUDescriptorHandleForHeapStart());
+	DescriptorHandle.Offset((INT)DescriptorIndex, CBVSRVDescriptorSize);
+	D3DDevice->CreateShaderResourceView(nullptr, &SRVDesc, DescriptorHandle);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DX12::GetTextureTable() const
+{
+	CD3DX12_GPU_DESCRIPTOR_HANDLE Table(SRVHeap->GetGPUDescriptorHandleForHeapStart());
+	Table.Offset((INT)(CurFrameResourceIndex * TextureTableSize), CBVSRVDescriptorSize);
+	return Table;
+}
+
 ID3D12Resource* DX12::CurrentBackBuffer() const
 {
 	return SwapChainBuffer[CurBackBuffer].Get();
@@ -556,8 +669,8 @@ void DX12::DrawItems()
 			CommandList->IASetIndexBuffer(&Item->Geo->IndexBufferView());
 			CommandList->IASetPrimitiveTopology(Item->PrimitiveType);
 
-			CD3DX12_GPU_DESCRIPTOR_HANDLE Tex(SRVHeap->GetGPUDescriptorHandleForHeapStart());
-			Tex.Offset(Item->Mat->DiffuseSrvHeapIndex, CBVSRVDescriptorSize);
+			// 모든 오브젝트가 같은 테이블을 묶고 셰이더가 머티리얼의 DiffuseMapIndex로 고른다.
+			const D3D12_GPU_DESCRIPTOR_HANDLE Tex = GetTextureTable();
 
 			ID3D12Resource* InstanceBuffer = CurFrameResource->InstanceBuffer->Resource();
 			ID3D12Resource* AnimationBuffer = CurFrameResource->AnimationBuffer->Resource();
@@ -568,17 +681,25 @@ void DX12::DrawItems()
 				CommandList->SetGraphicsRootShaderResourceView(1, MatBuffer->GetGPUVirtualAddress());
 				CommandList->SetGraphicsRootShaderResourceView(2, AnimationBuffer->GetGPUVirtualAddress());
 				CommandList->SetGraphicsRootConstantBufferView(3, PassCB->GetGPUVirtualAddress());
-				CommandList->SetGraphicsRootDescriptorTable(4, SRVHeap->GetGPUDescriptorHandleForHeapStart());
+				CommandList->SetGraphicsRootDescriptorTable(4, Tex);
 			}
 			else
 			{
 				CommandList->SetGraphicsRootShaderResourceView(0, InstanceBuffer->GetGPUVirtualAddress());
 				CommandList->SetGraphicsRootShaderResourceView(1, MatBuffer->GetGPUVirtualAddress());
 				CommandList->SetGraphicsRootConstantBufferView(2, PassCB->GetGPUVirtualAddress());
-				CommandList->SetGraphicsRootDescriptorTable(3, SRVHeap->GetGPUDescriptorHandleForHeapStart());
+				CommandList->SetGraphicsRootDescriptorTable(3, Tex);
 			}
 
 			CommandList->DrawIndexedInstanced(Item->IndexCount, Item->InstanceCount + Item->InstanceOffset, Item->StartIndexLocation, Item->BaseVertexLocation, Item->InstanceOffset);
+
+			// 인스턴스 버퍼 주소를 옮겨서 SV_InstanceID 0이 해당 인스턴스를 가리키게 한다.
+			for (const ClusterDrawRange& Range : Item->ClusterDraws)
+			{
+				D3D12_GPU_VIRTUAL_ADDRESS InstanceAddress = InstanceBuffer->GetGPUVirtualAddress() + (UINT64)Range.InstanceIndex * sizeof(InstanceData);
+				CommandList->SetGraphicsRootShaderResourceView(0, InstanceAddress);
+				CommandList->DrawIndexedInstanced(Range.IndexCount, 1, Range.StartIndexLocation, Item->BaseVertexLocation, 0);
+			}
 		}
 	}
 }
@@ -664,10 +785,6 @@ void DX12::UpdateMainPassConstantBuffer()
 	MainPassCB.FarZ = 1000.0f;
 	MainPassCB.TotalTime = GameTimer::Get()->TotalTime();
 	MainPassCB.DeltaTime = GameTimer::Get()->DeltaTime();
-	// FIXME: 이 하드코딩은 뭘까..
-	MainPassCB.Frame = float(WindowManager::Get()->GetElapsedFrame() / 6 % 13);
-	// FIXME: 이 하드코딩은 또 뭘까..
-	MainPassCB.BoneCount = float(FbxLoader::Get()->GetBoneCount("Dummy"));
 	MainPassCB.AmbientLight = { 0.25f, 0.25f, 0.35f, 1.0f };
 	MainPassCB.Lights[0].Direction = { 0.57735f, -0.57735f, 0.57735f };
 	MainPassCB.Lights[0].Strength = { 0.8f, 0.8f, 0.8f };
@@ -0,0 +1,52 @@
+#include "DualQuaternion.h"
+
+void DualQuaternion::FromMatrix(FXMMATRIX Matrix, XMVECTOR& OutReal, XMVECTOR& OutDual)
+{
+	XMVECTOR Scale;
+	XMVECTOR Rotation;
+	XMVECTOR Translation;
+	XMMatrixDecompose(&Scale, &Rotation, &Translation, Matrix);
+
+	// Dual = 0.5 * t * r. XMQuaternionMultiply(A, B)는 B * A 순서다.
+	OutReal = Rotation;
+	OutDual = XMVectorScale(XMQuaternionMultiply(Rotation, XMVectorAndInt(Translation, g_XMMask3)), 0.5f);
+}
+
+void DualQuaternion::Blend(const XMVECTOR* Reals, const XMVECTOR* Duals, const float* Weights, uint32_t Count, XMVECTOR& OutReal, XMVECTOR& OutDual)
+{
+	XMVECTOR Real = XMVectorZero();
+	XMVECTOR Dual = XMVectorZero();
+
+	for (uint32_t i = 0; i < Count; i++)
+	{
+		XMVECTOR Weight = XMVectorReplicate(Weights[i]);
+		if (i > 0 && XMVectorGetX(XMVector4Dot(Reals[0], Reals[i])) < 0.0f)
+		{
+			Weight = XMVectorNegate(Weight);
+		}
+
+		Real = XMVectorMultiplyAdd(Reals[i], Weight, Real);
+		Dual = XMVectorMultiplyAdd(Duals[i], Weight, Dual);
+	}
+
+	XMVECTOR InvLength = XMVectorReciprocal(XMVector4Length(Real));
+	OutReal = XMVectorMultiply(Real, InvLength);
+	OutDual = XMVectorMultiply(Dual, InvLength);
+}
+
+XMVECTOR DualQuaternion::TransformPoint(FXMVECTOR Real, FXMVECTOR Dual, FXMVECTOR Point)
+{
+	// t = 2 * (r.w * d.xyz - d.w * r.xyz + cross(r.xyz, d.xyz))
+	XMVECTOR RealW = XMVectorSplatW(Real);
+	XMVECTOR DualW = XMVectorSplatW(Dual);
+	XMVECTOR Translation = XMVectorSubtract(XMVectorMultiply(RealW, Dual), XMVectorMultiply(DualW, Real));
+	Translation = XMVectorAdd(Translation, XMVector3Cross(Real, Dual));
+	Translation = XMVectorScale(Translation, 2.0f);
+
+	return XMVectorAdd(XMVector3Rotate(Point, Real), Translation);
+}
+
+XMVECTOR DualQuaternion::TransformNormal(FXMVECTOR Real, FXMVECTOR Normal)
+{
+	return XMVector3Rotate(Normal, Real);
+}
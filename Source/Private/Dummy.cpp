@@ -1,6 +1,10 @@
 #include "Dummy.h"
 #include "FbxLoader.h"
 #include "Framework/MathHelper.h"
+#include "Framework/GameTimer.h"
+#include "Framework/Camera.h"
+#include "TextureManager.h"
+#include "UploadManager.h"
 
 Dummy::Dummy(Camera* InCamera)
 	:
@@ -16,7 +20,7 @@ Dummy::~Dummy()
 void Dummy::BuildRootSignature(ID3D12Device* Device)
 {
 	CD3DX12_DESCRIPTOR_RANGE TexTable;
-	TexTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 7, 0, 0);
+	TexTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, TextureManager::MaxSrvCount, 0, 0);
 
 	CD3DX12_ROOT_PARAMETER SlotRootParameter[5];
 
@@ -55,37 +59,19 @@ void Dummy::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList* Com
 	std::vector<Texture*> Textures = FbxLoader::Get()->GetTextures("Dummy");
 
 	// FIXME: 텍스쳐 여러개 받자
-	Tex = std::make_unique<Texture>(*Textures[0]);
-
-	ThrowIfFailed(CreateDDSTextureFromFile12(Device, CommandList, Tex->Filename.c_str(), Tex->Resource, Tex->UploadHeap));
+	Tex = TextureManager::Get()->Acquire(CommandList, Textures[0]->Filename, Textures[0]->Name);
 
 	std::vector<Material*> Materials = FbxLoader::Get()->GetMaterials("Dummy");
 
 	// FIXME: 머티리얼 여러개 받을 수 있게 해야하지 않나?
 	Mat = std::make_unique<Material>(*Materials[0]);
+	Mat->DiffuseSrvHeapIndex = Tex.GetSrvIndex();
 
-	XMFLOAT3 Minf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
-	XMFLOAT3 Maxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
-
-	XMVECTOR Min = XMLoadFloat3(&Minf3);
-	XMVECTOR Max = XMLoadFloat3(&Maxf3);
-
-	const std::vector<Vertex>& Vertices = FbxLoader::Get()->GetVertices("Dummy");
+	ArrayView<Vertex> Vertices = FbxLoader::Get()->GetVertices("Dummy");
 	const UINT VBByteSize = (UINT)Vertices.size() * sizeof(Vertex);
 
-	const std::vector<uint16_t>& Indices = FbxLoader::Get()->GetIndices("Dummy");
-	const UINT IBByteSize = (UINT)Indices.size() * sizeof(uint16_t);
-
-	for (size_t i = 0; i < Vertices.size(); ++i)
-	{
-		const XMFLOAT3& P = Vertices[i].Pos;
-		Min = XMVectorMin(Min, XMLoadFloat3(&P));
-		Max = XMVectorMax(Max, XMLoadFloat3(&P));
-	}
-
-	BoundingBox Bounds;
-	XMStoreFloat3(&Bounds.Center, 0.5f * (Min + Max));
-	XMStoreFloat3(&Bounds.Extents, 0.5f * (Max - Min));
+	ArrayView<uint32_t> Indices = FbxLoader::Get()->GetIndices("Dummy");
+	const UINT IBByteSize = (UINT)Indices.size() * sizeof(uint32_t);
 
 	std::unique_ptr<MeshGeometry> Geo = std::make_unique<MeshGeometry>();
 	Geo->Name = "DummyGeo";
@@ -96,21 +82,19 @@ void Dummy::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList* Com
 	ThrowIfFailed(D3DCreateBlob(IBByteSize, &Geo->IndexBufferCPU));
 	CopyMemory(Geo->IndexBufferCPU->GetBufferPointer(), Indices.data(), IBByteSize);
 
-	Geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(Device, CommandList, Vertices.data(), VBByteSize, Geo->VertexBufferUploader);
-	Geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(Device, CommandList, Indices.data(), IBByteSize, Geo->IndexBufferUploader);
+	Geo->VertexBufferGPU = UploadManager::Get()->CreateBuffer(GpuMemoryCategory::VertexBuffer, Vertices.data(), VBByteSize);
+	Geo->IndexBufferGPU = UploadManager::Get()->CreateBuffer(GpuMemoryCategory::IndexBuffer, Indices.data(), IBByteSize);
 
 	Geo->VertexByteStride = sizeof(Vertex);
 	Geo->VertexBufferByteSize = VBByteSize;
-	Geo->IndexFormat = DXGI_FORMAT_R16_UINT;
+	Geo->IndexFormat = DXGI_FORMAT_R32_UINT;
 	Geo->IndexBufferByteSize = IBByteSize;
 
-	SubmeshGeometry Submesh;
-	Submesh.IndexCount = (UINT)Indices.size();
-	Submesh.StartIndexLocation = 0;
-	Submesh.BaseVertexLocation = 0;
-	Submesh.Bounds = Bounds;
-
-	Geo->DrawArgs["Dummy"] = Submesh;
+	// 바운드는 쿠킹할 때 미리 계산해뒀다. "Dummy"가 전체 메쉬고 나머지는 노드별 서브메쉬.
+	for (const CookedSubmesh& Submesh : FbxLoader::Get()->GetSubmeshes("Dummy"))
+	{
+		Geo->DrawArgs[Submesh.Name] = Submesh.Geometry;
+	}
 
 	Geometry = std::move(Geo);
 
@@ -120,8 +104,22 @@ void Dummy::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList* Com
 
 void Dummy::BuildShadersAndInputLayout()
 {
-	VSByteCode = d3dUtil::CompileShader(L"Source/Shader/Dummy.hlsl", nullptr, "VSMain", "vs_5_1");
-	PSByteCode = d3dUtil::CompileShader(L"Source/Shader/Dummy.hlsl", nullptr, "PSMain", "ps_5_1");
+	// 정점마다 실제로 쓰는 뼈 수에 맞춰 셰이더 루프를 줄인다.
+	const uint32_t InfluenceCount = FbxLoader::Get()->GetMaxInfluenceCount("Dummy");
+	const char* MaxInfluences = InfluenceCount <= 1 ? "1" : (InfluenceCount <= 2 ? "2" : "4");
+
+	const D3D_SHADER_MACRO Defines[] =
+	{
+		"MAX_BONE_INFLUENCES", MaxInfluences,
+		"MAX_SRV_COUNT", TextureManager::GetMaxSrvCountDefine(),
+#if SKINNING_DUAL_QUATERNION
+		"SKINNING_DUAL_QUATERNION", "1",
+#endif
+		nullptr, nullptr
+	};
+
+	VSByteCode = d3dUtil::CompileShader(L"Source/Shader/Dummy.hlsl", Defines, "VSMain", "vs_5_1");
+	PSByteCode = d3dUtil::CompileShader(L"Source/Shader/Dummy.hlsl", Defines, "PSMain", "ps_5_1");
 
 	InputLayout =
 	{
@@ -129,7 +127,7 @@ void Dummy::BuildShadersAndInputLayout()
 		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "BONEWEIGHTS", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-		{ "BONEINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+		{ "BONEINDICES", 0, DXGI_FORMAT_R16G16B16A16_UINT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
 }
 
@@ -159,9 +157,9 @@ void Dummy::BuildRenderItem(int& InstanceOffset, std::vector<std::unique_ptr<Fra
 	float Dx = Width / (N - 1);
 	float Dz = Depth / (N - 1);
 
-	const std::vector<XMMATRIX>& BoneOffsets = FbxLoader::Get()->GetBoneOffsets("Dummy");
-	const std::vector<XMMATRIX>& ToRootTransforms = FbxLoader::Get()->GetToRootTransforms("Dummy");
-	RItem->Animations.resize(ToRootTransforms.size());
+	InstanceAnimator.Init(FbxLoader::Get()->GetSkeleton("Dummy"));
+	AnimationClip Clip = FbxLoader::Get()->GetAnimationClip("Dummy");
+	const uint32_t ClipIndex = InstanceAnimator.AddClip(Clip);
 
 	for (int i = 0; i < N; i++)
 	{
@@ -177,13 +175,14 @@ void Dummy::BuildRenderItem(int& InstanceOffset, std::vector<std::unique_ptr<Fra
 
 			XMStoreFloat4x4(&RItem->Instances[Index].TexTransform, XMMatrixScaling(1.0f, 1.0f, 1.0f));
 			RItem->Instances[Index].MaterialIndex = 0;
-		}
-	}
 
-	for (int i = 0; i < ToRootTransforms.size(); i++)
-	{
-		XMMATRIX FinalTransform = XMMatrixMultiply(BoneOffsets[i % BoneOffsets.size()], ToRootTransforms[i]);
-		XMStoreFloat4x4(&RItem->Animations[i].FinalTransform, FinalTransform);
+			// 전부 같은 동작을 하면 어색하니 시작 위치와 속도를 조금씩 흩뜨린다.
+			AnimationState State;
+			State.ClipIndex = ClipIndex;
+			State.Time = MathHelper::RandF(0.0f, Clip.GetDuration());
+			State.PlayRate = MathHelper::RandF(0.8f, 1.2f);
+			InstanceAnimator.AddInstance(State);
+		}
 	}
 
 	RenderItemLayer[(int)RenderLayer::Opaque] = RItem.get();
@@ -196,6 +195,60 @@ void Dummy::BuildRenderItem(int& InstanceOffset, std::vector<std::unique_ptr<Fra
 	GameObject::BuildRenderItem(InstanceOffset, FrameResources);
 }
 
+void Dummy::SkinInstance(int Instance, SkinnedVertexStream& Out)
+{
+	CpuPalette.resize(InstanceAnimator.GetBoneCount());
+	InstanceAnimator.ComputeInstancePalette(Instance, CpuPalette.data());
+
+	CpuSkinning::Skin(FbxLoader::Get()->GetVertices("Dummy"), CpuPalette.data(), InstanceAnimator.GetBoneCount(), Out);
+}
+
+void Dummy::UpdateAnimation(FrameResource* CurFrameResource)
+{
+	// 바운드 구의 지름이 화면 높이에서 차지하는 비율로 LOD를 고른다.
+	const XMFLOAT4X4 Proj = MainCamera->GetProj4x4f();
+	const XMVECTOR EyePos = MainCamera->GetPosition();
+	const float Radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&Item->Bounds.Extents)));
+
+	ScreenSizes.resize(VisibleInstances.size());
+	for (size_t i = 0; i < VisibleInstances.size(); i++)
+	{
+		XMMATRIX World = XMLoadFloat4x4(&Item->Instances[VisibleInstances[i]].World);
+		XMVECTOR Center = XMVector3TransformCoord(XMLoadFloat3(&Item->Bounds.Center), World);
+
+		float Scale = XMVectorGetX(XMVector3Length(World.r[0]));
+		Scale = MathHelper::Max(Scale, XMVectorGetX(XMVector3Length(World.r[1])));
+		Scale = MathHelper::Max(Scale, XMVectorGetX(XMVector3Length(World.r[2])));
+
+		float Distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(Center, EyePos)));
+		Distance = MathHelper::Max(Distance, MainCamera->GetNearZ());
+
+		ScreenSizes[i] = Radius * Scale * Proj._22 / Distance;
+	}
+
+	InstanceAnimator.Advance(GameTimer::Get()->DeltaTime());
+	// 애니메이션 버퍼는 Dummy 혼자 쓰니까 처음부터 끝까지 다 쓴다.
+	InstanceAnimator.UpdatePalettes(VisibleInstances, ScreenSizes, CurFrameResource->AnimationBuffer.get(), 0, CurFrameResource->AnimationCapacity, PaletteOffsets);
+}
+
+void Dummy::AppendStats(std::wostringstream& Stats) const
+{
+	const AnimationStats& AnimStats = InstanceAnimator.GetStats();
+
+	Stats << L"    " << L"고유 포즈: " << AnimStats.UniquePoseCount << L"/" << AnimStats.PosedInstanceCount;
+	Stats << L"    " << L"애니 LOD: ";
+	for (uint32_t Lod = 0; Lod < AnimationLodSettings::LodCount; Lod++)
+	{
+		Stats << (Lod > 0 ? L"/" : L"") << AnimStats.LodInstanceCounts[Lod];
+	}
+	Stats << L"    " << L"계산: " << AnimStats.ComputedPoseCount << L"    " << L"건너뜀: " << AnimStats.HeldInstanceCount;
+	if (AnimStats.OverflowInstanceCount > 0)
+	{
+		Stats << L"    " << L"팔레트 부족: " << AnimStats.OverflowInstanceCount;
+	}
+	Stats << L"    " << L"팔레트: " << AnimStats.PaletteMs << L"ms (절약 " << AnimStats.SavedMs << L"ms), " << AnimStats.UploadBytes / 1024 << L"KB";
+}
+
 std::array<const CD3DX12_STATIC_SAMPLER_DESC, 6> Dummy::GetStaticSamplers()
 {
 	const CD3DX12_STATIC_SAMPLER_DESC PointWrap(
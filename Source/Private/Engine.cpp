@@ -2,6 +2,11 @@
 #include "Framework/GameTimer.h"
 #include "Framework/Camera.h"
 #include "FbxLoader.h"
+#include "GpuHeapAllocator.h"
+#include "UploadManager.h"
+#include "TextureStreamer.h"
+#include "TextureManager.h"
+#include "JobSystem.h"
 #include "Window.h"
 #include "DX12.h"
 #include "Landscape.h"
@@ -21,6 +26,9 @@ Engine::Engine()
 Engine::~Engine()
 {
 	Graphics->FlushCommandQueue();
+
+	// GameObject가 든 텍스쳐 핸들은 TextureManager보다 먼저 풀려야 한다.
+	GameObjects.clear();
 }
 
 Engine* Engine::GetEngine()
@@ -143,6 +151,7 @@ LRESULT Engine::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 bool Engine::Init()
 {
 	InitTimer();
+	InitJobSystem();
 	InitLoader();
 	InitCamera();
 
@@ -216,10 +225,22 @@ void Engine::InitTimer()
 	Timer->Init();
 }
 
+void Engine::InitJobSystem()
+{
+	Jobs = std::make_unique<JobSystem>();
+	Jobs->Init();
+}
+
 void Engine::InitLoader()
 {
 	Loader = std::make_unique<FbxLoader>();
 	Loader->Init();
+
+	// 디바이스가 생긴 뒤에 DX12에서 Init한다.
+	GpuHeaps = std::make_unique<GpuHeapAllocator>();
+	Uploader = std::make_unique<UploadManager>();
+	Streamer = std::make_unique<TextureStreamer>();
+	TextureMgr = std::make_unique<TextureManager>();
 }
 
 void Engine::InitCamera()
@@ -1,7 +1,148 @@
 #include "FbxLoader.h"
 #include <cassert>
 #include <queue>
+#include <algorithm>
+#include <chrono>
 #include "Framework/MathHelper.h"
+#include "VertexWelder.h"
+#include "MappedFile.h"
+#include "JobSystem.h"
+#include "FbxLayerElementReader.h"
+
+// 1로 바꾸면 압축 클립 샘플링과 구운 행렬 복사의 포즈당 시간을 비교해서 출력한다.
+#define FBXLOADER_CLIP_BENCHMARK 0
+
+namespace
+{
+	// 워커가 씬을 하나 더 읽는 비용이 있으니 이보다 잘게는 나누지 않는다.
+	const size_t MinBakeFramesPerThread = 32;
+
+	// 남는 슬롯은 0번 뼈에 무게 0으로 채운다. 셰이더는 인덱스를 그대로 읽으니 범위 밖 값을 넣으면 안 된다.
+	void SetBoneInfluences(Vertex& Target, const BoneInfluence* Influences, uint32_t Count)
+	{
+		float Weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (uint32_t k = 0; k < 4; k++)
+		{
+			Target.BoneIndices[k] = k < Count ? Influences[k].Bone : 0;
+			Weights[k] = k < Count ? Influences[k].Weight : 0.0f;
+		}
+
+		Target.BoneWeights = XMFLOAT4(Weights[0], Weights[1], Weights[2], Weights[3]);
+	}
+
+	XMMATRIX ToXMMatrix(const FbxAMatrix& Matrix)
+	{
+		XMFLOAT4X4 Result;
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				Result.m[i][j] = (float)Matrix.Get(i, j);
+			}
+		}
+		return XMLoadFloat4x4(&Result);
+	}
+
+	BoneTransform ToBoneTransform(const FbxAMatrix& Matrix)
+	{
+		XMFLOAT4 Translation = MathHelper::Fbx4ToXM4(Matrix.GetT());
+		XMFLOAT4 Scale = MathHelper::Fbx4ToXM4(Matrix.GetS());
+
+		BoneTransform Result;
+		Result.Rotation = MathHelper::QuatToXM4(Matrix.GetQ());
+		Result.Translation = XMFLOAT3(Translation.x, Translation.y, Translation.z);
+		Result.Scale = XMFLOAT3(Scale.x, Scale.y, Scale.z);
+		return Result;
+	}
+
+	FbxSkin* GetSkin(FbxMesh* Mesh)
+	{
+		return reinterpret_cast<FbxSkin*>(Mesh->GetDeformer(0, FbxDeformer::eSkin));
+	}
+
+	void CollectNodes(FbxNode* Node, std::vector<FbxNode*>& OutNodes)
+	{
+		OutNodes.push_back(Node);
+		for (int i = 0; i < Node->GetChildCount(); i++)
+		{
+			CollectNodes(Node->GetChild(i), OutNodes);
+		}
+	}
+
+#if FBXLOADER_CLIP_BENCHMARK
+	void BenchmarkClipSampling(const AnimationClip& Clip, const std::vector<BoneTransform>& Poses)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		const uint32_t BoneCount = Clip.GetBoneCount();
+		const uint32_t FrameCount = Clip.GetFrameCount();
+		const int Repeat = 100;
+
+		std::vector<XMMATRIX> Baked(Poses.size());
+		for (size_t i = 0; i < Poses.size(); i++)
+		{
+			Baked[i] = Poses[i].ToMatrix();
+		}
+
+		std::vector<BoneTransform> Pose(BoneCount);
+		std::vector<XMMATRIX> Palette(BoneCount);
+
+		Clock::time_point ClipStart = Clock::now();
+		for (int r = 0; r < Repeat; r++)
+		{
+			for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+			{
+				Clip.Sample(Frame + 0.5f, Pose.data());
+				for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+				{
+					Palette[Bone] = Pose[Bone].ToMatrix();
+				}
+			}
+		}
+		double ClipUs = std::chrono::duration<double, std::micro>(Clock::now() - ClipStart).count() / (Repeat * FrameCount);
+
+		// 뼈 하나씩 푸는 기준 구현과 속도, 결과 차이를 같이 본다.
+		std::vector<BoneTransform> ScalarPose(BoneCount);
+		float MaxDifference = 0.0f;
+
+		Clock::time_point ScalarStart = Clock::now();
+		for (int r = 0; r < Repeat; r++)
+		{
+			for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+			{
+				Clip.SampleScalar(Frame + 0.5f, ScalarPose.data());
+			}
+		}
+		double ScalarUs = std::chrono::duration<double, std::micro>(Clock::now() - ScalarStart).count() / (Repeat * FrameCount);
+
+		for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+		{
+			Clip.Sample(Frame + 0.5f, Pose.data());
+			Clip.SampleScalar(Frame + 0.5f, ScalarPose.data());
+			for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+			{
+				XMVECTOR Difference = XMVectorSubtract(XMLoadFloat4(&Pose[Bone].Rotation), XMLoadFloat4(&ScalarPose[Bone].Rotation));
+				MaxDifference = std::max(MaxDifference, XMVectorGetX(XMVector4Length(Difference)));
+			}
+		}
+
+		Clock::time_point BakedStart = Clock::now();
+		for (int r = 0; r < Repeat; r++)
+		{
+			for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+			{
+				memcpy(Palette.data(), &Baked[(size_t)Frame * BoneCount], BoneCount * sizeof(XMMATRIX));
+			}
+		}
+		double BakedUs = std::chrono::duration<double, std::micro>(Clock::now() - BakedStart).count() / (Repeat * FrameCount);
+
+		std::ostringstream Stream;
+		Stream << "[FbxLoader] Clip sampling: " << ClipUs << " us/pose, scalar sampling: " << ScalarUs << " us/pose (max rotation difference "
+			<< MaxDifference << "), baked copy: " << BakedUs << " us/pose (" << BoneCount << " bones)\n";
+		OutputDebugStringA(Stream.str().c_str());
+	}
+#endif
+}
 
 FbxLoader* FbxLoader::Loader = nullptr;
 
@@ -30,17 +171,64 @@ void FbxLoader::Init()
 
 bool FbxLoader::Load(const char* FilePath, const std::string& Name)
 {
-	Importer = FbxImporter::Create(Manager, "");
+	using Clock = std::chrono::high_resolution_clock;
+	Clock::time_point Start = Clock::now();
 
-	if (false == Importer->Initialize(FilePath, -1, Manager->GetIOSettings()))
+	MappedFile Source;
+	if (false == Source.Open(FilePath))
 	{
 		return false;
 	}
 
+	const uint64_t CacheKey = GetCacheKey(CookedMesh::HashBytes(Source.GetData(), Source.GetSize()));
+	Source.Close();
+
 	Textures[Name].clear();
 	Materials[Name].clear();
+	CookedMeshes.erase(Name);
+
+	bool bCacheHit = false;
+
+	std::unique_ptr<CookedMesh> Cooked = CookedMesh::Open(GetCookedPath(Name), CacheKey);
+	if (Cooked)
+	{
+		LoadCooked(Name, std::move(Cooked));
+		bCacheHit = true;
+	}
+	else
+	{
+		if (false == Import(FilePath, Name))
+		{
+			return false;
+		}
+
+		Cook(Name, CacheKey);
+	}
+
+	double Milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+
+	char Message[256];
+	sprintf_s(Message, "[FbxLoader] %s: %s %.2fms\n", Name.c_str(), bCacheHit ? "cooked" : "imported", Milliseconds);
+	OutputDebugStringA(Message);
+
+	return CookedMeshes.find(Name) != CookedMeshes.end();
+}
+
+bool FbxLoader::Import(const char* FilePath, const std::string& Name)
+{
+	Importer = FbxImporter::Create(Manager, "");
+
+	if (false == Importer->Initialize(FilePath, -1, Manager->GetIOSettings()))
+	{
+		return false;
+	}
+
 	Vertices[Name].clear();
 	Indices[Name].clear();
+	Submeshes[Name].clear();
+	Meshlets[Name].clear();
+	Skeletons.erase(Name);
+	AnimationClips.erase(Name);
 
 	FbxScene* Scene = FbxScene::Create(Manager, "My Scene");
 	Importer->Import(Scene);
@@ -53,10 +241,154 @@ bool FbxLoader::Load(const char* FilePath, const std::string& Name)
 
 	LoadTexture(FilePath, Scene, Name);
 	LoadMaterial(Scene, Name);
-	FbxMesh* Mesh = LoadMesh(Scene, Name);
-	LoadAnimation(Scene, Name, Mesh);
 
-	return true;
+	std::vector<MeshPart> Parts;
+	CollectMeshes(Scene->GetRootNode(), Parts);
+	if (Parts.empty())
+	{
+		return false;
+	}
+
+	// 스켈레톤이 생기면 합친 메쉬 전체를 스키닝으로 그리니까 스킨이 없는 메쉬도 뼈에 붙여야 한다.
+	std::vector<FbxNode*> BoneNodes;
+	FbxNode* SkeletonNode = LoadSkeleton(Scene, Name, Parts, BoneNodes);
+
+	LoadMesh(Parts);
+
+	if (SkeletonNode)
+	{
+		for (MeshPart& Part : Parts)
+		{
+			LoadSkin(Name, Part);
+		}
+
+		LoadAnimation(FilePath, Scene, Name, SkeletonNode, BoneNodes);
+	}
+
+	return MergeMeshParts(Name, Parts);
+}
+
+void FbxLoader::Cook(const std::string& Name, uint64_t CacheKey)
+{
+	std::vector<CookedTexture> CookedTextures;
+	for (const std::unique_ptr<Texture>& Tex : Textures[Name])
+	{
+		CookedTexture Cooked;
+		strncpy_s(Cooked.Name, Tex->Name.c_str(), _TRUNCATE);
+		strncpy_s(Cooked.Filename, std::string(Tex->Filename.begin(), Tex->Filename.end()).c_str(), _TRUNCATE);
+		Cooked.Index = Tex->Index;
+		CookedTextures.push_back(Cooked);
+	}
+
+	std::vector<CookedMaterial> CookedMaterials;
+	for (const std::unique_ptr<Material>& Mat : Materials[Name])
+	{
+		CookedMaterial Cooked;
+		strncpy_s(Cooked.Name, Mat->Name.c_str(), _TRUNCATE);
+		Cooked.MatCBIndex = Mat->MatCBIndex;
+		Cooked.DiffuseSrvHeapIndex = Mat->DiffuseSrvHeapIndex;
+		Cooked.DiffuseAlbedo = Mat->DiffuseAlbedo;
+		Cooked.FresnelR0 = Mat->FresnelR0;
+		Cooked.Roughness = Mat->Roughness;
+		CookedMaterials.push_back(Cooked);
+	}
+
+	MeshCacheWriter Writer;
+	Writer.AddSection(MeshCacheSection::Vertices, ArrayView<Vertex>(Vertices[Name]));
+	Writer.AddSection(MeshCacheSection::Indices, ArrayView<uint32_t>(Indices[Name]));
+	Writer.AddSection(MeshCacheSection::Submeshes, ArrayView<CookedSubmesh>(Submeshes[Name]));
+	Writer.AddSection(MeshCacheSection::Meshlets, ArrayView<Meshlet>(Meshlets[Name]));
+	Writer.AddSection(MeshCacheSection::Materials, ArrayView<CookedMaterial>(CookedMaterials));
+	Writer.AddSection(MeshCacheSection::Textures, ArrayView<CookedTexture>(CookedTextures));
+
+	auto Skel = Skeletons.find(Name);
+	if (Skel != Skeletons.end())
+	{
+		const SkeletonData& SkelData = Skel->second;
+		Writer.AddSection(MeshCacheSection::BoneOffsets, ArrayView<XMMATRIX>(SkelData.InverseBindPose));
+		Writer.AddSection(MeshCacheSection::SkeletonParents, ArrayView<int32_t>(SkelData.ParentIndices));
+		Writer.AddSection(MeshCacheSection::SkeletonBindPose, ArrayView<BoneTransform>(SkelData.BindPose));
+	}
+
+	auto Clip = AnimationClips.find(Name);
+	if (Clip != AnimationClips.end())
+	{
+		const AnimationClipData& ClipData = Clip->second;
+		Writer.AddSection(MeshCacheSection::AnimationInfo, ArrayView<AnimationClipInfo>(&ClipData.Info, 1));
+		Writer.AddSection(MeshCacheSection::AnimationTracks, ArrayView<AnimationTrack>(ClipData.Tracks));
+		Writer.AddSection(MeshCacheSection::AnimationRotations, ArrayView<RotationKey>(ClipData.Rotations));
+		Writer.AddSection(MeshCacheSection::AnimationTranslations, ArrayView<VectorKey>(ClipData.Translations));
+		Writer.AddSection(MeshCacheSection::AnimationScales, ArrayView<VectorKey>(ClipData.Scales));
+	}
+
+	std::vector<uint8_t> Bytes = Writer.Finish(CacheKey);
+
+	// 캐시를 못 써도 이번 실행은 메모리에 있는 바이트로 그대로 진행한다.
+	if (false == CookedMesh::Write(GetCookedPath(Name), Bytes))
+	{
+		OutputDebugStringA(("[FbxLoader] Failed to write " + GetCookedPath(Name) + "\n").c_str());
+	}
+
+	CookedMeshes[Name] = CookedMesh::FromMemory(std::move(Bytes));
+
+	Vertices.erase(Name);
+	Indices.erase(Name);
+	Submeshes.erase(Name);
+	Meshlets.erase(Name);
+	Skeletons.erase(Name);
+	AnimationClips.erase(Name);
+}
+
+void FbxLoader::LoadCooked(const std::string& Name, std::unique_ptr<CookedMesh> Cooked)
+{
+	for (const CookedTexture& CookedTex : Cooked->GetSection<CookedTexture>(MeshCacheSection::Textures))
+	{
+		std::unique_ptr<Texture> Tex = std::make_unique<Texture>();
+		Tex->Name = CookedTex.Name;
+		std::string Filename(CookedTex.Filename);
+		Tex->Filename.assign(Filename.begin(), Filename.end());
+		Tex->Index = CookedTex.Index;
+		Textures[Name].push_back(std::move(Tex));
+	}
+
+	for (const CookedMaterial& CookedMat : Cooked->GetSection<CookedMaterial>(MeshCacheSection::Materials))
+	{
+		std::unique_ptr<Material> Mat = std::make_unique<Material>();
+		Mat->Name = CookedMat.Name;
+		Mat->MatCBIndex = CookedMat.MatCBIndex;
+		Mat->DiffuseSrvHeapIndex = CookedMat.DiffuseSrvHeapIndex;
+		Mat->DiffuseAlbedo = CookedMat.DiffuseAlbedo;
+		Mat->FresnelR0 = CookedMat.FresnelR0;
+		Mat->Roughness = CookedMat.Roughness;
+		Materials[Name].push_back(std::move(Mat));
+	}
+
+	CookedMeshes[Name] = std::move(Cooked);
+}
+
+std::string FbxLoader::GetCookedPath(const std::string& Name) const
+{
+	return "Models/Cooked/" + Name + ".mesh";
+}
+
+uint64_t FbxLoader::GetCacheKey(uint64_t SourceHash) const
+{
+	// 쿠킹 결과를 바꾸는 설정은 전부 넣는다. 하나라도 바뀌면 캐시를 버리고 다시 Import한다.
+	const float Settings[] =
+	{
+		WeldEpsilon,
+		CompressionSettings.RotationTolerance,
+		CompressionSettings.TranslationTolerance,
+		CompressionSettings.ScaleTolerance,
+		SkinSettings.MinWeight,
+	};
+
+	uint8_t Bytes[sizeof(SourceHash) + sizeof(Settings) + sizeof(SkinSettings.MaxInfluences)];
+	memcpy(Bytes, &SourceHash, sizeof(SourceHash));
+	memcpy(Bytes + sizeof(SourceHash), Settings, sizeof(Settings));
+	memcpy(Bytes + sizeof(SourceHash) + sizeof(Settings), &SkinSettings.MaxInfluences, sizeof(SkinSettings.MaxInfluences));
+
+	return CookedMesh::HashBytes(Bytes, sizeof(Bytes));
 }
 
 void FbxLoader::LoadTexture(const char* FilePath, FbxScene* Scene, const std::string& Name)
@@ -123,107 +455,535 @@ void FbxLoader::LoadMaterial(FbxScene* Scene, const std::string& Name)
 	}
 }
 
-FbxMesh* FbxLoader::LoadMesh(FbxScene* Scene, const std::string& Name)
+void FbxLoader::LoadMesh(std::vector<MeshPart>& Parts)
+{
+	// 메쉬마다 따로 처리하고, 메쉬 하나 안에서는 SDK 객체를 공유하지 않는다.
+	JobSystem::Get()->ParallelFor(Parts.size(), 1, [this, &Parts](size_t Begin, size_t End, uint32_t ThreadIndex)
+	{
+		for (size_t i = Begin; i < End; i++)
+		{
+			MeshPart& Part = Parts[i];
+			ProcessPolygon(Part);
+			MeshletBuilder::Build(Part.Vertices, Part.Indices, Part.Meshlets);
+		}
+	});
+}
+
+FbxNode* FbxLoader::LoadSkeleton(FbxScene* Scene, const std::string& Name, std::vector<MeshPart>& Parts, std::vector<FbxNode*>& OutBoneNodes)
 {
-	FbxNode* RootNode = Scene->GetRootNode();
-	FbxMesh* Mesh = nullptr;
-	if (false == FindMesh(RootNode, Mesh))
+	for (MeshPart& Part : Parts)
+	{
+		Part.bSkinned = Part.bSkinned && GetSkin(Part.Mesh)->GetClusterCount() > 0;
+	}
+
+	// 애니메이션이 없으면 팔레트를 못 만드니 스킨도 정적 메쉬로 그린다.
+	if (nullptr == Scene->GetSrcObject<FbxAnimStack>(0))
+	{
+		for (MeshPart& Part : Parts)
+		{
+			Part.bSkinned = false;
+		}
+		return nullptr;
+	}
+
+	// 여러 스킨이 같은 노드를 쓰면 같은 뼈다. 바인드 트랜스폼은 그 노드를 처음 쓴 클러스터에서 가져온다.
+	std::vector<FbxNode*> Nodes;
+	std::vector<FbxAMatrix> LinkBinds;
+	std::unordered_map<FbxNode*, int> NodeToIndex;
+
+	// 처음 나온 스킨이 바인드될 때의 메쉬 공간을 스켈레톤 공간으로 삼고, 애니메이션도 그 메쉬 노드 기준으로 굽는다.
+	FbxNode* SkeletonNode = nullptr;
+	FbxAMatrix SkeletonSpace;
+
+	for (const MeshPart& Part : Parts)
+	{
+		if (false == Part.bSkinned)
+		{
+			continue;
+		}
+
+		FbxSkin* Skin = GetSkin(Part.Mesh);
+		for (int i = 0; i < Skin->GetClusterCount(); i++)
+		{
+			FbxCluster* Cluster = Skin->GetCluster(i);
+			if (NodeToIndex.find(Cluster->GetLink()) != NodeToIndex.end())
+			{
+				continue;
+			}
+
+			FbxAMatrix TransformLinkMatrix;
+			Cluster->GetTransformLinkMatrix(TransformLinkMatrix);
+
+			NodeToIndex[Cluster->GetLink()] = (int)Nodes.size();
+			Nodes.push_back(Cluster->GetLink());
+			LinkBinds.push_back(TransformLinkMatrix);
+		}
+
+		if (nullptr == SkeletonNode)
+		{
+			SkeletonNode = Part.Mesh->GetNode();
+			Skin->GetCluster(0)->GetTransformMatrix(SkeletonSpace);
+		}
+	}
+
+	if (nullptr == SkeletonNode)
 	{
 		return nullptr;
 	}
 
-	ProcessPolygon(Mesh, Name);
+	// 인덱스가 16비트라 움직이지 않는 뼈 자리 하나를 남겨두고 그 이상은 담을 수 없다.
+	const int NodeCount = (int)Nodes.size();
+	if (NodeCount >= 65536)
+	{
+		char Message[256];
+		sprintf_s(Message, "[FbxLoader] %s: %d bones don't fit in 16-bit bone indices, importing as a static mesh\n", Name.c_str(), NodeCount);
+		OutputDebugStringA(Message);
+
+		for (MeshPart& Part : Parts)
+		{
+			Part.bSkinned = false;
+		}
+		return nullptr;
+	}
+
+	// 노드 순서는 계층과 상관이 없으니 부모가 자식보다 먼저 오도록 다시 줄 세운다.
+	// 사이에 뼈가 아닌 노드가 끼어 있으면 건너뛰고 가장 가까운 조상 뼈를 부모로 삼는다.
+	auto FindAncestorBone = [&NodeToIndex](FbxNode* Node)
+	{
+		for (; Node; Node = Node->GetParent())
+		{
+			auto Found = NodeToIndex.find(Node);
+			if (Found != NodeToIndex.end())
+			{
+				return Found->second;
+			}
+		}
+		return -1;
+	};
+
+	std::vector<int> NodeParents(NodeCount, -1);
+	for (int i = 0; i < NodeCount; i++)
+	{
+		NodeParents[i] = FindAncestorBone(Nodes[i]->GetParent());
+	}
+
+	std::vector<int> NodeDepths(NodeCount, 0);
+	for (int i = 0; i < NodeCount; i++)
+	{
+		for (int Parent = NodeParents[i]; Parent >= 0; Parent = NodeParents[Parent])
+		{
+			NodeDepths[i]++;
+		}
+	}
+
+	std::vector<int> SkeletonOrder(NodeCount);
+	for (int i = 0; i < NodeCount; i++)
+	{
+		SkeletonOrder[i] = i;
+	}
+	std::stable_sort(SkeletonOrder.begin(), SkeletonOrder.end(), [&NodeDepths](int A, int B) { return NodeDepths[A] < NodeDepths[B]; });
+
+	std::vector<int> NodeToBone(NodeCount);
+	for (int Bone = 0; Bone < NodeCount; Bone++)
+	{
+		NodeToBone[SkeletonOrder[Bone]] = Bone;
+	}
+
+	// 스킨이 없는 메쉬는 자기 노드나 가장 가까운 조상 뼈를 따라가고, 어느 뼈 밑에도 없으면 맨 끝에 붙인 움직이지 않는 뼈에 붙는다.
+	std::vector<int> RigidNodes(Parts.size(), -1);
+	bool bStaticBone = false;
+	for (size_t i = 0; i < Parts.size(); i++)
+	{
+		if (false == Parts[i].bSkinned)
+		{
+			RigidNodes[i] = FindAncestorBone(Parts[i].Mesh->GetNode());
+			bStaticBone = bStaticBone || RigidNodes[i] < 0;
+		}
+	}
+
+	const int BoneCount = NodeCount + (bStaticBone ? 1 : 0);
+	const FbxAMatrix SkeletonInverse = SkeletonSpace.Inverse();
+
+	SkeletonData& Skel = Skeletons[Name];
+	Skel.ParentIndices.assign(BoneCount, -1);
+	Skel.InverseBindPose.assign(BoneCount, XMMatrixIdentity());
+	Skel.BindPose.resize(BoneCount);
+
+	// 바인드 포즈에서 각 뼈의 스켈레톤 공간 기준 트랜스폼. 움직이지 않는 뼈는 단위 행렬 그대로다.
+	std::vector<FbxAMatrix> BindToRoot(BoneCount);
+	OutBoneNodes.assign(BoneCount, nullptr);
+
+	for (int Bone = 0; Bone < NodeCount; Bone++)
+	{
+		const int i = SkeletonOrder[Bone];
+
+		Skel.InverseBindPose[Bone] = ToXMMatrix(LinkBinds[i].Inverse() * SkeletonSpace);
+		Skel.ParentIndices[Bone] = NodeParents[i] < 0 ? -1 : NodeToBone[NodeParents[i]];
+		BindToRoot[Bone] = SkeletonInverse * LinkBinds[i];
+		OutBoneNodes[Bone] = Nodes[i];
+	}
+
+	for (int Bone = 0; Bone < BoneCount; Bone++)
+	{
+		const int Parent = Skel.ParentIndices[Bone];
+		FbxAMatrix Local = Parent < 0 ? BindToRoot[Bone] : BindToRoot[Parent].Inverse() * BindToRoot[Bone];
+		Skel.BindPose[Bone] = ToBoneTransform(Local);
+	}
+
+	// 정점은 전부 스켈레톤 공간의 바인드 포즈로 옮겨 둔다. 뼈에 붙는 정적 메쉬는 지금 뼈와의 상대 위치를 바인드 포즈에서도 그대로 둔다.
+	for (size_t i = 0; i < Parts.size(); i++)
+	{
+		MeshPart& Part = Parts[i];
+		FbxNode* Node = Part.Mesh->GetNode();
+
+		FbxAMatrix MeshToSkeleton;
+		if (Part.bSkinned)
+		{
+			FbxSkin* Skin = GetSkin(Part.Mesh);
+			Part.ClusterBones.resize(Skin->GetClusterCount());
+			for (int k = 0; k < Skin->GetClusterCount(); k++)
+			{
+				Part.ClusterBones[k] = (uint16_t)NodeToBone[NodeToIndex[Skin->GetCluster(k)->GetLink()]];
+			}
 
-	return Mesh;
+			FbxAMatrix MeshBind;
+			Skin->GetCluster(0)->GetTransformMatrix(MeshBind);
+			MeshToSkeleton = SkeletonInverse * MeshBind * GetGeometryTransformation(Node);
+		}
+		else if (RigidNodes[i] >= 0)
+		{
+			const int RigidNode = RigidNodes[i];
+			Part.RigidBone = NodeToBone[RigidNode];
+
+			FbxAMatrix BoneToMesh = Nodes[RigidNode]->EvaluateGlobalTransform().Inverse() * Node->EvaluateGlobalTransform();
+			MeshToSkeleton = SkeletonInverse * LinkBinds[RigidNode] * BoneToMesh * GetGeometryTransformation(Node);
+		}
+		else
+		{
+			Part.RigidBone = NodeCount;
+			MeshToSkeleton = SkeletonInverse * Node->EvaluateGlobalTransform() * GetGeometryTransformation(Node);
+		}
+
+		XMStoreFloat4x4(&Part.Transform, ToXMMatrix(MeshToSkeleton));
+	}
+
+	return SkeletonNode;
 }
 
-void FbxLoader::LoadAnimation(FbxScene* Scene, const std::string& Name, FbxMesh* Mesh)
+void FbxLoader::LoadSkin(const std::string& Name, MeshPart& Part)
 {
-	FbxAnimStack* AnimStack = Scene->GetSrcObject<FbxAnimStack>(0);
-	if (nullptr == AnimStack)
+	std::vector<Vertex>& MeshVertices = Part.Vertices;
+
+	if (false == Part.bSkinned)
 	{
+		BoneInfluence Rigid;
+		Rigid.Bone = (uint16_t)Part.RigidBone;
+		Rigid.Weight = 1.0f;
+
+		for (Vertex& Vertex : MeshVertices)
+		{
+			SetBoneInfluences(Vertex, &Rigid, 1);
+		}
 		return;
 	}
 
-	FbxString AnimStackName = AnimStack->GetName();
+	FbxMesh* Mesh = Part.Mesh;
+	FbxSkin* Skin = GetSkin(Mesh);
+	const int ClusterCount = Skin->GetClusterCount();
 
-	FbxSkin* Skin = reinterpret_cast<FbxSkin*>(Mesh->GetDeformer(0, FbxDeformer::eSkin));
-	int BoneCount = Skin->GetClusterCount();
-	BoneCounts[Name] = BoneCount;
+	// Control Point마다 붙은 영향을 클러스터 순서와 상관없이 전부 모은다. Influences[Offsets[i], Offsets[i + 1])
+	const int ControlPointCount = Mesh->GetControlPointsCount();
+	std::vector<uint32_t> InfluenceOffsets(ControlPointCount + 1, 0);
+	for (int i = 0; i < ClusterCount; i++)
+	{
+		FbxCluster* Cluster = Skin->GetCluster(i);
+		const int* VertexList = Cluster->GetControlPointIndices();
+		const int VertexCount = Cluster->GetControlPointIndicesCount();
+		for (int j = 0; j < VertexCount; j++)
+		{
+			InfluenceOffsets[VertexList[j] + 1]++;
+		}
+	}
 
-	FbxAMatrix GeometryTransform = GetGeometryTransformation(Mesh->GetNode());
+	for (int i = 0; i < ControlPointCount; i++)
+	{
+		InfluenceOffsets[i + 1] += InfluenceOffsets[i];
+	}
 
-	for (int i = 0; i < BoneCount; i++)
+	std::vector<BoneInfluence> Influences(InfluenceOffsets[ControlPointCount]);
+	std::vector<uint32_t> InfluenceCursors(InfluenceOffsets.begin(), InfluenceOffsets.end() - 1);
+	for (int i = 0; i < ClusterCount; i++)
 	{
 		FbxCluster* Cluster = Skin->GetCluster(i);
-		int* VertexList = Cluster->GetControlPointIndices();
-		int VertexCount = Cluster->GetControlPointIndicesCount();
+		const int* VertexList = Cluster->GetControlPointIndices();
+		const double* WeightList = Cluster->GetControlPointWeights();
+		const int VertexCount = Cluster->GetControlPointIndicesCount();
 		for (int j = 0; j < VertexCount; j++)
 		{
-			const FbxVector4& Pos = Mesh->GetControlPointAt(VertexList[j]);
+			BoneInfluence& Influence = Influences[InfluenceCursors[VertexList[j]]++];
+			Influence.Bone = Part.ClusterBones[i];
+			Influence.Weight = (float)WeightList[j];
+		}
+	}
 
-			// FIXME: 어차피 Vertex끼리 비교할 때 Pos만 비교하니까 이렇게 했다.
-			Vertex Vertex;
-			Vertex.Pos = MathHelper::Fbx4ToXM3(Pos);
+	SkinImportSettings Settings = SkinSettings;
+	Settings.MaxInfluences = MathHelper::Clamp<uint32_t>(Settings.MaxInfluences, 1, 4);
 
-			uint16_t Index = IndexMap[Vertex];
-			for (int k = 0; k < 4; k++)
-			{
-				// FIXME: 255번째 Bone이 있으면 망한다.
-				if (Vertices[Name][Index].BoneIndices[k] == 255)
-				{
-					Vertices[Name][Index].BoneIndices[k] = i;
-					float BoneWeight = (float)Cluster->GetControlPointWeights()[j];
-
-					switch (k)
-					{
-					case 0:
-						Vertices[Name][Index].BoneWeights.x = BoneWeight;
-						break;
-					case 1:
-						Vertices[Name][Index].BoneWeights.y = BoneWeight;
-						break;
-					case 2:
-						Vertices[Name][Index].BoneWeights.z = BoneWeight;
-						break;
-					case 3:
-						Vertices[Name][Index].BoneWeights.w = BoneWeight;
-						break;
-					}
-
-					break;
-				}
-			}
+	size_t KeptCount = 0;
+	for (int ControlPoint = 0; ControlPoint < ControlPointCount; ControlPoint++)
+	{
+		const uint32_t Begin = InfluenceOffsets[ControlPoint];
+		const uint32_t Kept = PruneInfluences(&Influences[Begin], InfluenceOffsets[ControlPoint + 1] - Begin, Settings);
+		KeptCount += Kept;
+
+		// 같은 Control Point에서 갈라진 Vertex(UV 이음새 등)에도 전부 넣는다.
+		for (uint32_t k = Part.ControlPointVertexOffsets[ControlPoint]; k < Part.ControlPointVertexOffsets[ControlPoint + 1]; k++)
+		{
+			SetBoneInfluences(MeshVertices[Part.ControlPointVertices[k]], &Influences[Begin], Kept);
 		}
+	}
 
-		FbxAMatrix TransformMatrix;
-		Cluster->GetTransformMatrix(TransformMatrix);
-		FbxAMatrix TransformLinkMatrix;
-		Cluster->GetTransformLinkMatrix(TransformLinkMatrix);
-		FbxAMatrix BoneOffsetMatrix = TransformLinkMatrix.Inverse() * TransformMatrix * GeometryTransform;
+	char Message[256];
+	sprintf_s(Message, "[FbxLoader] %s_%s skin: %d control points, influences %.2f -> %.2f per vertex\n",
+		Name.c_str(), Part.Name.c_str(), ControlPointCount,
+		ControlPointCount > 0 ? (double)Influences.size() / ControlPointCount : 0.0,
+		ControlPointCount > 0 ? (double)KeptCount / ControlPointCount : 0.0);
+	OutputDebugStringA(Message);
+}
 
-		XMFLOAT4X4 BoneOffset;
-		for (int i = 0; i < 4; ++i)
+void FbxLoader::LoadAnimation(const char* FilePath, FbxScene* Scene, const std::string& Name, FbxNode* MeshNode, const std::vector<FbxNode*>& BoneNodes)
+{
+	FbxAnimStack* AnimStack = Scene->GetSrcObject<FbxAnimStack>(0);
+
+	FbxTakeInfo* TakeInfo = Scene->GetTakeInfo(AnimStack->GetName());
+	FbxLongLong StartFrame = TakeInfo->mLocalTimeSpan.GetStart().GetFrameCount(FbxTime::eFrames24);
+	FbxLongLong EndFrame = TakeInfo->mLocalTimeSpan.GetStop().GetFrameCount(FbxTime::eFrames24);
+
+	BakeAnimation(FilePath, Name, MeshNode, BoneNodes, StartFrame, EndFrame);
+}
+
+void FbxLoader::BakeAnimation(const char* FilePath, const std::string& Name, FbxNode* MeshNode, const std::vector<FbxNode*>& BoneNodes, FbxLongLong StartFrame, FbxLongLong EndFrame)
+{
+	const int BoneCount = (int)BoneNodes.size();
+	const size_t FrameCount = (size_t)(EndFrame - StartFrame + 1);
+
+	std::vector<BoneTransform> Poses(FrameCount * BoneCount);
+
+	// 메인 스레드는 Import한 씬을 그대로 쓰고, 워커는 필요할 때 자기 씬을 따로 Import한다.
+	std::vector<BakeContext> Contexts(JobSystem::Get()->GetThreadCount());
+	Contexts[0].Scene = MeshNode->GetScene();
+	Contexts[0].MeshNode = MeshNode;
+	Contexts[0].BoneNodes = BoneNodes;
+	Contexts[0].ParentIndices = Skeletons.at(Name).ParentIndices;
+	IndexBakeNodes(Contexts[0]);
+
+	std::vector<uint8_t> bFrameBaked(FrameCount, 0);
+
+	const size_t ThreadCount = Contexts.size();
+	const size_t Grain = MathHelper::Max<size_t>((FrameCount + ThreadCount - 1) / ThreadCount, MinBakeFramesPerThread);
+
+	JobSystem::Get()->ParallelFor(FrameCount, Grain, [&](size_t Begin, size_t End, uint32_t ThreadIndex)
+	{
+		BakeContext& Context = Contexts[ThreadIndex];
+		if (nullptr == Context.Scene && false == Context.bFailed)
 		{
-			for (int j = 0; j < 4; ++j)
-			{
-				BoneOffset.m[i][j] = BoneOffsetMatrix.Get(i, j);
-			}
+			Context.bFailed = false == CreateBakeContext(FilePath, Contexts[0], Context);
+		}
+
+		if (Context.bFailed)
+		{
+			return;
 		}
-		BoneOffsets[Name].push_back(XMLoadFloat4x4(&BoneOffset));
+
+		for (size_t i = Begin; i < End; i++)
+		{
+			BakeFrame(Context, StartFrame + (FbxLongLong)i, &Poses[i * BoneCount]);
+			bFrameBaked[i] = 1;
+		}
+	});
+
+	// 워커 씬을 못 만들었으면 남은 프레임은 여기서 굽는다.
+	for (size_t i = 0; i < FrameCount; i++)
+	{
+		if (0 == bFrameBaked[i])
+		{
+			BakeFrame(Contexts[0], StartFrame + (FbxLongLong)i, &Poses[i * BoneCount]);
+		}
+	}
+
+	for (size_t i = 1; i < Contexts.size(); i++)
+	{
+		if (Contexts[i].Manager)
+		{
+			Contexts[i].Manager->Destroy();
+		}
+	}
+
+	AnimationClipData& ClipData = AnimationClips[Name];
+	AnimationClip::Compress(Poses, (uint32_t)FrameCount, (uint32_t)BoneCount, 24.0f, CompressionSettings, ClipData);
+
+	const size_t BakedBytes = Poses.size() * sizeof(XMMATRIX);
+	const size_t ClipBytes = AnimationClip(ClipData).GetByteSize();
+
+	char Message[256];
+	sprintf_s(Message, "[FbxLoader] %s clip: %zu frames x %d bones, baked matrices %zu bytes -> compressed %zu bytes (%.1f%%)\n",
+		Name.c_str(), FrameCount, BoneCount, BakedBytes, ClipBytes, 100.0 * ClipBytes / MathHelper::Max<size_t>(BakedBytes, 1));
+	OutputDebugStringA(Message);
+
+#if FBXLOADER_CLIP_BENCHMARK
+	BenchmarkClipSampling(AnimationClip(ClipData), Poses);
+#endif
+}
+
+void FbxLoader::IndexBakeNodes(BakeContext& Context)
+{
+	// FBX 노드 이름은 겹칠 수 있어서 이름으로는 못 찾는다. 같은 파일을 같은 순서로 읽은 씬이면 전위 순회 번호가 같다.
+	// 워커가 메인 씬을 건드리지 않도록 번호는 굽기 전에 메인 스레드에서 매긴다.
+	std::vector<FbxNode*> Nodes;
+	CollectNodes(Context.Scene->GetRootNode(), Nodes);
+
+	std::unordered_map<FbxNode*, int32_t> NodeIndices;
+	for (size_t i = 0; i < Nodes.size(); i++)
+	{
+		NodeIndices[Nodes[i]] = (int32_t)i;
+	}
+
+	Context.NodeCount = Nodes.size();
+	Context.MeshNodeIndex = NodeIndices.at(Context.MeshNode);
+	Context.BoneNodeIndices.clear();
+	for (FbxNode* BoneNode : Context.BoneNodes)
+	{
+		Context.BoneNodeIndices.push_back(BoneNode ? NodeIndices.at(BoneNode) : -1);
+	}
+}
+
+bool FbxLoader::CreateBakeContext(const char* FilePath, const BakeContext& Source, BakeContext& OutContext)
+{
+	// FBX SDK 객체는 스레드 간에 공유하면 안 되니까 매니저부터 따로 만든다.
+	OutContext.Manager = FbxManager::Create();
+	OutContext.Manager->SetIOSettings(FbxIOSettings::Create(OutContext.Manager, IOSROOT));
+
+	FbxImporter* WorkerImporter = FbxImporter::Create(OutContext.Manager, "");
+	if (false == WorkerImporter->Initialize(FilePath, -1, OutContext.Manager->GetIOSettings()))
+	{
+		return false;
 	}
 
-	FbxTakeInfo* TakeInfo = Scene->GetTakeInfo(AnimStackName);
-	FbxTime Start = TakeInfo->mLocalTimeSpan.GetStart();
-	FbxTime End = TakeInfo->mLocalTimeSpan.GetStop();
-	
-	FbxLongLong DebugStart = Start.GetFrameCount(FbxTime::eFrames24);
-	FbxLongLong DebugEnd = End.GetFrameCount(FbxTime::eFrames24);
+	OutContext.Scene = FbxScene::Create(OutContext.Manager, "Bake Scene");
+	WorkerImporter->Import(OutContext.Scene);
+	WorkerImporter->Destroy();
+
+	FbxAxisSystem::MayaYUp.ConvertScene(OutContext.Scene);
 
-	for (FbxLongLong i = Start.GetFrameCount(FbxTime::eFrames24); i <= End.GetFrameCount(FbxTime::eFrames24); i++)
+	std::vector<FbxNode*> Nodes;
+	CollectNodes(OutContext.Scene->GetRootNode(), Nodes);
+	if (Nodes.size() != Source.NodeCount)
 	{
-		FindAnimation(Scene, Mesh, i, Name);
+		return false;
+	}
+
+	OutContext.MeshNode = Nodes[Source.MeshNodeIndex];
+	for (int32_t NodeIndex : Source.BoneNodeIndices)
+	{
+		OutContext.BoneNodes.push_back(NodeIndex < 0 ? nullptr : Nodes[NodeIndex]);
 	}
+	OutContext.ParentIndices = Source.ParentIndices;
+
+	return true;
+}
+
+void FbxLoader::BakeFrame(BakeContext& Context, FbxLongLong Frame, BoneTransform* OutPose)
+{
+	FbxTime CurTime;
+	CurTime.SetFrame(Frame, FbxTime::eFrames24);
+
+	// 루트는 프레임마다 한 번만 평가한다.
+	FbxAMatrix RootInverse = Context.MeshNode->EvaluateGlobalTransform(CurTime).Inverse();
+
+	// 부모가 항상 먼저 나오니까 부모의 글로벌 트랜스폼은 이미 구해져 있다.
+	Context.GlobalTransforms.resize(Context.BoneNodes.size());
+	for (size_t i = 0; i < Context.BoneNodes.size(); i++)
+	{
+		// 노드가 없는 뼈는 정적 메쉬를 붙여 둔 움직이지 않는 뼈다.
+		if (nullptr == Context.BoneNodes[i])
+		{
+			Context.GlobalTransforms[i] = RootInverse.Inverse();
+			OutPose[i] = ToBoneTransform(FbxAMatrix());
+			continue;
+		}
+
+		Context.GlobalTransforms[i] = Context.BoneNodes[i]->EvaluateGlobalTransform(CurTime);
+
+		const int32_t Parent = Context.ParentIndices[i];
+		FbxAMatrix ParentInverse = Parent < 0 ? RootInverse : Context.GlobalTransforms[Parent].Inverse();
+
+		OutPose[i] = ToBoneTransform(ParentInverse * Context.GlobalTransforms[i]);
+	}
+}
+
+bool FbxLoader::MergeMeshParts(const std::string& Name, std::vector<MeshPart>& Parts)
+{
+	std::vector<Vertex>& MeshVertices = Vertices[Name];
+	std::vector<uint32_t>& MeshIndices = Indices[Name];
+	std::vector<Meshlet>& MeshMeshlets = Meshlets[Name];
+	std::vector<CookedSubmesh>& MeshSubmeshes = Submeshes[Name];
+
+	size_t VertexCount = 0;
+	size_t IndexCount = 0;
+	for (const MeshPart& Part : Parts)
+	{
+		VertexCount += Part.Vertices.size();
+		IndexCount += Part.Indices.size();
+	}
+
+	// 전체를 한 번에 그릴 수도 있게 인덱스는 합친 정점 버퍼 기준으로 다시 매긴다.
+	if (VertexCount > UINT32_MAX || IndexCount > UINT32_MAX)
+	{
+		char Message[256];
+		sprintf_s(Message, "[FbxLoader] %s: %zu vertices, %zu indices don't fit in 32-bit indices\n", Name.c_str(), VertexCount, IndexCount);
+		OutputDebugStringA(Message);
+		return false;
+	}
+
+	MeshVertices.reserve(VertexCount);
+	MeshIndices.reserve(IndexCount);
+
+	// 0번은 전체 메쉬, 그 뒤로 노드별 서브메쉬.
+	CookedSubmesh Whole;
+	strncpy_s(Whole.Name, Name.c_str(), _TRUNCATE);
+	Whole.Geometry.IndexCount = (UINT)IndexCount;
+	Whole.Geometry.Bounds = Parts[0].Bounds;
+	MeshSubmeshes.push_back(Whole);
+
+	for (const MeshPart& Part : Parts)
+	{
+		const uint32_t BaseVertex = (uint32_t)MeshVertices.size();
+		const UINT StartIndex = (UINT)MeshIndices.size();
+
+		MeshVertices.insert(MeshVertices.end(), Part.Vertices.begin(), Part.Vertices.end());
+		for (uint32_t Index : Part.Indices)
+		{
+			MeshIndices.push_back(BaseVertex + Index);
+		}
+
+		for (Meshlet Cluster : Part.Meshlets)
+		{
+			Cluster.StartIndexLocation += StartIndex;
+			MeshMeshlets.push_back(Cluster);
+		}
+
+		CookedSubmesh Submesh;
+		strncpy_s(Submesh.Name, (Name + "_" + Part.Name).c_str(), _TRUNCATE);
+		Submesh.Geometry.IndexCount = (UINT)Part.Indices.size();
+		Submesh.Geometry.StartIndexLocation = StartIndex;
+		Submesh.Geometry.BaseVertexLocation = 0;
+		Submesh.Geometry.Bounds = Part.Bounds;
+		MeshSubmeshes.push_back(Submesh);
+
+		BoundingBox::CreateMerged(MeshSubmeshes[0].Geometry.Bounds, MeshSubmeshes[0].Geometry.Bounds, Part.Bounds);
+	}
+
+	return true;
 }
 
 std::wstring FbxLoader::ConvertToTextureName(const char* FilePath, const std::string& Name)
@@ -253,104 +1013,138 @@ std::wstring FbxLoader::ConvertToTextureName(const char* FilePath, const std::st
 	return Wstr;
 }
 
-bool FbxLoader::FindMesh(FbxNode* Node, FbxMesh*& OutMesh)
+void FbxLoader::CollectMeshes(FbxNode* Node, std::vector<MeshPart>& OutParts)
 {
 	FbxNodeAttribute* Attribute = Node->GetNodeAttribute();
-	if (Attribute)
+	if (Attribute && Attribute->GetAttributeType() == FbxNodeAttribute::eMesh)
 	{
-		if (Attribute->GetAttributeType() == FbxNodeAttribute::eMesh)
+		MeshPart Part;
+		Part.Mesh = Node->GetMesh();
+		Part.Name = Node->GetName();
+		Part.bSkinned = Part.Mesh->GetDeformerCount(FbxDeformer::eSkin) > 0;
+
+		if (Part.Name.empty())
+		{
+			Part.Name = "Mesh" + std::to_string(OutParts.size());
+		}
+
+		FbxAMatrix NodeTransform = Node->EvaluateGlobalTransform() * GetGeometryTransformation(Node);
+		for (int i = 0; i < 4; ++i)
 		{
-			OutMesh = Node->GetMesh();
-			return true;
+			for (int j = 0; j < 4; ++j)
+			{
+				Part.Transform.m[i][j] = (float)NodeTransform.Get(i, j);
+			}
 		}
+
+		OutParts.push_back(std::move(Part));
 	}
 
 	int ChildCount = Node->GetChildCount();
 	for (int i = 0; i < ChildCount; i++)
 	{
-		if (FindMesh(Node->GetChild(i), OutMesh))
-		{
-			return true;
-		}
+		CollectMeshes(Node->GetChild(i), OutParts);
 	}
-
-	return false;
 }
 
-void FbxLoader::FindAnimation(FbxScene* Scene, FbxMesh* Mesh, const FbxLongLong& Time, const std::string& Name)
+void FbxLoader::ProcessPolygon(MeshPart& Part)
 {
-	FbxAnimEvaluator* AnimEvaluator = Scene->GetAnimationEvaluator();
+	FbxMesh* Mesh = Part.Mesh;
+	const int PolygonCount = Mesh->GetPolygonCount();
+	const int CornerCount = PolygonCount * 3;
 
-	FbxSkin* Skin = reinterpret_cast<FbxSkin*>(Mesh->GetDeformer(0, FbxDeformer::eSkin));
-	int ClusterCount = Skin->GetClusterCount();
-	for (int i = 0; i < ClusterCount; i++)
+	const FbxVector4* ControlPoints = Mesh->GetControlPoints();
+	const int* PolygonVertices = Mesh->GetPolygonVertices();
+
+	LayerElementReader<FbxVector4> Normals(Mesh->GetElementNormal(0));
+	LayerElementReader<FbxVector2> TexCoords(Mesh->GetElementUV(0));
+
+	XMMATRIX Transform = XMLoadFloat4x4(&Part.Transform);
+	XMMATRIX NormalTransform = XMMatrixTranspose(XMMatrixInverse(nullptr, Transform));
+
+	std::vector<Vertex> Corners(CornerCount);
+	std::vector<int> CornerControlPoints(CornerCount);
+
+	// 삼각형 구간별로 나눠서 코너 Vertex를 먼저 다 만든다. 용접은 순서가 중요하니까 아래에서 한 스레드로 한다.
+	JobSystem::Get()->ParallelFor(PolygonCount, 4096, [&](size_t Begin, size_t End, uint32_t ThreadIndex)
 	{
-		FbxCluster* Cluster = Skin->GetCluster(i);
-		FbxNode* Node = Cluster->GetLink();
+		for (int i = (int)Begin; i < (int)End; i++)
+		{
+			const int PolygonStart = Mesh->GetPolygonVertexIndex(i);
 
-		FbxTime CurTime;
-		CurTime.SetFrame(Time, FbxTime::eFrames24);
+			for (int j = 0; j < 3; j++)
+			{
+				const int Corner = i * 3 + j;
+				const int ControlPoint = PolygonVertices[PolygonStart + j];
 
-		FbxAMatrix RootGlobalMatrix = Mesh->GetNode()->EvaluateGlobalTransform(CurTime);
-		FbxAMatrix ToRootMatrix = RootGlobalMatrix.Inverse() * Node->EvaluateGlobalTransform(CurTime);
-		
-		XMFLOAT4 Translation = MathHelper::Fbx4ToXM4(ToRootMatrix.GetT());
-		XMFLOAT4 Quaternion = MathHelper::QuatToXM4(ToRootMatrix.GetQ());
-		XMFLOAT4 Scale = MathHelper::Fbx4ToXM4(ToRootMatrix.GetS());
+				Vertex& Vertex = Corners[Corner];
+				CornerControlPoints[Corner] = ControlPoint;
 
-		XMVECTOR TranslationVector = XMLoadFloat4(&Translation);
-		XMVECTOR QuaternionVector = XMLoadFloat4(&Quaternion);
-		XMVECTOR ScaleVector = XMLoadFloat4(&Scale);
-		XMVECTOR Zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+				Vertex.Pos = MathHelper::Fbx4ToXM3(ControlPoints[ControlPoint]);
+				Vertex.Normal = Normals.IsValid() ? MathHelper::Fbx4ToXM3(Normals.Get(ControlPoint, i, PolygonStart + j)) : XMFLOAT3(0.0f, 1.0f, 0.0f);
+				Vertex.TexCoord = TexCoords.IsValid() ? MathHelper::Fbx2ToXM2(TexCoords.Get(ControlPoint, i, PolygonStart + j)) : XMFLOAT2(0.0f, 0.0f);
+				Vertex.TexCoord.y *= -1.0f;
 
-		XMMATRIX ToRootTransform = XMMatrixAffineTransformation(ScaleVector, Zero, QuaternionVector, TranslationVector);
-		ToRootTransforms[Name].push_back(ToRootTransform);
-	}
-}
+				XMStoreFloat3(&Vertex.Pos, XMVector3TransformCoord(XMLoadFloat3(&Vertex.Pos), Transform));
+				XMStoreFloat3(&Vertex.Normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&Vertex.Normal), NormalTransform)));
 
-void FbxLoader::ProcessPolygon(FbxMesh* Mesh, const std::string& Name)
-{
-	int PolygonCount = Mesh->GetPolygonCount();
+				Vertex.BoneWeights = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+				memset(Vertex.BoneIndices, 0, sizeof(Vertex.BoneIndices));
+			}
+		}
+	});
 
-	for (int i = 0; i < PolygonCount; i++)
-	{
-		for (int j = 0; j < 3; j++)
-		{
-			Vertex Vertex;
-			int Index = Mesh->GetPolygonVertex(i, j);
+	std::vector<uint32_t>& MeshIndices = Part.Indices;
+	MeshIndices.reserve(CornerCount);
+
+	VertexWelder Welder(Part.Vertices, WeldEpsilon);
+	Welder.Reserve(CornerCount);
+
+	XMFLOAT3 Minf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
+	XMFLOAT3 Maxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
 
-			GetPosition(Mesh, Index, Vertex.Pos);
-			GetNormal(Mesh, i, j, Vertex.Normal);
-			GetTexCoord(Mesh, i, j, Vertex.TexCoord);
+	XMVECTOR Min = XMLoadFloat3(&Minf3);
+	XMVECTOR Max = XMLoadFloat3(&Maxf3);
 
-			Vertex.BoneWeights.x = 0.0f;
-			Vertex.BoneWeights.y = 0.0f;
-			Vertex.BoneWeights.z = 0.0f;
-			Vertex.BoneWeights.w = 0.0f;
+	std::vector<int> VertexControlPoints;
+	VertexControlPoints.reserve(CornerCount);
 
-			Vertex.BoneIndices[0] = 255;
-			Vertex.BoneIndices[1] = 255;
-			Vertex.BoneIndices[2] = 255;
-			Vertex.BoneIndices[3] = 255;
+	// 스키닝 무게는 LoadAnimation에서 Control Point 단위로 채운다. 위치가 같아도 Control Point가 다르면 무게가 다를 수 있으니 따로 둔다.
+	for (int Corner = 0; Corner < CornerCount; Corner++)
+	{
+		uint32_t Index = Welder.Insert(Corners[Corner], Part.bSkinned ? (uint32_t)CornerControlPoints[Corner] : 0);
+
+		if (Index == VertexControlPoints.size())
+		{
+			VertexControlPoints.push_back(CornerControlPoints[Corner]);
 
-			InsertVertex(Vertex, Name);
+			Min = XMVectorMin(Min, XMLoadFloat3(&Corners[Corner].Pos));
+			Max = XMVectorMax(Max, XMLoadFloat3(&Corners[Corner].Pos));
 		}
+
+		MeshIndices.push_back(Index);
 	}
-}
 
-void FbxLoader::InsertVertex(const Vertex& InVertex, const std::string& Name)
-{
-	auto Lookup = IndexMap.find(InVertex);
-	if (Lookup != IndexMap.end())
+	XMStoreFloat3(&Part.Bounds.Center, 0.5f * (Min + Max));
+	XMStoreFloat3(&Part.Bounds.Extents, 0.5f * (Max - Min));
+
+	// Control Point -> Vertex 역참조 테이블을 CSR로 만든다.
+	std::vector<uint32_t>& Offsets = Part.ControlPointVertexOffsets;
+	Offsets.assign(Mesh->GetControlPointsCount() + 1, 0);
+	for (int ControlPoint : VertexControlPoints)
 	{
-		Indices[Name].push_back(Lookup->second);
+		Offsets[ControlPoint + 1]++;
 	}
-	else
+	for (size_t i = 1; i < Offsets.size(); i++)
+	{
+		Offsets[i] += Offsets[i - 1];
+	}
+
+	std::vector<uint32_t> FillOffsets(Offsets.begin(), Offsets.end() - 1);
+	Part.ControlPointVertices.resize(VertexControlPoints.size());
+	for (uint32_t i = 0; i < (uint32_t)VertexControlPoints.size(); i++)
 	{
-		unsigned int Index = (unsigned int)Vertices[Name].size();
-		IndexMap[InVertex] = Index;
-		Indices[Name].push_back(Index);
-		Vertices[Name].push_back(InVertex);
+		Part.ControlPointVertices[FillOffsets[VertexControlPoints[i]]++] = i;
 	}
 }
 
@@ -363,45 +1157,39 @@ FbxAMatrix FbxLoader::GetGeometryTransformation(FbxNode* Node)
 	return FbxAMatrix(Translation, Rotation, Scaling);
 }
 
-void FbxLoader::GetPosition(FbxMesh* Mesh, int Index, XMFLOAT3& Data)
+void FbxLoader::SetWeldEpsilon(float InEpsilon)
 {
-	const FbxVector4& ControlPoint = Mesh->GetControlPointAt(Index);
-	Data = MathHelper::Fbx4ToXM3(ControlPoint);
+	WeldEpsilon = InEpsilon;
 }
 
-void FbxLoader::GetNormal(FbxMesh* Mesh, int PolyIndex, int VertexIndex, XMFLOAT3& Data)
+void FbxLoader::SetAnimationCompression(const AnimationCompressionSettings& InSettings)
 {
-	FbxVector4 Normal;
-	bool bResult = Mesh->GetPolygonVertexNormal(PolyIndex, VertexIndex, Normal);
-	Data = bResult ? MathHelper::Fbx4ToXM3(Normal) : XMFLOAT3(0.0f, 1.0f, 0.0f);
+	CompressionSettings = InSettings;
 }
 
-void FbxLoader::GetTexCoord(FbxMesh* Mesh, int PolyIndex, int VertexIndex, XMFLOAT2& Data)
+void FbxLoader::SetSkinImport(const SkinImportSettings& InSettings)
 {
-	FbxStringList UVNames;
-	Mesh->GetUVSetNames(UVNames);
+	SkinSettings = InSettings;
+}
 
-	if (0 == UVNames.GetCount())
-	{
-		Data = XMFLOAT2(0.0f, 0.0f);
-		return;
-	}
+ArrayView<Vertex> FbxLoader::GetVertices(const std::string& Name) const
+{
+	return CookedMeshes.at(Name)->GetSection<Vertex>(MeshCacheSection::Vertices);
+}
 
-	FbxVector2 TexCoord;
-	bool bUnmapped;
-	bool bResult = Mesh->GetPolygonVertexUV(PolyIndex, VertexIndex, UVNames[0], TexCoord, bUnmapped);
-	Data = (bResult) ? MathHelper::Fbx2ToXM2(TexCoord) : XMFLOAT2(0.0f, 0.0f);
-	Data.y *= -1.0f;
+ArrayView<uint32_t> FbxLoader::GetIndices(const std::string& Name) const
+{
+	return CookedMeshes.at(Name)->GetSection<uint32_t>(MeshCacheSection::Indices);
 }
 
-const std::vector<Vertex>& FbxLoader::GetVertices(const std::string& Name) const
+ArrayView<CookedSubmesh> FbxLoader::GetSubmeshes(const std::string& Name) const
 {
-	return Vertices.at(Name);
+	return CookedMeshes.at(Name)->GetSection<CookedSubmesh>(MeshCacheSection::Submeshes);
 }
 
-const std::vector<uint16_t>& FbxLoader::GetIndices(const std::string& Name) const
+ArrayView<Meshlet> FbxLoader::GetMeshlets(const std::string& Name) const
 {
-	return Indices.at(Name);
+	return CookedMeshes.at(Name)->GetSection<Meshlet>(MeshCacheSection::Meshlets);
 }
 
 const std::vector<Texture*> FbxLoader::GetTextures(const std::string& Name) const
@@ -424,22 +1212,68 @@ const std::vector<Material*> FbxLoader::GetMaterials(const std::string& Name) co
 	return MatList;
 }
 
-const std::vector<XMMATRIX>& FbxLoader::GetBoneOffsets(const std::string& Name) const
+ArrayView<XMMATRIX> FbxLoader::GetBoneOffsets(const std::string& Name) const
 {
-	return BoneOffsets.at(Name);
+	return CookedMeshes.at(Name)->GetSection<XMMATRIX>(MeshCacheSection::BoneOffsets);
 }
 
-const std::vector<XMMATRIX>& FbxLoader::GetToRootTransforms(const std::string& Name) const
+Skeleton FbxLoader::GetSkeleton(const std::string& Name) const
 {
-	return ToRootTransforms.at(Name);
+	const CookedMesh* Cooked = CookedMeshes.at(Name).get();
+
+	return Skeleton(Cooked->GetSection<int32_t>(MeshCacheSection::SkeletonParents),
+		Cooked->GetSection<XMMATRIX>(MeshCacheSection::BoneOffsets),
+		Cooked->GetSection<BoneTransform>(MeshCacheSection::SkeletonBindPose));
+}
+
+AnimationClip FbxLoader::GetAnimationClip(const std::string& Name) const
+{
+	const CookedMesh* Cooked = CookedMeshes.at(Name).get();
+
+	ArrayView<AnimationClipInfo> Info = Cooked->GetSection<AnimationClipInfo>(MeshCacheSection::AnimationInfo);
+	if (Info.empty())
+	{
+		return AnimationClip();
+	}
+
+	return AnimationClip(Info[0],
+		Cooked->GetSection<AnimationTrack>(MeshCacheSection::AnimationTracks),
+		Cooked->GetSection<RotationKey>(MeshCacheSection::AnimationRotations),
+		Cooked->GetSection<VectorKey>(MeshCacheSection::AnimationTranslations),
+		Cooked->GetSection<VectorKey>(MeshCacheSection::AnimationScales));
 }
 
 const int FbxLoader::GetBoneCount(const std::string& Name) const
 {
-	if (BoneCounts.find(Name) != BoneCounts.end())
+	if (CookedMeshes.find(Name) != CookedMeshes.end())
 	{
-		return BoneCounts.at(Name);
+		return (int)GetBoneOffsets(Name).size();
 	}
 
 	return 0;
 }
+
+uint32_t FbxLoader::GetMaxInfluenceCount(const std::string& Name) const
+{
+	if (GetBoneCount(Name) <= 0)
+	{
+		return 0;
+	}
+
+	// 가지치기할 때 무게 순으로 앞에서부터 채웠으니 0이 아닌 마지막 슬롯만 보면 된다.
+	uint32_t MaxCount = 0;
+	for (const Vertex& V : GetVertices(Name))
+	{
+		const float Weights[4] = { V.BoneWeights.x, V.BoneWeights.y, V.BoneWeights.z, V.BoneWeights.w };
+		for (uint32_t k = 4; k > MaxCount; k--)
+		{
+			if (Weights[k - 1] > 0.0f)
+			{
+				MaxCount = k;
+				break;
+			}
+		}
+	}
+
+	return MaxCount;
+}
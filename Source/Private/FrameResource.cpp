@@ -1,5 +1,6 @@
 #include "FrameResource.h"
 #include "GameObject.h"
+#include "VertexWelder.h"
 
 FrameResource::FrameResource(ID3D12Device* Device, UINT PassCount, UINT MaxInstanceCount, UINT MaterialCount, UINT MaxAnimationCount)
 {
@@ -11,8 +12,14 @@ FrameResource::FrameResource(ID3D12Device* Device, UINT PassCount, UINT MaxInsta
     MaterialBuffer = std::make_unique<UploadBuffer<MaterialData>>(Device, MaterialCount, false);
     InstanceBuffer = std::make_unique<UploadBuffer<InstanceData>>(Device, MaxInstanceCount, false);
     AnimationBuffer = std::make_unique<UploadBuffer<AnimationData>>(Device, MaxAnimationCount, false);
+    AnimationCapacity = MaxAnimationCount;
 }
 
 FrameResource::~FrameResource()
 {
+}
+
+size_t std::hash<Vertex>::operator()(const Vertex& V) const
+{
+    return (size_t)VertexWelder::HashKey(VertexWelder::MakeKey(V, 0.0f));
 }
\ No newline at end of file
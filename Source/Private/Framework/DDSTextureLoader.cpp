@@ -24,6 +24,9 @@
 #include <wrl.h>
 
 #include "Framework/DDSTextureLoader.h" 
+#include "DDSFile.h"
+#include "UploadManager.h"
+#include "GpuHeapAllocator.h"
 
 using namespace Microsoft::WRL;
 
@@ -1269,14 +1272,23 @@ static HRESULT CreateD3DResources12(
 		texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 		texDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-		hr = device->CreateCommittedResource(
-			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-			D3D12_HEAP_FLAG_NONE,
-			&texDesc,
-			D3D12_RESOURCE_STATE_COMMON,
-			nullptr,
-			IID_PPV_ARGS(&texture)
-			);
+		// Place the texture inside a shared texture heap when the engine has one. That path throws on failure.
+		if (GpuHeapAllocator::Get())
+		{
+			texture = GpuHeapAllocator::Get()->CreateResource(GpuMemoryCategory::Texture, texDesc, D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_STATE_COMMON);
+			hr = S_OK;
+		}
+		else
+		{
+			hr = device->CreateCommittedResource(
+				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+				D3D12_HEAP_FLAG_NONE,
+				&texDesc,
+				D3D12_RESOURCE_STATE_COMMON,
+				nullptr,
+				IID_PPV_ARGS(&texture)
+				);
+		}
 
 		if (FAILED(hr))
 		{
@@ -1286,6 +1298,15 @@ static HRESULT CreateD3DResources12(
 		else
 		{
 			const UINT num2DSubresources = texDesc.DepthOrArraySize * texDesc.MipLevels;
+
+			// Stage through the shared upload ring instead of creating a per-texture upload heap.
+			// The copy is recorded with the rest of the batch, so textureUploadHeap stays empty.
+			if (UploadManager::Get())
+			{
+				UploadManager::Get()->UploadSubresources(texture.Get(), 0, num2DSubresources, initData, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+				return S_OK;
+			}
+
 			const UINT64 uploadBufferSize = GetRequiredIntermediateSize(texture.Get(), 0, num2DSubresources);
 
 			hr = device->CreateCommittedResource(
@@ -1873,6 +1894,83 @@ static HRESULT CreateTextureFromDDS12(
 	return hr;
 }
 
+//--------------------------------------------------------------------------------------
+// Points the subresource data straight at the parsed (usually memory-mapped) file, so
+// UpdateSubresources copies each mip from the file view into the upload heap exactly once.
+static HRESULT CreateTextureFromDDSFile12(
+	_In_ ID3D12Device* device,
+	_In_ ID3D12GraphicsCommandList* cmdList,
+	_In_ const DDSFile& file,
+	_In_ size_t maxsize,
+	ComPtr<ID3D12Resource>& texture,
+	ComPtr<ID3D12Resource>& textureUploadHeap)
+{
+	uint32_t resDim = D3D12_RESOURCE_DIMENSION_UNKNOWN;
+	switch (file.GetDimension())
+	{
+	case DDSDimension::Texture1D:
+		resDim = D3D12_RESOURCE_DIMENSION_TEXTURE1D;
+		break;
+	case DDSDimension::Texture2D:
+		resDim = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+		break;
+	case DDSDimension::Texture3D:
+		resDim = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+		break;
+	default:
+		return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+	}
+
+	switch (file.GetFormat())
+	{
+	case DXGI_FORMAT_AI44:
+	case DXGI_FORMAT_IA44:
+	case DXGI_FORMAT_P8:
+	case DXGI_FORMAT_A8P8:
+		return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+	}
+
+	const uint32_t skipMip = file.GetFirstMipWithin(maxsize);
+	const uint32_t mipCount = file.GetMipCount() - skipMip;
+	const uint32_t arraySize = file.GetArraySize();
+
+	std::unique_ptr<D3D12_SUBRESOURCE_DATA[]> initData(
+		new (std::nothrow) D3D12_SUBRESOURCE_DATA[mipCount * arraySize]
+		);
+
+	if (!initData)
+	{
+		return E_OUTOFMEMORY;
+	}
+
+	size_t index = 0;
+	for (uint32_t j = 0; j < arraySize; j++)
+	{
+		for (uint32_t i = skipMip; i < file.GetMipCount(); i++)
+		{
+			const DDSSubresource& subresource = file.GetSubresource(i, j);
+			initData[index].pData = file.GetSubresourceData(i, j);
+			initData[index].RowPitch = subresource.RowBytes;
+			initData[index].SlicePitch = subresource.SliceBytes;
+			++index;
+		}
+	}
+
+	const DDSSubresource& top = file.GetSubresource(skipMip, 0);
+
+	return CreateD3DResources12(
+		device, cmdList,
+		resDim, top.Width, top.Height, top.Depth,
+		mipCount,
+		arraySize,
+		static_cast<DXGI_FORMAT>(file.GetFormat()),
+		false, // forceSRGB
+		file.IsCubeMap(),
+		initData.get(),
+		texture,
+		textureUploadHeap);
+}
+
 //--------------------------------------------------------------------------------------
 static DDS_ALPHA_MODE GetAlphaMode( _In_ const DDS_HEADER* header )
 {
@@ -2160,19 +2258,28 @@ HRESULT DirectX::CreateDDSTextureFromFile12(_In_ ID3D12Device* device,
 		return E_INVALIDARG;
 	}
 
-	DDS_HEADER* header = nullptr;
-	uint8_t* bitData = nullptr;
-	size_t bitSize = 0;
-
-	std::unique_ptr<uint8_t[]> ddsData;
-	HRESULT hr = LoadTextureDataFromFile(szFileName, ddsData, &header, &bitData, &bitSize);
-	if (FAILED(hr))
+	// Map the file instead of reading it into a heap buffer; the view is only needed
+	// until UpdateSubresources has copied the mips into the upload heap.
+	DDSResult result = DDSResult::Ok;
+	std::unique_ptr<DDSFile> file = DDSFile::Open(szFileName, &result);
+	if (!file)
 	{
-		return hr;
+		switch (result)
+		{
+		case DDSResult::FileNotFound:
+			return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+		case DDSResult::Truncated:
+			return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+		case DDSResult::NotSupported:
+			return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+		default:
+			return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+		}
 	}
 
-	hr = CreateTextureFromDDS12(device, cmdList, header,
-		bitData, bitSize, maxsize, false, texture, textureUploadHeap);
+	auto header = reinterpret_cast<const DDS_HEADER*>(file->GetData() + sizeof(uint32_t));
+
+	HRESULT hr = CreateTextureFromDDSFile12(device, cmdList, *file, maxsize, texture, textureUploadHeap);
 
 	if (SUCCEEDED(hr))
 	{
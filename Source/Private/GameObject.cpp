@@ -1,6 +1,7 @@
 #include "GameObject.h"
 #include "Framework/Camera.h"
 #include "Window.h"
+#include "TextureStreamer.h"
 
 GameObject::GameObject(Camera* InCamera)
 	:
@@ -18,18 +19,6 @@ void GameObject::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList
 
 void GameObject::BuildRenderItem(int& InstanceOffset, std::vector<std::unique_ptr<FrameResource>>& FrameResources)
 {
-	for (int i = 0; i < FrameResources.size(); i++)
-	{
-		UploadBuffer<AnimationData>* AnimationBuffer = FrameResources[i]->AnimationBuffer.get();
-
-		for (int j = 0; j < Item->Animations.size(); j++)
-		{
-			AnimationData AnimData;
-			AnimData.FinalTransform = Item->Animations[j].FinalTransform;
-
-			AnimationBuffer->CopyData(j, AnimData);
-		}
-	}
 }
 
 void GameObject::BuildPSO(ID3D12Device* Device, const DXGI_FORMAT& BackBufferFormat, const DXGI_FORMAT& DepthStencilFormat, bool b4xMsaaState, UINT QualityOf4xMsaa)
@@ -76,12 +65,17 @@ void GameObject::UpdateInstanceData(FrameResource* CurFrameResource)
 
 	UploadBuffer<InstanceData>* CurInstanceBuffer = CurFrameResource->InstanceBuffer.get();
 
-	int VisibleInstanceCount = 0;
+	VisibleInstances.clear();
+	CloseUpInstances.clear();
+
+	// 화면에서 가장 크게 보이는 인스턴스 기준으로 필요한 밉을 정한다.
+	const float PixelScale = MainCamera->GetProj4x4f()._22 * (float)WindowManager::Get()->GetFirstWindow()->GetHeight();
+	const float BoundsRadius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&Item->Bounds.Extents)));
+	float MaxProjectedPixels = 0.0f;
 
 	for (int i = 0; i < Item->Instances.size(); i++)
 	{
 		XMMATRIX World = XMLoadFloat4x4(&Item->Instances[i].World);
-		XMMATRIX TexTransform = XMLoadFloat4x4(&Item->Instances[i].TexTransform);
 		XMMATRIX InvWorld = XMMatrixInverse(&XMMatrixDeterminant(World), World);
 		XMMATRIX ViewToLocal = XMMatrixMultiply(InvView, InvWorld);
 
@@ -91,25 +85,93 @@ void GameObject::UpdateInstanceData(FrameResource* CurFrameResource)
 
 		if (LocalSpaceFrustum.Contains(Item->Bounds) != DirectX::DISJOINT)
 		{
-			InstanceData InstData;
-			XMStoreFloat4x4(&InstData.World, XMMatrixTranspose(World));
-			XMStoreFloat4x4(&InstData.TexTransform, XMMatrixTranspose(TexTransform));
-			InstData.MaterialIndex = Item->Instances[i].MaterialIndex;
-
-			CurInstanceBuffer->CopyData(Item->InstanceOffset + VisibleInstanceCount, InstData);
-			++VisibleInstanceCount;
+			XMVECTOR LocalEyePos = XMVector3TransformCoord(XMVectorZero(), ViewToLocal);
+
+			float Distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(LocalEyePos, XMLoadFloat3(&Item->Bounds.Center))));
+			MaxProjectedPixels = std::max<float>(MaxProjectedPixels, BoundsRadius / std::max<float>(Distance, MainCamera->GetNearZ()) * PixelScale);
+
+			if (bUseMeshletCulling && IsCloseUp(LocalEyePos))
+			{
+				ClusterCullInput Input;
+				Input.InstanceIndex = i;
+				Input.LocalFrustum = LocalSpaceFrustum;
+				XMStoreFloat3(&Input.LocalEyePos, LocalEyePos);
+				CloseUpInstances.push_back(Input);
+				continue;
+			}
+
+			VisibleInstances.push_back(i);
 		}
 	}
 
+	if (Tex)
+	{
+		TextureStreamer::Get()->RequestScreenSize(Tex->StreamingHandle, MaxProjectedPixels);
+	}
+
+	const int VisibleInstanceCount = (int)VisibleInstances.size();
+
+	// 가까운 인스턴스는 일반 인스턴스 뒤에 채워 넣는다.
+	for (const ClusterCullInput& Input : CloseUpInstances)
+	{
+		VisibleInstances.push_back(Input.InstanceIndex);
+	}
+
+	// 팔레트 위치가 정해져야 인스턴스 데이터를 쓸 수 있다.
+	UpdateAnimation(CurFrameResource);
+
+	for (int i = 0; i < VisibleInstanceCount; i++)
+	{
+		CopyInstanceData(CurInstanceBuffer, Item->InstanceOffset + i, Item->Instances[VisibleInstances[i]], PaletteOffsets[i]);
+	}
+
 	Item->InstanceCount = VisibleInstanceCount;
+	Item->ClusterDraws.clear();
+
+	UINT VisibleClusterCount = 0;
+	for (int i = 0; i < CloseUpInstances.size(); i++)
+	{
+		const ClusterCullInput& Input = CloseUpInstances[i];
+		int BufferIndex = Item->InstanceOffset + VisibleInstanceCount + i;
+
+		CopyInstanceData(CurInstanceBuffer, BufferIndex, Item->Instances[Input.InstanceIndex], PaletteOffsets[VisibleInstanceCount + i]);
+
+		VisibleClusterCount += MeshletBuilder::Cull(
+			Meshlets,
+			Input.LocalFrustum,
+			XMLoadFloat3(&Input.LocalEyePos),
+			BufferIndex,
+			Item->StartIndexLocation,
+			Item->ClusterDraws);
+	}
 
 	std::wostringstream outs;
 	outs.precision(6);
-	outs << L"보이는 오브젝트: " << Item->InstanceCount << L"    " << L"전체 오브젝트: " << Item->Instances.size();
+	outs << L"보이는 오브젝트: " << Item->InstanceCount + CloseUpInstances.size() << L"    " << L"전체 오브젝트: " << Item->Instances.size();
+	if (bUseMeshletCulling)
+	{
+		outs << L"    " << L"보이는 클러스터: " << VisibleClusterCount << L"/" << Meshlets.size() * CloseUpInstances.size();
+	}
+	AppendStats(outs);
+
+	const TextureStreamingStats& StreamingStats = TextureStreamer::Get()->GetStats();
+	outs << L"    " << L"텍스쳐: " << StreamingStats.ResidentBytes / 1024 << L"/" << StreamingStats.Budget / 1024 << L"KB";
+
+	const TextureCacheStats& CacheStats = TextureManager::Get()->GetStats();
+	outs << L"    " << L"중복 제거: " << CacheStats.SavedBytes / 1024 << L"KB";
 
 	WindowManager::Get()->GetFirstWindow()->SetName(outs.str());
 }
 
+void GameObject::UpdateAnimation(FrameResource* CurFrameResource)
+{
+	PaletteOffsets.assign(VisibleInstances.size(), 0);
+}
+
+void GameObject::AppendStats(std::wostringstream& Stats) const
+{
+}
+
 void GameObject::UpdateMaterialBuffer(FrameResource* CurFrameResource)
 {
 	UploadBuffer<MaterialData>* CurMaterialBuffer = CurFrameResource->MaterialBuffer.get();
@@ -119,6 +181,19 @@ void GameObject::UpdateMaterialBuffer(FrameResource* CurFrameResource)
 		XMMATRIX MatTransform = XMLoadFloat4x4(&Mat->MatTransform);
 
 		MaterialData MatData;
+
+		// 아틀라스에 들어간 텍스쳐는 원래 UV를 자기 칸으로 옮기는 변환을 뒤에 붙인다.
+		if (Tex)
+		{
+			const TexturePlacement& Placement = Tex.GetPlacement();
+			MatTransform = XMMatrixMultiply(MatTransform, XMMatrixMultiply(
+				XMMatrixScaling(Placement.ScaleU, Placement.ScaleV, 1.0f),
+				XMMatrixTranslation(Placement.OffsetU, Placement.OffsetV, 0.0f)));
+
+			MatData.DiffuseMapIndex = (UINT)Tex.GetSrvIndex();
+			MatData.DiffuseMapSlice = Placement.Slice;
+		}
+
 		MatData.DiffuseAlbedo = Mat->DiffuseAlbedo;
 		MatData.FresnelR0 = Mat->FresnelR0;
 		MatData.Roughness = Mat->Roughness;
@@ -130,6 +205,29 @@ void GameObject::UpdateMaterialBuffer(FrameResource* CurFrameResource)
 	}
 }
 
+void GameObject::CopyInstanceData(UploadBuffer<InstanceData>* InstanceBuffer, int BufferIndex, const InstanceData& Instance, UINT PaletteOffset)
+{
+	XMMATRIX World = XMLoadFloat4x4(&Instance.World);
+	XMMATRIX TexTransform = XMLoadFloat4x4(&Instance.TexTransform);
+
+	InstanceData InstData;
+	XMStoreFloat4x4(&InstData.World, XMMatrixTranspose(World));
+	XMStoreFloat4x4(&InstData.TexTransform, XMMatrixTranspose(TexTransform));
+	InstData.MaterialIndex = Instance.MaterialIndex;
+	InstData.PaletteOffset = PaletteOffset;
+
+	InstanceBuffer->CopyData(BufferIndex, InstData);
+}
+
+bool GameObject::IsCloseUp(FXMVECTOR LocalEyePos) const
+{
+	XMVECTOR Center = XMLoadFloat3(&Item->Bounds.Center);
+	float Radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&Item->Bounds.Extents)));
+	float Distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(LocalEyePos, Center)));
+
+	return Distance < Radius * MeshletCullDistanceScale;
+}
+
 void GameObject::Translate(float Dx, float Dy, float Dz)
 {
 	OffsetX = Dx;
@@ -179,7 +277,7 @@ std::string GameObject::GetName() const
 
 Texture* GameObject::GetTexture() const
 {
-	return Tex.get();
+	return Tex.Get();
 }
 
 bool GameObject::UseAnimation() const
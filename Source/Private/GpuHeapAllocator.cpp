@@ -0,0 +1,411 @@
+#include "GpuHeapAllocator.h"
+#include <cassert>
+#include <atomic>
+#include <algorithm>
+#include "Framework/d3dUtil.h"
+
+GpuHeapAllocator* GpuHeapAllocator::Allocator = nullptr;
+
+namespace
+{
+	// 자원에 Allocation을 붙일 때 쓰는 키
+	const GUID AllocationGuid = { 0x6a3c5d2e, 0x41b7, 0x4f0e, { 0x9b, 0x1d, 0x2c, 0x7e, 0x58, 0x03, 0xa4, 0x61 } };
+
+	const char* HeapKindNames[] = { "buffer", "texture", "render target", "upload" };
+
+	UINT64 AlignUp(UINT64 Value, UINT64 Alignment)
+	{
+		return (Value + Alignment - 1) & ~(Alignment - 1);
+	}
+}
+
+class GpuHeapAllocator::Allocation final : public IUnknown
+{
+public:
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID Riid, void** Object) override
+	{
+		if (nullptr == Object)
+		{
+			return E_POINTER;
+		}
+
+		if (Riid == __uuidof(IUnknown))
+		{
+			*Object = static_cast<IUnknown*>(this);
+			AddRef();
+			return S_OK;
+		}
+
+		*Object = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	ULONG STDMETHODCALLTYPE AddRef() override
+	{
+		return ++RefCount;
+	}
+
+	ULONG STDMETHODCALLTYPE Release() override
+	{
+		const ULONG Count = --RefCount;
+		if (0 == Count)
+		{
+			// 종료할 때 할당기가 먼저 사라졌으면 힙도 이미 놓였다.
+			if (GpuHeapAllocator* Owner = GpuHeapAllocator::Get())
+			{
+				Owner->Free(*this);
+			}
+			delete this;
+		}
+		return Count;
+	}
+
+public:
+	HeapKind Kind = HeapKind::Buffer;
+	GpuMemoryCategory Category = GpuMemoryCategory::VertexBuffer;
+	Heap* Owner = nullptr;
+	uint32_t Handle = TlsfAllocator::InvalidHandle;
+	UINT64 Bytes = 0;
+	UINT64 Alignment = 0;
+
+	// 조각 모으기에서 같은 자원을 다시 만들 때 쓴다. 자원을 잡고 있지는 않는다.
+	ID3D12Resource* Resource = nullptr;
+	D3D12_RESOURCE_DESC Desc = {};
+
+private:
+	std::atomic<ULONG> RefCount{ 1 };
+};
+
+GpuHeapAllocator::GpuHeapAllocator()
+{
+	assert(Allocator == nullptr);
+	Allocator = this;
+}
+
+GpuHeapAllocator::~GpuHeapAllocator()
+{
+	Allocator = nullptr;
+}
+
+GpuHeapAllocator* GpuHeapAllocator::Get()
+{
+	return Allocator;
+}
+
+void GpuHeapAllocator::Init(ID3D12Device* InDevice, UINT64 InHeapBytes)
+{
+	Device = InDevice;
+	HeapBytes = std::max<UINT64>(InHeapBytes, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+	// 힙 티어 1은 한 힙에 버퍼, 텍스쳐, 렌더 타깃/깊이를 섞을 수 없다.
+	Pool& Buffers = Pools[(uint32_t)HeapKind::Buffer];
+	Buffers.Type = D3D12_HEAP_TYPE_DEFAULT;
+	Buffers.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+	Buffers.Granularity = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	Buffers.HeapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	Pool& Textures = Pools[(uint32_t)HeapKind::Texture];
+	Textures.Type = D3D12_HEAP_TYPE_DEFAULT;
+	Textures.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+	Textures.Granularity = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+	Textures.HeapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	// MSAA 깊이 버퍼를 넣으려면 힙부터 4MB 정렬이어야 한다.
+	Pool& RenderTargets = Pools[(uint32_t)HeapKind::RenderTarget];
+	RenderTargets.Type = D3D12_HEAP_TYPE_DEFAULT;
+	RenderTargets.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+	RenderTargets.Granularity = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	RenderTargets.HeapAlignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	Pool& Uploads = Pools[(uint32_t)HeapKind::Upload];
+	Uploads.Type = D3D12_HEAP_TYPE_UPLOAD;
+	Uploads.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+	Uploads.Granularity = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	Uploads.HeapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+}
+
+ComPtr<ID3D12Resource> GpuHeapAllocator::CreateResource(GpuMemoryCategory Category, const D3D12_RESOURCE_DESC& Desc, D3D12_HEAP_TYPE HeapType,
+	D3D12_RESOURCE_STATES InitialState, const D3D12_CLEAR_VALUE* ClearValue)
+{
+	const HeapKind Kind = GetKind(Desc, HeapType);
+
+	D3D12_RESOURCE_DESC PlacedDesc = Desc;
+	D3D12_RESOURCE_ALLOCATION_INFO Info = {};
+
+	// 작은 텍스쳐는 4KB 정렬이 되는지 먼저 물어본다. 안 되면 드라이버가 0이 아닌 정렬을 돌려준다.
+	if (Kind == HeapKind::Texture && PlacedDesc.SampleDesc.Count <= 1)
+	{
+		PlacedDesc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+		Info = Device->GetResourceAllocationInfo(0, 1, &PlacedDesc);
+		if (Info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+		{
+			PlacedDesc.Alignment = 0;
+			Info = Device->GetResourceAllocationInfo(0, 1, &PlacedDesc);
+		}
+	}
+	else
+	{
+		PlacedDesc.Alignment = 0;
+		Info = Device->GetResourceAllocationInfo(0, 1, &PlacedDesc);
+	}
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+	EmptyHeaps.clear();
+
+	Heap* Target = nullptr;
+	uint32_t Handle = TlsfAllocator::InvalidHandle;
+	Allocate(Kind, Info.SizeInBytes, Info.Alignment, nullptr, 0, Target, Handle);
+
+	return Place(Kind, Target, Handle, Category, PlacedDesc, Info.SizeInBytes, Info.Alignment, InitialState, ClearValue);
+}
+
+void GpuHeapAllocator::PlanDefragment(GpuMemoryCategory Category, UINT64 MaxBytes, std::vector<GpuRelocation>& OutRelocations)
+{
+	OutRelocations.clear();
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+	EmptyHeaps.clear();
+
+	UINT64 MovedBytes = 0;
+	std::vector<uint32_t> Handles;
+
+	const HeapKind Kinds[] = { HeapKind::Buffer, HeapKind::Texture };
+	for (HeapKind Kind : Kinds)
+	{
+		Pool& Target = Pools[(uint32_t)Kind];
+
+		// 빈 블록이 하나뿐이면 이미 앞으로 붙어 있다.
+		uint32_t FreeBlockCount = 0;
+		for (const std::unique_ptr<Heap>& Candidate : Target.Heaps)
+		{
+			FreeBlockCount += Candidate->Allocator.GetStats().FreeBlockCount;
+		}
+
+		if (FreeBlockCount <= 1)
+		{
+			continue;
+		}
+
+		for (size_t HeapIndex = Target.Heaps.size(); HeapIndex-- > 0;)
+		{
+			Heap* Source = Target.Heaps[HeapIndex].get();
+			Source->Allocator.GetAllocations(Handles);
+
+			for (uint32_t SourceHandle : Handles)
+			{
+				const Allocation* Moving = static_cast<const Allocation*>(Source->Allocator.GetUserData(SourceHandle));
+				if (nullptr == Moving || Moving->Category != Category)
+				{
+					continue;
+				}
+
+				if (MovedBytes + Moving->Bytes > MaxBytes)
+				{
+					return;
+				}
+
+				Heap* Destination = nullptr;
+				uint32_t Handle = TlsfAllocator::InvalidHandle;
+				if (false == Allocate(Kind, Moving->Bytes, Moving->Alignment, Source, Source->Allocator.GetOffset(SourceHandle), Destination, Handle))
+				{
+					continue;
+				}
+
+				GpuRelocation Relocation;
+				Relocation.Old = Moving->Resource;
+				Relocation.New = Place(Kind, Destination, Handle, Category, Moving->Desc, Moving->Bytes, Moving->Alignment, D3D12_RESOURCE_STATE_COPY_DEST, nullptr);
+				OutRelocations.push_back(std::move(Relocation));
+
+				MovedBytes += Moving->Bytes;
+			}
+		}
+	}
+}
+
+GpuMemoryStats GpuHeapAllocator::GetStats(GpuMemoryCategory Category) const
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	return Stats[(uint32_t)Category];
+}
+
+GpuHeapStats GpuHeapAllocator::GetHeapStats() const
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	GpuHeapStats Result;
+	for (const Pool& Each : Pools)
+	{
+		for (const std::unique_ptr<Heap>& Candidate : Each.Heaps)
+		{
+			const TlsfStats& HeapStats = Candidate->Allocator.GetStats();
+			++Result.HeapCount;
+			Result.HeapBytes += HeapStats.Size;
+			Result.UsedBytes += HeapStats.UsedBytes;
+			Result.LargestFreeBlock = std::max(Result.LargestFreeBlock, Candidate->Allocator.GetLargestFreeBlock());
+		}
+	}
+
+	return Result;
+}
+
+const char* GpuHeapAllocator::GetCategoryName(GpuMemoryCategory Category)
+{
+	switch (Category)
+	{
+	case GpuMemoryCategory::VertexBuffer:
+		return "VertexBuffer";
+	case GpuMemoryCategory::IndexBuffer:
+		return "IndexBuffer";
+	case GpuMemoryCategory::Texture:
+		return "Texture";
+	case GpuMemoryCategory::DepthStencil:
+		return "DepthStencil";
+	case GpuMemoryCategory::Upload:
+		return "Upload";
+	default:
+		return "Unknown";
+	}
+}
+
+GpuHeapAllocator::HeapKind GpuHeapAllocator::GetKind(const D3D12_RESOURCE_DESC& Desc, D3D12_HEAP_TYPE HeapType)
+{
+	if (HeapType == D3D12_HEAP_TYPE_UPLOAD)
+	{
+		assert(Desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER);
+		return HeapKind::Upload;
+	}
+
+	assert(HeapType == D3D12_HEAP_TYPE_DEFAULT);
+
+	if (Desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+	{
+		return HeapKind::Buffer;
+	}
+
+	if (Desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+	{
+		return HeapKind::RenderTarget;
+	}
+
+	return HeapKind::Texture;
+}
+
+bool GpuHeapAllocator::Allocate(HeapKind Kind, UINT64 Bytes, UINT64 Alignment, const Heap* Limit, UINT64 LimitOffset, Heap*& OutHeap, uint32_t& OutHandle)
+{
+	Pool& Target = Pools[(uint32_t)Kind];
+
+	for (const std::unique_ptr<Heap>& Candidate : Target.Heaps)
+	{
+		const uint32_t Handle = Candidate->Allocator.Allocate(Bytes, Alignment);
+		const bool bLast = Candidate.get() == Limit;
+
+		if (Handle != TlsfAllocator::InvalidHandle)
+		{
+			// 옮기는 중이면 같은 힙 안에서는 앞으로 가는 자리만 쓴다.
+			if (bLast && Candidate->Allocator.GetOffset(Handle) >= LimitOffset)
+			{
+				Candidate->Allocator.Free(Handle);
+				return false;
+			}
+
+			OutHeap = Candidate.get();
+			OutHandle = Handle;
+			return true;
+		}
+
+		if (bLast)
+		{
+			return false;
+		}
+	}
+
+	if (Limit)
+	{
+		return false;
+	}
+
+	// 기본 크기보다 큰 자원은 그 크기만 한 힙을 따로 받는다.
+	std::unique_ptr<Heap> NewHeap = std::make_unique<Heap>();
+	const UINT64 Size = AlignUp(std::max(HeapBytes, Bytes), Target.HeapAlignment);
+
+	ThrowIfFailed(Device->CreateHeap(&CD3DX12_HEAP_DESC(Size, Target.Type, Target.HeapAlignment, Target.Flags), IID_PPV_ARGS(&NewHeap->Resource)));
+	NewHeap->Allocator.Init(Size, Target.Granularity);
+
+	OutHandle = NewHeap->Allocator.Allocate(Bytes, Alignment);
+	assert(OutHandle != TlsfAllocator::InvalidHandle);
+
+	OutHeap = NewHeap.get();
+	Target.Heaps.push_back(std::move(NewHeap));
+
+	char Message[256];
+	sprintf_s(Message, "[GpuHeapAllocator] new %s heap of %llu KB (%u in the pool)\n",
+		HeapKindNames[(uint32_t)Kind], (unsigned long long)(Size / 1024), (uint32_t)Target.Heaps.size());
+	OutputDebugStringA(Message);
+
+	return true;
+}
+
+ComPtr<ID3D12Resource> GpuHeapAllocator::Place(HeapKind Kind, Heap* Target, uint32_t Handle, GpuMemoryCategory Category, const D3D12_RESOURCE_DESC& Desc,
+	UINT64 Bytes, UINT64 Alignment, D3D12_RESOURCE_STATES InitialState, const D3D12_CLEAR_VALUE* ClearValue)
+{
+	ComPtr<ID3D12Resource> Resource;
+	const HRESULT Result = Device->CreatePlacedResource(Target->Resource.Get(), Target->Allocator.GetOffset(Handle), &Desc, InitialState, ClearValue, IID_PPV_ARGS(&Resource));
+	if (FAILED(Result))
+	{
+		Target->Allocator.Free(Handle);
+		ThrowIfFailed(Result);
+	}
+
+	Allocation* Tracked = new Allocation();
+	Tracked->Kind = Kind;
+	Tracked->Category = Category;
+	Tracked->Owner = Target;
+	Tracked->Handle = Handle;
+	Tracked->Bytes = Bytes;
+	Tracked->Alignment = Alignment;
+	Tracked->Resource = Resource.Get();
+	Tracked->Desc = Desc;
+
+	Target->Allocator.SetUserData(Handle, Tracked);
+
+	// 자원이 참조를 하나 더 잡고, 자원이 사라질 때 놓는다. 여기서 Release가 0이 되면 Mutex를 다시 잡으니 실패하면 직접 푼다.
+	const HRESULT Attached = Resource->SetPrivateDataInterface(AllocationGuid, Tracked);
+	if (FAILED(Attached))
+	{
+		Target->Allocator.Free(Handle);
+		delete Tracked;
+		ThrowIfFailed(Attached);
+	}
+	Tracked->Release();
+
+	GpuMemoryStats& CategoryStats = Stats[(uint32_t)Category];
+	CategoryStats.Bytes += Bytes;
+	CategoryStats.PeakBytes = std::max(CategoryStats.PeakBytes, CategoryStats.Bytes);
+	++CategoryStats.AllocationCount;
+
+	return Resource;
+}
+
+void GpuHeapAllocator::Free(const Allocation& Freed)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	Freed.Owner->Allocator.Free(Freed.Handle);
+
+	GpuMemoryStats& CategoryStats = Stats[(uint32_t)Freed.Category];
+	CategoryStats.Bytes -= Freed.Bytes;
+	--CategoryStats.AllocationCount;
+
+	// 맨 앞 힙은 남겨두고, 나머지는 비면 놓는다.
+	Pool& Target = Pools[(uint32_t)Freed.Kind];
+	if (Freed.Owner->Allocator.IsEmpty() && Target.Heaps.front().get() != Freed.Owner)
+	{
+		auto It = std::find_if(Target.Heaps.begin(), Target.Heaps.end(), [&Freed](const std::unique_ptr<Heap>& Candidate)
+		{
+			return Candidate.get() == Freed.Owner;
+		});
+
+		EmptyHeaps.push_back(std::move(*It));
+		Target.Heaps.erase(It);
+	}
+}
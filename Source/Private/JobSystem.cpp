@@ -0,0 +1,149 @@
+#include "JobSystem.h"
+#include <cassert>
+#include <algorithm>
+
+JobSystem* JobSystem::Jobs = nullptr;
+
+namespace
+{
+	// 메인 스레드는 0번, 워커는 1번부터.
+	thread_local uint32_t CurrentThreadIndex = 0;
+}
+
+JobSystem::JobSystem()
+{
+	assert(Jobs == nullptr);
+	Jobs = this;
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bQuit = true;
+	}
+	WakeCondition.notify_all();
+
+	for (std::thread& Worker : Workers)
+	{
+		Worker.join();
+	}
+
+	Jobs = nullptr;
+}
+
+JobSystem* JobSystem::Get()
+{
+	return Jobs;
+}
+
+void JobSystem::Init(uint32_t WorkerCount)
+{
+	if (0 == WorkerCount)
+	{
+		uint32_t CoreCount = std::thread::hardware_concurrency();
+		WorkerCount = CoreCount > 1 ? CoreCount - 1 : 1;
+	}
+
+	for (uint32_t i = 0; i < WorkerCount; i++)
+	{
+		Workers.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+	}
+}
+
+void JobSystem::ParallelFor(size_t Count, size_t Grain, const std::function<void(size_t Begin, size_t End, uint32_t ThreadIndex)>& Body)
+{
+	if (0 == Count)
+	{
+		return;
+	}
+
+	Grain = std::max<size_t>(Grain, 1);
+	const size_t ChunkCount = (Count + Grain - 1) / Grain;
+
+	if (Workers.empty() || ChunkCount == 1)
+	{
+		Body(0, Count, GetThreadIndex());
+		return;
+	}
+
+	std::shared_ptr<Batch> Job = std::make_shared<Batch>();
+	Job->Body = Body;
+	Job->Count = Count;
+	Job->Grain = Grain;
+	Job->Remaining = Count;
+
+	const size_t HelperCount = std::min(Workers.size(), ChunkCount - 1);
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		for (size_t i = 0; i < HelperCount; i++)
+		{
+			Queue.push_back(Job);
+		}
+	}
+	WakeCondition.notify_all();
+
+	while (RunChunk(*Job))
+	{
+	}
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+	DoneCondition.wait(Lock, [&Job]() { return 0 == Job->Remaining.load(); });
+}
+
+uint32_t JobSystem::GetThreadCount() const
+{
+	return (uint32_t)Workers.size() + 1;
+}
+
+uint32_t JobSystem::GetThreadIndex()
+{
+	return CurrentThreadIndex;
+}
+
+void JobSystem::WorkerMain(uint32_t ThreadIndex)
+{
+	CurrentThreadIndex = ThreadIndex;
+
+	while (true)
+	{
+		std::shared_ptr<Batch> Job;
+		{
+			std::unique_lock<std::mutex> Lock(Mutex);
+			WakeCondition.wait(Lock, [this]() { return bQuit || false == Queue.empty(); });
+
+			if (Queue.empty())
+			{
+				return;
+			}
+
+			Job = std::move(Queue.front());
+			Queue.pop_front();
+		}
+
+		while (RunChunk(*Job))
+		{
+		}
+	}
+}
+
+bool JobSystem::RunChunk(Batch& Job)
+{
+	const size_t Begin = Job.Next.fetch_add(Job.Grain);
+	if (Begin >= Job.Count)
+	{
+		return false;
+	}
+
+	const size_t End = std::min(Begin + Job.Grain, Job.Count);
+	Job.Body(Begin, End, CurrentThreadIndex);
+
+	if (Job.Remaining.fetch_sub(End - Begin) == End - Begin)
+	{
+		// 기다리는 쪽이 조건을 확인한 뒤 잠들기 전에 깨우는 걸 놓치지 않게 락을 잡고 알린다.
+		std::lock_guard<std::mutex> Lock(Mutex);
+		DoneCondition.notify_all();
+	}
+
+	return true;
+}
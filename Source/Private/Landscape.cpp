@@ -2,6 +2,8 @@
 #include "FrameResource.h"
 #include "Framework/GeometryGenerator.h"
 #include "Framework/d3dUtil.h"
+#include "TextureManager.h"
+#include "UploadManager.h"
 
 Landscape::Landscape(Camera* InCamera)
 	:
@@ -17,7 +19,7 @@ Landscape::~Landscape()
 void Landscape::BuildRootSignature(ID3D12Device* Device)
 {
 	CD3DX12_DESCRIPTOR_RANGE TexTable;
-	TexTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 7, 0, 0);
+	TexTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, TextureManager::MaxSrvCount, 0, 0);
 
 	CD3DX12_ROOT_PARAMETER SlotRootParameter[4];
 
@@ -56,15 +58,12 @@ void Landscape::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList*
 	Mat = std::make_unique<Material>();
 	Mat->Name = "LandMat";
 	Mat->MatCBIndex = 0;
-	Mat->DiffuseSrvHeapIndex = 0;
 	Mat->DiffuseAlbedo = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
 	Mat->FresnelR0 = XMFLOAT3(0.02f, 0.02f, 0.02f);
 	Mat->Roughness = 0.3f;
 
-	Tex = std::make_unique<Texture>();
-	Tex->Filename = L"Textures/texture_ground.dds";
-	Tex->Name = "LandTex";
-	ThrowIfFailed(CreateDDSTextureFromFile12(Device, CommandList, Tex->Filename.c_str(), Tex->Resource, Tex->UploadHeap));
+	Tex = TextureManager::Get()->Acquire(CommandList, L"Textures/texture_ground.dds", "LandTex");
+	Mat->DiffuseSrvHeapIndex = Tex.GetSrvIndex();
 
 	XMFLOAT3 Minf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
 	XMFLOAT3 Maxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
@@ -95,6 +94,9 @@ void Landscape::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList*
 	const UINT VBByteSize = (UINT)Vertices.size() * sizeof(Vertex);
 
 	std::vector<std::uint16_t> Indices = Grid.GetIndices16();
+	MeshletBuilder::Build(Vertices, Indices, Meshlets);
+	bUseMeshletCulling = true;
+
 	const UINT IBByteSize = (UINT)Indices.size() * sizeof(std::uint16_t);
 
 	std::unique_ptr<MeshGeometry> Geo = std::make_unique<MeshGeometry>();
@@ -106,8 +108,8 @@ void Landscape::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList*
 	ThrowIfFailed(D3DCreateBlob(IBByteSize, &Geo->IndexBufferCPU));
 	CopyMemory(Geo->IndexBufferCPU->GetBufferPointer(), Indices.data(), IBByteSize);
 
-	Geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(Device, CommandList, Vertices.data(), VBByteSize, Geo->VertexBufferUploader);
-	Geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(Device, CommandList, Indices.data(), IBByteSize, Geo->IndexBufferUploader);
+	Geo->VertexBufferGPU = UploadManager::Get()->CreateBuffer(GpuMemoryCategory::VertexBuffer, Vertices.data(), VBByteSize);
+	Geo->IndexBufferGPU = UploadManager::Get()->CreateBuffer(GpuMemoryCategory::IndexBuffer, Indices.data(), IBByteSize);
 
 	Geo->VertexByteStride = sizeof(Vertex);
 	Geo->VertexBufferByteSize = VBByteSize;
@@ -130,8 +132,14 @@ void Landscape::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList*
 
 void Landscape::BuildShadersAndInputLayout()
 {
-	VSByteCode = d3dUtil::CompileShader(L"Source/Shader/Landscape.hlsl", nullptr, "VSMain", "vs_5_1");
-	PSByteCode = d3dUtil::CompileShader(L"Source/Shader/Landscape.hlsl", nullptr, "PSMain", "ps_5_1");
+	const D3D_SHADER_MACRO Defines[] =
+	{
+		"MAX_SRV_COUNT", TextureManager::GetMaxSrvCountDefine(),
+		nullptr, nullptr
+	};
+
+	VSByteCode = d3dUtil::CompileShader(L"Source/Shader/Landscape.hlsl", Defines, "VSMain", "vs_5_1");
+	PSByteCode = d3dUtil::CompileShader(L"Source/Shader/Landscape.hlsl", Defines, "PSMain", "ps_5_1");
 
 	InputLayout =
 	{
@@ -0,0 +1,176 @@
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <string>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char* FilePath)
+{
+	Close();
+
+	HANDLE NewFile = CreateFileA(FilePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	return Map(NewFile);
+}
+
+bool MappedFile::Open(const wchar_t* FilePath)
+{
+	Close();
+
+	HANDLE NewFile = CreateFileW(FilePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	return Map(NewFile);
+}
+
+bool MappedFile::Map(HANDLE InFile)
+{
+	if (InFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	File = InFile;
+
+	LARGE_INTEGER FileSize = {};
+	if (false == GetFileSizeEx(File, &FileSize) || 0 == FileSize.QuadPart)
+	{
+		Close();
+		return false;
+	}
+
+	Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (nullptr == Mapping)
+	{
+		Close();
+		return false;
+	}
+
+	Data = static_cast<const uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+	if (nullptr == Data)
+	{
+		Close();
+		return false;
+	}
+
+	Size = (size_t)FileSize.QuadPart;
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (Data)
+	{
+		UnmapViewOfFile(Data);
+	}
+
+	if (Mapping)
+	{
+		CloseHandle(Mapping);
+	}
+
+	if (File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(File);
+	}
+
+	File = INVALID_HANDLE_VALUE;
+	Mapping = nullptr;
+	Data = nullptr;
+	Size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const char* FilePath)
+{
+	Close();
+
+	return Map(open(FilePath, O_RDONLY));
+}
+
+bool MappedFile::Open(const wchar_t* FilePath)
+{
+	std::string NarrowPath(wcslen(FilePath) * MB_CUR_MAX + 1, '\0');
+	size_t Length = wcstombs(&NarrowPath[0], FilePath, NarrowPath.size());
+	if (Length == (size_t)-1)
+	{
+		return false;
+	}
+	NarrowPath.resize(Length);
+
+	return Open(NarrowPath.c_str());
+}
+
+bool MappedFile::Map(int InFile)
+{
+	if (InFile < 0)
+	{
+		return false;
+	}
+
+	File = InFile;
+
+	struct stat FileStat;
+	if (fstat(File, &FileStat) != 0 || 0 == FileStat.st_size)
+	{
+		Close();
+		return false;
+	}
+
+	void* View = mmap(nullptr, (size_t)FileStat.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+	if (View == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	Data = static_cast<const uint8_t*>(View);
+	Size = (size_t)FileStat.st_size;
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (Data)
+	{
+		munmap(const_cast<uint8_t*>(Data), Size);
+	}
+
+	if (File >= 0)
+	{
+		close(File);
+	}
+
+	File = -1;
+	Data = nullptr;
+	Size = 0;
+}
+
+#endif
+
+const uint8_t* MappedFile::GetData() const
+{
+	return Data;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return Size;
+}
+
+bool MappedFile::IsOpen() const
+{
+	return nullptr != Data;
+}
@@ -0,0 +1,237 @@
+#include "MeshCache.h"
+#include <cassert>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	const uint64_t SectionAlignment = 16;
+
+	uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+	{
+		return (Value + Alignment - 1) & ~(Alignment - 1);
+	}
+
+	uint32_t GetExpectedElementSize(MeshCacheSection Section)
+	{
+		switch (Section)
+		{
+		case MeshCacheSection::Vertices:
+			return sizeof(Vertex);
+		case MeshCacheSection::Indices:
+			return sizeof(uint32_t);
+		case MeshCacheSection::Submeshes:
+			return sizeof(CookedSubmesh);
+		case MeshCacheSection::Meshlets:
+			return sizeof(Meshlet);
+		case MeshCacheSection::Materials:
+			return sizeof(CookedMaterial);
+		case MeshCacheSection::Textures:
+			return sizeof(CookedTexture);
+		case MeshCacheSection::BoneOffsets:
+			return sizeof(XMMATRIX);
+		case MeshCacheSection::AnimationInfo:
+			return sizeof(AnimationClipInfo);
+		case MeshCacheSection::AnimationTracks:
+			return sizeof(AnimationTrack);
+		case MeshCacheSection::AnimationRotations:
+			return sizeof(RotationKey);
+		case MeshCacheSection::AnimationTranslations:
+		case MeshCacheSection::AnimationScales:
+			return sizeof(VectorKey);
+		case MeshCacheSection::SkeletonParents:
+			return sizeof(int32_t);
+		case MeshCacheSection::SkeletonBindPose:
+			return sizeof(BoneTransform);
+		}
+
+		return 0;
+	}
+}
+
+void MeshCacheWriter::AddSection(MeshCacheSection Section, const void* Data, uint32_t ElementSize, size_t Count)
+{
+	assert(ElementSize == GetExpectedElementSize(Section));
+
+	uint64_t Offset = AlignUp(sizeof(MeshCacheHeader) + Payload.size(), SectionAlignment);
+	uint64_t ByteSize = (uint64_t)ElementSize * Count;
+
+	Payload.resize((size_t)(Offset - sizeof(MeshCacheHeader) + ByteSize), 0);
+	if (ByteSize > 0)
+	{
+		memcpy(&Payload[(size_t)(Offset - sizeof(MeshCacheHeader))], Data, (size_t)ByteSize);
+	}
+
+	MeshCacheSectionDesc& Desc = Header.Sections[(int)Section];
+	Desc.Offset = Offset;
+	Desc.Count = Count;
+	Desc.ElementSize = ElementSize;
+}
+
+std::vector<uint8_t> MeshCacheWriter::Finish(uint64_t SourceHash)
+{
+	for (int i = 0; i < (int)MeshCacheSection::Count; i++)
+	{
+		// 비어 있는 섹션도 크기는 적어둬야 읽을 때 레이아웃 검사를 통과한다.
+		if (0 == Header.Sections[i].ElementSize)
+		{
+			Header.Sections[i].ElementSize = GetExpectedElementSize((MeshCacheSection)i);
+			Header.Sections[i].Offset = 0;
+		}
+	}
+
+	Header.SourceHash = SourceHash;
+	Header.FileSize = sizeof(MeshCacheHeader) + Payload.size();
+
+	std::vector<uint8_t> Bytes((size_t)Header.FileSize);
+	memcpy(Bytes.data(), &Header, sizeof(MeshCacheHeader));
+	if (false == Payload.empty())
+	{
+		memcpy(Bytes.data() + sizeof(MeshCacheHeader), Payload.data(), Payload.size());
+	}
+
+	return Bytes;
+}
+
+std::unique_ptr<CookedMesh> CookedMesh::Open(const std::string& CookedPath, uint64_t SourceHash)
+{
+	std::unique_ptr<CookedMesh> Mesh = std::make_unique<CookedMesh>();
+	if (false == Mesh->File.Open(CookedPath.c_str()))
+	{
+		return nullptr;
+	}
+
+	if (false == Mesh->Validate(Mesh->File.GetData(), Mesh->File.GetSize(), SourceHash))
+	{
+		return nullptr;
+	}
+
+	return Mesh;
+}
+
+std::unique_ptr<CookedMesh> CookedMesh::FromMemory(std::vector<uint8_t>&& Bytes)
+{
+	if (Bytes.size() < sizeof(MeshCacheHeader))
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<CookedMesh> Mesh = std::make_unique<CookedMesh>();
+	Mesh->Memory = std::move(Bytes);
+
+	uint64_t SourceHash = reinterpret_cast<const MeshCacheHeader*>(Mesh->Memory.data())->SourceHash;
+	if (false == Mesh->Validate(Mesh->Memory.data(), Mesh->Memory.size(), SourceHash))
+	{
+		return nullptr;
+	}
+
+	return Mesh;
+}
+
+bool CookedMesh::Write(const std::string& CookedPath, const std::vector<uint8_t>& Bytes)
+{
+	size_t Separator = CookedPath.find_last_of("/\\");
+	if (Separator != std::string::npos)
+	{
+		CreateDirectoryA(CookedPath.substr(0, Separator).c_str(), nullptr);
+	}
+
+	// 중간에 죽어도 반쯤 쓰인 캐시를 읽지 않게 임시 파일에 다 쓴 다음 이름을 바꾼다.
+	std::string TempPath = CookedPath + ".tmp";
+	{
+		std::ofstream Stream(TempPath, std::ios::binary | std::ios::trunc);
+		if (false == Stream.is_open())
+		{
+			return false;
+		}
+
+		Stream.write(reinterpret_cast<const char*>(Bytes.data()), Bytes.size());
+		if (false == Stream.good())
+		{
+			return false;
+		}
+	}
+
+	std::remove(CookedPath.c_str());
+	return 0 == std::rename(TempPath.c_str(), CookedPath.c_str());
+}
+
+uint64_t CookedMesh::HashBytes(const uint8_t* Data, size_t Size)
+{
+	const uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+	const uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+	const uint64_t Prime3 = 0x165667B19E3779F9ull;
+
+	uint64_t Hash = Prime3 + Size;
+
+	size_t Offset = 0;
+	for (; Offset + 8 <= Size; Offset += 8)
+	{
+		uint64_t Word;
+		memcpy(&Word, Data + Offset, sizeof(Word));
+
+		Hash ^= Word * Prime1;
+		Hash = ((Hash << 31) | (Hash >> 33)) * Prime2;
+	}
+
+	for (; Offset < Size; Offset++)
+	{
+		Hash ^= Data[Offset] * Prime3;
+		Hash = ((Hash << 11) | (Hash >> 53)) * Prime1;
+	}
+
+	Hash ^= Hash >> 33;
+	Hash *= Prime2;
+	Hash ^= Hash >> 29;
+	Hash *= Prime3;
+	Hash ^= Hash >> 32;
+
+	return Hash;
+}
+
+uint64_t CookedMesh::GetSourceHash() const
+{
+	return Header->SourceHash;
+}
+
+size_t CookedMesh::GetByteSize() const
+{
+	return Size;
+}
+
+bool CookedMesh::Validate(const uint8_t* InBase, size_t InSize, uint64_t SourceHash)
+{
+	if (InSize < sizeof(MeshCacheHeader))
+	{
+		return false;
+	}
+
+	const MeshCacheHeader* InHeader = reinterpret_cast<const MeshCacheHeader*>(InBase);
+	if (InHeader->Magic != MeshCacheHeader::MagicValue ||
+		InHeader->Version != MeshCacheHeader::CurrentVersion ||
+		InHeader->SourceHash != SourceHash ||
+		InHeader->FileSize != InSize)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < (int)MeshCacheSection::Count; i++)
+	{
+		const MeshCacheSectionDesc& Desc = InHeader->Sections[i];
+
+		if (Desc.ElementSize != GetExpectedElementSize((MeshCacheSection)i) ||
+			Desc.Offset % SectionAlignment != 0 ||
+			Desc.Offset > InSize ||
+			Desc.Count > (InSize - Desc.Offset) / Desc.ElementSize)
+		{
+			return false;
+		}
+	}
+
+	Base = InBase;
+	Size = InSize;
+	Header = InHeader;
+
+	return true;
+}
@@ -0,0 +1,294 @@
+#include "Meshlet.h"
+#include <climits>
+#include <cmath>
+
+template<typename IndexType>
+void MeshletBuilder::Build(const std::vector<Vertex>& Vertices, std::vector<IndexType>& Indices, std::vector<Meshlet>& OutMeshlets)
+{
+	OutMeshlets.clear();
+
+	const UINT TriangleCount = (UINT)Indices.size() / 3;
+	if (0 == TriangleCount)
+	{
+		return;
+	}
+
+	// Vertex -> Triangle 인접 리스트
+	std::vector<UINT> AdjacencyOffsets(Vertices.size() + 1, 0);
+	for (UINT i = 0; i < TriangleCount * 3; i++)
+	{
+		AdjacencyOffsets[Indices[i] + 1]++;
+	}
+	for (size_t i = 1; i < AdjacencyOffsets.size(); i++)
+	{
+		AdjacencyOffsets[i] += AdjacencyOffsets[i - 1];
+	}
+
+	std::vector<UINT> AdjacencyTriangles(TriangleCount * 3);
+	std::vector<UINT> FillOffsets(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+	for (UINT i = 0; i < TriangleCount; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			AdjacencyTriangles[FillOffsets[Indices[i * 3 + j]]++] = i;
+		}
+	}
+
+	std::vector<bool> Emitted(TriangleCount, false);
+	std::vector<int> VertexMeshlet(Vertices.size(), -1);
+
+	std::vector<IndexType> Reordered;
+	Reordered.reserve(TriangleCount * 3);
+
+	std::vector<IndexType> MeshletVertices;
+	MeshletVertices.reserve(MaxVertices);
+
+	UINT Seed = 0;
+	while (true)
+	{
+		while (Seed < TriangleCount && Emitted[Seed])
+		{
+			Seed++;
+		}
+
+		if (Seed == TriangleCount)
+		{
+			break;
+		}
+
+		const int MeshletIndex = (int)OutMeshlets.size();
+
+		Meshlet Current;
+		Current.StartIndexLocation = (UINT)Reordered.size();
+
+		MeshletVertices.clear();
+		UINT MeshletTriangleCount = 0;
+		UINT Triangle = Seed;
+
+		while (Triangle != UINT_MAX)
+		{
+			for (int j = 0; j < 3; j++)
+			{
+				IndexType Index = Indices[Triangle * 3 + j];
+				if (VertexMeshlet[Index] != MeshletIndex)
+				{
+					VertexMeshlet[Index] = MeshletIndex;
+					MeshletVertices.push_back(Index);
+				}
+				Reordered.push_back(Index);
+			}
+
+			Emitted[Triangle] = true;
+			MeshletTriangleCount++;
+
+			if (MeshletTriangleCount == MaxTriangles)
+			{
+				break;
+			}
+
+			// 이미 들어간 정점을 가장 많이 공유하는 삼각형을 다음으로 고른다.
+			UINT Best = UINT_MAX;
+			UINT BestNewVertices = 4;
+			for (IndexType MeshletVertex : MeshletVertices)
+			{
+				for (UINT i = AdjacencyOffsets[MeshletVertex]; i < AdjacencyOffsets[MeshletVertex + 1]; i++)
+				{
+					UINT Candidate = AdjacencyTriangles[i];
+					if (Emitted[Candidate])
+					{
+						continue;
+					}
+
+					UINT NewVertices = 0;
+					for (int j = 0; j < 3; j++)
+					{
+						if (VertexMeshlet[Indices[Candidate * 3 + j]] != MeshletIndex)
+						{
+							NewVertices++;
+						}
+					}
+
+					if (NewVertices < BestNewVertices)
+					{
+						Best = Candidate;
+						BestNewVertices = NewVertices;
+					}
+				}
+			}
+
+			if (Best != UINT_MAX && MeshletVertices.size() + BestNewVertices > MaxVertices)
+			{
+				Best = UINT_MAX;
+			}
+
+			Triangle = Best;
+		}
+
+		Current.IndexCount = MeshletTriangleCount * 3;
+		Current.VertexCount = (UINT)MeshletVertices.size();
+		ComputeBounds(Vertices, &Reordered[Current.StartIndexLocation], MeshletTriangleCount, Current);
+
+		OutMeshlets.push_back(Current);
+	}
+
+	Indices.swap(Reordered);
+}
+
+UINT MeshletBuilder::Cull(const std::vector<Meshlet>& Meshlets,
+	const BoundingFrustum& LocalFrustum,
+	FXMVECTOR LocalEyePos,
+	UINT InstanceIndex,
+	UINT BaseIndexLocation,
+	std::vector<ClusterDrawRange>& OutRanges)
+{
+	UINT VisibleCount = 0;
+
+	ClusterDrawRange Range;
+	bool bRangeOpen = false;
+
+	for (const Meshlet& Cluster : Meshlets)
+	{
+		bool bVisible = LocalFrustum.Contains(Cluster.Bounds) != DirectX::DISJOINT;
+
+		if (bVisible && Cluster.ConeCutoff < 1.0f)
+		{
+			XMVECTOR Apex = XMLoadFloat3(&Cluster.ConeApex);
+			XMVECTOR Axis = XMLoadFloat3(&Cluster.ConeAxis);
+			XMVECTOR EyeToApex = XMVector3Normalize(XMVectorSubtract(Apex, LocalEyePos));
+
+			bVisible = XMVectorGetX(XMVector3Dot(EyeToApex, Axis)) < Cluster.ConeCutoff;
+		}
+
+		if (false == bVisible)
+		{
+			if (bRangeOpen)
+			{
+				OutRanges.push_back(Range);
+				bRangeOpen = false;
+			}
+			continue;
+		}
+
+		++VisibleCount;
+
+		const UINT StartIndexLocation = BaseIndexLocation + Cluster.StartIndexLocation;
+		if (bRangeOpen && Range.StartIndexLocation + Range.IndexCount == StartIndexLocation)
+		{
+			Range.IndexCount += Cluster.IndexCount;
+		}
+		else
+		{
+			if (bRangeOpen)
+			{
+				OutRanges.push_back(Range);
+			}
+
+			Range.InstanceIndex = InstanceIndex;
+			Range.StartIndexLocation = StartIndexLocation;
+			Range.IndexCount = Cluster.IndexCount;
+			bRangeOpen = true;
+		}
+	}
+
+	if (bRangeOpen)
+	{
+		OutRanges.push_back(Range);
+	}
+
+	return VisibleCount;
+}
+
+template<typename IndexType>
+void MeshletBuilder::ComputeBounds(const std::vector<Vertex>& Vertices, const IndexType* Triangles, UINT TriangleCount, Meshlet& OutMeshlet)
+{
+	std::vector<XMFLOAT3> Points(TriangleCount * 3);
+	for (UINT i = 0; i < TriangleCount * 3; i++)
+	{
+		Points[i] = Vertices[Triangles[i]].Pos;
+	}
+	BoundingSphere::CreateFromPoints(OutMeshlet.Bounds, Points.size(), Points.data(), sizeof(XMFLOAT3));
+
+	XMVECTOR Normals[MaxTriangles];
+	bool bValid[MaxTriangles];
+	XMVECTOR AxisSum = XMVectorZero();
+	UINT ValidCount = 0;
+
+	for (UINT i = 0; i < TriangleCount; i++)
+	{
+		const Vertex& V0 = Vertices[Triangles[i * 3 + 0]];
+		const Vertex& V1 = Vertices[Triangles[i * 3 + 1]];
+		const Vertex& V2 = Vertices[Triangles[i * 3 + 2]];
+
+		XMVECTOR P0 = XMLoadFloat3(&V0.Pos);
+		XMVECTOR Normal = XMVector3Cross(XMVectorSubtract(XMLoadFloat3(&V1.Pos), P0), XMVectorSubtract(XMLoadFloat3(&V2.Pos), P0));
+		float Length = XMVectorGetX(XMVector3Length(Normal));
+
+		bValid[i] = Length > 1e-8f;
+		if (false == bValid[i])
+		{
+			continue;
+		}
+
+		Normal = XMVectorScale(Normal, 1.0f / Length);
+
+		// 와인딩 규칙에 상관없이 정점 노멀 쪽을 바깥으로 본다.
+		XMVECTOR VertexNormal = XMLoadFloat3(&V0.Normal) + XMLoadFloat3(&V1.Normal) + XMLoadFloat3(&V2.Normal);
+		if (XMVectorGetX(XMVector3Dot(Normal, VertexNormal)) < 0.0f)
+		{
+			Normal = XMVectorNegate(Normal);
+		}
+
+		Normals[i] = Normal;
+		AxisSum = XMVectorAdd(AxisSum, Normal);
+		ValidCount++;
+	}
+
+	float AxisLength = XMVectorGetX(XMVector3Length(AxisSum));
+	if (0 == ValidCount || AxisLength < 1e-8f)
+	{
+		return;
+	}
+
+	XMVECTOR Axis = XMVectorScale(AxisSum, 1.0f / AxisLength);
+
+	float MinDot = 1.0f;
+	for (UINT i = 0; i < TriangleCount; i++)
+	{
+		if (bValid[i])
+		{
+			MinDot = MathHelper::Min(MinDot, XMVectorGetX(XMVector3Dot(Axis, Normals[i])));
+		}
+	}
+
+	XMStoreFloat3(&OutMeshlet.ConeAxis, Axis);
+
+	// 노멀이 너무 퍼져 있으면 콘으로 걸러낼 수 없다.
+	if (MinDot <= 0.1f)
+	{
+		OutMeshlet.ConeCutoff = 1.0f;
+		OutMeshlet.ConeApex = OutMeshlet.Bounds.Center;
+		return;
+	}
+
+	XMVECTOR Center = XMLoadFloat3(&OutMeshlet.Bounds.Center);
+
+	float MaxT = 0.0f;
+	for (UINT i = 0; i < TriangleCount; i++)
+	{
+		if (false == bValid[i])
+		{
+			continue;
+		}
+
+		XMVECTOR P0 = XMLoadFloat3(&Vertices[Triangles[i * 3]].Pos);
+		float Dc = XMVectorGetX(XMVector3Dot(XMVectorSubtract(Center, P0), Normals[i]));
+		float Dn = XMVectorGetX(XMVector3Dot(Axis, Normals[i]));
+		MaxT = MathHelper::Max(MaxT, Dc / Dn);
+	}
+
+	XMStoreFloat3(&OutMeshlet.ConeApex, XMVectorSubtract(Center, XMVectorScale(Axis, MaxT)));
+	OutMeshlet.ConeCutoff = sqrtf(1.0f - MinDot * MinDot);
+}
+
+template void MeshletBuilder::Build<uint16_t>(const std::vector<Vertex>& Vertices, std::vector<uint16_t>& Indices, std::vector<Meshlet>& OutMeshlets);
+template void MeshletBuilder::Build<uint32_t>(const std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices, std::vector<Meshlet>& OutMeshlets);
@@ -0,0 +1,381 @@
+#include "MipGenerator.h"
+#include <emmintrin.h>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "JobSystem.h"
+
+namespace
+{
+	// 카이저 창을 씌운 sinc. 반지름은 출력 픽셀 3개, 알파 4.
+	const float KaiserRadius = 3.0f;
+	const float KaiserAlpha = 4.0f;
+
+	// 선형 → sRGB 표. 어두운 쪽에서도 8비트 한 칸보다 촘촘하게 잡는다.
+	const int LinearToSRGBSteps = 8192;
+
+	// 출력 행 하나당 필요한 입력 행까지 한 번에 가로로 걸러두는 묶음 크기(출력 픽셀 수 기준)
+	const size_t BandPixels = 65536;
+
+	struct ColorTables
+	{
+		float SRGBToLinear[256];
+		float UnormToFloat[256];
+		uint8_t LinearToSRGB[LinearToSRGBSteps + 1];
+
+		ColorTables()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				const float Value = i / 255.0f;
+				SRGBToLinear[i] = Value <= 0.04045f ? Value / 12.92f : std::pow((Value + 0.055f) / 1.055f, 2.4f);
+				UnormToFloat[i] = Value;
+			}
+
+			for (int i = 0; i <= LinearToSRGBSteps; i++)
+			{
+				const float Value = (float)i / LinearToSRGBSteps;
+				const float Encoded = Value <= 0.0031308f ? Value * 12.92f : 1.055f * std::pow(Value, 1.0f / 2.4f) - 0.055f;
+				LinearToSRGB[i] = (uint8_t)std::min(255.0f, std::floor(Encoded * 255.0f + 0.5f));
+			}
+		}
+	};
+
+	const ColorTables& GetColorTables()
+	{
+		static const ColorTables Tables;
+		return Tables;
+	}
+
+	// 출력 좌표 하나마다 읽을 입력 좌표와 가중치. 탭 수를 맞추려고 남는 자리는 가중치 0으로 채운다.
+	struct FilterTable
+	{
+		uint32_t TapCount = 0;
+		std::vector<uint32_t> Indices;
+		std::vector<float> Weights;
+	};
+
+	float BesselI0(float Value)
+	{
+		float Sum = 1.0f;
+		float Term = 1.0f;
+		const float Half = Value * 0.5f;
+		for (int k = 1; k < 32 && Term > Sum * 1e-8f; k++)
+		{
+			Term *= (Half / k) * (Half / k);
+			Sum += Term;
+		}
+		return Sum;
+	}
+
+	float EvaluateKaiser(float Offset)
+	{
+		if (std::fabs(Offset) >= KaiserRadius)
+		{
+			return 0.0f;
+		}
+
+		const float Pi = 3.14159265358979f;
+		const float Sinc = std::fabs(Offset) < 1e-6f ? 1.0f : std::sin(Pi * Offset) / (Pi * Offset);
+		const float Ratio = Offset / KaiserRadius;
+
+		return Sinc * BesselI0(KaiserAlpha * std::sqrt(1.0f - Ratio * Ratio)) / BesselI0(KaiserAlpha);
+	}
+
+	uint32_t AddressTap(int Index, uint32_t Size, bool bWrap)
+	{
+		if (bWrap)
+		{
+			const int Wrapped = Index % (int)Size;
+			return (uint32_t)(Wrapped < 0 ? Wrapped + (int)Size : Wrapped);
+		}
+
+		return (uint32_t)std::min(std::max(Index, 0), (int)Size - 1);
+	}
+
+	FilterTable BuildFilterTable(uint32_t SourceSize, uint32_t DestSize, MipFilter Filter, bool bWrap)
+	{
+		const float Scale = (float)SourceSize / DestSize;
+
+		// 상자는 출력 픽셀이 덮는 입력 구간 그대로, 카이저는 반지름을 입력 픽셀 단위로 늘린다.
+		const float Support = Filter == MipFilter::Box ? Scale * 0.5f : KaiserRadius * Scale;
+
+		FilterTable Table;
+		Table.TapCount = 1;
+		for (uint32_t Dest = 0; Dest < DestSize && SourceSize > 1; Dest++)
+		{
+			const float Center = (Dest + 0.5f) * Scale;
+			Table.TapCount = std::max<uint32_t>(Table.TapCount, (uint32_t)(std::ceil(Center + Support) - std::floor(Center - Support)));
+		}
+
+		Table.Indices.assign((size_t)DestSize * Table.TapCount, 0);
+		Table.Weights.assign((size_t)DestSize * Table.TapCount, 0.0f);
+
+		for (uint32_t Dest = 0; Dest < DestSize; Dest++)
+		{
+			const float Center = (Dest + 0.5f) * Scale;
+			const int First = (int)std::floor(Center - Support);
+
+			uint32_t* Indices = &Table.Indices[(size_t)Dest * Table.TapCount];
+			float* Weights = &Table.Weights[(size_t)Dest * Table.TapCount];
+
+			float Sum = 0.0f;
+			for (uint32_t Tap = 0; Tap < Table.TapCount; Tap++)
+			{
+				const int Source = First + (int)Tap;
+
+				float Weight = 0.0f;
+				if (SourceSize == 1)
+				{
+					Weight = 1.0f;
+				}
+				else if (Filter == MipFilter::Box)
+				{
+					const float Low = std::max(Center - Support, (float)Source);
+					const float High = std::min(Center + Support, (float)Source + 1.0f);
+					Weight = std::max(High - Low, 0.0f);
+				}
+				else
+				{
+					Weight = EvaluateKaiser((Source + 0.5f - Center) / Scale);
+				}
+
+				Indices[Tap] = AddressTap(Source, SourceSize, bWrap);
+				Weights[Tap] = Weight;
+				Sum += Weight;
+			}
+
+			for (uint32_t Tap = 0; Tap < Table.TapCount; Tap++)
+			{
+				Weights[Tap] /= Sum;
+			}
+		}
+
+		return Table;
+	}
+
+	// 8비트 한 행을 선형 float RGBA로 푼다.
+	void DecodeRow(const uint8_t* Source, uint32_t Width, bool bSRGB, float* Out)
+	{
+		const ColorTables& Tables = GetColorTables();
+		const float* ColorTable = bSRGB ? Tables.SRGBToLinear : Tables.UnormToFloat;
+
+		for (uint32_t X = 0; X < Width; X++)
+		{
+			Out[X * 4 + 0] = ColorTable[Source[X * 4 + 0]];
+			Out[X * 4 + 1] = ColorTable[Source[X * 4 + 1]];
+			Out[X * 4 + 2] = ColorTable[Source[X * 4 + 2]];
+			Out[X * 4 + 3] = Tables.UnormToFloat[Source[X * 4 + 3]];
+		}
+	}
+
+	// 선형 float RGBA 한 행을 8비트로 담는다. 카이저는 음수 꼬리가 있어서 [0, 1]로 자른다.
+	void EncodeRow(const float* Source, uint32_t Width, bool bSRGB, uint8_t* Out)
+	{
+		const ColorTables& Tables = GetColorTables();
+		const __m128 Zero = _mm_setzero_ps();
+		const __m128 One = _mm_set1_ps(1.0f);
+		const __m128 UnormScale = _mm_set1_ps(255.0f);
+		const __m128 TableScale = _mm_set1_ps((float)LinearToSRGBSteps);
+
+		for (uint32_t X = 0; X < Width; X++)
+		{
+			const __m128 Pixel = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(Source + X * 4), Zero), One);
+			const __m128i Unorm = _mm_cvtps_epi32(_mm_mul_ps(Pixel, UnormScale));
+
+			if (bSRGB)
+			{
+				alignas(16) int32_t Steps[4];
+				_mm_store_si128((__m128i*)Steps, _mm_cvtps_epi32(_mm_mul_ps(Pixel, TableScale)));
+
+				Out[X * 4 + 0] = Tables.LinearToSRGB[Steps[0]];
+				Out[X * 4 + 1] = Tables.LinearToSRGB[Steps[1]];
+				Out[X * 4 + 2] = Tables.LinearToSRGB[Steps[2]];
+				Out[X * 4 + 3] = (uint8_t)_mm_cvtsi128_si32(_mm_srli_si128(Unorm, 12));
+			}
+			else
+			{
+				const __m128i Packed = _mm_packus_epi16(_mm_packs_epi32(Unorm, Unorm), Unorm);
+				const int32_t Bytes = _mm_cvtsi128_si32(Packed);
+				memcpy(Out + X * 4, &Bytes, 4);
+			}
+		}
+	}
+
+	void FilterRowHorizontal(const float* Source, const FilterTable& Table, uint32_t DestWidth, float* Out)
+	{
+		for (uint32_t X = 0; X < DestWidth; X++)
+		{
+			const uint32_t* Indices = &Table.Indices[(size_t)X * Table.TapCount];
+			const float* Weights = &Table.Weights[(size_t)X * Table.TapCount];
+
+			__m128 Sum = _mm_setzero_ps();
+			for (uint32_t Tap = 0; Tap < Table.TapCount; Tap++)
+			{
+				Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_loadu_ps(Source + Indices[Tap] * 4), _mm_set1_ps(Weights[Tap])));
+			}
+
+			_mm_storeu_ps(Out + X * 4, Sum);
+		}
+	}
+
+	// 밉 하나를 만드는 데 필요한 것. 첫 밉은 8비트 원본에서, 그 뒤는 앞 밉의 선형 float에서 읽는다.
+	struct LevelJob
+	{
+		const uint8_t* SourcePixels = nullptr;
+		size_t SourceRowPitch = 0;
+		const float* SourceLinear = nullptr;
+
+		uint32_t SourceWidth = 0;
+		uint32_t SourceHeight = 0;
+		uint32_t DestWidth = 0;
+		uint32_t DestHeight = 0;
+
+		FilterTable Horizontal;
+		FilterTable Vertical;
+
+		bool bSRGB = false;
+
+		// 다음 밉의 입력. 마지막 밉이면 nullptr
+		float* OutLinear = nullptr;
+		uint8_t* OutPixels = nullptr;
+	};
+
+	void FilterBand(const LevelJob& Job, uint32_t Begin, uint32_t End)
+	{
+		const size_t SourceRowFloats = (size_t)Job.SourceWidth * 4;
+		const size_t DestRowFloats = (size_t)Job.DestWidth * 4;
+
+		// 이 묶음이 읽는 입력 행만 가로로 걸러둔다. 감싸기 때문에 연속 구간이 아닐 수 있다.
+		std::vector<int32_t> SlotOfRow(Job.SourceHeight, -1);
+		std::vector<uint32_t> Rows;
+		for (uint32_t Y = Begin; Y < End; Y++)
+		{
+			for (uint32_t Tap = 0; Tap < Job.Vertical.TapCount; Tap++)
+			{
+				const uint32_t Row = Job.Vertical.Indices[(size_t)Y * Job.Vertical.TapCount + Tap];
+				if (SlotOfRow[Row] < 0)
+				{
+					SlotOfRow[Row] = (int32_t)Rows.size();
+					Rows.push_back(Row);
+				}
+			}
+		}
+
+		std::vector<float> Filtered(Rows.size() * DestRowFloats);
+		std::vector<float> Decoded(Job.SourcePixels ? SourceRowFloats : 0);
+
+		for (size_t Slot = 0; Slot < Rows.size(); Slot++)
+		{
+			const float* Source = nullptr;
+			if (Job.SourcePixels)
+			{
+				DecodeRow(Job.SourcePixels + Rows[Slot] * Job.SourceRowPitch, Job.SourceWidth, Job.bSRGB, Decoded.data());
+				Source = Decoded.data();
+			}
+			else
+			{
+				Source = Job.SourceLinear + Rows[Slot] * SourceRowFloats;
+			}
+
+			FilterRowHorizontal(Source, Job.Horizontal, Job.DestWidth, Filtered.data() + Slot * DestRowFloats);
+		}
+
+		std::vector<float> Scratch(Job.OutLinear ? 0 : DestRowFloats);
+
+		for (uint32_t Y = Begin; Y < End; Y++)
+		{
+			float* Out = Job.OutLinear ? Job.OutLinear + Y * DestRowFloats : Scratch.data();
+			std::fill(Out, Out + DestRowFloats, 0.0f);
+
+			for (uint32_t Tap = 0; Tap < Job.Vertical.TapCount; Tap++)
+			{
+				const size_t Entry = (size_t)Y * Job.Vertical.TapCount + Tap;
+				const float* Source = Filtered.data() + SlotOfRow[Job.Vertical.Indices[Entry]] * DestRowFloats;
+				const __m128 Weight = _mm_set1_ps(Job.Vertical.Weights[Entry]);
+
+				for (size_t i = 0; i < DestRowFloats; i += 4)
+				{
+					_mm_storeu_ps(Out + i, _mm_add_ps(_mm_loadu_ps(Out + i), _mm_mul_ps(_mm_loadu_ps(Source + i), Weight)));
+				}
+			}
+
+			EncodeRow(Out, Job.DestWidth, Job.bSRGB, Job.OutPixels + (size_t)Y * Job.DestWidth * 4);
+		}
+	}
+}
+
+void MipGenerator::Generate(const uint8_t* Pixels, uint32_t Width, uint32_t Height, size_t RowPitch, const MipGenerationOptions& Options, std::vector<std::vector<uint8_t>>& OutMips)
+{
+	const uint32_t MipCount = GetMipCount(Width, Height);
+
+	OutMips.resize(MipCount);
+	OutMips[0].resize((size_t)Width * Height * 4);
+	for (uint32_t Y = 0; Y < Height; Y++)
+	{
+		memcpy(OutMips[0].data() + (size_t)Y * Width * 4, Pixels + Y * RowPitch, (size_t)Width * 4);
+	}
+
+	std::vector<float> PreviousLinear;
+	std::vector<float> CurrentLinear;
+
+	for (uint32_t Mip = 1; Mip < MipCount; Mip++)
+	{
+		LevelJob Job;
+		Job.SourceWidth = std::max<uint32_t>(1, Width >> (Mip - 1));
+		Job.SourceHeight = std::max<uint32_t>(1, Height >> (Mip - 1));
+		Job.DestWidth = std::max<uint32_t>(1, Width >> Mip);
+		Job.DestHeight = std::max<uint32_t>(1, Height >> Mip);
+		Job.Horizontal = BuildFilterTable(Job.SourceWidth, Job.DestWidth, Options.Filter, Options.bWrap);
+		Job.Vertical = BuildFilterTable(Job.SourceHeight, Job.DestHeight, Options.Filter, Options.bWrap);
+		Job.bSRGB = Options.bSRGB;
+
+		if (Mip == 1)
+		{
+			Job.SourcePixels = Pixels;
+			Job.SourceRowPitch = RowPitch;
+		}
+		else
+		{
+			Job.SourceLinear = PreviousLinear.data();
+		}
+
+		if (Mip + 1 < MipCount)
+		{
+			CurrentLinear.resize((size_t)Job.DestWidth * Job.DestHeight * 4);
+			Job.OutLinear = CurrentLinear.data();
+		}
+
+		OutMips[Mip].resize((size_t)Job.DestWidth * Job.DestHeight * 4);
+		Job.OutPixels = OutMips[Mip].data();
+
+		const size_t BandRows = std::max<size_t>(1, BandPixels / Job.DestWidth);
+		auto FilterRows = [&Job](size_t Begin, size_t End, uint32_t ThreadIndex)
+		{
+			FilterBand(Job, (uint32_t)Begin, (uint32_t)End);
+		};
+
+		if (JobSystem::Get())
+		{
+			JobSystem::Get()->ParallelFor(Job.DestHeight, BandRows, FilterRows);
+		}
+		else
+		{
+			FilterRows(0, Job.DestHeight, 0);
+		}
+
+		PreviousLinear.swap(CurrentLinear);
+	}
+}
+
+uint32_t MipGenerator::GetMipCount(uint32_t Width, uint32_t Height)
+{
+	uint32_t Count = 1;
+	while (Width > 1 || Height > 1)
+	{
+		Width = std::max<uint32_t>(1, Width >> 1);
+		Height = std::max<uint32_t>(1, Height >> 1);
+		Count++;
+	}
+	return Count;
+}
@@ -1,5 +1,7 @@
 #include "Rock.h"
 #include "FbxLoader.h"
+#include "TextureManager.h"
+#include "UploadManager.h"
 
 Rock::Rock(Camera* InCamera)
 	:
@@ -15,7 +17,7 @@ Rock::~Rock()
 void Rock::BuildRootSignature(ID3D12Device* Device)
 {
 	CD3DX12_DESCRIPTOR_RANGE TexTable;
-	TexTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 7, 0, 0);
+	TexTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, TextureManager::MaxSrvCount, 0, 0);
 
 	CD3DX12_ROOT_PARAMETER SlotRootParameter[4];
 
@@ -53,37 +55,19 @@ void Rock::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList* Comm
 	std::vector<Texture*> Textures = FbxLoader::Get()->GetTextures("Rock");
 
 	// FIXME: 텍스쳐 여러개 받자
-	Tex = std::make_unique<Texture>(*Textures[0]);
-
-	ThrowIfFailed(CreateDDSTextureFromFile12(Device, CommandList, Tex->Filename.c_str(), Tex->Resource, Tex->UploadHeap));
+	Tex = TextureManager::Get()->Acquire(CommandList, Textures[0]->Filename, Textures[0]->Name);
 
 	std::vector<Material*> Materials = FbxLoader::Get()->GetMaterials("Rock");
 
 	// FIXME: 머티리얼 여러개 받을 수 있게 해야하지 않나?
 	Mat = std::make_unique<Material>(*Materials[0]);
+	Mat->DiffuseSrvHeapIndex = Tex.GetSrvIndex();
 
-	XMFLOAT3 Minf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
-	XMFLOAT3 Maxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
-
-	XMVECTOR Min = XMLoadFloat3(&Minf3);
-	XMVECTOR Max = XMLoadFloat3(&Maxf3);
-
-	const std::vector<Vertex>& Vertices = FbxLoader::Get()->GetVertices("Rock");
+	ArrayView<Vertex> Vertices = FbxLoader::Get()->GetVertices("Rock");
 	const UINT VBByteSize = (UINT)Vertices.size() * sizeof(Vertex);
 
-	const std::vector<uint16_t>& Indices = FbxLoader::Get()->GetIndices("Rock");
-	const UINT IBByteSize = (UINT)Indices.size() * sizeof(uint16_t);
-
-	for (size_t i = 0; i < Vertices.size(); ++i)
-	{
-		const XMFLOAT3& P = Vertices[i].Pos;
-		Min = XMVectorMin(Min, XMLoadFloat3(&P));
-		Max = XMVectorMax(Max, XMLoadFloat3(&P));
-	}
-
-	BoundingBox Bounds;
-	XMStoreFloat3(&Bounds.Center, 0.5f * (Min + Max));
-	XMStoreFloat3(&Bounds.Extents, 0.5f * (Max - Min));
+	ArrayView<uint32_t> Indices = FbxLoader::Get()->GetIndices("Rock");
+	const UINT IBByteSize = (UINT)Indices.size() * sizeof(uint32_t);
 
 	std::unique_ptr<MeshGeometry> Geo = std::make_unique<MeshGeometry>();
 	Geo->Name = "RockGeo";
@@ -94,21 +78,23 @@ void Rock::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList* Comm
 	ThrowIfFailed(D3DCreateBlob(IBByteSize, &Geo->IndexBufferCPU));
 	CopyMemory(Geo->IndexBufferCPU->GetBufferPointer(), Indices.data(), IBByteSize);
 
-	Geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(Device, CommandList, Vertices.data(), VBByteSize, Geo->VertexBufferUploader);
-	Geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(Device, CommandList, Indices.data(), IBByteSize, Geo->IndexBufferUploader);
+	Geo->VertexBufferGPU = UploadManager::Get()->CreateBuffer(GpuMemoryCategory::VertexBuffer, Vertices.data(), VBByteSize);
+	Geo->IndexBufferGPU = UploadManager::Get()->CreateBuffer(GpuMemoryCategory::IndexBuffer, Indices.data(), IBByteSize);
 
 	Geo->VertexByteStride = sizeof(Vertex);
 	Geo->VertexBufferByteSize = VBByteSize;
-	Geo->IndexFormat = DXGI_FORMAT_R16_UINT;
+	Geo->IndexFormat = DXGI_FORMAT_R32_UINT;
 	Geo->IndexBufferByteSize = IBByteSize;
 
-	SubmeshGeometry Submesh;
-	Submesh.IndexCount = (UINT)Indices.size();
-	Submesh.StartIndexLocation = 0;
-	Submesh.BaseVertexLocation = 0;
-	Submesh.Bounds = Bounds;
+	// 바운드는 쿠킹할 때 미리 계산해뒀다. "Rock"가 전체 메쉬고 나머지는 노드별 서브메쉬.
+	for (const CookedSubmesh& Submesh : FbxLoader::Get()->GetSubmeshes("Rock"))
+	{
+		Geo->DrawArgs[Submesh.Name] = Submesh.Geometry;
+	}
 
-	Geo->DrawArgs["Rock"] = Submesh;
+	ArrayView<Meshlet> CookedMeshlets = FbxLoader::Get()->GetMeshlets("Rock");
+	Meshlets.assign(CookedMeshlets.begin(), CookedMeshlets.end());
+	bUseMeshletCulling = true;
 
 	Geometry = std::move(Geo);
 
@@ -118,8 +104,14 @@ void Rock::BuildGameObject(ID3D12Device* Device, ID3D12GraphicsCommandList* Comm
 
 void Rock::BuildShadersAndInputLayout()
 {
-	VSByteCode = d3dUtil::CompileShader(L"Source/Shader/Rock.hlsl", nullptr, "VSMain", "vs_5_1");
-	PSByteCode = d3dUtil::CompileShader(L"Source/Shader/Rock.hlsl", nullptr, "PSMain", "ps_5_1");
+	const D3D_SHADER_MACRO Defines[] =
+	{
+		"MAX_SRV_COUNT", TextureManager::GetMaxSrvCountDefine(),
+		nullptr, nullptr
+	};
+
+	VSByteCode = d3dUtil::CompileShader(L"Source/Shader/Rock.hlsl", Defines, "VSMain", "vs_5_1");
+	PSByteCode = d3dUtil::CompileShader(L"Source/Shader/Rock.hlsl", Defines, "PSMain", "ps_5_1");
 
 	InputLayout =
 	{
@@ -0,0 +1,115 @@
+#include "Skeleton.h"
+#include <cassert>
+#include <algorithm>
+
+Skeleton::Skeleton(ArrayView<int32_t> InParentIndices, ArrayView<XMMATRIX> InInverseBindPose, ArrayView<BoneTransform> InBindPose)
+	:
+	ParentIndices(InParentIndices),
+	InverseBindPose(InInverseBindPose),
+	BindPose(InBindPose)
+{
+}
+
+Skeleton::Skeleton(const SkeletonData& Data)
+	:
+	Skeleton(Data.ParentIndices, Data.InverseBindPose, Data.BindPose)
+{
+}
+
+void Skeleton::ComposeModelSpace(const BoneTransform* LocalPose, XMMATRIX* OutModel) const
+{
+	const uint32_t BoneCount = GetBoneCount();
+	for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+	{
+		const int32_t Parent = ParentIndices[Bone];
+		assert(Parent < (int32_t)Bone);
+
+		XMMATRIX Local = LocalPose[Bone].ToMatrix();
+		OutModel[Bone] = Parent < 0 ? Local : XMMatrixMultiply(Local, OutModel[Parent]);
+	}
+}
+
+void Skeleton::ComposePalette(const BoneTransform* LocalPose, XMMATRIX* OutModel, XMMATRIX* OutPalette) const
+{
+	ComposeModelSpace(LocalPose, OutModel);
+
+	const uint32_t BoneCount = GetBoneCount();
+	for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+	{
+		OutPalette[Bone] = XMMatrixMultiply(InverseBindPose[Bone], OutModel[Bone]);
+	}
+}
+
+bool Skeleton::IsValid() const
+{
+	return false == ParentIndices.empty()
+		&& ParentIndices.size() == InverseBindPose.size()
+		&& ParentIndices.size() == BindPose.size();
+}
+
+uint32_t Skeleton::GetBoneCount() const
+{
+	return (uint32_t)ParentIndices.size();
+}
+
+int32_t Skeleton::GetParentIndex(uint32_t Bone) const
+{
+	return ParentIndices[Bone];
+}
+
+uint32_t Skeleton::GetBoneCountUpToDepth(uint32_t MaxDepth) const
+{
+	std::vector<uint32_t> Depths(GetBoneCount(), 0);
+
+	for (uint32_t Bone = 0; Bone < GetBoneCount(); Bone++)
+	{
+		const int32_t Parent = ParentIndices[Bone];
+		Depths[Bone] = Parent < 0 ? 0 : Depths[Parent] + 1;
+
+		if (Depths[Bone] > MaxDepth)
+		{
+			return Bone;
+		}
+	}
+
+	return GetBoneCount();
+}
+
+ArrayView<BoneTransform> Skeleton::GetBindPose() const
+{
+	return BindPose;
+}
+
+uint32_t PruneInfluences(BoneInfluence* Influences, uint32_t Count, const SkinImportSettings& Settings)
+{
+	if (0 == Count)
+	{
+		return 0;
+	}
+
+	std::sort(Influences, Influences + Count, [](const BoneInfluence& A, const BoneInfluence& B)
+	{
+		return A.Weight != B.Weight ? A.Weight > B.Weight : A.Bone < B.Bone;
+	});
+
+	uint32_t Kept = 0;
+	while (Kept < Count && Kept < Settings.MaxInfluences && Influences[Kept].Weight >= Settings.MinWeight)
+	{
+		++Kept;
+	}
+	Kept = std::max<uint32_t>(Kept, 1);
+
+	float Total = 0.0f;
+	for (uint32_t k = 0; k < Kept; k++)
+	{
+		Total += Influences[k].Weight;
+	}
+
+	const float InvTotal = Total > 0.0f ? 1.0f / Total : 0.0f;
+	for (uint32_t k = 0; k < Kept; k++)
+	{
+		Influences[k].Weight *= InvTotal;
+	}
+
+	return Kept;
+}
@@ -0,0 +1,117 @@
+#include "StagingRing.h"
+#include <cassert>
+#include <algorithm>
+
+void StagingRing::Init(uint64_t InCapacity)
+{
+	assert(Batches.empty() && Head == Tail);
+
+	Capacity = InCapacity;
+	Head = 0;
+	Tail = 0;
+	SubmittedHead = 0;
+	PendingDedicatedBytes = 0;
+
+	Stats = StagingStats();
+	Stats.Capacity = Capacity;
+}
+
+uint64_t StagingRing::Allocate(uint64_t Bytes, uint64_t Alignment)
+{
+	assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0 && Capacity % Alignment == 0);
+
+	if (0 == Capacity || Bytes > Capacity)
+	{
+		return InvalidOffset;
+	}
+
+	const uint64_t Offset = Head % Capacity;
+	uint64_t Aligned = (Offset + Alignment - 1) & ~(Alignment - 1);
+
+	uint64_t Start = Head + (Aligned - Offset);
+	if (Aligned + Bytes > Capacity)
+	{
+		Start = Head + (Capacity - Offset);
+		Aligned = 0;
+	}
+
+	if (Start + Bytes - Tail > Capacity)
+	{
+		return InvalidOffset;
+	}
+
+	Head = Start + Bytes;
+
+	Stats.TotalBytes += Bytes;
+	++Stats.AllocationCount;
+	UpdatePeak();
+
+	return Aligned;
+}
+
+void StagingRing::AddDedicated(uint64_t Bytes)
+{
+	PendingDedicatedBytes += Bytes;
+
+	Stats.DedicatedBytes += Bytes;
+	Stats.TotalBytes += Bytes;
+	++Stats.DedicatedCount;
+	UpdatePeak();
+}
+
+void StagingRing::Submit(uint64_t Fence)
+{
+	if (Head == SubmittedHead && 0 == PendingDedicatedBytes)
+	{
+		return;
+	}
+
+	assert(Batches.empty() || Batches.back().Fence <= Fence);
+
+	Batch NewBatch;
+	NewBatch.Fence = Fence;
+	NewBatch.End = Head;
+	NewBatch.DedicatedBytes = PendingDedicatedBytes;
+	Batches.push_back(NewBatch);
+
+	SubmittedHead = Head;
+	PendingDedicatedBytes = 0;
+	++Stats.BatchCount;
+}
+
+void StagingRing::Retire(uint64_t CompletedFence)
+{
+	while (false == Batches.empty() && Batches.front().Fence <= CompletedFence)
+	{
+		Tail = Batches.front().End;
+		Stats.DedicatedBytes -= Batches.front().DedicatedBytes;
+		Batches.pop_front();
+	}
+
+	// 다 돌려받았으면 처음으로 돌아가서 다음 묶음이 끝에서 잘리지 않게 한다.
+	if (Batches.empty() && Head == Tail)
+	{
+		Head = 0;
+		Tail = 0;
+		SubmittedHead = 0;
+	}
+
+	Stats.RingBytes = Head - Tail;
+}
+
+uint64_t StagingRing::GetCapacity() const
+{
+	return Capacity;
+}
+
+const StagingStats& StagingRing::GetStats() const
+{
+	return Stats;
+}
+
+void StagingRing::UpdatePeak()
+{
+	Stats.RingBytes = Head - Tail;
+	Stats.PeakRingBytes = std::max(Stats.PeakRingBytes, Stats.RingBytes);
+	Stats.PeakBytes = std::max(Stats.PeakBytes, Stats.RingBytes + Stats.DedicatedBytes);
+}
@@ -0,0 +1,849 @@
+#include "SupercompressedTexture.h"
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+#include "DDSFile.h"
+#include "JobSystem.h"
+
+namespace
+{
+	// 조각 하나의 원본 크기. LZ 오프셋이 16비트에 들어가고, 작은 밉 여러 개가 한 조각에 모인다.
+	const uint32_t DefaultChunkBytes = 1 << 16;
+
+	const uint32_t ProbabilityBits = 12;
+	const uint32_t ProbabilityScale = 1 << ProbabilityBits;
+	const uint32_t RansLowerBound = 1 << 23;
+
+	const uint32_t MinMatchLength = 4;
+	const uint32_t MaxMatchOffset = 0xFFFF;
+	const uint32_t HashBits = 15;
+	const uint32_t MaxChainDepth = 64;
+
+	enum class StreamMode : uint8_t
+	{
+		Raw = 0,
+		Rans
+	};
+
+	// 조각마다 이 순서로 스트림 네 개가 이어진다.
+	enum StreamIndex : uint32_t
+	{
+		StreamLiterals = 0,
+		StreamCommands,
+		StreamOffsetLow,
+		StreamOffsetHigh,
+		StreamCount
+	};
+
+	void AppendU32(std::vector<uint8_t>& Out, uint32_t Value)
+	{
+		const uint8_t Bytes[4] = { (uint8_t)Value, (uint8_t)(Value >> 8), (uint8_t)(Value >> 16), (uint8_t)(Value >> 24) };
+		Out.insert(Out.end(), Bytes, Bytes + 4);
+	}
+
+	bool ReadU32(const uint8_t*& Cursor, const uint8_t* End, uint32_t& Out)
+	{
+		if (End - Cursor < 4)
+		{
+			return false;
+		}
+
+		Out = (uint32_t)Cursor[0] | (uint32_t)Cursor[1] << 8 | (uint32_t)Cursor[2] << 16 | (uint32_t)Cursor[3] << 24;
+		Cursor += 4;
+		return true;
+	}
+
+	uint32_t GetElementBytes(uint32_t Format)
+	{
+		const uint32_t BitsPerPixel = DDSFile::GetBitsPerPixel(Format);
+		if (DDSFile::IsBlockCompressed(Format))
+		{
+			return BitsPerPixel * 2;
+		}
+
+		// 비트 단위로 묶인 포맷은 바이트로 나누면 평면이 의미 없다.
+		return (BitsPerPixel % 8 != 0 || 0 == BitsPerPixel || BitsPerPixel > 128) ? 1 : BitsPerPixel / 8;
+	}
+
+	// 빈도 합이 ProbabilityScale이 되게 줄인다. 한 번이라도 나온 심볼은 1 이상을 남긴다.
+	void NormalizeFrequencies(const uint32_t* Counts, size_t Total, uint32_t* OutFrequencies)
+	{
+		uint32_t Sum = 0;
+		uint32_t Largest = 0;
+
+		for (uint32_t Symbol = 0; Symbol < 256; Symbol++)
+		{
+			OutFrequencies[Symbol] = 0;
+			if (Counts[Symbol] > 0)
+			{
+				OutFrequencies[Symbol] = std::max<uint32_t>(1, (uint32_t)((uint64_t)Counts[Symbol] * ProbabilityScale / Total));
+				Sum += OutFrequencies[Symbol];
+			}
+
+			if (Counts[Symbol] > Counts[Largest])
+			{
+				Largest = Symbol;
+			}
+		}
+
+		// 1로 올린 심볼 때문에 넘치면 큰 쪽부터 깎는다.
+		while (Sum > ProbabilityScale)
+		{
+			uint32_t* Biggest = std::max_element(OutFrequencies, OutFrequencies + 256);
+			--*Biggest;
+			--Sum;
+		}
+
+		OutFrequencies[Largest] += ProbabilityScale - Sum;
+	}
+
+	// 심볼 수, 방식, (rANS면) 빈도표와 부호화된 바이트 순서로 쓴다. rANS가 더 크면 그대로 담는다.
+	void EncodeStream(const std::vector<uint8_t>& Symbols, std::vector<uint8_t>& Out)
+	{
+		AppendU32(Out, (uint32_t)Symbols.size());
+
+		uint32_t Counts[256] = {};
+		for (uint8_t Symbol : Symbols)
+		{
+			++Counts[Symbol];
+		}
+
+		std::vector<uint8_t> Encoded;
+		uint32_t Frequencies[256] = {};
+
+		if (false == Symbols.empty())
+		{
+			NormalizeFrequencies(Counts, Symbols.size(), Frequencies);
+
+			uint32_t Starts[256] = {};
+			for (uint32_t Symbol = 1; Symbol < 256; Symbol++)
+			{
+				Starts[Symbol] = Starts[Symbol - 1] + Frequencies[Symbol - 1];
+			}
+
+			// rANS는 뒤에서부터 부호화하고 바이트도 거꾸로 나온다. 마지막에 뒤집으면 디코더가 앞에서부터 읽는다.
+			uint32_t State = RansLowerBound;
+			for (size_t i = Symbols.size(); i-- > 0;)
+			{
+				const uint32_t Frequency = Frequencies[Symbols[i]];
+				const uint32_t Limit = ((RansLowerBound >> ProbabilityBits) << 8) * Frequency;
+				while (State >= Limit)
+				{
+					Encoded.push_back((uint8_t)State);
+					State >>= 8;
+				}
+
+				State = ((State / Frequency) << ProbabilityBits) + State % Frequency + Starts[Symbols[i]];
+			}
+
+			Encoded.push_back((uint8_t)(State >> 24));
+			Encoded.push_back((uint8_t)(State >> 16));
+			Encoded.push_back((uint8_t)(State >> 8));
+			Encoded.push_back((uint8_t)State);
+			std::reverse(Encoded.begin(), Encoded.end());
+		}
+
+		uint8_t PresentMask[32] = {};
+		uint32_t PresentCount = 0;
+		for (uint32_t Symbol = 0; Symbol < 256; Symbol++)
+		{
+			if (Frequencies[Symbol] > 0)
+			{
+				PresentMask[Symbol / 8] |= (uint8_t)(1 << (Symbol % 8));
+				++PresentCount;
+			}
+		}
+
+		const size_t RansBytes = sizeof(PresentMask) + PresentCount * 2 + 4 + Encoded.size();
+		if (Symbols.empty() || RansBytes >= Symbols.size())
+		{
+			Out.push_back((uint8_t)StreamMode::Raw);
+			Out.insert(Out.end(), Symbols.begin(), Symbols.end());
+			return;
+		}
+
+		Out.push_back((uint8_t)StreamMode::Rans);
+		Out.insert(Out.end(), PresentMask, PresentMask + sizeof(PresentMask));
+		for (uint32_t Symbol = 0; Symbol < 256; Symbol++)
+		{
+			if (Frequencies[Symbol] > 0)
+			{
+				Out.push_back((uint8_t)Frequencies[Symbol]);
+				Out.push_back((uint8_t)(Frequencies[Symbol] >> 8));
+			}
+		}
+
+		AppendU32(Out, (uint32_t)Encoded.size());
+		Out.insert(Out.end(), Encoded.begin(), Encoded.end());
+	}
+
+	// 그대로 담긴 스트림은 파일을 바로 가리키고, rANS면 Storage에 풀어서 가리킨다.
+	// 어느 스트림도 조각 원본 크기(MaxCount)보다 길 수 없으니, 깨진 원소 수로 큰 버퍼를 잡기 전에 거른다.
+	bool DecodeStream(const uint8_t*& Cursor, const uint8_t* End, size_t MaxCount, std::vector<uint8_t>& Storage, const uint8_t*& OutSymbols, size_t& OutCount)
+	{
+		uint32_t Count = 0;
+		if (false == ReadU32(Cursor, End, Count) || Cursor == End || Count > MaxCount)
+		{
+			return false;
+		}
+
+		const StreamMode Mode = (StreamMode)*Cursor++;
+		OutCount = Count;
+
+		if (Mode == StreamMode::Raw)
+		{
+			if ((size_t)(End - Cursor) < Count)
+			{
+				return false;
+			}
+
+			OutSymbols = Cursor;
+			Cursor += Count;
+			return true;
+		}
+
+		if (Mode != StreamMode::Rans || End - Cursor < 32)
+		{
+			return false;
+		}
+
+		const uint8_t* PresentMask = Cursor;
+		Cursor += 32;
+
+		uint32_t Frequencies[256] = {};
+		uint32_t Starts[256] = {};
+		uint8_t SlotToSymbol[ProbabilityScale];
+		uint32_t Next = 0;
+
+		for (uint32_t Symbol = 0; Symbol < 256; Symbol++)
+		{
+			if (0 == (PresentMask[Symbol / 8] & (1 << (Symbol % 8))))
+			{
+				continue;
+			}
+
+			if (End - Cursor < 2)
+			{
+				return false;
+			}
+
+			Frequencies[Symbol] = (uint32_t)Cursor[0] | (uint32_t)Cursor[1] << 8;
+			Cursor += 2;
+
+			if (0 == Frequencies[Symbol] || Next + Frequencies[Symbol] > ProbabilityScale)
+			{
+				return false;
+			}
+
+			Starts[Symbol] = Next;
+			memset(SlotToSymbol + Next, (int)Symbol, Frequencies[Symbol]);
+			Next += Frequencies[Symbol];
+		}
+
+		uint32_t EncodedBytes = 0;
+		if (Next != ProbabilityScale || false == ReadU32(Cursor, End, EncodedBytes) || (size_t)(End - Cursor) < EncodedBytes || EncodedBytes < 4)
+		{
+			return false;
+		}
+
+		const uint8_t* Input = Cursor;
+		const uint8_t* InputEnd = Cursor + EncodedBytes;
+		Cursor = InputEnd;
+
+		uint32_t State = 0;
+		ReadU32(Input, InputEnd, State);
+
+		Storage.resize(Count);
+		for (uint32_t i = 0; i < Count; i++)
+		{
+			const uint32_t Slot = State & (ProbabilityScale - 1);
+			const uint8_t Symbol = SlotToSymbol[Slot];
+			Storage[i] = Symbol;
+
+			State = Frequencies[Symbol] * (State >> ProbabilityBits) + Slot - Starts[Symbol];
+			while (State < RansLowerBound)
+			{
+				if (Input == InputEnd)
+				{
+					return false;
+				}
+				State = State << 8 | *Input++;
+			}
+		}
+
+		OutSymbols = Storage.data();
+		return true;
+	}
+
+	struct LZStreams
+	{
+		std::vector<uint8_t> Streams[StreamCount];
+	};
+
+	void AppendLength(std::vector<uint8_t>& Out, size_t Length)
+	{
+		for (; Length >= 255; Length -= 255)
+		{
+			Out.push_back(255);
+		}
+		Out.push_back((uint8_t)Length);
+	}
+
+	uint32_t HashFour(const uint8_t* Source)
+	{
+		uint32_t Value = 0;
+		memcpy(&Value, Source, 4);
+		return (Value * 2654435761u) >> (32 - HashBits);
+	}
+
+	// 명령 바이트 하나가 리터럴 수(위 4비트)와 매치 길이 - 4(아래 4비트)를 담고, 15면 뒤에 255 단위 길이가 붙는다.
+	// 리터럴만 남은 마지막 명령은 매치 없이 끝나고, 디코더는 원본 크기를 다 채우면 멈춘다.
+	void CompressLZ(const uint8_t* Source, size_t Size, LZStreams& Out)
+	{
+		std::vector<int32_t> Head((size_t)1 << HashBits, -1);
+		std::vector<int32_t> Previous(Size, -1);
+
+		auto Insert = [&](size_t Position)
+		{
+			if (Position + MinMatchLength <= Size)
+			{
+				const uint32_t Hash = HashFour(Source + Position);
+				Previous[Position] = Head[Hash];
+				Head[Hash] = (int32_t)Position;
+			}
+		};
+
+		auto FindMatch = [&](size_t Position, size_t& OutOffset) -> size_t
+		{
+			if (Position + MinMatchLength > Size)
+			{
+				return 0;
+			}
+
+			const size_t MaxLength = Size - Position;
+			size_t BestLength = 0;
+
+			int32_t Candidate = Head[HashFour(Source + Position)];
+			for (uint32_t Depth = 0; Candidate >= 0 && Depth < MaxChainDepth; Depth++)
+			{
+				const size_t Offset = Position - (size_t)Candidate;
+				if (Offset > MaxMatchOffset)
+				{
+					break;
+				}
+
+				size_t Length = 0;
+				while (Length < MaxLength && Source[Candidate + Length] == Source[Position + Length])
+				{
+					++Length;
+				}
+
+				if (Length > BestLength)
+				{
+					BestLength = Length;
+					OutOffset = Offset;
+					if (Length == MaxLength)
+					{
+						break;
+					}
+				}
+
+				Candidate = Previous[Candidate];
+			}
+
+			return BestLength >= MinMatchLength ? BestLength : 0;
+		};
+
+		std::vector<uint8_t>& Literals = Out.Streams[StreamLiterals];
+		std::vector<uint8_t>& Commands = Out.Streams[StreamCommands];
+
+		size_t LiteralStart = 0;
+		size_t Position = 0;
+
+		while (Position < Size)
+		{
+			size_t Offset = 0;
+			size_t Length = FindMatch(Position, Offset);
+			Insert(Position);
+
+			// 바로 다음 자리에서 더 긴 매치가 나오면 지금 바이트는 리터럴로 넘긴다.
+			if (Length > 0 && Length < 32)
+			{
+				size_t NextOffset = 0;
+				const size_t NextLength = FindMatch(Position + 1, NextOffset);
+				if (NextLength > Length + 1)
+				{
+					++Position;
+					continue;
+				}
+			}
+
+			if (0 == Length)
+			{
+				++Position;
+				continue;
+			}
+
+			const size_t LiteralCount = Position - LiteralStart;
+			const size_t ExtraLength = Length - MinMatchLength;
+
+			Commands.push_back((uint8_t)(std::min<size_t>(LiteralCount, 15) << 4 | std::min<size_t>(ExtraLength, 15)));
+			if (LiteralCount >= 15)
+			{
+				AppendLength(Commands, LiteralCount - 15);
+			}
+			if (ExtraLength >= 15)
+			{
+				AppendLength(Commands, ExtraLength - 15);
+			}
+
+			Literals.insert(Literals.end(), Source + LiteralStart, Source + Position);
+			Out.Streams[StreamOffsetLow].push_back((uint8_t)Offset);
+			Out.Streams[StreamOffsetHigh].push_back((uint8_t)(Offset >> 8));
+
+			for (size_t i = 1; i < Length; i++)
+			{
+				Insert(Position + i);
+			}
+
+			Position += Length;
+			LiteralStart = Position;
+		}
+
+		if (LiteralStart < Size)
+		{
+			const size_t LiteralCount = Size - LiteralStart;
+
+			Commands.push_back((uint8_t)(std::min<size_t>(LiteralCount, 15) << 4));
+			if (LiteralCount >= 15)
+			{
+				AppendLength(Commands, LiteralCount - 15);
+			}
+
+			Literals.insert(Literals.end(), Source + LiteralStart, Source + Size);
+		}
+	}
+
+	struct StreamView
+	{
+		const uint8_t* Data = nullptr;
+		size_t Count = 0;
+		size_t Position = 0;
+	};
+
+	bool ReadLength(StreamView& Commands, size_t& Length)
+	{
+		uint8_t Byte = 255;
+		while (Byte == 255)
+		{
+			if (Commands.Position == Commands.Count)
+			{
+				return false;
+			}
+
+			Byte = Commands.Data[Commands.Position++];
+			Length += Byte;
+		}
+
+		return true;
+	}
+
+	bool DecompressLZ(StreamView* Streams, uint8_t* Out, size_t Size)
+	{
+		StreamView& Literals = Streams[StreamLiterals];
+		StreamView& Commands = Streams[StreamCommands];
+		StreamView& OffsetLow = Streams[StreamOffsetLow];
+		StreamView& OffsetHigh = Streams[StreamOffsetHigh];
+
+		size_t Position = 0;
+		while (Position < Size)
+		{
+			if (Commands.Position == Commands.Count)
+			{
+				return false;
+			}
+
+			const uint8_t Command = Commands.Data[Commands.Position++];
+
+			size_t LiteralCount = Command >> 4;
+			if (LiteralCount == 15 && false == ReadLength(Commands, LiteralCount))
+			{
+				return false;
+			}
+
+			if (LiteralCount > Size - Position || LiteralCount > Literals.Count - Literals.Position)
+			{
+				return false;
+			}
+
+			memcpy(Out + Position, Literals.Data + Literals.Position, LiteralCount);
+			Literals.Position += LiteralCount;
+			Position += LiteralCount;
+
+			if (Position == Size)
+			{
+				break;
+			}
+
+			size_t Length = (Command & 15) + MinMatchLength;
+			if ((Command & 15) == 15 && false == ReadLength(Commands, Length))
+			{
+				return false;
+			}
+
+			if (OffsetLow.Position == OffsetLow.Count || OffsetHigh.Position == OffsetHigh.Count)
+			{
+				return false;
+			}
+
+			const size_t Offset = (size_t)OffsetLow.Data[OffsetLow.Position++] | (size_t)OffsetHigh.Data[OffsetHigh.Position++] << 8;
+			if (0 == Offset || Offset > Position || Length > Size - Position)
+			{
+				return false;
+			}
+
+			// 겹치는 매치(같은 블록이 이어지는 곳)는 앞에서부터 한 바이트씩 복사해야 반복된다.
+			uint8_t* Destination = Out + Position;
+			const uint8_t* Source = Destination - Offset;
+			if (Offset >= Length)
+			{
+				memcpy(Destination, Source, Length);
+			}
+			else
+			{
+				for (size_t i = 0; i < Length; i++)
+				{
+					Destination[i] = Source[i];
+				}
+			}
+
+			Position += Length;
+		}
+
+		return true;
+	}
+
+	// 원소(블록)마다 ElementBytes 바이트를 k번째 바이트끼리 모은다. 원소로 나누어 떨어지지 않는 끝은 그대로 둔다.
+	void SplitBytePlanes(const uint8_t* Source, size_t Size, uint32_t ElementBytes, uint8_t* Out)
+	{
+		const size_t Count = Size / ElementBytes;
+		for (size_t i = 0; i < Count; i++)
+		{
+			for (uint32_t Byte = 0; Byte < ElementBytes; Byte++)
+			{
+				Out[Byte * Count + i] = Source[i * ElementBytes + Byte];
+			}
+		}
+
+		memcpy(Out + Count * ElementBytes, Source + Count * ElementBytes, Size - Count * ElementBytes);
+	}
+
+	void MergeBytePlanes(const uint8_t* Source, size_t Size, uint32_t ElementBytes, uint8_t* Out)
+	{
+		const size_t Count = Size / ElementBytes;
+		for (uint32_t Byte = 0; Byte < ElementBytes; Byte++)
+		{
+			const uint8_t* Plane = Source + Byte * Count;
+			uint8_t* Destination = Out + Byte;
+			for (size_t i = 0; i < Count; i++)
+			{
+				Destination[i * ElementBytes] = Plane[i];
+			}
+		}
+
+		memcpy(Out + Count * ElementBytes, Source + Count * ElementBytes, Size - Count * ElementBytes);
+	}
+
+	void EncodeChunk(const uint8_t* Source, size_t Size, std::vector<uint8_t>& Out)
+	{
+		LZStreams Streams;
+		CompressLZ(Source, Size, Streams);
+
+		for (const std::vector<uint8_t>& Stream : Streams.Streams)
+		{
+			EncodeStream(Stream, Out);
+		}
+	}
+
+	struct TranscodeScratch
+	{
+		std::vector<uint8_t> Streams[StreamCount];
+		std::vector<uint8_t> Planes;
+	};
+
+	bool TranscodeChunk(const uint8_t* Input, size_t InputBytes, uint32_t Flags, uint32_t ElementBytes, uint8_t* Out, size_t Size, TranscodeScratch& Scratch)
+	{
+		const uint8_t* Cursor = Input;
+		const uint8_t* End = Input + InputBytes;
+
+		StreamView Streams[StreamCount];
+		for (uint32_t Stream = 0; Stream < StreamCount; Stream++)
+		{
+			if (false == DecodeStream(Cursor, End, Size, Scratch.Streams[Stream], Streams[Stream].Data, Streams[Stream].Count))
+			{
+				return false;
+			}
+		}
+
+		if (0 == (Flags & ChunkFlagBytePlanes))
+		{
+			return DecompressLZ(Streams, Out, Size);
+		}
+
+		Scratch.Planes.resize(Size);
+		if (false == DecompressLZ(Streams, Scratch.Planes.data(), Size))
+		{
+			return false;
+		}
+
+		MergeBytePlanes(Scratch.Planes.data(), Size, ElementBytes, Out);
+		return true;
+	}
+}
+
+bool SupercompressedTexture::Encode(const uint8_t* DDSData, size_t DDSSize, std::vector<uint8_t>& Out)
+{
+	std::unique_ptr<DDSFile> Source = DDSFile::FromMemory(DDSData, DDSSize);
+	if (nullptr == Source)
+	{
+		return false;
+	}
+
+	SupercompressedHeader NewHeader;
+	NewHeader.Format = Source->GetFormat();
+	NewHeader.ElementBytes = GetElementBytes(NewHeader.Format);
+	NewHeader.RawBytes = DDSSize;
+	NewHeader.HeaderBytes = (uint32_t)Source->GetSubresource(0, 0).Offset;
+	NewHeader.ChunkBytes = DefaultChunkBytes;
+
+	const size_t PayloadBytes = DDSSize - NewHeader.HeaderBytes;
+	NewHeader.ChunkCount = (uint32_t)((PayloadBytes + DefaultChunkBytes - 1) / DefaultChunkBytes);
+
+	const uint8_t* Payload = DDSData + NewHeader.HeaderBytes;
+
+	std::vector<std::vector<uint8_t>> Encoded(NewHeader.ChunkCount);
+	std::vector<uint32_t> Flags(NewHeader.ChunkCount, 0);
+
+	// 조각마다 그대로 압축한 것과 바이트 평면으로 나눠 압축한 것 중 작은 쪽을 남긴다.
+	auto EncodeChunks = [&](size_t Begin, size_t End, uint32_t ThreadIndex)
+	{
+		std::vector<uint8_t> Planes;
+		std::vector<uint8_t> Candidate;
+
+		for (size_t Chunk = Begin; Chunk < End; Chunk++)
+		{
+			const uint8_t* Source = Payload + Chunk * DefaultChunkBytes;
+			const size_t Size = std::min<size_t>(DefaultChunkBytes, PayloadBytes - Chunk * DefaultChunkBytes);
+
+			EncodeChunk(Source, Size, Encoded[Chunk]);
+
+			if (NewHeader.ElementBytes > 1)
+			{
+				Planes.resize(Size);
+				SplitBytePlanes(Source, Size, NewHeader.ElementBytes, Planes.data());
+
+				Candidate.clear();
+				EncodeChunk(Planes.data(), Size, Candidate);
+
+				if (Candidate.size() < Encoded[Chunk].size())
+				{
+					Encoded[Chunk].swap(Candidate);
+					Flags[Chunk] = ChunkFlagBytePlanes;
+				}
+			}
+		}
+	};
+
+	if (JobSystem::Get())
+	{
+		JobSystem::Get()->ParallelFor(NewHeader.ChunkCount, 1, EncodeChunks);
+	}
+	else
+	{
+		EncodeChunks(0, NewHeader.ChunkCount, 0);
+	}
+
+	// [헤더][조각 표][원본 DDS 헤더][조각들]
+	std::vector<SupercompressedChunk> ChunkTable(NewHeader.ChunkCount);
+	uint64_t Offset = sizeof(SupercompressedHeader) + sizeof(SupercompressedChunk) * ChunkTable.size() + NewHeader.HeaderBytes;
+	for (uint32_t Chunk = 0; Chunk < NewHeader.ChunkCount; Chunk++)
+	{
+		ChunkTable[Chunk].Offset = Offset;
+		ChunkTable[Chunk].Bytes = (uint32_t)Encoded[Chunk].size();
+		ChunkTable[Chunk].Flags = Flags[Chunk];
+		Offset += Encoded[Chunk].size();
+	}
+
+	Out.resize((size_t)Offset);
+	uint8_t* Destination = Out.data();
+
+	memcpy(Destination, &NewHeader, sizeof(NewHeader));
+	Destination += sizeof(NewHeader);
+	memcpy(Destination, ChunkTable.data(), sizeof(SupercompressedChunk) * ChunkTable.size());
+	Destination += sizeof(SupercompressedChunk) * ChunkTable.size();
+	memcpy(Destination, DDSData, NewHeader.HeaderBytes);
+	Destination += NewHeader.HeaderBytes;
+
+	for (const std::vector<uint8_t>& Chunk : Encoded)
+	{
+		memcpy(Destination, Chunk.data(), Chunk.size());
+		Destination += Chunk.size();
+	}
+
+	return true;
+}
+
+std::unique_ptr<SupercompressedTexture> SupercompressedTexture::Open(const char* FilePath)
+{
+	std::unique_ptr<SupercompressedTexture> Texture = std::make_unique<SupercompressedTexture>();
+	if (false == Texture->File.Open(FilePath) || false == Texture->Parse(Texture->File.GetData(), Texture->File.GetSize()))
+	{
+		return nullptr;
+	}
+
+	return Texture;
+}
+
+std::unique_ptr<SupercompressedTexture> SupercompressedTexture::Open(const wchar_t* FilePath)
+{
+	std::unique_ptr<SupercompressedTexture> Texture = std::make_unique<SupercompressedTexture>();
+	if (false == Texture->File.Open(FilePath) || false == Texture->Parse(Texture->File.GetData(), Texture->File.GetSize()))
+	{
+		return nullptr;
+	}
+
+	return Texture;
+}
+
+std::unique_ptr<SupercompressedTexture> SupercompressedTexture::FromMemory(const uint8_t* Data, size_t Size)
+{
+	std::unique_ptr<SupercompressedTexture> Texture = std::make_unique<SupercompressedTexture>();
+	if (false == Texture->Parse(Data, Size))
+	{
+		return nullptr;
+	}
+
+	return Texture;
+}
+
+std::wstring SupercompressedTexture::GetPathFor(const std::wstring& DDSPath)
+{
+	const size_t Dot = DDSPath.find_last_of(L'.');
+	const size_t Separator = DDSPath.find_last_of(L"/\\");
+	if (Dot == std::wstring::npos || (Separator != std::wstring::npos && Dot < Separator))
+	{
+		return DDSPath + L".sctx";
+	}
+
+	return DDSPath.substr(0, Dot) + L".sctx";
+}
+
+bool SupercompressedTexture::Transcode(uint8_t* Out) const
+{
+	const uint8_t* SourceHeader = reinterpret_cast<const uint8_t*>(Chunks + Header.ChunkCount);
+	memcpy(Out, SourceHeader, Header.HeaderBytes);
+
+	uint8_t* Payload = Out + Header.HeaderBytes;
+	const uint64_t PayloadBytes = Header.RawBytes - Header.HeaderBytes;
+
+	std::atomic<bool> bFailed{ false };
+
+	auto TranscodeChunks = [&](size_t Begin, size_t End, uint32_t ThreadIndex)
+	{
+		TranscodeScratch Scratch;
+
+		for (size_t Chunk = Begin; Chunk < End; Chunk++)
+		{
+			const uint64_t ChunkStart = (uint64_t)Chunk * Header.ChunkBytes;
+			const size_t Size = (size_t)std::min<uint64_t>(Header.ChunkBytes, PayloadBytes - ChunkStart);
+
+			const SupercompressedChunk& Desc = Chunks[Chunk];
+			if (false == TranscodeChunk(Data + Desc.Offset, Desc.Bytes, Desc.Flags, Header.ElementBytes, Payload + ChunkStart, Size, Scratch))
+			{
+				bFailed = true;
+			}
+		}
+	};
+
+	if (JobSystem::Get())
+	{
+		JobSystem::Get()->ParallelFor(Header.ChunkCount, 1, TranscodeChunks);
+	}
+	else
+	{
+		TranscodeChunks(0, Header.ChunkCount, 0);
+	}
+
+	return false == bFailed;
+}
+
+std::unique_ptr<DDSFile> SupercompressedTexture::TranscodeToDDS() const
+{
+	std::vector<uint8_t> Bytes((size_t)Header.RawBytes);
+	if (false == Transcode(Bytes.data()))
+	{
+		return nullptr;
+	}
+
+	return DDSFile::FromStorage(std::move(Bytes));
+}
+
+uint32_t SupercompressedTexture::GetFormat() const
+{
+	return Header.Format;
+}
+
+uint64_t SupercompressedTexture::GetRawSize() const
+{
+	return Header.RawBytes;
+}
+
+size_t SupercompressedTexture::GetSize() const
+{
+	return Size;
+}
+
+bool SupercompressedTexture::Parse(const uint8_t* InData, size_t InSize)
+{
+	if (nullptr == InData || InSize < sizeof(SupercompressedHeader))
+	{
+		return false;
+	}
+
+	memcpy(&Header, InData, sizeof(Header));
+	if (Header.Magic != SupercompressedHeader::MagicValue || Header.Version != SupercompressedHeader::CurrentVersion)
+	{
+		return false;
+	}
+
+	// 인코더가 쓰는 것보다 큰 조각은 받지 않는다. 깨진 헤더로 조각마다 큰 버퍼를 잡지 않게 한다.
+	if (0 == Header.ChunkBytes || Header.ChunkBytes > DefaultChunkBytes || 0 == Header.ElementBytes || Header.HeaderBytes > Header.RawBytes)
+	{
+		return false;
+	}
+
+	const uint64_t PayloadBytes = Header.RawBytes - Header.HeaderBytes;
+	if (Header.ChunkCount != (PayloadBytes + Header.ChunkBytes - 1) / Header.ChunkBytes)
+	{
+		return false;
+	}
+
+	const uint64_t TableEnd = sizeof(SupercompressedHeader) + sizeof(SupercompressedChunk) * (uint64_t)Header.ChunkCount + Header.HeaderBytes;
+	if (TableEnd > InSize)
+	{
+		return false;
+	}
+
+	Chunks = reinterpret_cast<const SupercompressedChunk*>(InData + sizeof(SupercompressedHeader));
+	for (uint32_t Chunk = 0; Chunk < Header.ChunkCount; Chunk++)
+	{
+		if (Chunks[Chunk].Offset < TableEnd || Chunks[Chunk].Offset > InSize || Chunks[Chunk].Bytes > InSize - Chunks[Chunk].Offset)
+		{
+			return false;
+		}
+	}
+
+	Data = InData;
+	Size = InSize;
+	return true;
+}
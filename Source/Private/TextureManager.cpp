@@ -0,0 +1,493 @@
+#include "TextureManager.h"
+#include <cassert>
+#include <cwctype>
+#include <cstring>
+#include <algorithm>
+#include "Framework/d3dUtil.h"
+#include "TextureStreamer.h"
+#include "UploadManager.h"
+#include "GpuHeapAllocator.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "DDSFile.h"
+#include "SupercompressedTexture.h"
+
+TextureManager* TextureManager::Manager = nullptr;
+
+TextureHandle::TextureHandle(int InIndex)
+	:
+	Index(InIndex)
+{
+	TextureManager::Get()->AddRef(Index);
+}
+
+TextureHandle::TextureHandle(const TextureHandle& Rhs)
+	:
+	Index(Rhs.Index)
+{
+	if (Index >= 0)
+	{
+		TextureManager::Get()->AddRef(Index);
+	}
+}
+
+TextureHandle::TextureHandle(TextureHandle&& Rhs)
+	:
+	Index(Rhs.Index)
+{
+	Rhs.Index = -1;
+}
+
+TextureHandle& TextureHandle::operator=(const TextureHandle& Rhs)
+{
+	if (this != &Rhs)
+	{
+		TextureHandle Copy(Rhs);
+		*this = std::move(Copy);
+	}
+
+	return *this;
+}
+
+TextureHandle& TextureHandle::operator=(TextureHandle&& Rhs)
+{
+	if (this != &Rhs)
+	{
+		Reset();
+		Index = Rhs.Index;
+		Rhs.Index = -1;
+	}
+
+	return *this;
+}
+
+TextureHandle::~TextureHandle()
+{
+	Reset();
+}
+
+Texture* TextureHandle::Get() const
+{
+	return Index >= 0 ? TextureManager::Get()->GetTexture(Index) : nullptr;
+}
+
+Texture* TextureHandle::operator->() const
+{
+	return Get();
+}
+
+TextureHandle::operator bool() const
+{
+	return Index >= 0;
+}
+
+int TextureHandle::GetSrvIndex() const
+{
+	if (Index < 0)
+	{
+		return Index;
+	}
+
+	const TextureHandle& Page = TextureManager::Get()->Entries[Index].Page;
+	return Page ? Page.Index : Index;
+}
+
+const TexturePlacement& TextureHandle::GetPlacement() const
+{
+	static const TexturePlacement Unpacked;
+	return Index >= 0 ? TextureManager::Get()->Entries[Index].Placement : Unpacked;
+}
+
+void TextureHandle::Reset()
+{
+	if (Index >= 0)
+	{
+		TextureManager::Get()->Release(Index);
+		Index = -1;
+	}
+}
+
+TextureManager::TextureManager()
+{
+	assert(Manager == nullptr);
+	Manager = this;
+}
+
+TextureManager::~TextureManager()
+{
+	Manager = nullptr;
+}
+
+TextureManager* TextureManager::Get()
+{
+	return Manager;
+}
+
+TextureHandle TextureManager::Acquire(ID3D12GraphicsCommandList* CommandList, const std::wstring& Filename, const std::string& Name, bool bRepeat)
+{
+	++Stats.RequestCount;
+
+	const std::wstring Path = NormalizePath(Filename);
+
+	auto PathIt = PathToSlot.find(Path);
+	if (PathIt != PathToSlot.end())
+	{
+		// 한 곳이라도 반복해서 깔면 아틀라스에 넣지 않는다.
+		Entries[PathIt->second].bRepeat |= bRepeat;
+
+		++Stats.PathHitCount;
+		Stats.SavedBytes += Entries[PathIt->second].Bytes;
+		return TextureHandle(PathIt->second);
+	}
+
+	// 처음 보는 경로면 파일 전체를 해시해서 내용이 같은 텍스쳐가 있는지 본다.
+	// .sctx는 같은 DDS에서 늘 같게 구워지니 있으면 더 작은 그쪽을 해시한다.
+	uint64_t ContentHash = 0;
+	uint64_t Bytes = 0;
+	{
+		MappedFile File;
+		if (File.Open(SupercompressedTexture::GetPathFor(Filename).c_str()) || File.Open(Filename.c_str()))
+		{
+			ContentHash = CookedMesh::HashBytes(File.GetData(), File.GetSize());
+			Bytes = File.GetSize();
+		}
+	}
+
+	if (Bytes > 0)
+	{
+		auto HashIt = HashToSlot.find(ContentHash);
+		if (HashIt != HashToSlot.end())
+		{
+			const int Slot = HashIt->second;
+			PathToSlot[Path] = Slot;
+			Entries[Slot].bRepeat |= bRepeat;
+
+			++Stats.ContentHitCount;
+			Stats.SavedBytes += Bytes;
+
+			char Message[256];
+			sprintf_s(Message, "[TextureManager] %s: same content as %s, %llu bytes saved\n",
+				Name.c_str(), Entries[Slot].Tex->Name.c_str(), (unsigned long long)Bytes);
+			OutputDebugStringA(Message);
+
+			return TextureHandle(Slot);
+		}
+	}
+
+	const int Slot = AllocateSlot();
+
+	Entry& NewEntry = Entries[Slot];
+	NewEntry.Tex = std::make_unique<Texture>();
+	NewEntry.Tex->Name = Name;
+	NewEntry.Tex->Filename = Filename;
+	NewEntry.Tex->Index = Slot;
+	NewEntry.Path = Path;
+	NewEntry.ContentHash = ContentHash;
+	NewEntry.Bytes = Bytes;
+	NewEntry.bRepeat = bRepeat;
+
+	ThrowIfFailed(TextureStreamer::Get()->Load(CommandList, *NewEntry.Tex));
+
+	PathToSlot[Path] = Slot;
+	if (Bytes > 0)
+	{
+		HashToSlot[ContentHash] = Slot;
+	}
+
+	++Stats.TextureCount;
+	Stats.LoadedBytes += Bytes;
+
+	return TextureHandle(Slot);
+}
+
+void TextureManager::Pack(const TexturePackOptions& Options)
+{
+	TextureStreamer* Streamer = TextureStreamer::Get();
+
+	std::vector<int> Slots;
+	std::vector<TexturePackItem> Items;
+	std::vector<const DDSFile*> Files;
+	std::vector<std::unique_ptr<DDSFile>> OpenedFiles;
+
+	int SrvCountBefore = 0;
+	for (int Slot = 0; Slot < (int)Entries.size(); Slot++)
+	{
+		const Entry& Candidate = Entries[Slot];
+		if (nullptr == Candidate.Tex || nullptr == Candidate.Tex->Resource.Get())
+		{
+			continue;
+		}
+
+		++SrvCountBefore;
+		if (Candidate.bPage)
+		{
+			continue;
+		}
+
+		// 스트리밍 중이면 스트리머가 들고 있는 내용을 쓰고, 처음부터 전부 올린 텍스쳐만 다시 연다.
+		const DDSFile* File = Streamer->GetFile(*Candidate.Tex);
+		if (nullptr == File)
+		{
+			OpenedFiles.push_back(Streamer->Open(*Candidate.Tex));
+			File = OpenedFiles.back().get();
+		}
+
+		if (nullptr == File || File->GetDimension() != DDSDimension::Texture2D || File->GetArraySize() != 1)
+		{
+			continue;
+		}
+
+		TexturePackItem Item;
+		Item.Format = File->GetFormat();
+		Item.Width = File->GetWidth();
+		Item.Height = File->GetHeight();
+		Item.MipCount = File->GetMipCount();
+		Item.bRepeat = Candidate.bRepeat;
+
+		Slots.push_back(Slot);
+		Items.push_back(Item);
+		Files.push_back(File);
+	}
+
+	std::vector<TexturePage> Pages;
+	std::vector<TexturePlacement> Placements;
+	TexturePacker::Plan(Items, Options, Pages, Placements);
+
+	uint32_t PackedCount = 0;
+
+	for (uint32_t PageIndex = 0; PageIndex < (uint32_t)Pages.size(); PageIndex++)
+	{
+		const TexturePage& Page = Pages[PageIndex];
+		const DXGI_FORMAT Format = (DXGI_FORMAT)Page.Format;
+
+		ComPtr<ID3D12Resource> Resource = GpuHeapAllocator::Get()->CreateResource(GpuMemoryCategory::Texture,
+			CD3DX12_RESOURCE_DESC::Tex2D(Format, Page.Width, Page.Height, (UINT16)Page.ArraySize, (UINT16)Page.MipCount),
+			D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_STATE_COMMON);
+
+		// 묶음에 들어가는 텍스쳐의 밉마다 따로 올린다. 아틀라스 칸은 텍스쳐 크기로 복사한다.
+		for (size_t i = 0; i < Items.size(); i++)
+		{
+			const TexturePlacement& Placement = Placements[i];
+			if (Placement.Page != (int)PageIndex)
+			{
+				continue;
+			}
+
+			const D3D12_RESOURCE_DESC ItemDesc = CD3DX12_RESOURCE_DESC::Tex2D(Format, Items[i].Width, Items[i].Height, 1, (UINT16)Page.MipCount);
+			for (uint32_t Mip = 0; Mip < Page.MipCount; Mip++)
+			{
+				const DDSSubresource& Subresource = Files[i]->GetSubresource(Mip, 0);
+
+				D3D12_SUBRESOURCE_DATA Data = {};
+				Data.pData = Files[i]->GetSubresourceData(Mip, 0);
+				Data.RowPitch = Subresource.RowBytes;
+				Data.SlicePitch = Subresource.SliceBytes;
+
+				UploadManager::Get()->UploadRegion(Resource.Get(), D3D12CalcSubresource(Mip, Placement.Slice, 0, Page.MipCount, Page.ArraySize),
+					Placement.X >> Mip, Placement.Y >> Mip, ItemDesc, Mip, Data, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+			}
+		}
+
+		const int PageSlot = AllocateSlot();
+
+		Entry& PageEntry = Entries[PageSlot];
+		PageEntry.Tex = std::make_unique<Texture>();
+		PageEntry.Tex->Name = (Page.bAtlas ? "Atlas" : "Array") + std::to_string(PageIndex);
+		PageEntry.Tex->Index = PageSlot;
+		PageEntry.Tex->Resource = Resource;
+		PageEntry.bPage = true;
+
+		// 묶인 텍스쳐가 묶음을 잡고 있다가 마지막 것이 풀릴 때 묶음도 풀린다.
+		for (size_t i = 0; i < Items.size(); i++)
+		{
+			if (Placements[i].Page != (int)PageIndex)
+			{
+				continue;
+			}
+
+			Entry& Member = Entries[Slots[i]];
+			Streamer->Unload(*Member.Tex);
+			Member.Page = TextureHandle(PageSlot);
+			Member.Placement = Placements[i];
+			++PackedCount;
+		}
+
+		char Message[256];
+		sprintf_s(Message, "[TextureManager] %s: %ux%u x %u slices, %u mips, format %u\n",
+			PageEntry.Tex->Name.c_str(), Page.Width, Page.Height, Page.ArraySize, Page.MipCount, Page.Format);
+		OutputDebugStringA(Message);
+	}
+
+	Stats.PackedCount += PackedCount;
+	Stats.PageCount += (uint32_t)Pages.size();
+
+	const int SrvCountAfter = SrvCountBefore - (int)PackedCount + (int)Pages.size();
+
+	char Message[256];
+	sprintf_s(Message, "[TextureManager] packed %u of %u textures into %u arrays, SRVs in use %d -> %d\n",
+		PackedCount, (uint32_t)Items.size(), (uint32_t)Pages.size(), SrvCountBefore, SrvCountAfter);
+	OutputDebugStringA(Message);
+}
+
+void TextureManager::Defragment(ID3D12GraphicsCommandList* CommandList, UINT64 CompletedFence, UINT64 SubmitFence, UINT64 MaxBytes)
+{
+	Retired.erase(std::remove_if(Retired.begin(), Retired.end(), [CompletedFence](const RetiredResource& Resource)
+	{
+		return Resource.Fence <= CompletedFence;
+	}), Retired.end());
+
+	std::vector<GpuRelocation> Relocations;
+	GpuHeapAllocator::Get()->PlanDefragment(GpuMemoryCategory::Texture, MaxBytes, Relocations);
+
+	// 스트리머가 펜스를 기다리며 들고 있는 옛 텍스쳐처럼 여기 없는 자원은 옮기지 않는다. 새 자원은 버리면 자리가 돌아간다.
+	std::vector<Texture*> Targets;
+	std::vector<D3D12_RESOURCE_BARRIER> Barriers;
+	for (const GpuRelocation& Relocation : Relocations)
+	{
+		Texture* Target = nullptr;
+		for (const Entry& Candidate : Entries)
+		{
+			if (Candidate.Tex && Candidate.Tex->Resource.Get() == Relocation.Old)
+			{
+				Target = Candidate.Tex.get();
+				break;
+			}
+		}
+
+		Targets.push_back(Target);
+		if (Target)
+		{
+			Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Relocation.Old, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE));
+		}
+	}
+
+	if (Barriers.empty())
+	{
+		return;
+	}
+
+	CommandList->ResourceBarrier((UINT)Barriers.size(), Barriers.data());
+	Barriers.clear();
+
+	for (size_t i = 0; i < Relocations.size(); i++)
+	{
+		Texture* Target = Targets[i];
+		if (nullptr == Target)
+		{
+			continue;
+		}
+
+		CommandList->CopyResource(Relocations[i].New.Get(), Relocations[i].Old);
+		Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Relocations[i].New.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+		// SRV는 DX12가 Resource가 바뀐 걸 보고 프레임 리소스마다 다시 만든다.
+		RetiredResource Retire;
+		Retire.Resource = std::move(Target->Resource);
+		Retire.Fence = SubmitFence;
+		Retired.push_back(std::move(Retire));
+
+		Target->Resource = std::move(Relocations[i].New);
+	}
+
+	CommandList->ResourceBarrier((UINT)Barriers.size(), Barriers.data());
+
+	Stats.RelocatedCount += (uint32_t)Barriers.size();
+
+	char Message[256];
+	sprintf_s(Message, "[TextureManager] moved %u textures forward in the texture heaps (%u so far)\n", (uint32_t)Barriers.size(), Stats.RelocatedCount);
+	OutputDebugStringA(Message);
+}
+
+Texture* TextureManager::GetTexture(int SrvIndex) const
+{
+	return Entries[SrvIndex].Tex.get();
+}
+
+int TextureManager::GetSrvCount() const
+{
+	return (int)Entries.size();
+}
+
+const char* TextureManager::GetMaxSrvCountDefine()
+{
+	static const std::string Define = std::to_string(MaxSrvCount);
+	return Define.c_str();
+}
+
+const TextureCacheStats& TextureManager::GetStats() const
+{
+	return Stats;
+}
+
+void TextureManager::AddRef(int SrvIndex)
+{
+	assert(Entries[SrvIndex].Tex);
+	++Entries[SrvIndex].RefCount;
+}
+
+void TextureManager::Release(int SrvIndex)
+{
+	Entry& Target = Entries[SrvIndex];
+	assert(Target.RefCount > 0);
+
+	if (--Target.RefCount > 0)
+	{
+		return;
+	}
+
+	TextureStreamer::Get()->Unload(*Target.Tex);
+
+	// 내용이 같아서 붙은 다른 경로도 같이 지운다.
+	for (auto It = PathToSlot.begin(); It != PathToSlot.end();)
+	{
+		It = It->second == SrvIndex ? PathToSlot.erase(It) : std::next(It);
+	}
+
+	auto HashIt = HashToSlot.find(Target.ContentHash);
+	if (HashIt != HashToSlot.end() && HashIt->second == SrvIndex)
+	{
+		HashToSlot.erase(HashIt);
+	}
+
+	if (Target.bPage)
+	{
+		--Stats.PageCount;
+	}
+	else
+	{
+		--Stats.TextureCount;
+		Stats.LoadedBytes -= Target.Bytes;
+		Stats.PackedCount -= Target.Page ? 1 : 0;
+	}
+
+	// 묶음의 마지막 텍스쳐면 여기서 묶음도 풀린다.
+	Target.Page.Reset();
+
+	Target = Entry();
+	FreeSlots.push_back(SrvIndex);
+}
+
+int TextureManager::AllocateSlot()
+{
+	if (false == FreeSlots.empty())
+	{
+		const int Slot = FreeSlots.back();
+		FreeSlots.pop_back();
+		return Slot;
+	}
+
+	assert((int)Entries.size() < MaxSrvCount);
+	Entries.emplace_back();
+	return (int)Entries.size() - 1;
+}
+
+std::wstring TextureManager::NormalizePath(const std::wstring& Filename)
+{
+	std::wstring Path = Filename;
+	for (wchar_t& Character : Path)
+	{
+		Character = Character == L'\\' ? L'/' : (wchar_t)std::towlower(Character);
+	}
+
+	return Path;
+}
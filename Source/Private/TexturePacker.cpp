@@ -0,0 +1,188 @@
+#include "TexturePacker.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include "DDSFile.h"
+
+namespace
+{
+	bool IsPowerOfTwo(uint32_t Value)
+	{
+		return Value > 0 && (Value & (Value - 1)) == 0;
+	}
+
+	uint32_t FloorLog2(uint32_t Value)
+	{
+		uint32_t Log = 0;
+		while (Value > 1)
+		{
+			Value >>= 1;
+			++Log;
+		}
+
+		return Log;
+	}
+
+	// Z 순서 번호의 짝수 비트가 X, 홀수 비트가 Y
+	uint32_t CompactBits(uint64_t Value)
+	{
+		uint32_t Result = 0;
+		for (uint32_t Bit = 0; Bit < 32; Bit++)
+		{
+			Result |= (uint32_t)((Value >> (Bit * 2)) & 1) << Bit;
+		}
+
+		return Result;
+	}
+
+	bool CanPlaceInAtlas(const TexturePackItem& Item, const TexturePackOptions& Options)
+	{
+		const uint32_t Size = std::max<uint32_t>(Item.Width, Item.Height);
+		if (Item.bRepeat || Size > Options.MaxAtlasItemSize || Size > Options.AtlasSize || Size > Options.MaxItemSize)
+		{
+			return false;
+		}
+
+		if (false == IsPowerOfTwo(Item.Width) || false == IsPowerOfTwo(Item.Height))
+		{
+			return false;
+		}
+
+		return false == DDSFile::IsBlockCompressed(Item.Format) || std::min<uint32_t>(Item.Width, Item.Height) >= 4;
+	}
+
+	// 아틀라스 안에서 이 텍스쳐가 온전히 남는 밉 수. BC는 칸이 블록 하나(4x4)보다 작아지면 이웃과 블록을 나눠 써야 한다.
+	uint32_t GetAtlasMipCount(const TexturePackItem& Item)
+	{
+		const uint32_t Levels = FloorLog2(std::min<uint32_t>(Item.Width, Item.Height)) + 1;
+		const uint32_t Usable = DDSFile::IsBlockCompressed(Item.Format) ? Levels - 2 : Levels;
+
+		return std::max<uint32_t>(1, std::min<uint32_t>(Usable, Item.MipCount));
+	}
+
+	void PackAtlases(const std::vector<TexturePackItem>& Items, const TexturePackOptions& Options,
+		std::vector<TexturePage>& OutPages, std::vector<TexturePlacement>& OutPlacements)
+	{
+		if (0 == Options.MaxAtlasItemSize || false == IsPowerOfTwo(Options.AtlasSize))
+		{
+			return;
+		}
+
+		std::map<uint32_t, std::vector<size_t>> Groups;
+		for (size_t i = 0; i < Items.size(); i++)
+		{
+			if (CanPlaceInAtlas(Items[i], Options))
+			{
+				Groups[Items[i].Format].push_back(i);
+			}
+		}
+
+		const uint64_t SliceArea = (uint64_t)Options.AtlasSize * Options.AtlasSize;
+
+		for (auto& Group : Groups)
+		{
+			std::vector<size_t>& Members = Group.second;
+			if (Members.size() < 2)
+			{
+				continue;
+			}
+
+			// 큰 칸부터 채우면 앞에 놓인 칸 넓이의 합이 늘 지금 칸 넓이의 배수라서 Z 순서 자리가 칸 크기에 맞게 떨어진다.
+			std::stable_sort(Members.begin(), Members.end(), [&Items](size_t Lhs, size_t Rhs)
+			{
+				return std::max<uint32_t>(Items[Lhs].Width, Items[Lhs].Height) > std::max<uint32_t>(Items[Rhs].Width, Items[Rhs].Height);
+			});
+
+			TexturePage Page;
+			Page.Format = Group.first;
+			Page.Width = Options.AtlasSize;
+			Page.Height = Options.AtlasSize;
+			Page.MipCount = FloorLog2(Options.AtlasSize) + 1;
+			Page.ArraySize = 1;
+			Page.bAtlas = true;
+
+			const int PageIndex = (int)OutPages.size();
+			uint64_t Cursor = 0;
+
+			for (size_t Member : Members)
+			{
+				const TexturePackItem& Item = Items[Member];
+				const uint32_t CellSize = std::max<uint32_t>(Item.Width, Item.Height);
+				const uint64_t CellArea = (uint64_t)CellSize * CellSize;
+
+				if (Cursor + CellArea > SliceArea)
+				{
+					++Page.ArraySize;
+					Cursor = 0;
+				}
+
+				const uint64_t CellIndex = Cursor / CellArea;
+				Cursor += CellArea;
+
+				TexturePlacement& Placement = OutPlacements[Member];
+				Placement.Page = PageIndex;
+				Placement.Slice = Page.ArraySize - 1;
+				Placement.X = CompactBits(CellIndex) * CellSize;
+				Placement.Y = CompactBits(CellIndex >> 1) * CellSize;
+				Placement.ScaleU = (float)Item.Width / Options.AtlasSize;
+				Placement.ScaleV = (float)Item.Height / Options.AtlasSize;
+				Placement.OffsetU = (float)Placement.X / Options.AtlasSize;
+				Placement.OffsetV = (float)Placement.Y / Options.AtlasSize;
+
+				Page.MipCount = std::min<uint32_t>(Page.MipCount, GetAtlasMipCount(Item));
+			}
+
+			OutPages.push_back(Page);
+		}
+	}
+
+	void PackArrays(const std::vector<TexturePackItem>& Items, const TexturePackOptions& Options,
+		std::vector<TexturePage>& OutPages, std::vector<TexturePlacement>& OutPlacements)
+	{
+		using GroupKey = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>;
+
+		std::map<GroupKey, std::vector<size_t>> Groups;
+		for (size_t i = 0; i < Items.size(); i++)
+		{
+			const TexturePackItem& Item = Items[i];
+			if (OutPlacements[i].Page >= 0 || Item.Width > Options.MaxItemSize || Item.Height > Options.MaxItemSize)
+			{
+				continue;
+			}
+
+			Groups[GroupKey(Item.Format, Item.Width, Item.Height, Item.MipCount)].push_back(i);
+		}
+
+		for (const auto& Group : Groups)
+		{
+			const std::vector<size_t>& Members = Group.second;
+			if (Members.size() < std::max<uint32_t>(2, Options.MinArraySize))
+			{
+				continue;
+			}
+
+			TexturePage Page;
+			std::tie(Page.Format, Page.Width, Page.Height, Page.MipCount) = Group.first;
+			Page.ArraySize = (uint32_t)Members.size();
+
+			for (uint32_t Slice = 0; Slice < (uint32_t)Members.size(); Slice++)
+			{
+				TexturePlacement& Placement = OutPlacements[Members[Slice]];
+				Placement.Page = (int)OutPages.size();
+				Placement.Slice = Slice;
+			}
+
+			OutPages.push_back(Page);
+		}
+	}
+}
+
+void TexturePacker::Plan(const std::vector<TexturePackItem>& Items, const TexturePackOptions& Options,
+	std::vector<TexturePage>& OutPages, std::vector<TexturePlacement>& OutPlacements)
+{
+	OutPages.clear();
+	OutPlacements.assign(Items.size(), TexturePlacement());
+
+	PackAtlases(Items, Options, OutPages, OutPlacements);
+	PackArrays(Items, Options, OutPages, OutPlacements);
+}
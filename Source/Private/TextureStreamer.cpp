@@ -0,0 +1,494 @@
+#include "TextureStreamer.h"
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include "Framework/d3dUtil.h"
+#include "Framework/DDSTextureLoader.h"
+#include "BlockCompression.h"
+#include "MipGenerator.h"
+#include "SupercompressedTexture.h"
+#include "GpuHeapAllocator.h"
+
+TextureStreamer* TextureStreamer::Streamer = nullptr;
+
+namespace
+{
+	// BC 텍스쳐는 가장 고운 밉의 크기가 4의 배수여야 만들 수 있다.
+	// 스트리밍하면 [0, TailMip] 사이 어느 밉이든 맨 위에 올 수 있으니 전부 확인한다.
+	bool CanStartAtEveryMip(const DDSFile& File, uint32_t TailMip)
+	{
+		if (false == DDSFile::IsBlockCompressed(File.GetFormat()))
+		{
+			return true;
+		}
+
+		for (uint32_t Mip = 0; Mip <= TailMip; Mip++)
+		{
+			const DDSSubresource& Subresource = File.GetSubresource(Mip, 0);
+			if (Subresource.Width % 4 != 0 || Subresource.Height % 4 != 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// 쿠커가 만든 .sctx가 옆에 있으면 DDS 대신 그걸 읽어 원래 DDS 내용으로 푼다. 디스크에서 읽는 양이 줄어든다.
+	std::unique_ptr<DDSFile> OpenSupercompressed(const Texture& Target)
+	{
+		std::unique_ptr<SupercompressedTexture> Compressed = SupercompressedTexture::Open(SupercompressedTexture::GetPathFor(Target.Filename).c_str());
+		if (nullptr == Compressed)
+		{
+			return nullptr;
+		}
+
+		const auto Begin = std::chrono::high_resolution_clock::now();
+		std::unique_ptr<DDSFile> File = Compressed->TranscodeToDDS();
+		const double Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - Begin).count();
+
+		char Message[256];
+		sprintf_s(Message, "[TextureStreamer] %s: %s %llu KB from %llu KB in %.2f ms\n",
+			Target.Name.c_str(), File ? "transcoded" : "failed to transcode",
+			(unsigned long long)(Compressed->GetRawSize() / 1024), (unsigned long long)(Compressed->GetSize() / 1024), Milliseconds);
+		OutputDebugStringA(Message);
+
+		return File;
+	}
+
+	// 밉이 하나뿐인 텍스쳐를 CPU에서 풀어 밉 사슬을 만들고 원래 포맷으로 다시 담는다. 풀 수 없는 포맷이면 nullptr.
+	std::unique_ptr<DDSFile> CreateWithMipChain(const DDSFile& File)
+	{
+		const uint32_t Format = File.GetFormat();
+		const uint32_t Width = File.GetWidth();
+		const uint32_t Height = File.GetHeight();
+
+		bool bBlockCompressed = true;
+		BCFormat Block = BCFormat::BC1;
+		bool bOpaque = false;
+
+		// 이 엔진 텍스쳐는 전부 디퓨즈라 UNORM이어도 sRGB로 저장된 색으로 보고 거른다. BC4, BC5는 데이터 채널이다.
+		bool bSRGB = true;
+
+		switch (Format)
+		{
+		case 71: case 72:
+			Block = BCFormat::BC1;
+			break;
+		case 77: case 78:
+			Block = BCFormat::BC3;
+			break;
+		case 80:
+			Block = BCFormat::BC4;
+			bSRGB = false;
+			break;
+		case 83:
+			Block = BCFormat::BC5;
+			bSRGB = false;
+			break;
+		case 98: case 99:
+			Block = BCFormat::BC7;
+			break;
+		// 채널 순서는 거르는 데 상관없으니 BGRA도 그대로 거른다.
+		case 28: case 29: case 87: case 91:
+			bBlockCompressed = false;
+			break;
+		case 88: case 93:
+			bBlockCompressed = false;
+			bOpaque = true;
+			break;
+		default:
+			return nullptr;
+		}
+
+		const DDSSubresource& Top = File.GetSubresource(0, 0);
+		const uint8_t* Source = File.GetSubresourceData(0, 0);
+
+		std::vector<uint8_t> Pixels;
+		if (bBlockCompressed)
+		{
+			File.DecodeSubresource(0, 0, Pixels);
+		}
+		else
+		{
+			Pixels.resize((size_t)Width * Height * 4);
+			for (uint32_t Y = 0; Y < Height; Y++)
+			{
+				memcpy(Pixels.data() + (size_t)Y * Width * 4, Source + (size_t)Y * Top.RowBytes, (size_t)Width * 4);
+			}
+		}
+
+		if (bOpaque)
+		{
+			for (size_t i = 3; i < Pixels.size(); i += 4)
+			{
+				Pixels[i] = 255;
+			}
+		}
+
+		MipGenerationOptions Options;
+		Options.bSRGB = bSRGB;
+
+		std::vector<std::vector<uint8_t>> Mips;
+		MipGenerator::Generate(Pixels.data(), Width, Height, (size_t)Width * 4, Options, Mips);
+
+		if (bBlockCompressed)
+		{
+			Mips[0].assign(Source, Source + Top.SliceBytes);
+			for (uint32_t Mip = 1; Mip < (uint32_t)Mips.size(); Mip++)
+			{
+				const uint32_t MipWidth = std::max<uint32_t>(1, Width >> Mip);
+				const uint32_t MipHeight = std::max<uint32_t>(1, Height >> Mip);
+
+				std::vector<uint8_t> Blocks(BlockCompression::GetSurfaceBytes(Block, MipWidth, MipHeight));
+				BlockCompression::EncodeSurface(Block, Mips[Mip].data(), MipWidth, MipHeight, (size_t)MipWidth * 4, Blocks.data());
+				Mips[Mip] = std::move(Blocks);
+			}
+		}
+
+		return DDSFile::Create(Format, Width, Height, Mips);
+	}
+}
+
+TextureStreamer::TextureStreamer()
+{
+	assert(Streamer == nullptr);
+	Streamer = this;
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bQuit = true;
+	}
+	WakeCondition.notify_all();
+
+	if (Loader.joinable())
+	{
+		Loader.join();
+	}
+
+	Streamer = nullptr;
+}
+
+TextureStreamer* TextureStreamer::Get()
+{
+	return Streamer;
+}
+
+void TextureStreamer::Init(ID3D12Device* InDevice)
+{
+	Device = InDevice;
+
+	if (false == Loader.joinable())
+	{
+		Loader = std::thread(&TextureStreamer::LoaderMain, this);
+	}
+}
+
+HRESULT TextureStreamer::Load(ID3D12GraphicsCommandList* CommandList, Texture& Target)
+{
+	Target.StreamingHandle = -1;
+
+	std::unique_ptr<DDSFile> File = Open(Target);
+	if (nullptr == File)
+	{
+		return CreateDDSTextureFromFile12(Device.Get(), CommandList, Target.Filename.c_str(), Target.Resource, Target.UploadHeap);
+	}
+
+	// .sctx에서 풀었으면 DDS 파일이 없을 수도 있으니 연 내용으로 만든다.
+	if (File->GetDimension() != DDSDimension::Texture2D || File->GetArraySize() != 1)
+	{
+		return CreateDDSTextureFromMemory12(Device.Get(), CommandList, File->GetData(), File->GetSize(), Target.Resource, Target.UploadHeap);
+	}
+
+	// 파일에서 다시 읽지 않고 이미 열어둔(또는 밉을 채운) 내용으로 만든다.
+	const uint32_t MipCount = File->GetMipCount();
+	const uint32_t TailMip = File->GetFirstMipWithin(TailSize);
+	if (0 == TailMip || false == CanStartAtEveryMip(*File, TailMip))
+	{
+		return CreateDDSTextureFromMemory12(Device.Get(), CommandList, File->GetData(), File->GetSize(), Target.Resource, Target.UploadHeap);
+	}
+
+	// maxsize를 주면 그보다 큰 밉을 건너뛰고 만든다. 꼬리 밉 계산과 같은 기준이다.
+	HRESULT Result = CreateDDSTextureFromMemory12(Device.Get(), CommandList, File->GetData(), File->GetSize(), Target.Resource, Target.UploadHeap, TailSize);
+	if (FAILED(Result))
+	{
+		return Result;
+	}
+
+	std::vector<uint64_t> MipBytes(MipCount);
+	for (uint32_t Mip = 0; Mip < MipCount; Mip++)
+	{
+		const DDSSubresource& Subresource = File->GetSubresource(Mip, 0);
+		MipBytes[Mip] = (uint64_t)Subresource.SliceBytes * Subresource.Depth;
+	}
+
+	StreamedTexture Streamed;
+	Streamed.Target = &Target;
+	Streamed.File = std::move(File);
+	Streamed.ResidentMip = TailMip;
+
+	Target.StreamingHandle = (int)Scheduler.AddTexture(MipBytes.data(), MipCount, MipCount - TailMip);
+	assert(Target.StreamingHandle == (int)Textures.size());
+
+	Textures.push_back(std::move(Streamed));
+
+	return S_OK;
+}
+
+void TextureStreamer::Unload(Texture& Target)
+{
+	RetiredResource Retire;
+	Retire.Fence = LastSubmitFence;
+
+	Retire.Resource = Target.Resource;
+	Retired.push_back(Retire);
+
+	Retire.Resource = Target.UploadHeap;
+	Retired.push_back(Retire);
+
+	if (Target.StreamingHandle >= 0)
+	{
+		// 로더 스레드가 아직 File을 읽고 있을 수 있어서 파일은 스트리머가 끝날 때까지 둔다.
+		Scheduler.RemoveTexture(Target.StreamingHandle);
+		Textures[Target.StreamingHandle].Target = nullptr;
+	}
+
+	Target.Resource.Reset();
+	Target.UploadHeap.Reset();
+	Target.StreamingHandle = -1;
+}
+
+const DDSFile* TextureStreamer::GetFile(const Texture& Target) const
+{
+	return Target.StreamingHandle >= 0 ? Textures[Target.StreamingHandle].File.get() : nullptr;
+}
+
+std::unique_ptr<DDSFile> TextureStreamer::Open(const Texture& Target) const
+{
+	std::unique_ptr<DDSFile> File = OpenSupercompressed(Target);
+	if (nullptr == File)
+	{
+		File = DDSFile::Open(Target.Filename.c_str());
+	}
+
+	if (nullptr == File || File->GetDimension() != DDSDimension::Texture2D || File->GetArraySize() != 1)
+	{
+		return File;
+	}
+
+	// 밉이 하나뿐이면 멀리서 깨져 보이고 텍셀을 띄엄띄엄 읽어 캐시도 버린다. 올리기 전에 사슬을 채운다.
+	if (File->GetMipCount() <= 1 && (File->GetWidth() > 1 || File->GetHeight() > 1))
+	{
+		const auto Begin = std::chrono::high_resolution_clock::now();
+		std::unique_ptr<DDSFile> WithMips = CreateWithMipChain(*File);
+		const double Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - Begin).count();
+
+		if (WithMips)
+		{
+			char Message[256];
+			sprintf_s(Message, "[TextureStreamer] %s: %ux%u had no mips, generated %u in %.1f ms\n",
+				Target.Name.c_str(), WithMips->GetWidth(), WithMips->GetHeight(), WithMips->GetMipCount(), Milliseconds);
+			OutputDebugStringA(Message);
+
+			File = std::move(WithMips);
+		}
+	}
+
+	return File;
+}
+
+void TextureStreamer::RequestScreenSize(int Handle, float ProjectedPixels)
+{
+	if (Handle < 0)
+	{
+		return;
+	}
+
+	const DDSFile& File = *Textures[Handle].File;
+	const uint32_t Size = std::max<uint32_t>(File.GetWidth(), File.GetHeight());
+
+	Scheduler.RequestMip(Handle, TextureStreamingScheduler::ComputeRequiredMip(Size, ProjectedPixels, File.GetMipCount()));
+}
+
+void TextureStreamer::Update(ID3D12GraphicsCommandList* CommandList, UINT64 CompletedFence, UINT64 SubmitFence)
+{
+	Retired.erase(std::remove_if(Retired.begin(), Retired.end(), [CompletedFence](const RetiredResource& Resource)
+	{
+		return Resource.Fence <= CompletedFence;
+	}), Retired.end());
+
+	std::deque<LoadJob> Completed;
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Completed.swap(CompletedJobs);
+	}
+
+	LastSubmitFence = SubmitFence;
+
+	for (LoadJob& Job : Completed)
+	{
+		if (Textures[Job.Handle].Target)
+		{
+			Rebuild(CommandList, Textures[Job.Handle], Job.Mip, &Job, SubmitFence);
+			Scheduler.CompleteLoad(Job.Handle);
+		}
+
+		RetiredResource Upload;
+		Upload.Resource = Job.Upload;
+		Upload.Fence = SubmitFence;
+		Retired.push_back(Upload);
+	}
+
+	Scheduler.Update(++Frame, Commands);
+
+	bool bQueued = false;
+	for (const TextureStreamingCommand& Command : Commands)
+	{
+		StreamedTexture& Streamed = Textures[Command.Texture];
+
+		if (Command.Action == TextureStreamingAction::Evict)
+		{
+			Rebuild(CommandList, Streamed, Command.Mip, nullptr, SubmitFence);
+			continue;
+		}
+
+		// 업로드 버퍼는 여기서 만들어 매핑해두고, 파일에서 읽어 채우는 일만 로더 스레드에 넘긴다.
+		const DDSSubresource& Subresource = Streamed.File->GetSubresource(Command.Mip, 0);
+
+		D3D12_RESOURCE_DESC MipDesc = Streamed.Target->Resource->GetDesc();
+		MipDesc.Width = Subresource.Width;
+		MipDesc.Height = Subresource.Height;
+		MipDesc.MipLevels = 1;
+
+		LoadJob Job;
+		Job.Handle = Command.Texture;
+		Job.Mip = Command.Mip;
+		Job.File = Streamed.File.get();
+
+		UINT64 UploadBytes = 0;
+		Device->GetCopyableFootprints(&MipDesc, 0, 1, 0, &Job.Footprint, nullptr, nullptr, &UploadBytes);
+
+		Job.Upload = GpuHeapAllocator::Get()->CreateResource(GpuMemoryCategory::Upload, CD3DX12_RESOURCE_DESC::Buffer(UploadBytes),
+			D3D12_HEAP_TYPE_UPLOAD, D3D12_RESOURCE_STATE_GENERIC_READ);
+
+		void* Mapped = nullptr;
+		ThrowIfFailed(Job.Upload->Map(0, nullptr, &Mapped));
+		Job.Mapped = static_cast<uint8_t*>(Mapped);
+
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			PendingJobs.push_back(std::move(Job));
+		}
+		bQueued = true;
+	}
+
+	if (bQueued)
+	{
+		WakeCondition.notify_one();
+	}
+}
+
+void TextureStreamer::SetBudget(uint64_t Bytes)
+{
+	Scheduler.SetBudget(Bytes);
+}
+
+void TextureStreamer::SetTailSize(uint32_t Size)
+{
+	TailSize = std::max<uint32_t>(Size, 1);
+}
+
+const TextureStreamingStats& TextureStreamer::GetStats() const
+{
+	return Scheduler.GetStats();
+}
+
+void TextureStreamer::LoaderMain()
+{
+	while (true)
+	{
+		LoadJob Job;
+		{
+			std::unique_lock<std::mutex> Lock(Mutex);
+			WakeCondition.wait(Lock, [this]() { return bQuit || false == PendingJobs.empty(); });
+
+			if (bQuit)
+			{
+				return;
+			}
+
+			Job = std::move(PendingJobs.front());
+			PendingJobs.pop_front();
+		}
+
+		PrepareUpload(Job);
+
+		std::lock_guard<std::mutex> Lock(Mutex);
+		CompletedJobs.push_back(std::move(Job));
+	}
+}
+
+void TextureStreamer::PrepareUpload(LoadJob& Job) const
+{
+	// 매핑된 파일이라 여기서 처음 읽는 순간 디스크에서 올라온다. 메인 스레드는 이걸 기다리지 않는다.
+	const DDSSubresource& Subresource = Job.File->GetSubresource(Job.Mip, 0);
+	const uint8_t* Source = Job.File->GetSubresourceData(Job.Mip, 0);
+	uint8_t* Destination = Job.Mapped + Job.Footprint.Offset;
+
+	for (uint32_t Row = 0; Row < Subresource.RowCount; Row++)
+	{
+		memcpy(Destination + (size_t)Row * Job.Footprint.Footprint.RowPitch, Source + (size_t)Row * Subresource.RowBytes, Subresource.RowBytes);
+	}
+}
+
+void TextureStreamer::Rebuild(ID3D12GraphicsCommandList* CommandList, StreamedTexture& Streamed, uint32_t NewMip, const LoadJob* Job, UINT64 SubmitFence)
+{
+	const uint32_t OldMip = Streamed.ResidentMip;
+	const uint32_t MipCount = Streamed.File->GetMipCount();
+	assert(nullptr == Job || NewMip + 1 == OldMip);
+
+	ComPtr<ID3D12Resource> OldResource = Streamed.Target->Resource;
+	const DDSSubresource& Top = Streamed.File->GetSubresource(NewMip, 0);
+
+	D3D12_RESOURCE_DESC Desc = OldResource->GetDesc();
+	Desc.Width = Top.Width;
+	Desc.Height = Top.Height;
+	Desc.MipLevels = (UINT16)(MipCount - NewMip);
+
+	ComPtr<ID3D12Resource> NewResource = GpuHeapAllocator::Get()->CreateResource(GpuMemoryCategory::Texture, Desc,
+		D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_STATE_COPY_DEST);
+
+	CommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(OldResource.Get(),
+		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE));
+
+	// 두 텍스쳐가 같이 갖는 밉은 GPU 안에서 복사한다.
+	for (uint32_t Mip = std::max<uint32_t>(NewMip, OldMip); Mip < MipCount; Mip++)
+	{
+		CD3DX12_TEXTURE_COPY_LOCATION Destination(NewResource.Get(), Mip - NewMip);
+		CD3DX12_TEXTURE_COPY_LOCATION Source(OldResource.Get(), Mip - OldMip);
+		CommandList->CopyTextureRegion(&Destination, 0, 0, 0, &Source, nullptr);
+	}
+
+	if (Job)
+	{
+		CD3DX12_TEXTURE_COPY_LOCATION Destination(NewResource.Get(), 0);
+		CD3DX12_TEXTURE_COPY_LOCATION Source(Job->Upload.Get(), Job->Footprint);
+		CommandList->CopyTextureRegion(&Destination, 0, 0, 0, &Source, nullptr);
+	}
+
+	CommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(NewResource.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+	// 아직 GPU에 올라간 앞 프레임들이 옛 텍스쳐를 읽고 있을 수 있다.
+	RetiredResource Retire;
+	Retire.Resource = OldResource;
+	Retire.Fence = SubmitFence;
+	Retired.push_back(Retire);
+
+	Streamed.Target->Resource = NewResource;
+	Streamed.ResidentMip = NewMip;
+}
@@ -0,0 +1,275 @@
+#include "TextureStreamingScheduler.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+uint32_t TextureStreamingScheduler::AddTexture(const uint64_t* MipBytes, uint32_t MipCount, uint32_t TailMipCount)
+{
+	assert(MipCount > 0);
+
+	TextureState State;
+	State.MipCount = MipCount;
+	State.TailMip = MipCount - std::min(std::max<uint32_t>(TailMipCount, 1), MipCount);
+	State.ResidentMip = State.TailMip;
+	State.PendingMip = State.TailMip;
+	State.WantedMip = State.TailMip;
+
+	State.ChainBytes.assign(MipCount + 1, 0);
+	for (uint32_t Mip = MipCount; Mip > 0; Mip--)
+	{
+		State.ChainBytes[Mip - 1] = State.ChainBytes[Mip] + MipBytes[Mip - 1];
+	}
+
+	UsedBytes += State.ChainBytes[State.TailMip];
+	Textures.push_back(std::move(State));
+
+	return (uint32_t)Textures.size() - 1;
+}
+
+void TextureStreamingScheduler::RemoveTexture(uint32_t Texture)
+{
+	TextureState& State = Textures[Texture];
+	UsedBytes -= State.ChainBytes[State.PendingMip];
+
+	// 꼬리 밉이 MipCount면 지운 텍스쳐다. ChainBytes[MipCount]가 0이라 통계에도 안 잡힌다.
+	State.TailMip = State.MipCount;
+	State.ResidentMip = State.MipCount;
+	State.PendingMip = State.MipCount;
+	State.WantedMip = State.MipCount;
+}
+
+void TextureStreamingScheduler::SetBudget(uint64_t InBudget)
+{
+	Budget = InBudget;
+}
+
+void TextureStreamingScheduler::SetMaxLoadsPerFrame(uint32_t Count)
+{
+	MaxLoadsPerFrame = std::max<uint32_t>(Count, 1);
+}
+
+void TextureStreamingScheduler::RequestMip(uint32_t Texture, uint32_t Mip)
+{
+	TextureState& State = Textures[Texture];
+	if (State.TailMip == State.MipCount)
+	{
+		return;
+	}
+
+	State.RequestedMip = std::min(State.RequestedMip, Mip);
+}
+
+void TextureStreamingScheduler::Update(uint64_t Frame, std::vector<TextureStreamingCommand>& OutCommands)
+{
+	OutCommands.clear();
+
+	Stats.LoadCount = 0;
+	Stats.EvictCount = 0;
+	Stats.StarvedCount = 0;
+
+	// 이번 프레임에 안 보인 텍스쳐는 꼬리 밉만 있으면 된다. 바로 내리지는 않고 예산이 모자랄 때 먼저 내린다.
+	for (TextureState& State : Textures)
+	{
+		if (State.RequestedMip != UINT32_MAX)
+		{
+			State.WantedMip = std::min(State.RequestedMip, State.TailMip);
+			State.LastUsedFrame = Frame;
+		}
+		else
+		{
+			State.WantedMip = State.TailMip;
+		}
+
+		State.RequestedMip = UINT32_MAX;
+		State.bEvicted = false;
+	}
+
+	// 예산을 줄였으면 그것부터 맞춘다.
+	while (UsedBytes > Budget && EvictOne(UINT64_MAX, UINT32_MAX))
+	{
+	}
+
+	Candidates.clear();
+	for (uint32_t i = 0; i < (uint32_t)Textures.size(); i++)
+	{
+		const TextureState& State = Textures[i];
+		if (State.PendingMip == State.ResidentMip && State.WantedMip < State.ResidentMip && false == State.bEvicted)
+		{
+			Candidates.push_back(i);
+		}
+	}
+
+	// 최근에 쓴 텍스쳐, 그 중에서도 모자란 밉이 많은 텍스쳐부터 올린다.
+	std::sort(Candidates.begin(), Candidates.end(), [this](uint32_t A, uint32_t B)
+	{
+		const TextureState& StateA = Textures[A];
+		const TextureState& StateB = Textures[B];
+		if (StateA.LastUsedFrame != StateB.LastUsedFrame)
+		{
+			return StateA.LastUsedFrame > StateB.LastUsedFrame;
+		}
+
+		const uint32_t GapA = StateA.ResidentMip - StateA.WantedMip;
+		const uint32_t GapB = StateB.ResidentMip - StateB.WantedMip;
+		return GapA != GapB ? GapA > GapB : A < B;
+	});
+
+	for (uint32_t Texture : Candidates)
+	{
+		TextureState& State = Textures[Texture];
+
+		// 앞에서 다른 텍스쳐 자리를 만들다가 내려간 텍스쳐는 이번 프레임에 다시 올리지 않는다.
+		if (State.bEvicted)
+		{
+			continue;
+		}
+
+		if (Stats.LoadCount >= MaxLoadsPerFrame)
+		{
+			break;
+		}
+
+		const uint32_t TargetMip = State.ResidentMip - 1;
+		const uint64_t Cost = GetMipBytes(State, TargetMip);
+
+		while (UsedBytes + Cost > Budget && EvictOne(State.LastUsedFrame, Texture))
+		{
+		}
+
+		if (UsedBytes + Cost > Budget)
+		{
+			++Stats.StarvedCount;
+			continue;
+		}
+
+		State.PendingMip = TargetMip;
+		UsedBytes += Cost;
+
+		TextureStreamingCommand Command;
+		Command.Texture = Texture;
+		Command.Mip = TargetMip;
+		Command.Action = TextureStreamingAction::Load;
+		OutCommands.push_back(Command);
+
+		++Stats.LoadCount;
+	}
+
+	// 한 텍스쳐에서 여러 단계를 내렸어도 명령은 최종 밉 하나로 합친다.
+	for (uint32_t i = 0; i < (uint32_t)Textures.size(); i++)
+	{
+		if (Textures[i].bEvicted)
+		{
+			TextureStreamingCommand Command;
+			Command.Texture = i;
+			Command.Mip = Textures[i].ResidentMip;
+			Command.Action = TextureStreamingAction::Evict;
+			OutCommands.push_back(Command);
+		}
+	}
+
+	Stats.Budget = Budget;
+	Stats.UsedBytes = UsedBytes;
+	Stats.TextureCount = (uint32_t)Textures.size();
+	Stats.ResidentBytes = 0;
+	Stats.PendingLoadCount = 0;
+	for (const TextureState& State : Textures)
+	{
+		Stats.ResidentBytes += State.ChainBytes[State.ResidentMip];
+		Stats.PendingLoadCount += State.PendingMip < State.ResidentMip ? 1 : 0;
+	}
+}
+
+void TextureStreamingScheduler::CompleteLoad(uint32_t Texture)
+{
+	TextureState& State = Textures[Texture];
+	assert(State.PendingMip < State.ResidentMip);
+
+	Stats.ResidentBytes += GetMipBytes(State, State.PendingMip);
+	State.ResidentMip = State.PendingMip;
+}
+
+uint32_t TextureStreamingScheduler::ComputeRequiredMip(uint32_t TextureSize, float ProjectedPixels, uint32_t MipCount)
+{
+	if (0 == MipCount)
+	{
+		return 0;
+	}
+
+	if (ProjectedPixels <= 1.0f)
+	{
+		return MipCount - 1;
+	}
+
+	const float Ratio = (float)TextureSize / ProjectedPixels;
+	if (Ratio <= 1.0f)
+	{
+		return 0;
+	}
+
+	return std::min((uint32_t)std::floor(std::log2(Ratio)), MipCount - 1);
+}
+
+uint32_t TextureStreamingScheduler::GetResidentMip(uint32_t Texture) const
+{
+	return Textures[Texture].ResidentMip;
+}
+
+uint32_t TextureStreamingScheduler::GetMipCount(uint32_t Texture) const
+{
+	return Textures[Texture].MipCount;
+}
+
+const TextureStreamingStats& TextureStreamingScheduler::GetStats() const
+{
+	return Stats;
+}
+
+uint64_t TextureStreamingScheduler::GetMipBytes(const TextureState& State, uint32_t Mip) const
+{
+	return State.ChainBytes[Mip] - State.ChainBytes[Mip + 1];
+}
+
+bool TextureStreamingScheduler::EvictOne(uint64_t MaxLastUsedFrame, uint32_t ExcludedTexture)
+{
+	// 필요 이상으로 올라와 있는 텍스쳐가 먼저, 그 다음은 오래 안 쓴 순서
+	uint32_t Victim = UINT32_MAX;
+	bool bVictimSurplus = false;
+
+	for (uint32_t i = 0; i < (uint32_t)Textures.size(); i++)
+	{
+		const TextureState& State = Textures[i];
+		if (i == ExcludedTexture || State.PendingMip != State.ResidentMip || State.ResidentMip >= State.TailMip)
+		{
+			continue;
+		}
+
+		const bool bSurplus = State.ResidentMip < State.WantedMip;
+		if (false == bSurplus && State.LastUsedFrame >= MaxLastUsedFrame)
+		{
+			continue;
+		}
+
+		if (Victim == UINT32_MAX ||
+			(bSurplus && false == bVictimSurplus) ||
+			(bSurplus == bVictimSurplus && State.LastUsedFrame < Textures[Victim].LastUsedFrame))
+		{
+			Victim = i;
+			bVictimSurplus = bSurplus;
+		}
+	}
+
+	if (Victim == UINT32_MAX)
+	{
+		return false;
+	}
+
+	TextureState& State = Textures[Victim];
+	UsedBytes -= GetMipBytes(State, State.ResidentMip);
+	State.ResidentMip++;
+	State.PendingMip = State.ResidentMip;
+	State.bEvicted = true;
+
+	++Stats.EvictCount;
+
+	return true;
+}
@@ -0,0 +1,398 @@
+#include "TlsfAllocator.h"
+#include <cassert>
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+const uint32_t TlsfAllocator::InvalidHandle;
+
+namespace
+{
+	// Value는 0이 아니어야 한다. Win32에서도 되게 32비트씩 본다.
+	uint32_t FindLowestBit(uint64_t Value)
+	{
+#if defined(_MSC_VER)
+		unsigned long Index = 0;
+		if (_BitScanForward(&Index, (unsigned long)Value))
+		{
+			return Index;
+		}
+		_BitScanForward(&Index, (unsigned long)(Value >> 32));
+		return Index + 32;
+#else
+		return (uint32_t)__builtin_ctzll(Value);
+#endif
+	}
+
+	uint32_t FindHighestBit(uint64_t Value)
+	{
+#if defined(_MSC_VER)
+		unsigned long Index = 0;
+		if (_BitScanReverse(&Index, (unsigned long)(Value >> 32)))
+		{
+			return Index + 32;
+		}
+		_BitScanReverse(&Index, (unsigned long)Value);
+		return Index;
+#else
+		return 63 - (uint32_t)__builtin_clzll(Value);
+#endif
+	}
+
+	uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+	{
+		return (Value + Alignment - 1) & ~(Alignment - 1);
+	}
+}
+
+void TlsfAllocator::Init(uint64_t InSize, uint64_t InGranularity)
+{
+	assert(InGranularity > 0 && (InGranularity & (InGranularity - 1)) == 0);
+
+	Blocks.clear();
+	UnusedBlocks.clear();
+
+	for (uint32_t First = 0; First < FirstLevelCount; First++)
+	{
+		std::fill(std::begin(FreeHeads[First]), std::end(FreeHeads[First]), InvalidHandle);
+		SecondLevelBitmaps[First] = 0;
+	}
+	FirstLevelBitmap = 0;
+
+	Granularity = InGranularity;
+
+	Stats = TlsfStats();
+	Stats.Size = InSize & ~(Granularity - 1);
+
+	if (Stats.Size > 0)
+	{
+		const uint32_t Handle = NewBlock();
+		Blocks[Handle].Size = Stats.Size;
+		InsertFree(Handle);
+	}
+}
+
+uint32_t TlsfAllocator::Allocate(uint64_t Bytes, uint64_t Alignment)
+{
+	assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0);
+
+	Alignment = std::max(Alignment, Granularity);
+	const uint64_t Size = AlignUp(std::max<uint64_t>(Bytes, 1), Granularity);
+
+	// 시작이 어디든 정렬해서 Size가 들어가려면 Alignment - Granularity만큼 더 커야 한다.
+	const uint32_t Handle = FindFree(Size + (Alignment - Granularity));
+	if (Handle == InvalidHandle)
+	{
+		return InvalidHandle;
+	}
+
+	RemoveFree(Handle);
+
+	// 정렬 때문에 남는 앞쪽 틈은 빈 블록으로 떼어낸다. 빈 블록의 앞 이웃은 늘 쓰는 중이라 합칠 것이 없다.
+	const uint64_t Gap = AlignUp(Blocks[Handle].Offset, Alignment) - Blocks[Handle].Offset;
+	if (Gap > 0)
+	{
+		const uint32_t GapHandle = NewBlock();
+		Block& GapBlock = Blocks[GapHandle];
+		Block& Target = Blocks[Handle];
+
+		GapBlock.Offset = Target.Offset;
+		GapBlock.Size = Gap;
+		GapBlock.PrevPhysical = Target.PrevPhysical;
+		GapBlock.NextPhysical = Handle;
+		if (Target.PrevPhysical != InvalidHandle)
+		{
+			Blocks[Target.PrevPhysical].NextPhysical = GapHandle;
+		}
+
+		Target.PrevPhysical = GapHandle;
+		Target.Offset += Gap;
+		Target.Size -= Gap;
+
+		InsertFree(GapHandle);
+	}
+
+	if (Blocks[Handle].Size > Size)
+	{
+		const uint32_t RestHandle = NewBlock();
+		Block& Rest = Blocks[RestHandle];
+		Block& Target = Blocks[Handle];
+
+		Rest.Offset = Target.Offset + Size;
+		Rest.Size = Target.Size - Size;
+		Rest.PrevPhysical = Handle;
+		Rest.NextPhysical = Target.NextPhysical;
+		if (Target.NextPhysical != InvalidHandle)
+		{
+			Blocks[Target.NextPhysical].PrevPhysical = RestHandle;
+		}
+
+		Target.NextPhysical = RestHandle;
+		Target.Size = Size;
+
+		InsertFree(RestHandle);
+	}
+
+	Blocks[Handle].bFree = false;
+	Blocks[Handle].UserData = nullptr;
+
+	Stats.UsedBytes += Size;
+	++Stats.AllocationCount;
+
+	return Handle;
+}
+
+void TlsfAllocator::Free(uint32_t Handle)
+{
+	assert(Handle < Blocks.size() && Blocks[Handle].bUsed && false == Blocks[Handle].bFree);
+
+	Stats.UsedBytes -= Blocks[Handle].Size;
+	--Stats.AllocationCount;
+
+	const uint32_t Prev = Blocks[Handle].PrevPhysical;
+	if (Prev != InvalidHandle && Blocks[Prev].bFree)
+	{
+		RemoveFree(Prev);
+
+		Blocks[Prev].Size += Blocks[Handle].Size;
+		Blocks[Prev].NextPhysical = Blocks[Handle].NextPhysical;
+		if (Blocks[Handle].NextPhysical != InvalidHandle)
+		{
+			Blocks[Blocks[Handle].NextPhysical].PrevPhysical = Prev;
+		}
+
+		DeleteBlock(Handle);
+		Handle = Prev;
+	}
+
+	const uint32_t Next = Blocks[Handle].NextPhysical;
+	if (Next != InvalidHandle && Blocks[Next].bFree)
+	{
+		RemoveFree(Next);
+
+		Blocks[Handle].Size += Blocks[Next].Size;
+		Blocks[Handle].NextPhysical = Blocks[Next].NextPhysical;
+		if (Blocks[Next].NextPhysical != InvalidHandle)
+		{
+			Blocks[Blocks[Next].NextPhysical].PrevPhysical = Handle;
+		}
+
+		DeleteBlock(Next);
+	}
+
+	InsertFree(Handle);
+}
+
+uint64_t TlsfAllocator::GetOffset(uint32_t Handle) const
+{
+	return Blocks[Handle].Offset;
+}
+
+uint64_t TlsfAllocator::GetSize(uint32_t Handle) const
+{
+	return Blocks[Handle].Size;
+}
+
+void TlsfAllocator::SetUserData(uint32_t Handle, void* UserData)
+{
+	Blocks[Handle].UserData = UserData;
+}
+
+void* TlsfAllocator::GetUserData(uint32_t Handle) const
+{
+	return Blocks[Handle].UserData;
+}
+
+void TlsfAllocator::GetAllocations(std::vector<uint32_t>& OutHandles) const
+{
+	OutHandles.clear();
+	for (uint32_t Handle = 0; Handle < (uint32_t)Blocks.size(); Handle++)
+	{
+		if (Blocks[Handle].bUsed && false == Blocks[Handle].bFree)
+		{
+			OutHandles.push_back(Handle);
+		}
+	}
+
+	std::sort(OutHandles.begin(), OutHandles.end(), [this](uint32_t Lhs, uint32_t Rhs)
+	{
+		return Blocks[Lhs].Offset > Blocks[Rhs].Offset;
+	});
+}
+
+uint64_t TlsfAllocator::GetLargestFreeBlock() const
+{
+	if (0 == FirstLevelBitmap)
+	{
+		return 0;
+	}
+
+	// 가장 큰 목록 안에서도 크기가 다를 수 있어서 그 목록만 훑는다.
+	const uint32_t First = FindHighestBit(FirstLevelBitmap);
+	const uint32_t Second = FindHighestBit(SecondLevelBitmaps[First]);
+
+	uint64_t Largest = 0;
+	for (uint32_t Handle = FreeHeads[First][Second]; Handle != InvalidHandle; Handle = Blocks[Handle].NextFree)
+	{
+		Largest = std::max(Largest, Blocks[Handle].Size);
+	}
+
+	return Largest;
+}
+
+bool TlsfAllocator::IsEmpty() const
+{
+	return 0 == Stats.AllocationCount;
+}
+
+const TlsfStats& TlsfAllocator::GetStats() const
+{
+	return Stats;
+}
+
+void TlsfAllocator::Map(uint64_t Size, bool bRoundUp, uint32_t& OutFirst, uint32_t& OutSecond) const
+{
+	uint64_t Units = Size / Granularity;
+
+	// 작은 크기는 한 칸에 한 크기씩 그대로 나눈다.
+	if (Units < SecondLevelCount)
+	{
+		OutFirst = 0;
+		OutSecond = (uint32_t)Units;
+		return;
+	}
+
+	if (bRoundUp)
+	{
+		Units += (1ull << (FindHighestBit(Units) - SecondLevelBits)) - 1;
+	}
+
+	const uint32_t Highest = FindHighestBit(Units);
+	OutFirst = Highest - SecondLevelBits + 1;
+	OutSecond = (uint32_t)(Units >> (Highest - SecondLevelBits)) - SecondLevelCount;
+}
+
+uint32_t TlsfAllocator::FindFree(uint64_t Size) const
+{
+	uint32_t First = 0;
+	uint32_t Second = 0;
+	Map(Size, true, First, Second);
+
+	if (First < FirstLevelCount)
+	{
+		uint32_t SecondMap = SecondLevelBitmaps[First] & (~0u << Second);
+		if (0 == SecondMap)
+		{
+			const uint64_t FirstMap = First + 1 < FirstLevelCount ? FirstLevelBitmap & (~0ull << (First + 1)) : 0;
+			First = FirstMap ? FindLowestBit(FirstMap) : FirstLevelCount;
+			SecondMap = FirstMap ? SecondLevelBitmaps[First] : 0;
+		}
+
+		if (SecondMap)
+		{
+			return FreeHeads[First][FindLowestBit(SecondMap)];
+		}
+	}
+
+	// 올려 잡은 목록 위로 아무것도 없어도 Size가 든 목록에 더 큰 블록이 있을 수 있다. 힙을 통째로 쓰는 경우가 그렇다.
+	Map(Size, false, First, Second);
+	if (First >= FirstLevelCount)
+	{
+		return InvalidHandle;
+	}
+
+	for (uint32_t Handle = FreeHeads[First][Second]; Handle != InvalidHandle; Handle = Blocks[Handle].NextFree)
+	{
+		if (Blocks[Handle].Size >= Size)
+		{
+			return Handle;
+		}
+	}
+
+	return InvalidHandle;
+}
+
+void TlsfAllocator::InsertFree(uint32_t Handle)
+{
+	uint32_t First = 0;
+	uint32_t Second = 0;
+	Map(Blocks[Handle].Size, false, First, Second);
+
+	Block& Target = Blocks[Handle];
+	Target.bFree = true;
+	Target.PrevFree = InvalidHandle;
+	Target.NextFree = FreeHeads[First][Second];
+	if (Target.NextFree != InvalidHandle)
+	{
+		Blocks[Target.NextFree].PrevFree = Handle;
+	}
+
+	FreeHeads[First][Second] = Handle;
+	SecondLevelBitmaps[First] |= 1u << Second;
+	FirstLevelBitmap |= 1ull << First;
+
+	++Stats.FreeBlockCount;
+}
+
+void TlsfAllocator::RemoveFree(uint32_t Handle)
+{
+	uint32_t First = 0;
+	uint32_t Second = 0;
+	Map(Blocks[Handle].Size, false, First, Second);
+
+	Block& Target = Blocks[Handle];
+	if (Target.PrevFree != InvalidHandle)
+	{
+		Blocks[Target.PrevFree].NextFree = Target.NextFree;
+	}
+	else
+	{
+		FreeHeads[First][Second] = Target.NextFree;
+	}
+
+	if (Target.NextFree != InvalidHandle)
+	{
+		Blocks[Target.NextFree].PrevFree = Target.PrevFree;
+	}
+
+	if (FreeHeads[First][Second] == InvalidHandle)
+	{
+		SecondLevelBitmaps[First] &= ~(1u << Second);
+		if (0 == SecondLevelBitmaps[First])
+		{
+			FirstLevelBitmap &= ~(1ull << First);
+		}
+	}
+
+	Target.bFree = false;
+	Target.PrevFree = InvalidHandle;
+	Target.NextFree = InvalidHandle;
+
+	--Stats.FreeBlockCount;
+}
+
+uint32_t TlsfAllocator::NewBlock()
+{
+	uint32_t Handle = 0;
+	if (UnusedBlocks.empty())
+	{
+		Handle = (uint32_t)Blocks.size();
+		Blocks.emplace_back();
+	}
+	else
+	{
+		Handle = UnusedBlocks.back();
+		UnusedBlocks.pop_back();
+		Blocks[Handle] = Block();
+	}
+
+	Blocks[Handle].bUsed = true;
+	return Handle;
+}
+
+void TlsfAllocator::DeleteBlock(uint32_t Handle)
+{
+	Blocks[Handle] = Block();
+	UnusedBlocks.push_back(Handle);
+}
@@ -0,0 +1,265 @@
+#include "UploadManager.h"
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include "Framework/d3dUtil.h"
+
+UploadManager* UploadManager::Manager = nullptr;
+
+namespace
+{
+	// 버퍼 복사는 정렬이 필요 없지만 memcpy가 잘리지 않게 맞춰둔다.
+	const UINT64 BufferAlignment = 16;
+}
+
+UploadManager::UploadManager()
+{
+	assert(Manager == nullptr);
+	Manager = this;
+}
+
+UploadManager::~UploadManager()
+{
+	Manager = nullptr;
+}
+
+UploadManager* UploadManager::Get()
+{
+	return Manager;
+}
+
+void UploadManager::Init(ID3D12Device* InDevice, ID3D12Fence* InFence, UINT64 RingBytes)
+{
+	Device = InDevice;
+	Fence = InFence;
+
+	// 텍스쳐 자리는 512바이트 정렬이라 링 크기도 그 배수로 맞춘다.
+	RingBytes = (std::max<UINT64>(RingBytes, 1) + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+
+	Ring = GpuHeapAllocator::Get()->CreateResource(GpuMemoryCategory::Upload, CD3DX12_RESOURCE_DESC::Buffer(RingBytes),
+		D3D12_HEAP_TYPE_UPLOAD, D3D12_RESOURCE_STATE_GENERIC_READ);
+
+	// 업로드 힙은 매핑한 채로 둬도 된다.
+	ThrowIfFailed(Ring->Map(0, nullptr, reinterpret_cast<void**>(&RingMapped)));
+
+	Allocator.Init(RingBytes);
+}
+
+ComPtr<ID3D12Resource> UploadManager::CreateBuffer(GpuMemoryCategory Category, const void* Data, UINT64 Bytes, D3D12_RESOURCE_STATES FinalState)
+{
+	ComPtr<ID3D12Resource> Buffer = GpuHeapAllocator::Get()->CreateResource(Category, CD3DX12_RESOURCE_DESC::Buffer(Bytes),
+		D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_STATE_COMMON);
+
+	const Staging Source = Allocate(Bytes, BufferAlignment);
+	memcpy(Source.Mapped, Data, (size_t)Bytes);
+
+	PendingCopy Copy;
+	Copy.Dest = Buffer.Get();
+	Copy.Source = Source.Resource;
+	Copy.bBuffer = true;
+	Copy.SourceOffset = Source.Offset;
+	Copy.Bytes = Bytes;
+	Copies.push_back(Copy);
+
+	Track(Buffer.Get(), FinalState);
+
+	return Buffer;
+}
+
+void UploadManager::UploadSubresources(ID3D12Resource* Dest, UINT First, UINT Count, const D3D12_SUBRESOURCE_DATA* Data, D3D12_RESOURCE_STATES FinalState)
+{
+	const D3D12_RESOURCE_DESC Desc = Dest->GetDesc();
+
+	std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Footprints(Count);
+	std::vector<UINT> RowCounts(Count);
+	std::vector<UINT64> RowBytes(Count);
+	UINT64 TotalBytes = 0;
+	Device->GetCopyableFootprints(&Desc, First, Count, 0, Footprints.data(), RowCounts.data(), RowBytes.data(), &TotalBytes);
+
+	// 서브리소스 전부를 한 자리에 담는다.
+	const Staging Source = Allocate(TotalBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+	for (UINT i = 0; i < Count; i++)
+	{
+		const D3D12_SUBRESOURCE_FOOTPRINT& Footprint = Footprints[i].Footprint;
+		const uint8_t* SourceData = static_cast<const uint8_t*>(Data[i].pData);
+		uint8_t* Staged = Source.Mapped + Footprints[i].Offset;
+
+		for (UINT Z = 0; Z < Footprint.Depth; Z++)
+		{
+			for (UINT Row = 0; Row < RowCounts[i]; Row++)
+			{
+				memcpy(Staged + (size_t)Footprint.RowPitch * (RowCounts[i] * Z + Row),
+					SourceData + (size_t)Data[i].SlicePitch * Z + (size_t)Data[i].RowPitch * Row,
+					(size_t)RowBytes[i]);
+			}
+		}
+
+		PendingCopy Copy;
+		Copy.Dest = Dest;
+		Copy.Source = Source.Resource;
+		Copy.DestSubresource = First + i;
+		Copy.Footprint = Footprints[i];
+		Copy.Footprint.Offset += Source.Offset;
+		Copies.push_back(Copy);
+	}
+
+	Track(Dest, FinalState);
+}
+
+void UploadManager::UploadRegion(ID3D12Resource* Dest, UINT DestSubresource, UINT X, UINT Y,
+	const D3D12_RESOURCE_DESC& SourceDesc, UINT SourceSubresource, const D3D12_SUBRESOURCE_DATA& Data, D3D12_RESOURCE_STATES FinalState)
+{
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT Footprint = {};
+	UINT RowCount = 0;
+	UINT64 RowBytes = 0;
+	UINT64 TotalBytes = 0;
+	Device->GetCopyableFootprints(&SourceDesc, SourceSubresource, 1, 0, &Footprint, &RowCount, &RowBytes, &TotalBytes);
+
+	const Staging Source = Allocate(TotalBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+	// 원본 행이 자리의 행보다 짧을 수 있다(밉 끝의 작은 BC 블록 행).
+	const size_t CopyBytes = std::min<size_t>((size_t)RowBytes, (size_t)Data.RowPitch);
+	for (UINT Row = 0; Row < RowCount; Row++)
+	{
+		memcpy(Source.Mapped + (size_t)Row * Footprint.Footprint.RowPitch, static_cast<const uint8_t*>(Data.pData) + (size_t)Row * Data.RowPitch, CopyBytes);
+	}
+
+	PendingCopy Copy;
+	Copy.Dest = Dest;
+	Copy.Source = Source.Resource;
+	Copy.DestSubresource = DestSubresource;
+	Copy.X = X;
+	Copy.Y = Y;
+	Copy.Footprint = Footprint;
+	Copy.Footprint.Offset += Source.Offset;
+	Copies.push_back(Copy);
+
+	Track(Dest, FinalState);
+}
+
+void UploadManager::Update(ID3D12GraphicsCommandList* CommandList, UINT64 CompletedFence, UINT64 SubmitFence)
+{
+	Allocator.Retire(CompletedFence);
+
+	Retired.erase(std::remove_if(Retired.begin(), Retired.end(), [CompletedFence](const RetiredResource& Resource)
+	{
+		return Resource.Fence <= CompletedFence;
+	}), Retired.end());
+
+	if (false == Copies.empty())
+	{
+		// 전환은 자원 수만큼 한 번에, 복사는 그 사이에 몰아서 기록한다.
+		std::vector<D3D12_RESOURCE_BARRIER> Barriers;
+		Barriers.reserve(Transitions.size());
+
+		for (const PendingTransition& Transition : Transitions)
+		{
+			Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Transition.Resource.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
+		}
+		CommandList->ResourceBarrier((UINT)Barriers.size(), Barriers.data());
+
+		for (const PendingCopy& Copy : Copies)
+		{
+			if (Copy.bBuffer)
+			{
+				CommandList->CopyBufferRegion(Copy.Dest, 0, Copy.Source, Copy.SourceOffset, Copy.Bytes);
+				continue;
+			}
+
+			CD3DX12_TEXTURE_COPY_LOCATION Destination(Copy.Dest, Copy.DestSubresource);
+			CD3DX12_TEXTURE_COPY_LOCATION Source(Copy.Source, Copy.Footprint);
+			CommandList->CopyTextureRegion(&Destination, Copy.X, Copy.Y, 0, &Source, nullptr);
+		}
+
+		Barriers.clear();
+		for (PendingTransition& Transition : Transitions)
+		{
+			Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Transition.Resource.Get(), D3D12_RESOURCE_STATE_COPY_DEST, Transition.FinalState));
+
+			// 복사가 끝나기 전에 쓰는 쪽이 놓아도 GPU가 읽는 동안은 살아 있게 한다.
+			RetiredResource Retire;
+			Retire.Resource = std::move(Transition.Resource);
+			Retire.Fence = SubmitFence;
+			Retired.push_back(std::move(Retire));
+		}
+		CommandList->ResourceBarrier((UINT)Barriers.size(), Barriers.data());
+
+		Copies.clear();
+		Transitions.clear();
+	}
+
+	Allocator.Submit(SubmitFence);
+
+	for (ComPtr<ID3D12Resource>& Resource : Dedicated)
+	{
+		RetiredResource Retire;
+		Retire.Resource = std::move(Resource);
+		Retire.Fence = SubmitFence;
+		Retired.push_back(std::move(Retire));
+	}
+	Dedicated.clear();
+}
+
+const StagingStats& UploadManager::GetStats() const
+{
+	return Allocator.GetStats();
+}
+
+UploadManager::Staging UploadManager::Allocate(UINT64 Bytes, UINT64 Alignment)
+{
+	Staging Result;
+
+	UINT64 Offset = Allocator.Allocate(Bytes, Alignment);
+	if (Offset == StagingRing::InvalidOffset && Fence)
+	{
+		Allocator.Retire(Fence->GetCompletedValue());
+		Offset = Allocator.Allocate(Bytes, Alignment);
+	}
+
+	if (Offset != StagingRing::InvalidOffset)
+	{
+		Result.Resource = Ring.Get();
+		Result.Offset = Offset;
+		Result.Mapped = RingMapped + Offset;
+		return Result;
+	}
+
+	// 링보다 크거나 아직 GPU가 링을 다 읽지 않았다. 이것만 따로 만들고 같은 펜스에 푼다.
+	ComPtr<ID3D12Resource> Upload = GpuHeapAllocator::Get()->CreateResource(GpuMemoryCategory::Upload, CD3DX12_RESOURCE_DESC::Buffer(std::max<UINT64>(Bytes, 1)),
+		D3D12_HEAP_TYPE_UPLOAD, D3D12_RESOURCE_STATE_GENERIC_READ);
+
+	ThrowIfFailed(Upload->Map(0, nullptr, reinterpret_cast<void**>(&Result.Mapped)));
+
+	Result.Resource = Upload.Get();
+	Result.Offset = 0;
+
+	Allocator.AddDedicated(Bytes);
+	Dedicated.push_back(Upload);
+
+	char Message[256];
+	sprintf_s(Message, "[UploadManager] %llu KB did not fit the %llu KB ring, using a dedicated upload buffer\n",
+		(unsigned long long)(Bytes / 1024), (unsigned long long)(Allocator.GetCapacity() / 1024));
+	OutputDebugStringA(Message);
+
+	return Result;
+}
+
+void UploadManager::Track(ID3D12Resource* Dest, D3D12_RESOURCE_STATES FinalState)
+{
+	auto It = std::find_if(Transitions.begin(), Transitions.end(), [Dest](const PendingTransition& Transition)
+	{
+		return Transition.Resource.Get() == Dest;
+	});
+
+	if (It != Transitions.end())
+	{
+		assert(It->FinalState == FinalState);
+		return;
+	}
+
+	PendingTransition Transition;
+	Transition.Resource = Dest;
+	Transition.FinalState = FinalState;
+	Transitions.push_back(Transition);
+}
@@ -0,0 +1,161 @@
+#include "VertexWelder.h"
+#include <cmath>
+
+namespace
+{
+	const uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+	const uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+	const uint64_t Prime3 = 0x165667B19E3779F9ull;
+
+	inline uint64_t RotateLeft(uint64_t Value, int Shift)
+	{
+		return (Value << Shift) | (Value >> (64 - Shift));
+	}
+
+	inline uint32_t QuantizeFloat(float Value, float InvEpsilon)
+	{
+		if (InvEpsilon > 0.0f)
+		{
+			return (uint32_t)(int32_t)floorf(Value * InvEpsilon + 0.5f);
+		}
+
+		// -0.0f와 0.0f를 같은 키로 만든다.
+		float Normalized = Value + 0.0f;
+		uint32_t Bits;
+		memcpy(&Bits, &Normalized, sizeof(Bits));
+		return Bits;
+	}
+}
+
+VertexWelder::VertexWelder(std::vector<Vertex>& InVertices, float InEpsilon)
+	:
+	Vertices(InVertices),
+	Epsilon(InEpsilon)
+{
+}
+
+void VertexWelder::Reserve(size_t VertexCount)
+{
+	size_t Capacity = 64;
+	while (Capacity < VertexCount * 2)
+	{
+		Capacity <<= 1;
+	}
+
+	if (Capacity > Slots.size())
+	{
+		Vertices.reserve(VertexCount);
+
+		std::vector<Slot> OldSlots;
+		OldSlots.swap(Slots);
+		Slots.resize(Capacity);
+
+		for (const Slot& Old : OldSlots)
+		{
+			if (Old.Index != UINT32_MAX)
+			{
+				size_t Position = Old.Hash & (Capacity - 1);
+				while (Slots[Position].Index != UINT32_MAX)
+				{
+					Position = (Position + 1) & (Capacity - 1);
+				}
+				Slots[Position] = Old;
+			}
+		}
+	}
+}
+
+uint32_t VertexWelder::Insert(const Vertex& InVertex, uint32_t Group)
+{
+	if ((Count + 1) * 2 > Slots.size())
+	{
+		Grow();
+	}
+
+	const VertexKey Key = MakeKey(InVertex, Epsilon, Group);
+	const uint32_t Hash = (uint32_t)HashKey(Key);
+	const size_t Mask = Slots.size() - 1;
+
+	size_t Position = Hash & Mask;
+	while (true)
+	{
+		++ProbeCount;
+
+		Slot& Current = Slots[Position];
+		if (Current.Index == UINT32_MAX)
+		{
+			Current.Hash = Hash;
+			Current.Index = (uint32_t)Vertices.size();
+			Current.Group = Group;
+			Vertices.push_back(InVertex);
+			++Count;
+			return Current.Index;
+		}
+
+		if (Current.Hash == Hash && MakeKey(Vertices[Current.Index], Epsilon, Current.Group) == Key)
+		{
+			return Current.Index;
+		}
+
+		Position = (Position + 1) & Mask;
+	}
+}
+
+size_t VertexWelder::GetMemoryUsage() const
+{
+	return Slots.capacity() * sizeof(Slot);
+}
+
+size_t VertexWelder::GetProbeCount() const
+{
+	return ProbeCount;
+}
+
+VertexKey VertexWelder::MakeKey(const Vertex& InVertex, float Epsilon, uint32_t Group)
+{
+	const float InvEpsilon = Epsilon > 0.0f ? 1.0f / Epsilon : 0.0f;
+
+	VertexKey Key;
+	Key.Words[0] = QuantizeFloat(InVertex.Pos.x, InvEpsilon);
+	Key.Words[1] = QuantizeFloat(InVertex.Pos.y, InvEpsilon);
+	Key.Words[2] = QuantizeFloat(InVertex.Pos.z, InvEpsilon);
+	Key.Words[3] = QuantizeFloat(InVertex.Normal.x, InvEpsilon);
+	Key.Words[4] = QuantizeFloat(InVertex.Normal.y, InvEpsilon);
+	Key.Words[5] = QuantizeFloat(InVertex.Normal.z, InvEpsilon);
+	Key.Words[6] = QuantizeFloat(InVertex.TexCoord.x, InvEpsilon);
+	Key.Words[7] = QuantizeFloat(InVertex.TexCoord.y, InvEpsilon);
+
+	// 스키닝 정보는 절대 합치면 안 되니까 정확히 비교한다.
+	Key.Words[8] = QuantizeFloat(InVertex.BoneWeights.x, 0.0f);
+	Key.Words[9] = QuantizeFloat(InVertex.BoneWeights.y, 0.0f);
+	Key.Words[10] = QuantizeFloat(InVertex.BoneWeights.z, 0.0f);
+	Key.Words[11] = QuantizeFloat(InVertex.BoneWeights.w, 0.0f);
+	memcpy(&Key.Words[12], InVertex.BoneIndices, sizeof(InVertex.BoneIndices));
+	Key.Words[14] = Group;
+
+	return Key;
+}
+
+uint64_t VertexWelder::HashKey(const VertexKey& Key)
+{
+	uint64_t Hash = Prime3 + sizeof(Key.Words);
+
+	for (int i = 0; i < VertexKey::WordCount; i++)
+	{
+		Hash ^= Key.Words[i] * Prime1;
+		Hash = RotateLeft(Hash, 23) * Prime2 + Prime3;
+	}
+
+	Hash ^= Hash >> 33;
+	Hash *= Prime2;
+	Hash ^= Hash >> 29;
+	Hash *= Prime3;
+	Hash ^= Hash >> 32;
+
+	return Hash;
+}
+
+void VertexWelder::Grow()
+{
+	Reserve(MathHelper::Max<size_t>(Count + 1, Slots.size()));
+}
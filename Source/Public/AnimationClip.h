@@ -0,0 +1,127 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include "ArrayView.h"
+
+using namespace DirectX;
+
+struct BoneTransform
+{
+	XMFLOAT4 Rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+	XMFLOAT3 Translation = { 0.0f, 0.0f, 0.0f };
+	XMFLOAT3 Scale = { 1.0f, 1.0f, 1.0f };
+
+	XMMATRIX ToMatrix() const;
+};
+
+struct AnimationClipInfo
+{
+	uint32_t FrameCount = 0;
+	uint32_t BoneCount = 0;
+	float FrameRate = 24.0f;
+	uint32_t Pad = 0;
+};
+
+// 뼈 하나가 쓰는 키 범위. 채널마다 키는 프레임 순으로 정렬돼 있다.
+struct AnimationTrack
+{
+	uint32_t RotationStart = 0;
+	uint32_t RotationCount = 0;
+	uint32_t TranslationStart = 0;
+	uint32_t TranslationCount = 0;
+	uint32_t ScaleStart = 0;
+	uint32_t ScaleCount = 0;
+};
+
+// Smallest-three 48비트 쿼터니언: 제일 큰 성분 번호 2비트 + 나머지 세 성분 15비트씩.
+struct RotationKey
+{
+	uint16_t Frame = 0;
+	uint16_t Packed[3] = {};
+};
+
+struct VectorKey
+{
+	XMFLOAT3 Value = { 0.0f, 0.0f, 0.0f };
+	uint32_t Frame = 0;
+};
+
+struct AnimationCompressionSettings
+{
+	// 라디안. 48비트로 양자화한 키 값으로 보간해서 재니까 양자화 오차도 들어 있다.
+	// AnimationClip::RotationQuantizationError보다 작게 주면 그 값으로 올려서 쓴다.
+	float RotationTolerance = 0.001f;
+
+	// 이동과 스케일 키는 float 그대로 저장해서 오차는 키를 버릴 때만 생긴다.
+	// 뼈 로컬 공간에서 원본 단위로 이 값 이하고, 자식 뼈에는 부모들의 오차가 계층을 따라 더해진다.
+	float TranslationTolerance = 0.001f;
+	float ScaleTolerance = 0.0001f;
+};
+
+// 압축 결과. 쿠킹할 때 이 배열들을 그대로 섹션으로 쓴다.
+struct AnimationClipData
+{
+	AnimationClipInfo Info;
+	std::vector<AnimationTrack> Tracks;
+	std::vector<RotationKey> Rotations;
+	std::vector<VectorKey> Translations;
+	std::vector<VectorKey> Scales;
+};
+
+// 키를 직접 들고 있지 않고 쿠킹된 데이터나 AnimationClipData를 가리키기만 한다.
+class AnimationClip
+{
+public:
+	AnimationClip() = default;
+	AnimationClip(const AnimationClipInfo& InInfo,
+		ArrayView<AnimationTrack> InTracks,
+		ArrayView<RotationKey> InRotations,
+		ArrayView<VectorKey> InTranslations,
+		ArrayView<VectorKey> InScales);
+	explicit AnimationClip(const AnimationClipData& Data);
+
+public:
+	// Poses는 프레임 순서로 FrameCount * BoneCount 개.
+	static void Compress(const std::vector<BoneTransform>& Poses,
+		uint32_t FrameCount,
+		uint32_t BoneCount,
+		float FrameRate,
+		const AnimationCompressionSettings& Settings,
+		AnimationClipData& OutData);
+
+	static void PackRotation(FXMVECTOR Rotation, uint16_t OutPacked[3]);
+	static XMVECTOR UnpackRotation(const uint16_t Packed[3]);
+
+	// PackRotation 한 번으로 생기는 최대 회전 오차(라디안). 성분당 15비트라 약 0.00014.
+	static const float RotationQuantizationError;
+
+public:
+	// Frame은 소수 프레임이고 클립 범위로 잘린다. OutPose는 BoneCount 개.
+	// MaxBoneCount를 주면 앞쪽 뼈만 샘플링하고 나머지는 건드리지 않는다.
+	// 뼈 4개씩 성분별로 모아서 키를 풀고 보간한다.
+	void Sample(float Frame, BoneTransform* OutPose, uint32_t MaxBoneCount = UINT32_MAX) const;
+
+	// 뼈 하나씩 푸는 기준 구현. Sample과 결과와 속도를 비교할 때 쓴다.
+	void SampleScalar(float Frame, BoneTransform* OutPose, uint32_t MaxBoneCount = UINT32_MAX) const;
+
+public:
+	bool IsValid() const;
+	uint32_t GetFrameCount() const;
+	uint32_t GetBoneCount() const;
+	float GetFrameRate() const;
+	float GetDuration() const;
+	size_t GetByteSize() const;
+
+private:
+	void SampleGroup(float Frame, uint32_t FirstBone, BoneTransform* OutPose) const;
+	void SampleBone(float Frame, uint32_t Bone, BoneTransform& OutTransform) const;
+
+private:
+	AnimationClipInfo Info;
+	ArrayView<AnimationTrack> Tracks;
+	ArrayView<RotationKey> Rotations;
+	ArrayView<VectorKey> Translations;
+	ArrayView<VectorKey> Scales;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "FrameResource.h"
+#include "Skeleton.h"
+#include "AnimationClip.h"
+
+using namespace DirectX;
+
+enum class AnimationLoopMode : uint8_t
+{
+	Loop = 0,
+	Once,
+	PingPong
+};
+
+// 인스턴스 하나의 재생 상태. Time은 초 단위.
+struct AnimationState
+{
+	uint32_t ClipIndex = 0;
+	float Time = 0.0f;
+	float PlayRate = 1.0f;
+	AnimationLoopMode LoopMode = AnimationLoopMode::Loop;
+};
+
+// 화면에 작게 보일수록 포즈를 드물게 갱신하고 깊은 뼈는 바인드 포즈로 둔다.
+struct AnimationLodSettings
+{
+	static const uint32_t LodCount = 4;
+
+	// 화면 높이 대비 크기가 ScreenSizes[i]보다 작으면 i + 1 단계
+	float ScreenSizes[LodCount - 1] = { 0.2f, 0.1f, 0.05f };
+
+	// 이 프레임 간격마다 한 번 갱신한다. 인스턴스마다 시작 프레임을 엇갈려서 부하를 나눈다.
+	uint32_t UpdateIntervals[LodCount] = { 1, 2, 4, 8 };
+
+	// 이보다 깊은 뼈는 샘플링하지 않는다.
+	uint32_t MaxBoneDepths[LodCount] = { UINT32_MAX, UINT32_MAX, 8, 4 };
+
+	// 포즈를 이 프레임 간격으로 맞춰서 공유한다. 0이면 시간이 정확히 같을 때만 공유한다.
+	// 가까이 보이는 LOD 0은 한 프레임 단위로 맞추면 움직임이 끊겨 보이니 맞추지 않는다.
+	float PoseQuantizations[LodCount] = { 0.0f, 0.25f, 0.5f, 1.0f };
+};
+
+// 마지막 UpdatePalettes 기준
+struct AnimationStats
+{
+	size_t PosedInstanceCount = 0;
+	size_t UniquePoseCount = 0;
+	size_t ComputedPoseCount = 0;
+	size_t HeldInstanceCount = 0;
+
+	// 버퍼 용량이 모자라서 자기 포즈 대신 다른 포즈를 쓴 인스턴스 수
+	size_t OverflowInstanceCount = 0;
+	size_t LodInstanceCounts[AnimationLodSettings::LodCount] = {};
+
+	// 이번 프레임에 애니메이션 버퍼로 올린 팔레트 크기
+	size_t UploadBytes = 0;
+
+	double PaletteMs = 0.0;
+
+	// 전부 LOD 0으로 따로 계산했을 때와 비교한 추정치
+	double SavedMs = 0.0;
+};
+
+// 인스턴스마다 따로 재생하고, 보이는 인스턴스의 본 팔레트를 매 프레임 애니메이션 버퍼에 채운다.
+// 같은 클립의 비슷한 시간은 한 포즈로 모아서 팔레트를 한 번만 만들고 같이 가리키게 한다.
+class Animator
+{
+public:
+	void Init(const Skeleton& InSkeleton);
+	uint32_t AddClip(const AnimationClip& Clip);
+	uint32_t AddInstance(const AnimationState& State);
+
+public:
+	void Advance(float DeltaTime);
+
+	// 보이는 인스턴스의 팔레트를 버퍼의 [BaseOffset, BaseOffset + Capacity)에 채우고 각자 쓸 위치를 OutPaletteOffsets[i]에 돌려준다.
+	// ScreenSizes[i]는 Instances[i]의 화면 높이 대비 크기. 비어 있으면 전부 LOD 0.
+	// 고유 포즈가 Capacity에 다 안 들어가면 넘친 인스턴스는 마지막으로 들어간 포즈를 같이 쓴다.
+	void UpdatePalettes(const std::vector<int>& Instances,
+		const std::vector<float>& ScreenSizes,
+		UploadBuffer<AnimationData>* AnimationBuffer,
+		UINT BaseOffset,
+		UINT Capacity,
+		std::vector<UINT>& OutPaletteOffsets);
+
+	// 인스턴스의 현재 포즈를 LOD 없이 계산해서 행렬 팔레트로 돌려준다. CPU 스키닝처럼 버퍼 밖에서 쓸 때.
+	void ComputeInstancePalette(size_t Instance, XMMATRIX* OutPalette);
+
+public:
+	void SetLodSettings(const AnimationLodSettings& InSettings);
+
+public:
+	AnimationState& GetState(size_t Instance);
+	size_t GetInstanceCount() const;
+	uint32_t GetBoneCount() const;
+	const AnimationStats& GetStats() const;
+
+private:
+	// 스레드마다 하나씩 쓰는 작업 공간
+	struct PoseScratch
+	{
+		std::vector<BoneTransform> LocalPose;
+		std::vector<XMMATRIX> ModelPose;
+		std::vector<XMMATRIX> Palette;
+
+		size_t ComputedPoseCount = 0;
+		size_t SampledBoneCount = 0;
+	};
+
+	struct PoseKey
+	{
+		uint64_t Key = 0;
+		uint32_t ClipIndex = 0;
+		uint32_t Lod = 0;
+		float Frame = 0.0f;
+	};
+
+	// 갱신을 건너뛰는 프레임에는 마지막으로 뽑은 시간을 그대로 쓴다.
+	struct HeldPose
+	{
+		uint32_t ClipIndex = 0;
+		float Frame = 0.0f;
+		bool bValid = false;
+	};
+
+	// 오프셋은 팔레트 영역 시작 기준이다. 고유 포즈는 MaxPoseCount 개까지만 만든다.
+	void GatherPoses(const std::vector<int>& Instances, const std::vector<float>& ScreenSizes, size_t MaxPoseCount, std::vector<UINT>& OutPaletteOffsets);
+
+	template<typename WriteFunc>
+	void WritePalettes(WriteFunc Write);
+
+	void ComputePalette(const PoseKey& Pose, PoseScratch& Scratch) const;
+	float GetSampleFrame(const AnimationState& State) const;
+	uint32_t SelectLod(float ScreenSize) const;
+	void UpdateLodBoneCounts();
+
+private:
+	Skeleton Skel;
+	std::vector<AnimationClip> Clips;
+	std::vector<AnimationState> States;
+	std::vector<HeldPose> HeldPoses;
+	std::vector<PoseScratch> Scratches;
+
+	AnimationLodSettings LodSettings;
+	uint32_t LodBoneCounts[AnimationLodSettings::LodCount] = {};
+	uint64_t FrameIndex = 0;
+
+	// (클립, LOD, 맞춘 프레임) -> UniquePoses 번호. 지난 프레임 것은 팔레트를 다시 쓰는 데 쓴다.
+	std::unordered_map<uint64_t, UINT> PoseSlots;
+	std::unordered_map<uint64_t, UINT> PreviousPoseSlots;
+	std::vector<PoseKey> UniquePoses;
+	std::vector<AnimationData> Palettes;
+	std::vector<AnimationData> PreviousPalettes;
+
+	AnimationStats Stats;
+	double MsPerFullPose = 0.0;
+};
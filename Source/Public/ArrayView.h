@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// 소유권 없이 연속된 메모리를 읽기 전용으로 가리킨다. 쿠킹된 파일의 매핑 영역을 복사 없이 넘길 때 쓴다.
+template<typename T>
+class ArrayView
+{
+public:
+	ArrayView() = default;
+
+	ArrayView(const T* InData, size_t InCount)
+		:
+		Data(InData),
+		Count(InCount)
+	{
+	}
+
+	ArrayView(const std::vector<T>& InVector)
+		:
+		Data(InVector.data()),
+		Count(InVector.size())
+	{
+	}
+
+public:
+	const T* data() const
+	{
+		return Data;
+	}
+
+	size_t size() const
+	{
+		return Count;
+	}
+
+	bool empty() const
+	{
+		return 0 == Count;
+	}
+
+	const T* begin() const
+	{
+		return Data;
+	}
+
+	const T* end() const
+	{
+		return Data + Count;
+	}
+
+	const T& operator[](size_t Index) const
+	{
+		return Data[Index];
+	}
+
+private:
+	const T* Data = nullptr;
+	size_t Count = 0;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+enum class BCFormat : uint32_t
+{
+	BC1 = 0,
+	BC3,
+	BC4,
+	BC5,
+	BC7
+};
+
+// 4x4 블록 압축. 블록 하나의 입력과 출력은 RGBA8 16픽셀(행 순서, 64바이트)이다.
+// 인코더는 SSE2로 4픽셀씩 묶어 끝점을 잡고 인덱스를 고른다. 표면 단위 함수는 블록 행을 JobSystem으로 나눈다.
+// BC4는 R, BC5는 RG만 쓰고 BC7은 모드 6(RGBA 한 구간)만 만든다.
+class BlockCompression
+{
+public:
+	static void EncodeBlock(BCFormat Format, const uint8_t* Pixels, uint8_t* Block);
+
+	// 디코딩은 BlockDecoder로 넘긴다. 인코더가 만들지 않는 블록(BC7의 다른 모드 등)도 풀린다.
+	static void DecodeBlock(BCFormat Format, const uint8_t* Block, uint8_t* Pixels);
+
+	// Pixels는 RGBA8이고 행마다 RowPitch 바이트. 4의 배수가 아닌 가장자리는 마지막 행과 열을 반복해서 채운다.
+	// JobSystem이 없으면 부른 스레드에서 전부 처리한다.
+	static void EncodeSurface(BCFormat Format, const uint8_t* Pixels, uint32_t Width, uint32_t Height, size_t RowPitch, uint8_t* OutBlocks);
+	static void DecodeSurface(BCFormat Format, const uint8_t* Blocks, uint32_t Width, uint32_t Height, uint8_t* OutPixels, size_t RowPitch);
+
+public:
+	static uint32_t GetBlockBytes(BCFormat Format);
+	static size_t GetSurfaceBytes(BCFormat Format, uint32_t Width, uint32_t Height);
+	static uint32_t GetDXGIFormat(BCFormat Format, bool bSRGB);
+
+	// 포맷이 담는 채널 수. RGBA 앞에서부터 센다.
+	static uint32_t GetChannelCount(BCFormat Format);
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// DXGI BC1~BC7 블록을 CPU에서 푼다. GPU를 거치지 않고 텍스쳐 내용을 읽어야 하는 쪽(가려짐 판정, 높이 샘플링, 썸네일, 검증)에서 쓴다.
+// 포맷은 DDSFile과 같이 DXGI_FORMAT 값 그대로 받는다. 팔레트와 인덱스 선택은 SSE2로 하고, 표면 단위 함수는 블록 행을 JobSystem으로 나눈다.
+// BC1~BC5 보간은 정수 나눗셈에서 버림(SNORM만 float)이고, BC6H와 BC7은 스펙의 정수 식 그대로다.
+class BlockDecoder
+{
+public:
+	static bool IsSupported(uint32_t Format);
+
+	// RGBA8로 담을 수 있는지. BC6H와 SNORM인 BC4, BC5는 float로만 푼다.
+	static bool HasUnormOutput(uint32_t Format);
+
+	static uint32_t GetBlockBytes(uint32_t Format);
+
+public:
+	// 블록 하나를 16픽셀(행 순서)로 푼다. BC4는 (R, 0, 0, 1), BC5는 (R, G, 0, 1)로 채운다.
+	static void DecodeBlock(uint32_t Format, const uint8_t* Block, uint8_t* OutPixels);
+	static void DecodeBlockFloat(uint32_t Format, const uint8_t* Block, float* OutPixels);
+
+	// 블록 행마다 BlockRowPitch 바이트, 0이면 빈 공간 없이 붙어 있다고 본다. RowPitch는 출력 행 하나의 바이트 수.
+	// 4의 배수가 아닌 가장자리는 보이는 픽셀만 쓴다. 풀 수 없는 포맷이면 false.
+	static bool DecodeSurface(uint32_t Format, const uint8_t* Blocks, size_t BlockRowPitch, uint32_t Width, uint32_t Height, uint8_t* OutPixels, size_t RowPitch);
+	static bool DecodeSurfaceFloat(uint32_t Format, const uint8_t* Blocks, size_t BlockRowPitch, uint32_t Width, uint32_t Height, float* OutPixels, size_t RowPitch);
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include "ArrayView.h"
+#include "Vertex.h"
+
+using namespace DirectX;
+
+// CPU에서 스키닝한 결과. 그림자, 피킹, 물리처럼 성분별로 훑는 쪽에서 쓰기 좋게 성분마다 따로 모은다.
+struct SkinnedVertexStream
+{
+	std::vector<float> PositionX;
+	std::vector<float> PositionY;
+	std::vector<float> PositionZ;
+	std::vector<float> NormalX;
+	std::vector<float> NormalY;
+	std::vector<float> NormalZ;
+
+	void Resize(size_t Count);
+	size_t Size() const;
+};
+
+// 셰이더 없이 바인드 포즈 정점을 행렬 팔레트로 스키닝한다. 정점 4개씩 묶어서 SIMD로 처리한다.
+class CpuSkinning
+{
+public:
+	// 정점 범위를 잘라서 JobSystem으로 나눠 처리한다.
+	static void Skin(ArrayView<Vertex> Vertices, const XMMATRIX* Palette, uint32_t BoneCount, SkinnedVertexStream& Out);
+
+	// Out은 미리 Vertices 크기만큼 잡혀 있어야 한다.
+	static void SkinRange(ArrayView<Vertex> Vertices, const XMMATRIX* Palette, uint32_t BoneCount, size_t Begin, size_t End, SkinnedVertexStream& Out);
+};
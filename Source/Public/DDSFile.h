@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "MappedFile.h"
+
+enum class DDSDimension : uint32_t
+{
+	Unknown = 0,
+	Texture1D,
+	Texture2D,
+	Texture3D
+};
+
+// 열기나 파싱이 왜 실패했는지. DDSTextureLoader가 HRESULT로 바꿔서 돌려준다.
+enum class DDSResult : uint32_t
+{
+	Ok = 0,
+	FileNotFound,	// 파일을 열거나 매핑하지 못했다. 빈 파일도 여기에 들어간다.
+	InvalidData,	// DDS가 아니거나 헤더 값이 서로 맞지 않는다.
+	Truncated,		// 헤더가 말하는 픽셀 데이터보다 파일이 짧다.
+	NotSupported	// 올바른 DDS지만 포맷이나 크기를 다룰 수 없다.
+};
+
+// 서브리소스 하나가 파일 안 어디에 있는지. 블록 압축 포맷이면 행 하나가 블록 한 줄이다.
+struct DDSSubresource
+{
+	size_t Offset = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t Depth = 0;
+	uint32_t RowBytes = 0;
+	uint32_t RowCount = 0;
+
+	// 깊이 한 장 크기. 3D 텍스쳐면 이게 Depth 장 이어진다.
+	uint32_t SliceBytes = 0;
+};
+
+// DDS 헤더를 읽고 서브리소스 배치를 미리 계산해둔다. 픽셀은 복사하지 않고 매핑한 파일을 그대로 가리킨다.
+// D3D 헤더 없이 돌아가서 Windows가 아니어도 파싱과 배치 계산을 해볼 수 있다. 포맷은 DXGI_FORMAT 값 그대로.
+class DDSFile
+{
+public:
+	DDSFile() = default;
+	DDSFile(const DDSFile& Rhs) = delete;
+	DDSFile& operator=(const DDSFile& Rhs) = delete;
+
+public:
+	// 실패하면 nullptr이고 OutResult에 이유를 남긴다.
+	static std::unique_ptr<DDSFile> Open(const char* FilePath, DDSResult* OutResult = nullptr);
+	static std::unique_ptr<DDSFile> Open(const wchar_t* FilePath, DDSResult* OutResult = nullptr);
+
+	// Data는 DDSFile보다 오래 살아 있어야 한다.
+	static std::unique_ptr<DDSFile> FromMemory(const uint8_t* Data, size_t Size, DDSResult* OutResult = nullptr);
+
+	// 이미 메모리에 만든 DDS 파일 내용을 넘겨받아 들고 있는다.
+	static std::unique_ptr<DDSFile> FromStorage(std::vector<uint8_t>&& Bytes);
+
+	// Save와 같은 내용을 파일 대신 DDSFile 안에 들고 있는다. 밉을 새로 만든 텍스쳐를 파일처럼 다룰 때 쓴다.
+	static std::unique_ptr<DDSFile> Create(uint32_t Format, uint32_t Width, uint32_t Height, const std::vector<std::vector<uint8_t>>& Mips);
+
+	// DX10 헤더를 붙인 2D 텍스쳐 하나를 쓴다. Mips[i]가 밉 i이고 행 사이에 빈 공간이 없어야 한다.
+	static bool Save(const char* FilePath, uint32_t Format, uint32_t Width, uint32_t Height, const std::vector<std::vector<uint8_t>>& Mips);
+
+	// 포맷 하나의 픽셀당 비트 수. 지원하지 않는 포맷이면 0.
+	static uint32_t GetBitsPerPixel(uint32_t Format);
+	static bool IsBlockCompressed(uint32_t Format);
+
+public:
+	// D3D12 서브리소스 순서(Mip + ArraySlice * MipCount)와 같다.
+	const DDSSubresource& GetSubresource(uint32_t Mip, uint32_t ArraySlice) const;
+	const uint8_t* GetSubresourceData(uint32_t Mip, uint32_t ArraySlice) const;
+
+	// 가로, 세로, 깊이가 전부 MaxSize 이하가 되는 첫 밉. MaxSize가 0이면 0.
+	uint32_t GetFirstMipWithin(size_t MaxSize) const;
+
+	// 블록 압축 서브리소스를 BlockDecoder로 풀어 RGBA를 행 사이 빈 공간 없이 담는다. 3D 텍스쳐면 깊이 장이 차례로 이어진다.
+	// 압축 포맷이 아니거나 RGBA8로 담을 수 없으면 false.
+	bool DecodeSubresource(uint32_t Mip, uint32_t ArraySlice, std::vector<uint8_t>& OutPixels) const;
+	bool DecodeSubresourceFloat(uint32_t Mip, uint32_t ArraySlice, std::vector<float>& OutPixels) const;
+
+public:
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	uint32_t GetDepth() const;
+	uint32_t GetMipCount() const;
+	uint32_t GetArraySize() const;
+	uint32_t GetFormat() const;
+	DDSDimension GetDimension() const;
+	bool IsCubeMap() const;
+
+	// 헤더를 포함한 파일 전체
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+
+private:
+	static bool Serialize(uint32_t Format, uint32_t Width, uint32_t Height, const std::vector<std::vector<uint8_t>>& Mips, std::vector<uint8_t>& Out);
+
+	DDSResult Parse(const uint8_t* InData, size_t InSize);
+	DDSResult BuildLayout(size_t BitOffset);
+
+private:
+	MappedFile File;
+	std::vector<uint8_t> Storage;
+
+	const uint8_t* Data = nullptr;
+	size_t Size = 0;
+
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t Depth = 0;
+	uint32_t MipCount = 0;
+	uint32_t ArraySize = 0;
+	uint32_t Format = 0;
+	DDSDimension Dimension = DDSDimension::Unknown;
+	bool bCubeMap = false;
+
+	std::vector<DDSSubresource> Subresources;
+};
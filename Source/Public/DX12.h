@@ -48,6 +48,13 @@ private:
 	void BuildFrameResources();
 	void BuildDescriptorHeaps();
 
+	// 스트리밍으로 텍스쳐 자원이 바뀌었으면 이번 프레임 테이블만 다시 쓴다.
+	void UpdateTextureDescriptors();
+
+	// 비었거나 풀린 자리. 셰이더가 배열 전체를 묶으니 자원 없는 Texture2DArray SRV로 채워둔다.
+	void CreateNullTextureDescriptor(size_t DescriptorIndex);
+	D3D12_GPU_DESCRIPTOR_HANDLE GetTextureTable() const;
+
 private:
 	ID3D12Resource* CurrentBackBuffer() const;
 
@@ -85,6 +92,10 @@ private:
 	ComPtr<ID3D12DescriptorHeap> CBVHeap;
 	ComPtr<ID3D12DescriptorHeap> SRVHeap;
 
+	// 프레임 리소스마다 테이블을 따로 둔다. 각 테이블이 지금 가리키는 자원이고, nullptr인 자리에는 null SRV가 들어 있다.
+	std::vector<ID3D12Resource*> BoundTextures;
+	size_t TextureTableSize = 0;
+
 	std::vector<std::unique_ptr<FrameResource>> FrameResources;
 	FrameResource* CurFrameResource = nullptr;
 	int CurFrameResourceIndex = 0;
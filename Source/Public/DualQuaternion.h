@@ -0,0 +1,20 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+using namespace DirectX;
+
+// 강체 변환을 회전 쿼터니언(Real)과 이동을 담은 쿼터니언(Dual) 두 개로 나타낸다.
+// 스케일은 담지 못하니 팔레트에 스케일이 섞여 있으면 버려진다.
+class DualQuaternion
+{
+public:
+	static void FromMatrix(FXMMATRIX Matrix, XMVECTOR& OutReal, XMVECTOR& OutDual);
+
+	// 첫 번째 영향과 같은 반구로 맞춰서 더한 뒤 정규화한다. 셰이더와 같은 방식.
+	static void Blend(const XMVECTOR* Reals, const XMVECTOR* Duals, const float* Weights, uint32_t Count, XMVECTOR& OutReal, XMVECTOR& OutDual);
+
+	static XMVECTOR TransformPoint(FXMVECTOR Real, FXMVECTOR Dual, FXMVECTOR Point);
+	static XMVECTOR TransformNormal(FXMVECTOR Real, FXMVECTOR Normal);
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "GameObject.h"
+#include "Animator.h"
+#include "CpuSkinning.h"
 
 class Dummy : public GameObject
 {
@@ -14,7 +16,23 @@ public:
 	virtual void BuildShadersAndInputLayout() override;
 	virtual void BuildRenderItem(int& InstanceOffset, std::vector<std::unique_ptr<FrameResource>>& FrameResources) override;
 
+public:
+	// 그림자, 피킹, 물리처럼 셰이더 밖에서 모양이 필요할 때. 인스턴스의 현재 포즈로 스키닝한 모델 공간 정점.
+	void SkinInstance(int Instance, SkinnedVertexStream& Out);
+
+protected:
+	virtual void UpdateAnimation(FrameResource* CurFrameResource) override;
+	virtual void AppendStats(std::wostringstream& Stats) const override;
+
 private:
 	virtual std::array<const CD3DX12_STATIC_SAMPLER_DESC, 6> GetStaticSamplers();
+
+private:
+	Animator InstanceAnimator;
+
+	// VisibleInstances와 같은 순서
+	std::vector<float> ScreenSizes;
+
+	std::vector<XMMATRIX> CpuPalette;
 };
 
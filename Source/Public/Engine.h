@@ -6,7 +6,12 @@
 
 class WindowManager;
 class GameTimer;
+class JobSystem;
 class FbxLoader;
+class GpuHeapAllocator;
+class UploadManager;
+class TextureStreamer;
+class TextureManager;
 class DX12;
 class GameObject;
 class Camera;
@@ -34,6 +39,7 @@ private:
 	void InitGameObjects();
 	bool InitGraphics();
 	void InitTimer();
+	void InitJobSystem();
 	void InitLoader();
 	void InitCamera();
 
@@ -44,8 +50,19 @@ private:
 
 	std::vector<std::unique_ptr<GameObject>> GameObjects;
 
+	std::unique_ptr<JobSystem> Jobs;
+
 	std::unique_ptr<FbxLoader> Loader;
 
+	// 힙에 자원을 넣는 쪽(업로드, 텍스쳐, DX12)보다 늦게 풀려야 한다.
+	std::unique_ptr<GpuHeapAllocator> GpuHeaps;
+
+	std::unique_ptr<UploadManager> Uploader;
+
+	std::unique_ptr<TextureStreamer> Streamer;
+
+	std::unique_ptr<TextureManager> TextureMgr;
+
 	std::unique_ptr<DX12> Graphics;
 
 	std::unique_ptr<GameTimer> Timer;
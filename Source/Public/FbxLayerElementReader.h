@@ -0,0 +1,78 @@
+#pragma once
+
+#include <fbxsdk.h>
+
+// 레이어 요소의 매핑/참조 방식을 메쉬마다 한 번만 풀어두고, 배열은 잠가서 포인터로 바로 읽는다.
+// 생성한 스레드에서 잠그고 풀기 때문에 그 사이에는 여러 스레드가 같이 읽어도 된다.
+template<typename T>
+class LayerElementReader
+{
+public:
+	LayerElementReader(FbxLayerElementTemplate<T>* InElement)
+		:
+		Element(InElement)
+	{
+		if (nullptr == Element)
+		{
+			return;
+		}
+
+		Mapping = Element->GetMappingMode();
+		Direct = Element->GetDirectArray().GetLocked(FbxLayerElementArray::eReadLock);
+
+		if (Element->GetReferenceMode() != FbxLayerElement::eDirect)
+		{
+			Indices = Element->GetIndexArray().GetLocked(FbxLayerElementArray::eReadLock);
+		}
+	}
+
+	~LayerElementReader()
+	{
+		if (Direct)
+		{
+			Element->GetDirectArray().Release(&Direct);
+		}
+
+		if (Indices)
+		{
+			Element->GetIndexArray().Release(&Indices);
+		}
+	}
+
+	LayerElementReader(const LayerElementReader& Rhs) = delete;
+	LayerElementReader& operator=(const LayerElementReader& Rhs) = delete;
+
+public:
+	bool IsValid() const
+	{
+		return Direct != nullptr;
+	}
+
+	const T& Get(int ControlPoint, int Polygon, int PolygonVertex) const
+	{
+		int Index = 0;
+		switch (Mapping)
+		{
+		case FbxLayerElement::eByControlPoint:
+			Index = ControlPoint;
+			break;
+		case FbxLayerElement::eByPolygonVertex:
+			Index = PolygonVertex;
+			break;
+		case FbxLayerElement::eByPolygon:
+			Index = Polygon;
+			break;
+		default:
+			break;
+		}
+
+		return Direct[Indices ? Indices[Index] : Index];
+	}
+
+private:
+	FbxLayerElementTemplate<T>* Element = nullptr;
+	FbxLayerElement::EMappingMode Mapping = FbxLayerElement::eNone;
+
+	T* Direct = nullptr;
+	int* Indices = nullptr;
+};
@@ -4,6 +4,9 @@
 #include <DirectXMath.h>
 #include <vector>
 #include "FrameResource.h"
+#include "Meshlet.h"
+#include "MeshCache.h"
+#include "Skeleton.h"
 
 using namespace DirectX;
 
@@ -22,33 +25,100 @@ public:
 public:
 	bool Load(const char* FilePath, const std::string& Name);
 
+private:
+	bool Import(const char* FilePath, const std::string& Name);
+	void Cook(const std::string& Name, uint64_t CacheKey);
+	void LoadCooked(const std::string& Name, std::unique_ptr<CookedMesh> Cooked);
+	std::string GetCookedPath(const std::string& Name) const;
+
+	// 원본 파일 해시에 용접, 애니메이션 압축, 스킨 설정을 섞는다. 쿠킹된 파일은 이 값이 같을 때만 쓴다.
+	uint64_t GetCacheKey(uint64_t SourceHash) const;
+
+private:
+	// 씬 안의 메쉬 노드 하나. 각자 다른 스레드에서 채워지고 마지막에 하나로 합쳐진다.
+	struct MeshPart
+	{
+		FbxMesh* Mesh = nullptr;
+		std::string Name;
+		bool bSkinned = false;
+
+		// 정점에 구워 넣는 트랜스폼. 스켈레톤이 있으면 스켈레톤 공간으로, 없으면 월드 공간으로 옮긴다.
+		XMFLOAT4X4 Transform = MathHelper::Identity4x4();
+
+		// 스켈레톤이 있을 때만 쓴다. 스킨 메쉬는 클러스터 i가 뼈 ClusterBones[i]이고, 스킨이 없는 메쉬는 뼈 RigidBone 하나에 무게 1로 붙는다.
+		std::vector<uint16_t> ClusterBones;
+		int32_t RigidBone = -1;
+
+		std::vector<Vertex> Vertices;
+		std::vector<uint32_t> Indices;
+		std::vector<Meshlet> Meshlets;
+		BoundingBox Bounds;
+
+		// Control Point i에서 나온 Vertex들은 ControlPointVertices[Offsets[i], Offsets[i + 1])
+		std::vector<uint32_t> ControlPointVertexOffsets;
+		std::vector<uint32_t> ControlPointVertices;
+	};
+
+	// 애니메이션을 구울 때 스레드마다 따로 쓰는 씬. FBX SDK의 Evaluator는 스레드 안전하지 않다.
+	struct BakeContext
+	{
+		FbxManager* Manager = nullptr;
+		FbxScene* Scene = nullptr;
+		FbxNode* MeshNode = nullptr;
+		std::vector<FbxNode*> BoneNodes;
+		std::vector<int32_t> ParentIndices;
+
+		// 씬을 전위 순회한 노드 번호. 워커 씬에서 같은 노드를 찾을 때 쓴다. 노드가 없는 뼈는 -1.
+		size_t NodeCount = 0;
+		int32_t MeshNodeIndex = -1;
+		std::vector<int32_t> BoneNodeIndices;
+		std::vector<FbxAMatrix> GlobalTransforms;
+		bool bFailed = false;
+	};
+
+	static void IndexBakeNodes(BakeContext& Context);
+	static bool CreateBakeContext(const char* FilePath, const BakeContext& Source, BakeContext& OutContext);
+	static void BakeFrame(BakeContext& Context, FbxLongLong Frame, BoneTransform* OutPose);
+
 private:
 	void LoadTexture(const char* FilePath, FbxScene* Scene, const std::string& Name);
 	void LoadMaterial(FbxScene* Scene, const std::string& Name);
-	FbxMesh* LoadMesh(FbxScene* Scene, const std::string& Name);
-	void LoadAnimation(FbxScene* Scene, const std::string& Name, FbxMesh* Mesh);
+	void LoadMesh(std::vector<MeshPart>& Parts);
+
+	// 스킨 메쉬를 전부 한 스켈레톤에 묶고 메쉬마다 스켈레톤 공간으로 옮길 트랜스폼을 정한다. 스켈레톤 공간의 기준 메쉬 노드를 돌려준다. 스켈레톤이 없으면 nullptr.
+	FbxNode* LoadSkeleton(FbxScene* Scene, const std::string& Name, std::vector<MeshPart>& Parts, std::vector<FbxNode*>& OutBoneNodes);
+	void LoadSkin(const std::string& Name, MeshPart& Part);
+	void LoadAnimation(const char* FilePath, FbxScene* Scene, const std::string& Name, FbxNode* MeshNode, const std::vector<FbxNode*>& BoneNodes);
+	void BakeAnimation(const char* FilePath, const std::string& Name, FbxNode* MeshNode, const std::vector<FbxNode*>& BoneNodes, FbxLongLong StartFrame, FbxLongLong EndFrame);
+	bool MergeMeshParts(const std::string& Name, std::vector<MeshPart>& Parts);
 
 private:
 	std::wstring ConvertToTextureName(const char* FilePath, const std::string& Name);
-	bool FindMesh(FbxNode* Node, FbxMesh*& OutMesh);
-	void FindAnimation(FbxScene* Scene, FbxMesh* Mesh, const FbxLongLong& Time, const std::string& Name);
-	void ProcessPolygon(FbxMesh* Mesh, const std::string& Name);
-	void InsertVertex(const Vertex& InVertex, const std::string& Name);
+	void CollectMeshes(FbxNode* Node, std::vector<MeshPart>& OutParts);
+	void ProcessPolygon(MeshPart& Part);
 	FbxAMatrix GetGeometryTransformation(FbxNode* Node);
 
-	void GetPosition(FbxMesh* Mesh, int Index, XMFLOAT3& Data);
-	void GetNormal(FbxMesh* Mesh, int PolyIndex, int VertexIndex, XMFLOAT3& Data);
-	void GetTexCoord(FbxMesh* Mesh, int PolyIndex, int VertexIndex, XMFLOAT2& Data);
+public:
+	void SetWeldEpsilon(float InEpsilon);
+	void SetAnimationCompression(const AnimationCompressionSettings& InSettings);
+	void SetSkinImport(const SkinImportSettings& InSettings);
 
 public:
-	const std::vector<Vertex>& GetVertices(const std::string& Name) const;
-	const std::vector<uint16_t>& GetIndices(const std::string& Name) const;
+	ArrayView<Vertex> GetVertices(const std::string& Name) const;
+	// 파츠를 합치면 65535개를 쉽게 넘으니 인덱스는 32비트다. DXGI_FORMAT_R32_UINT로 그린다.
+	ArrayView<uint32_t> GetIndices(const std::string& Name) const;
+	ArrayView<CookedSubmesh> GetSubmeshes(const std::string& Name) const;
+	ArrayView<Meshlet> GetMeshlets(const std::string& Name) const;
 	const std::vector<Texture*> GetTextures(const std::string& Name) const;
 	const std::vector<Material*> GetMaterials(const std::string& Name) const;
-	const std::vector<XMMATRIX>& GetBoneOffsets(const std::string& Name) const;
-	const std::vector<XMMATRIX>& GetToRootTransforms(const std::string& Name) const;
+	ArrayView<XMMATRIX> GetBoneOffsets(const std::string& Name) const;
+	Skeleton GetSkeleton(const std::string& Name) const;
+	AnimationClip GetAnimationClip(const std::string& Name) const;
 	const int GetBoneCount(const std::string& Name) const;
 
+	// 정점 하나가 무게 0이 아닌 뼈를 최대 몇 개 쓰는지. 스키닝이 없으면 0.
+	uint32_t GetMaxInfluenceCount(const std::string& Name) const;
+
 private:
 	FbxManager* Manager = nullptr;
 	FbxIOSettings* IOSettings = nullptr;
@@ -61,13 +131,20 @@ private:
 	std::unordered_map<std::string, std::vector<std::unique_ptr<Texture>>> Textures;
 	std::unordered_map<std::string, std::vector<std::unique_ptr<Material>>> Materials;
 
+	// 게임 쪽에서 읽는 메쉬 데이터는 전부 여기서 나온다.
+	std::unordered_map<std::string, std::unique_ptr<CookedMesh>> CookedMeshes;
+
+	// 아래는 Import 중에만 채우고 쿠킹이 끝나면 비운다.
 	std::unordered_map<std::string, std::vector<Vertex>> Vertices;
-	std::unordered_map<std::string, std::vector<uint16_t>> Indices;
-	std::unordered_map<Vertex, uint16_t> IndexMap;
+	std::unordered_map<std::string, std::vector<uint32_t>> Indices;
+	std::unordered_map<std::string, std::vector<CookedSubmesh>> Submeshes;
+	std::unordered_map<std::string, std::vector<Meshlet>> Meshlets;
 
-	std::unordered_map<std::string, std::vector<XMMATRIX>> BoneOffsets;
-	std::unordered_map<std::string, std::vector<XMMATRIX>> ToRootTransforms;
+	std::unordered_map<std::string, SkeletonData> Skeletons;
+	std::unordered_map<std::string, AnimationClipData> AnimationClips;
 
-	std::unordered_map<std::string, int> BoneCounts;
+	float WeldEpsilon = 0.0f;
+	AnimationCompressionSettings CompressionSettings;
+	SkinImportSettings SkinSettings;
 };
 
@@ -4,6 +4,7 @@
 #include "Framework/MathHelper.h"
 #include "Framework/UploadBuffer.h"
 #include "fbxsdk.h"
+#include "Vertex.h"
 #include <string>
 #include <vector>
 
@@ -16,7 +17,7 @@ struct InstanceData
     XMFLOAT4X4 World = MathHelper::Identity4x4();
     XMFLOAT4X4 TexTransform = MathHelper::Identity4x4();
     UINT MaterialIndex;
-    UINT InstancePad0;
+    UINT PaletteOffset = 0;
     UINT InstancePad1;
     UINT InstancePad2;
 };
@@ -30,15 +31,27 @@ struct MaterialData
     XMFLOAT4X4 MatTransform = MathHelper::Identity4x4();
 
     UINT DiffuseMapIndex = 0;
-    UINT MaterialPad0;
+    UINT DiffuseMapSlice = 0;
     UINT MaterialPad1;
     UINT MaterialPad2;
 };
 
+// 1이면 뼈 팔레트를 4x4 행렬 대신 듀얼 쿼터니언(float 8개)으로 올린다. 스케일이 있는 뼈는 표현하지 못한다.
+// 셰이더에도 같은 이름으로 넘어간다.
+#define SKINNING_DUAL_QUATERNION 0
+
+#if SKINNING_DUAL_QUATERNION
+struct AnimationData
+{
+    XMFLOAT4 Real = { 0.0f, 0.0f, 0.0f, 1.0f };
+    XMFLOAT4 Dual = { 0.0f, 0.0f, 0.0f, 0.0f };
+};
+#else
 struct AnimationData
 {
     XMFLOAT4X4 FinalTransform = MathHelper::Identity4x4();
 };
+#endif
 
 struct PassConstants
 {
@@ -56,75 +69,15 @@ struct PassConstants
     float FarZ = 0.0f;
     float TotalTime = 0.0f;
     float DeltaTime = 0.0f; 
-    float Frame = 0.0f;
-    float BoneCount = 0.0f;
     float Pad0 = 0.0f;
     float Pad1 = 0.0f;
+    float Pad2 = 0.0f;
+    float Pad3 = 0.0f;
     XMFLOAT4 AmbientLight = { 0.0f, 0.0f, 0.0f, 1.0f };
 
     Light Lights[MaxLights];
 };
 
-struct Vertex
-{
-    XMFLOAT3 Pos;
-    XMFLOAT3 Normal;
-    XMFLOAT2 TexCoord;
-    XMFLOAT4 BoneWeights;
-    BYTE BoneIndices[4];
-
-    bool operator==(const Vertex& Rhs) const
-    {
-        return (Pos.x == Rhs.Pos.x) && (Pos.y == Rhs.Pos.y) && (Pos.z == Rhs.Pos.z);
-
-        /*return (Pos.x == Rhs.Pos.x) && (Pos.y == Rhs.Pos.y) && (Pos.z == Rhs.Pos.z)
-            && (Normal.x == Rhs.Normal.x) && (Normal.y == Rhs.Normal.y) && (Normal.z == Rhs.Normal.z)
-            && (TexCoord.x == Rhs.TexCoord.x) && (TexCoord.y == Rhs.TexCoord.y)
-            && (BoneIndex == Rhs.BoneIndex);*/
-    }
-};
-
-namespace std
-{
-    template<>
-    struct hash<XMFLOAT2>
-    {
-    public:
-        size_t operator()(const XMFLOAT2& F) const
-        {
-            size_t XHash = std::hash<float>()(F.x);
-            size_t YHash = std::hash<float>()(F.y) << 1;
-            return XHash ^ YHash;
-        }
-    };
-
-    template<>
-    struct hash<XMFLOAT3>
-    {
-    public:
-        size_t operator()(const XMFLOAT3& F) const
-        {
-            size_t XHash = std::hash<float>()(F.x);
-            size_t YHash = std::hash<float>()(F.y) << 1;
-            size_t ZHash = std::hash<float>()(F.z) << 1;
-            return ((XHash ^ YHash) >> 1) ^ ZHash;
-        }
-    };
-
-    template <>
-    struct hash<Vertex>
-    {
-        size_t operator()(const Vertex& V) const
-        {
-            size_t XHash = std::hash<XMFLOAT3>()(V.Pos);
-            /*size_t YHash = std::hash<XMFLOAT3>()(V.Normal) << 1;
-            size_t ZHash = std::hash<XMFLOAT2>()(V.TexCoord) << 1;
-            return ((XHash ^ YHash) >> 1) ^ ZHash;*/
-            return XHash;
-        }
-    };
-}
-
 struct FrameResource
 {
 public:
@@ -140,5 +93,8 @@ public:
     std::unique_ptr<UploadBuffer<InstanceData>> InstanceBuffer = nullptr;
     std::unique_ptr<UploadBuffer<AnimationData>> AnimationBuffer = nullptr;
 
+    // AnimationBuffer에 들어가는 AnimationData 개수
+    UINT AnimationCapacity = 0;
+
     UINT64 Fence = 0;
 };
\ No newline at end of file
@@ -270,6 +270,9 @@ struct Texture
 
     int Index;
 
+	// TextureStreamer에 등록된 번호. 스트리밍하지 않으면 -1.
+	int StreamingHandle = -1;
+
 	Microsoft::WRL::ComPtr<ID3D12Resource> Resource = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> UploadHeap = nullptr;
 };
@@ -5,12 +5,21 @@
 #include <DirectXMath.h>
 #include <d3d12.h>
 #include "DX12.h"
+#include "Meshlet.h"
+#include "TextureManager.h"
 
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 
 struct MeshGeometry;
 
+struct ClusterCullInput
+{
+	int InstanceIndex = 0;
+	BoundingFrustum LocalFrustum;
+	XMFLOAT3 LocalEyePos = { 0.0f, 0.0f, 0.0f };
+};
+
 class MathHelper;
 class Camera;
 
@@ -30,7 +39,9 @@ struct RenderItem
 
 	BoundingBox Bounds;
 	std::vector<InstanceData> Instances;
-	std::vector<AnimationData> Animations;
+
+	// 가까이 있는 인스턴스는 살아남은 클러스터 범위만 따로 그린다.
+	std::vector<ClusterDrawRange> ClusterDraws;
 
 	int InstanceOffset = 0;
 
@@ -60,9 +71,18 @@ public:
 public:
 	virtual void Update(FrameResource* CurFrameResource);
 
+protected:
+	// VisibleInstances 순서대로 PaletteOffsets를 채운다. 애니메이션이 없으면 전부 0.
+	virtual void UpdateAnimation(FrameResource* CurFrameResource);
+
+	// 창 제목에 붙일 오브젝트별 통계
+	virtual void AppendStats(std::wostringstream& Stats) const;
+
 private:
 	void UpdateInstanceData(FrameResource* CurFrameResource);
 	void UpdateMaterialBuffer(FrameResource* CurFrameResource);
+	void CopyInstanceData(UploadBuffer<InstanceData>* InstanceBuffer, int BufferIndex, const InstanceData& Instance, UINT PaletteOffset);
+	bool IsCloseUp(FXMVECTOR LocalEyePos) const;
 
 public:
 	virtual void Translate(float Dx, float Dy, float Dz);
@@ -92,7 +112,7 @@ protected:
 	std::unique_ptr<RenderItem> Item;
 
 	std::unique_ptr<Material> Mat;
-	std::unique_ptr<Texture> Tex;
+	TextureHandle Tex;
 
 	int VertexCount = 0;
 
@@ -104,6 +124,16 @@ protected:
 
 	bool bUseAnimation = false;
 
+	std::vector<Meshlet> Meshlets;
+	bool bUseMeshletCulling = false;
+	float MeshletCullDistanceScale = 4.0f;
+
+	std::vector<ClusterCullInput> CloseUpInstances;
+
+	// 이번 프레임에 인스턴스 버퍼에 들어가는 순서. 일반 인스턴스 뒤에 가까운 인스턴스가 온다.
+	std::vector<int> VisibleInstances;
+	std::vector<UINT> PaletteOffsets;
+
 protected:
 	float OffsetX = 0.0f;
 	float OffsetY = 0.0f;
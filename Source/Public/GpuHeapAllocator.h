@@ -0,0 +1,135 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include "TlsfAllocator.h"
+
+using Microsoft::WRL::ComPtr;
+
+enum class GpuMemoryCategory : uint32_t
+{
+	VertexBuffer,
+	IndexBuffer,
+	Texture,
+	DepthStencil,
+	Upload,
+	Count
+};
+
+struct GpuMemoryStats
+{
+	// 힙에서 잡은 크기. 정렬 때문에 자원 크기보다 클 수 있다.
+	uint64_t Bytes = 0;
+	uint64_t PeakBytes = 0;
+	uint32_t AllocationCount = 0;
+};
+
+struct GpuHeapStats
+{
+	uint32_t HeapCount = 0;
+	uint64_t HeapBytes = 0;
+	uint64_t UsedBytes = 0;
+	uint64_t LargestFreeBlock = 0;
+};
+
+// 조각 모으기로 옮길 자원 하나. New는 같은 모양으로 더 앞자리에 만든 COPY_DEST 상태의 자원이다.
+// 쓰는 쪽이 Old를 New로 복사하고 바꿔 끼운 뒤 Old를 펜스까지 들고 있다가 놓는다. 못 바꾸면 New를 그냥 버리면 자리가 돌아온다.
+struct GpuRelocation
+{
+	ID3D12Resource* Old = nullptr;
+	ComPtr<ID3D12Resource> New;
+};
+
+// 버퍼와 텍스쳐를 자원마다 커밋하지 않고 큰 ID3D12Heap에 CreatePlacedResource로 나눠 넣는다. 자리는 힙마다 TlsfAllocator가 나눈다.
+// 힙은 티어 1에서도 되게 버퍼, 텍스쳐, 렌더 타깃/깊이, 업로드로 나눈다. 작은 텍스쳐는 4KB 정렬로 넣어서 64KB씩 먹지 않는다.
+// 만든 자원이 풀리면 거기 붙여둔 IUnknown이 같이 풀리면서 자리를 돌려준다. 쓰는 쪽은 여느 ComPtr처럼 놓기만 하면 된다.
+class GpuHeapAllocator
+{
+public:
+	GpuHeapAllocator();
+	GpuHeapAllocator(const GpuHeapAllocator& Rhs) = delete;
+	GpuHeapAllocator& operator=(const GpuHeapAllocator& Rhs) = delete;
+	~GpuHeapAllocator();
+
+public:
+	static GpuHeapAllocator* Get();
+
+	static const UINT64 DefaultHeapBytes = 64ull * 1024 * 1024;
+
+public:
+	// 힙은 처음 쓸 때 HeapBytes로 만든다. 그보다 큰 자원은 자기 크기의 힙을 따로 받는다.
+	void Init(ID3D12Device* InDevice, UINT64 InHeapBytes = DefaultHeapBytes);
+
+	// CreateCommittedResource 대신 쓴다. 힙이 모자라면 새로 만들고, 만들지 못하면 예외를 던진다.
+	ComPtr<ID3D12Resource> CreateResource(GpuMemoryCategory Category, const D3D12_RESOURCE_DESC& Desc, D3D12_HEAP_TYPE HeapType,
+		D3D12_RESOURCE_STATES InitialState, const D3D12_CLEAR_VALUE* ClearValue = nullptr);
+
+	// Category 자원 중 뒤쪽 힙, 뒤쪽 자리에 있는 것부터 더 앞에 빈 자리가 있으면 새로 만들어 OutRelocations에 담는다. 합쳐서 MaxBytes까지.
+	// 렌더 타깃/깊이와 업로드 힙은 옮기지 않는다.
+	void PlanDefragment(GpuMemoryCategory Category, UINT64 MaxBytes, std::vector<GpuRelocation>& OutRelocations);
+
+public:
+	GpuMemoryStats GetStats(GpuMemoryCategory Category) const;
+	GpuHeapStats GetHeapStats() const;
+
+	static const char* GetCategoryName(GpuMemoryCategory Category);
+
+private:
+	enum class HeapKind : uint32_t
+	{
+		Buffer,
+		Texture,
+		RenderTarget,
+		Upload,
+		Count
+	};
+
+	struct Heap
+	{
+		ComPtr<ID3D12Heap> Resource;
+		TlsfAllocator Allocator;
+	};
+
+	struct Pool
+	{
+		D3D12_HEAP_TYPE Type = D3D12_HEAP_TYPE_DEFAULT;
+		D3D12_HEAP_FLAGS Flags = D3D12_HEAP_FLAG_NONE;
+		UINT64 Granularity = 0;
+		UINT64 HeapAlignment = 0;
+
+		// 앞의 것일수록 먼저 채운다. 맨 앞 힙이 아니면 비는 대로 놓는다.
+		std::vector<std::unique_ptr<Heap>> Heaps;
+	};
+
+	// 자원에 붙여두는 IUnknown. 마지막 참조가 풀리면 자리를 돌려준다.
+	class Allocation;
+
+	static HeapKind GetKind(const D3D12_RESOURCE_DESC& Desc, D3D12_HEAP_TYPE HeapType);
+
+	// Limit가 있으면 그 힙의 LimitOffset보다 앞자리만 받는다. 없으면 힙을 새로 만들어서라도 잡는다. Mutex를 잡고 부른다.
+	bool Allocate(HeapKind Kind, UINT64 Bytes, UINT64 Alignment, const Heap* Limit, UINT64 LimitOffset, Heap*& OutHeap, uint32_t& OutHandle);
+
+	// 잡은 자리에 자원을 만들고 Allocation을 붙인다. 실패하면 자리를 돌려주고 예외를 던진다. Mutex를 잡고 부른다.
+	ComPtr<ID3D12Resource> Place(HeapKind Kind, Heap* Target, uint32_t Handle, GpuMemoryCategory Category, const D3D12_RESOURCE_DESC& Desc,
+		UINT64 Bytes, UINT64 Alignment, D3D12_RESOURCE_STATES InitialState, const D3D12_CLEAR_VALUE* ClearValue);
+
+	void Free(const Allocation& Freed);
+
+private:
+	static GpuHeapAllocator* Allocator;
+
+	ComPtr<ID3D12Device> Device;
+	UINT64 HeapBytes = DefaultHeapBytes;
+
+	Pool Pools[(uint32_t)HeapKind::Count];
+	GpuMemoryStats Stats[(uint32_t)GpuMemoryCategory::Count];
+
+	// 자원이 풀리는 도중에는 힙을 놓지 않고 여기 모았다가 다음 CreateResource나 PlanDefragment에서 놓는다.
+	std::vector<std::unique_ptr<Heap>> EmptyHeaps;
+
+	// 자원은 어느 스레드에서든 풀릴 수 있다.
+	mutable std::mutex Mutex;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+
+// 엔진 전체가 같이 쓰는 워커 스레드 풀.
+// ParallelFor를 부른 스레드도 같이 일하고, 전부 끝나야 반환하니까 안에서 다시 ParallelFor를 불러도 된다.
+class JobSystem
+{
+public:
+	JobSystem();
+	JobSystem(const JobSystem& Rhs) = delete;
+	JobSystem& operator=(const JobSystem& Rhs) = delete;
+	~JobSystem();
+
+public:
+	static JobSystem* Get();
+
+public:
+	// WorkerCount가 0이면 코어 수 - 1 만큼 만든다.
+	void Init(uint32_t WorkerCount = 0);
+
+	// [0, Count)를 Grain 단위로 잘라서 나눠 처리한다. Body에는 [Begin, End)와 실행 중인 스레드 번호가 넘어온다.
+	void ParallelFor(size_t Count, size_t Grain, const std::function<void(size_t Begin, size_t End, uint32_t ThreadIndex)>& Body);
+
+public:
+	// 호출 스레드까지 포함한 수. 스레드별 작업 공간을 잡을 때 쓴다.
+	uint32_t GetThreadCount() const;
+	static uint32_t GetThreadIndex();
+
+private:
+	struct Batch
+	{
+		std::function<void(size_t, size_t, uint32_t)> Body;
+		size_t Count = 0;
+		size_t Grain = 1;
+		std::atomic<size_t> Next{ 0 };
+		std::atomic<size_t> Remaining{ 0 };
+	};
+
+	void WorkerMain(uint32_t ThreadIndex);
+	bool RunChunk(Batch& Job);
+
+private:
+	static JobSystem* Jobs;
+
+	std::vector<std::thread> Workers;
+	std::deque<std::shared_ptr<Batch>> Queue;
+
+	std::mutex Mutex;
+	std::condition_variable WakeCondition;
+	std::condition_variable DoneCondition;
+
+	bool bQuit = false;
+};
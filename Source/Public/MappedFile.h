@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// 파일 전체를 읽기 전용으로 메모리에 매핑한다. Windows는 File Mapping, 그 외는 mmap을 쓴다.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile& Rhs) = delete;
+	MappedFile& operator=(const MappedFile& Rhs) = delete;
+	~MappedFile();
+
+public:
+	bool Open(const char* FilePath);
+	bool Open(const wchar_t* FilePath);
+	void Close();
+
+public:
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+	bool IsOpen() const;
+
+private:
+#ifdef _WIN32
+	bool Map(HANDLE InFile);
+
+	HANDLE File = INVALID_HANDLE_VALUE;
+	HANDLE Mapping = nullptr;
+#else
+	bool Map(int InFile);
+
+	int File = -1;
+#endif
+
+	const uint8_t* Data = nullptr;
+	size_t Size = 0;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "ArrayView.h"
+#include "MappedFile.h"
+#include "Meshlet.h"
+#include "AnimationClip.h"
+
+enum class MeshCacheSection : uint32_t
+{
+	Vertices = 0,
+	Indices,
+	Submeshes,
+	Meshlets,
+	Materials,
+	Textures,
+	BoneOffsets,
+	AnimationInfo,
+	AnimationTracks,
+	AnimationRotations,
+	AnimationTranslations,
+	AnimationScales,
+	SkeletonParents,
+	SkeletonBindPose,
+	Count
+};
+
+struct MeshCacheSectionDesc
+{
+	uint64_t Offset = 0;
+	uint64_t Count = 0;
+	uint32_t ElementSize = 0;
+	uint32_t Pad = 0;
+};
+
+struct MeshCacheHeader
+{
+	static const uint32_t MagicValue = 0x4853454D; // "MESH"
+	static const uint32_t CurrentVersion = 8;
+
+	uint32_t Magic = MagicValue;
+	uint32_t Version = CurrentVersion;
+	// 원본 파일뿐 아니라 쿠킹 결과를 바꾸는 설정까지 섞은 값이다. FbxLoader::GetCacheKey
+	uint64_t SourceHash = 0;
+	uint64_t FileSize = 0;
+	MeshCacheSectionDesc Sections[(int)MeshCacheSection::Count];
+};
+
+struct CookedSubmesh
+{
+	char Name[64] = {};
+	SubmeshGeometry Geometry;
+};
+
+struct CookedMaterial
+{
+	char Name[64] = {};
+	int MatCBIndex = -1;
+	int DiffuseSrvHeapIndex = -1;
+	XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
+	XMFLOAT3 FresnelR0 = { 0.01f, 0.01f, 0.01f };
+	float Roughness = 0.25f;
+};
+
+struct CookedTexture
+{
+	char Name[64] = {};
+	char Filename[260] = {};
+	int Index = 0;
+};
+
+class MeshCacheWriter
+{
+public:
+	template<typename T>
+	void AddSection(MeshCacheSection Section, ArrayView<T> Elements)
+	{
+		AddSection(Section, Elements.data(), sizeof(T), Elements.size());
+	}
+
+	void AddSection(MeshCacheSection Section, const void* Data, uint32_t ElementSize, size_t Count);
+
+	std::vector<uint8_t> Finish(uint64_t SourceHash);
+
+private:
+	MeshCacheHeader Header;
+	std::vector<uint8_t> Payload;
+};
+
+// 쿠킹된 메쉬 한 개. 디스크에서 열었으면 매핑된 영역을 그대로 가리키고, 방금 쿠킹했으면 그 바이트를 들고 있는다.
+class CookedMesh
+{
+public:
+	CookedMesh() = default;
+	CookedMesh(const CookedMesh& Rhs) = delete;
+	CookedMesh& operator=(const CookedMesh& Rhs) = delete;
+
+public:
+	static std::unique_ptr<CookedMesh> Open(const std::string& CookedPath, uint64_t SourceHash);
+	static std::unique_ptr<CookedMesh> FromMemory(std::vector<uint8_t>&& Bytes);
+
+	static bool Write(const std::string& CookedPath, const std::vector<uint8_t>& Bytes);
+	static uint64_t HashBytes(const uint8_t* Data, size_t Size);
+
+public:
+	template<typename T>
+	ArrayView<T> GetSection(MeshCacheSection Section) const
+	{
+		const MeshCacheSectionDesc& Desc = Header->Sections[(int)Section];
+		if (Desc.ElementSize != sizeof(T))
+		{
+			return ArrayView<T>();
+		}
+
+		return ArrayView<T>(reinterpret_cast<const T*>(Base + Desc.Offset), (size_t)Desc.Count);
+	}
+
+	uint64_t GetSourceHash() const;
+	size_t GetByteSize() const;
+
+private:
+	bool Validate(const uint8_t* InBase, size_t InSize, uint64_t SourceHash);
+
+private:
+	MappedFile File;
+	std::vector<uint8_t> Memory;
+
+	const uint8_t* Base = nullptr;
+	size_t Size = 0;
+	const MeshCacheHeader* Header = nullptr;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <vector>
+#include <cstdint>
+#include "FrameResource.h"
+
+using namespace DirectX;
+
+struct Meshlet
+{
+	UINT StartIndexLocation = 0;
+	UINT IndexCount = 0;
+	UINT VertexCount = 0;
+
+	BoundingSphere Bounds;
+
+	// 콘 안의 모든 삼각형은 Apex에서 Axis 방향으로 Cutoff 이상 벗어나면 전부 뒷면이다.
+	XMFLOAT3 ConeApex = { 0.0f, 0.0f, 0.0f };
+	XMFLOAT3 ConeAxis = { 0.0f, 0.0f, 1.0f };
+	float ConeCutoff = 1.0f;
+};
+
+struct ClusterDrawRange
+{
+	UINT InstanceIndex = 0;
+	UINT StartIndexLocation = 0;
+	UINT IndexCount = 0;
+};
+
+class MeshletBuilder
+{
+public:
+	static const UINT MaxVertices = 64;
+	static const UINT MaxTriangles = 124;
+
+public:
+	// Indices는 Meshlet 순서대로 재배열된다. IndexType은 uint16_t나 uint32_t.
+	template<typename IndexType>
+	static void Build(const std::vector<Vertex>& Vertices, std::vector<IndexType>& Indices, std::vector<Meshlet>& OutMeshlets);
+
+	static UINT Cull(const std::vector<Meshlet>& Meshlets,
+		const BoundingFrustum& LocalFrustum,
+		FXMVECTOR LocalEyePos,
+		UINT InstanceIndex,
+		UINT BaseIndexLocation,
+		std::vector<ClusterDrawRange>& OutRanges);
+
+private:
+	template<typename IndexType>
+	static void ComputeBounds(const std::vector<Vertex>& Vertices, const IndexType* Triangles, UINT TriangleCount, Meshlet& OutMeshlet);
+};
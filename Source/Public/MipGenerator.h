@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+enum class MipFilter : uint32_t
+{
+	Box = 0,
+	Kaiser
+};
+
+struct MipGenerationOptions
+{
+	MipFilter Filter = MipFilter::Kaiser;
+
+	// RGB를 선형 공간으로 풀어서 거른 뒤 다시 sRGB로 담는다. 알파는 항상 그대로 거른다.
+	bool bSRGB = true;
+
+	// 반복해서 까는 텍스쳐는 가장자리 너머를 반대편에서 읽는다. 끄면 가장자리 픽셀을 늘려 쓴다.
+	bool bWrap = true;
+};
+
+// RGBA8 한 장에서 1x1까지 밉 사슬을 CPU로 만든다. 픽셀 하나를 float 4개로 SSE 레지스터에 담아 분리형 필터를 건다.
+// 밉은 앞 밉에서 차례로 만들고, 한 밉 안에서는 출력 행 묶음을 JobSystem으로 나눈다.
+class MipGenerator
+{
+public:
+	// Pixels는 행마다 RowPitch 바이트. OutMips[0]은 원본 복사이고 모든 밉이 행 사이 빈 공간 없이 채워진다.
+	static void Generate(const uint8_t* Pixels, uint32_t Width, uint32_t Height, size_t RowPitch, const MipGenerationOptions& Options, std::vector<std::vector<uint8_t>>& OutMips);
+
+	static uint32_t GetMipCount(uint32_t Width, uint32_t Height);
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include "ArrayView.h"
+#include "AnimationClip.h"
+
+using namespace DirectX;
+
+// Import 결과. 뼈는 부모가 항상 자식보다 앞에 오도록 정렬돼 있다.
+struct SkeletonData
+{
+	std::vector<int32_t> ParentIndices;
+	std::vector<XMMATRIX> InverseBindPose;
+	std::vector<BoneTransform> BindPose;
+};
+
+struct SkinImportSettings
+{
+	// 무게 순으로 이만큼만 남긴다. Vertex 포맷이 4슬롯이라 4를 넘길 수 없다.
+	uint32_t MaxInfluences = 4;
+
+	// 이보다 가벼운 영향은 버리고 남은 무게를 다시 1로 맞춘다.
+	float MinWeight = 0.01f;
+};
+
+struct BoneInfluence
+{
+	uint16_t Bone = 0;
+	float Weight = 0.0f;
+};
+
+// 무게가 큰 순으로 줄 세워서 가벼운 건 버리고 앞에서 MaxInfluences개만 남긴 뒤 합이 1이 되게 맞춘다.
+// 남은 개수를 돌려준다. 전부 버려지면 제일 무거운 하나는 남긴다.
+uint32_t PruneInfluences(BoneInfluence* Influences, uint32_t Count, const SkinImportSettings& Settings);
+
+// 쿠킹된 데이터나 SkeletonData를 가리키기만 한다.
+class Skeleton
+{
+public:
+	Skeleton() = default;
+	Skeleton(ArrayView<int32_t> InParentIndices, ArrayView<XMMATRIX> InInverseBindPose, ArrayView<BoneTransform> InBindPose);
+	explicit Skeleton(const SkeletonData& Data);
+
+public:
+	// 로컬 포즈를 부모 배열 순서대로 한 번 훑어서 모델 공간으로 올린다.
+	void ComposeModelSpace(const BoneTransform* LocalPose, XMMATRIX* OutModel) const;
+
+	// OutModel은 중간 결과를 담는 작업 공간. OutPalette는 바로 스키닝에 쓸 수 있는 행렬.
+	void ComposePalette(const BoneTransform* LocalPose, XMMATRIX* OutModel, XMMATRIX* OutPalette) const;
+
+public:
+	bool IsValid() const;
+	uint32_t GetBoneCount() const;
+	int32_t GetParentIndex(uint32_t Bone) const;
+
+	// 깊이가 MaxDepth 이하인 뼈로만 이루어진 앞쪽 구간의 길이. 이 구간만 따로 평가해도 부모가 빠지지 않는다.
+	uint32_t GetBoneCountUpToDepth(uint32_t MaxDepth) const;
+	ArrayView<BoneTransform> GetBindPose() const;
+
+private:
+	ArrayView<int32_t> ParentIndices;
+	ArrayView<XMMATRIX> InverseBindPose;
+	ArrayView<BoneTransform> BindPose;
+};
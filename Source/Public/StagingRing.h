@@ -0,0 +1,71 @@
+#pragma once
+
+#include <deque>
+#include <cstdint>
+
+struct StagingStats
+{
+	uint64_t Capacity = 0;
+
+	// GPU가 아직 다 읽지 않은 바이트. 링에 못 들어가서 따로 만든 업로드 버퍼는 Dedicated로 센다.
+	uint64_t RingBytes = 0;
+	uint64_t DedicatedBytes = 0;
+
+	uint64_t PeakRingBytes = 0;
+	uint64_t PeakBytes = 0;
+
+	// 지금까지 올린 양
+	uint64_t TotalBytes = 0;
+	uint32_t AllocationCount = 0;
+	uint32_t DedicatedCount = 0;
+	uint32_t BatchCount = 0;
+};
+
+// 업로드용 링 버퍼의 자리만 관리한다. 펜스 값만 받고 GPU는 몰라서 가짜 펜스로 따로 떼어 돌려볼 수 있다.
+// Submit 사이에 잡은 자리를 한 묶음으로 두고, 묶음의 펜스가 끝나면 앞에서부터 돌려받는다.
+// 끝에 안 맞는 자리는 남은 꼬리를 버리고 처음부터 잡으며, 버린 꼬리도 그 묶음과 같이 돌아온다.
+class StagingRing
+{
+public:
+	static const uint64_t InvalidOffset = UINT64_MAX;
+
+	void Init(uint64_t InCapacity);
+
+	// 링 안의 오프셋. 자리가 없으면 InvalidOffset. Alignment는 2의 거듭제곱이고 Capacity를 나눠야 한다.
+	uint64_t Allocate(uint64_t Bytes, uint64_t Alignment);
+
+	// 링에 못 넣어 따로 만든 업로드 버퍼도 지금 묶음과 같이 풀리는 것으로 센다.
+	void AddDedicated(uint64_t Bytes);
+
+	// 지난 Submit 뒤로 잡은 자리는 Fence가 끝나면 돌아온다. 잡은 것이 없으면 묶음을 만들지 않는다.
+	void Submit(uint64_t Fence);
+
+	// CompletedFence까지 끝난 묶음을 돌려받는다.
+	void Retire(uint64_t CompletedFence);
+
+public:
+	uint64_t GetCapacity() const;
+	const StagingStats& GetStats() const;
+
+private:
+	void UpdatePeak();
+
+private:
+	struct Batch
+	{
+		uint64_t Fence = 0;
+		uint64_t End = 0;
+		uint64_t DedicatedBytes = 0;
+	};
+
+	std::deque<Batch> Batches;
+
+	// 처음부터 센 위치. 링 안 오프셋은 Capacity로 나눈 나머지다.
+	uint64_t Head = 0;
+	uint64_t Tail = 0;
+	uint64_t SubmittedHead = 0;
+	uint64_t PendingDedicatedBytes = 0;
+
+	uint64_t Capacity = 0;
+	StagingStats Stats;
+};
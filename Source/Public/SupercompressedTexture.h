@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "MappedFile.h"
+
+class DDSFile;
+
+struct SupercompressedHeader
+{
+	static const uint32_t MagicValue = 0x58544353; // "SCTX"
+	static const uint32_t CurrentVersion = 1;
+
+	uint32_t Magic = MagicValue;
+	uint32_t Version = CurrentVersion;
+
+	// 원본 DDS의 DXGI_FORMAT과 블록(비압축이면 픽셀) 하나의 바이트 수
+	uint32_t Format = 0;
+	uint32_t ElementBytes = 1;
+
+	// 원본 DDS 전체 크기와 그중 압축하지 않고 그대로 담은 헤더 크기
+	uint64_t RawBytes = 0;
+	uint32_t HeaderBytes = 0;
+
+	// 헤더 뒤 픽셀 데이터를 이 크기씩 잘라 따로 압축한다. 마지막 조각만 짧다.
+	uint32_t ChunkBytes = 0;
+	uint32_t ChunkCount = 0;
+	uint32_t Pad = 0;
+};
+
+struct SupercompressedChunk
+{
+	uint64_t Offset = 0;
+	uint32_t Bytes = 0;
+
+	// SupercompressedChunkFlags
+	uint32_t Flags = 0;
+};
+
+enum SupercompressedChunkFlags : uint32_t
+{
+	// 블록의 k번째 바이트끼리 모아서 압축했다. 엔드포인트와 인덱스가 따로 모여 엔트로피가 낮아진다.
+	ChunkFlagBytePlanes = 1 << 0,
+};
+
+// DDS 파일을 디스크에 더 작게 담는 형식(.sctx). BCn 블록은 그대로 두고 그 위에 LZ와 rANS를 씌운다.
+// 조각마다 바이트 평면으로 나눌지 골라서 LZ로 반복을 지우고, 리터럴, 명령, 오프셋을 따로 rANS로 담는다.
+// 풀면 원본 DDS와 바이트 하나까지 같아서 DDSFile, DDSTextureLoader가 그대로 읽는다.
+class SupercompressedTexture
+{
+public:
+	SupercompressedTexture() = default;
+	SupercompressedTexture(const SupercompressedTexture& Rhs) = delete;
+	SupercompressedTexture& operator=(const SupercompressedTexture& Rhs) = delete;
+
+public:
+	// DDS 파일 내용 전체를 압축한다. 조각은 JobSystem으로 나눠 굽는다. DDS가 아니면 false.
+	static bool Encode(const uint8_t* DDSData, size_t DDSSize, std::vector<uint8_t>& Out);
+
+	static std::unique_ptr<SupercompressedTexture> Open(const char* FilePath);
+	static std::unique_ptr<SupercompressedTexture> Open(const wchar_t* FilePath);
+
+	// Data는 SupercompressedTexture보다 오래 살아 있어야 한다.
+	static std::unique_ptr<SupercompressedTexture> FromMemory(const uint8_t* Data, size_t Size);
+
+	// DDS 경로의 확장자를 .sctx로 바꾼 경로. 로더는 이 파일이 있으면 DDS 대신 읽는다.
+	static std::wstring GetPathFor(const std::wstring& DDSPath);
+
+public:
+	// 원본 DDS를 Out(GetRawSize() 바이트)에 푼다. 조각은 JobSystem으로 나눠 각자 제자리에 바로 쓴다. 깨진 파일이면 false.
+	bool Transcode(uint8_t* Out) const;
+
+	// 풀어서 DDSFile 하나로 들고 있는다. 실패하면 nullptr.
+	std::unique_ptr<DDSFile> TranscodeToDDS() const;
+
+public:
+	uint32_t GetFormat() const;
+	uint64_t GetRawSize() const;
+
+	// 헤더를 포함한 파일 전체
+	size_t GetSize() const;
+
+private:
+	bool Parse(const uint8_t* InData, size_t InSize);
+
+private:
+	MappedFile File;
+
+	const uint8_t* Data = nullptr;
+	size_t Size = 0;
+
+	SupercompressedHeader Header;
+	const SupercompressedChunk* Chunks = nullptr;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "TexturePacker.h"
+
+struct Texture;
+
+// TextureManager가 가진 텍스쳐 하나를 가리킨다. 복사하면 참조가 늘고, 마지막 핸들이 사라지면 텍스쳐가 풀린다.
+class TextureHandle
+{
+public:
+	TextureHandle() = default;
+	TextureHandle(const TextureHandle& Rhs);
+	TextureHandle(TextureHandle&& Rhs);
+	TextureHandle& operator=(const TextureHandle& Rhs);
+	TextureHandle& operator=(TextureHandle&& Rhs);
+	~TextureHandle();
+
+public:
+	Texture* Get() const;
+	Texture* operator->() const;
+	explicit operator bool() const;
+
+	// SRV 테이블 안에서의 자리. 같은 텍스쳐를 가리키는 핸들끼리는 같고, 묶인 텍스쳐는 묶음의 자리다.
+	int GetSrvIndex() const;
+
+	// 묶음 안의 장과 UV 변환. 묶이지 않았으면 0번 장, 변환 없음.
+	const TexturePlacement& GetPlacement() const;
+
+	void Reset();
+
+private:
+	friend class TextureManager;
+	explicit TextureHandle(int InIndex);
+
+	int Index = -1;
+};
+
+struct TextureCacheStats
+{
+	uint32_t RequestCount = 0;
+	uint32_t TextureCount = 0;
+
+	// 경로가 같아서, 경로는 다르지만 내용이 같아서 다시 쓴 횟수
+	uint32_t PathHitCount = 0;
+	uint32_t ContentHitCount = 0;
+
+	uint64_t LoadedBytes = 0;
+	uint64_t SavedBytes = 0;
+
+	// Texture2DArray로 묶인 텍스쳐 수와 묶음 수
+	uint32_t PackedCount = 0;
+	uint32_t PageCount = 0;
+
+	// Defragment로 힙 앞자리로 옮긴 횟수
+	uint32_t RelocatedCount = 0;
+};
+
+// 텍스쳐를 경로와 파일 내용 해시로 한 번만 만들어서 여러 GameObject가 나눠 쓰게 한다.
+// SRV 자리도 텍스쳐마다 하나라서 DX12는 GameObject가 아니라 여기 있는 텍스쳐 수만큼 서술자를 만든다.
+// 모든 SRV는 Texture2DArray로 만들고, 셰이더는 테이블 전체를 묶어 머티리얼의 DiffuseMapIndex와 장 번호로 고른다.
+class TextureManager
+{
+public:
+	TextureManager();
+	TextureManager(const TextureManager& Rhs) = delete;
+	TextureManager& operator=(const TextureManager& Rhs) = delete;
+	~TextureManager();
+
+public:
+	static TextureManager* Get();
+
+public:
+	// SRV 테이블 크기. 루트 서명의 범위이고, 셰이더의 gDiffuseMap 배열 크기로 MAX_SRV_COUNT에 넘어간다.
+	static const int MaxSrvCount = 128;
+
+	// 셰이더 매크로로 넘길 MaxSrvCount 글자
+	static const char* GetMaxSrvCountDefine();
+
+public:
+	// 처음 보는 텍스쳐면 TextureStreamer로 올린다. 실패하면 예외를 던진다.
+	// bRepeat가 false면 UV가 [0, 1] 안에만 있다는 뜻이라 Pack에서 아틀라스에 넣을 수 있다.
+	TextureHandle Acquire(ID3D12GraphicsCommandList* CommandList, const std::wstring& Filename, const std::string& Name, bool bRepeat = true);
+
+	// 지금 있는 텍스쳐를 TexturePacker로 묶어 Texture2DArray를 만들고 밉을 전부 UploadManager로 올린다. 묶인 텍스쳐는 스트리밍에서 빠진다.
+	// 머티리얼은 그릴 때 핸들에서 자리를 다시 읽으니 첫 프레임 전에 한 번 부른다.
+	void Pack(const TexturePackOptions& Options = TexturePackOptions());
+
+	static const UINT64 DefaultDefragmentBytes = 4ull * 1024 * 1024;
+
+	// 텍스쳐 힙 뒤쪽의 텍스쳐를 앞의 빈 자리로 MaxBytes만큼 복사해 옮기고 Resource를 바꿔 끼운다. 옛 자원은 SubmitFence까지 들고 있는다.
+	// 텍스쳐가 전부 PIXEL_SHADER_RESOURCE여야 해서 프레임마다 UploadManager, TextureStreamer의 Update 뒤, 서술자를 고치기 전에 부른다.
+	void Defragment(ID3D12GraphicsCommandList* CommandList, UINT64 CompletedFence, UINT64 SubmitFence, UINT64 MaxBytes = DefaultDefragmentBytes);
+
+public:
+	// 풀린 자리는 nullptr
+	Texture* GetTexture(int SrvIndex) const;
+	int GetSrvCount() const;
+
+	const TextureCacheStats& GetStats() const;
+
+private:
+	friend class TextureHandle;
+
+	void AddRef(int SrvIndex);
+	void Release(int SrvIndex);
+
+	int AllocateSlot();
+
+	static std::wstring NormalizePath(const std::wstring& Filename);
+
+private:
+	struct Entry
+	{
+		std::unique_ptr<Texture> Tex;
+		std::wstring Path;
+		uint64_t ContentHash = 0;
+		uint64_t Bytes = 0;
+		uint32_t RefCount = 0;
+		bool bRepeat = true;
+
+		// 묶음 자체면 bPage. 묶인 텍스쳐는 Page가 묶음을 잡고 있고 자기 Resource는 비어 있다.
+		bool bPage = false;
+		TextureHandle Page;
+		TexturePlacement Placement;
+	};
+
+	struct RetiredResource
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+		UINT64 Fence = 0;
+	};
+
+	static TextureManager* Manager;
+
+	std::vector<Entry> Entries;
+	std::vector<int> FreeSlots;
+
+	std::unordered_map<std::wstring, int> PathToSlot;
+	std::unordered_map<uint64_t, int> HashToSlot;
+
+	// Defragment로 옮기고 GPU가 아직 읽고 있을 수 있는 옛 텍스쳐
+	std::vector<RetiredResource> Retired;
+
+	TextureCacheStats Stats;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+struct TexturePackItem
+{
+	// DXGI_FORMAT 값
+	uint32_t Format = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t MipCount = 1;
+
+	// UV가 [0, 1] 밖으로 나가서 반복해 까는 텍스쳐. 아틀라스에 넣으면 이웃 텍스쳐를 읽으므로 배열로만 묶는다.
+	bool bRepeat = true;
+};
+
+struct TexturePackOptions
+{
+	// 이보다 큰 텍스쳐는 묶지 않고 따로 둔다. 묶인 텍스쳐는 스트리밍하지 않으니 작은 것만 모은다.
+	uint32_t MaxItemSize = 1024;
+
+	// 포맷, 크기, 밉 수가 같은 텍스쳐가 이만큼 모여야 배열 하나로 만든다.
+	uint32_t MinArraySize = 2;
+
+	// 아틀라스 한 장의 한 변. 2의 거듭제곱이어야 한다.
+	uint32_t AtlasSize = 1024;
+
+	// 긴 변이 이 이하인 2의 거듭제곱 텍스쳐만 아틀라스에 넣는다. 0이면 아틀라스를 만들지 않는다.
+	uint32_t MaxAtlasItemSize = 256;
+};
+
+// Texture2DArray 하나. 아틀라스면 장마다 여러 텍스쳐가 들어 있다.
+struct TexturePage
+{
+	uint32_t Format = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t MipCount = 1;
+	uint32_t ArraySize = 0;
+	bool bAtlas = false;
+};
+
+// 묶이지 않은 텍스쳐는 Page가 -1이고 나머지 값은 그대로 원본 전체를 뜻한다.
+struct TexturePlacement
+{
+	int Page = -1;
+	uint32_t Slice = 0;
+
+	// 밉 0에서 차지하는 텍셀 영역. 밉 m에서는 전부 m만큼 민 값이다.
+	uint32_t X = 0;
+	uint32_t Y = 0;
+
+	// 원본 UV에 곱하고 더해서 페이지 UV로 바꾼다.
+	float ScaleU = 1.0f;
+	float ScaleV = 1.0f;
+	float OffsetU = 0.0f;
+	float OffsetV = 0.0f;
+};
+
+// 텍스쳐 목록을 Texture2DArray 몇 장으로 묶을지 정한다. 크기와 포맷만 보고 GPU는 몰라서 따로 떼어 돌려볼 수 있다.
+// 같은 포맷, 같은 크기끼리는 배열의 장으로 묶고, 작은 비반복 텍스쳐는 포맷별 아틀라스에 넣는다.
+// 아틀라스 칸은 텍스쳐 긴 변 크기의 정사각형을 큰 것부터 Z 순서로 채워서 모든 밉에서 칸 경계가 텍셀(BC는 블록)에 맞는다.
+class TexturePacker
+{
+public:
+	// OutPlacements는 Items와 같은 순서. 한 텍스쳐뿐인 묶음은 만들지 않는다.
+	static void Plan(const std::vector<TexturePackItem>& Items, const TexturePackOptions& Options,
+		std::vector<TexturePage>& OutPages, std::vector<TexturePlacement>& OutPlacements);
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "DDSFile.h"
+#include "TextureStreamingScheduler.h"
+
+using Microsoft::WRL::ComPtr;
+
+struct Texture;
+
+// DDS 텍스쳐를 밉 단위로 스트리밍한다. 처음에는 꼬리 밉만 올리고, 필요한 밉은 로더 스레드가 업로드 버퍼에 채워두면
+// 메인 스레드가 그 밉을 포함하는 텍스쳐를 새로 만들어 복사한다. 밉을 내릴 때도 더 작은 텍스쳐로 바꿔서 메모리를 돌려준다.
+class TextureStreamer
+{
+public:
+	TextureStreamer();
+	TextureStreamer(const TextureStreamer& Rhs) = delete;
+	TextureStreamer& operator=(const TextureStreamer& Rhs) = delete;
+	~TextureStreamer();
+
+public:
+	static TextureStreamer* Get();
+
+public:
+	void Init(ID3D12Device* InDevice);
+
+	// Target.Filename을 읽어서 Resource, StreamingHandle을 채운다. 처음 올리는 밉은 UploadManager에 모았다가 같이 복사한다.
+	// 2D가 아니거나 배열인 텍스쳐는 스트리밍하지 않고 전부 올린다.
+	// 밉이 하나뿐인 텍스쳐는 MipGenerator로 사슬을 채운 뒤 올린다.
+	HRESULT Load(ID3D12GraphicsCommandList* CommandList, Texture& Target);
+
+	// Target의 자원을 마지막으로 제출한 프레임이 끝난 뒤에 풀고 스트리밍에서 뺀다.
+	void Unload(Texture& Target);
+
+	// 스트리밍 중인 텍스쳐면 그 내용(밉을 채웠으면 채운 것)을, 아니면 nullptr
+	const DDSFile* GetFile(const Texture& Target) const;
+
+	// Target.Filename을 Load와 같은 방식으로 연다. 옆에 .sctx가 있으면 그걸 풀고, 밉이 하나뿐이면 사슬을 채운다.
+	std::unique_ptr<DDSFile> Open(const Texture& Target) const;
+
+	// 텍스쳐가 이번 프레임에 화면에서 덮는 최대 픽셀 수(긴 변 기준)
+	void RequestScreenSize(int Handle, float ProjectedPixels);
+
+	// 프레임마다 한 번. CompletedFence까지 끝난 옛 자원을 풀고, SubmitFence로 끝날 CommandList에 복사를 기록한다.
+	void Update(ID3D12GraphicsCommandList* CommandList, UINT64 CompletedFence, UINT64 SubmitFence);
+
+public:
+	void SetBudget(uint64_t Bytes);
+
+	// 가로, 세로가 이 이하인 밉은 처음부터 올린다.
+	void SetTailSize(uint32_t Size);
+
+	const TextureStreamingStats& GetStats() const;
+
+private:
+	struct StreamedTexture
+	{
+		Texture* Target = nullptr;
+		std::unique_ptr<DDSFile> File;
+		uint32_t ResidentMip = 0;
+	};
+
+	// 로더 스레드는 Textures를 건드리지 않고 여기 담긴 것만 쓴다.
+	struct LoadJob
+	{
+		uint32_t Handle = 0;
+		uint32_t Mip = 0;
+		const DDSFile* File = nullptr;
+
+		ComPtr<ID3D12Resource> Upload;
+		uint8_t* Mapped = nullptr;
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT Footprint = {};
+	};
+
+	struct RetiredResource
+	{
+		ComPtr<ID3D12Resource> Resource;
+		UINT64 Fence = 0;
+	};
+
+	void LoaderMain();
+	void PrepareUpload(LoadJob& Job) const;
+
+	// 밉 [NewMip, MipCount)를 갖는 텍스쳐를 새로 만들고 겹치는 밉은 옛 텍스쳐에서, 새 밉은 Job에서 복사한다.
+	void Rebuild(ID3D12GraphicsCommandList* CommandList, StreamedTexture& Streamed, uint32_t NewMip, const LoadJob* Job, UINT64 SubmitFence);
+
+private:
+	static TextureStreamer* Streamer;
+
+	ComPtr<ID3D12Device> Device;
+
+	std::vector<StreamedTexture> Textures;
+	TextureStreamingScheduler Scheduler;
+	std::vector<TextureStreamingCommand> Commands;
+	std::vector<RetiredResource> Retired;
+
+	uint64_t Frame = 0;
+	UINT64 LastSubmitFence = 0;
+	uint32_t TailSize = 64;
+
+	std::thread Loader;
+	std::mutex Mutex;
+	std::condition_variable WakeCondition;
+	std::deque<LoadJob> PendingJobs;
+	std::deque<LoadJob> CompletedJobs;
+	bool bQuit = false;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+enum class TextureStreamingAction : uint32_t
+{
+	Load = 0,
+	Evict
+};
+
+// 텍스쳐 하나의 상주 밉을 바꾸라는 명령. Mip은 바뀐 뒤 가장 고운 밉이다.
+struct TextureStreamingCommand
+{
+	uint32_t Texture = 0;
+	uint32_t Mip = 0;
+	TextureStreamingAction Action = TextureStreamingAction::Load;
+};
+
+struct TextureStreamingStats
+{
+	uint64_t Budget = 0;
+
+	// 올라와 있는 밉 + 올리는 중인 밉
+	uint64_t UsedBytes = 0;
+	uint64_t ResidentBytes = 0;
+
+	uint32_t TextureCount = 0;
+	uint32_t PendingLoadCount = 0;
+
+	// 이번 Update에서 내린 명령 수와 예산 때문에 못 올린 텍스쳐 수
+	uint32_t LoadCount = 0;
+	uint32_t EvictCount = 0;
+	uint32_t StarvedCount = 0;
+};
+
+// 어떤 텍스쳐의 어느 밉을 올리고 내릴지만 정한다. 밉 크기만 알면 되고 GPU는 몰라서 따로 떼어 돌려볼 수 있다.
+// 밉은 한 번에 한 단계씩 고와지고, 예산이 모자라면 오래 안 쓴 텍스쳐의 가장 고운 밉부터 내린다.
+class TextureStreamingScheduler
+{
+public:
+	// MipBytes[0]이 가장 고운 밉. 뒤에서 TailMipCount개는 처음부터 올라와 있고 내리지 않는다.
+	uint32_t AddTexture(const uint64_t* MipBytes, uint32_t MipCount, uint32_t TailMipCount);
+
+	// 더 이상 올리지도 내리지도 않고, 쓰던 예산(올리는 중인 밉 포함)을 돌려준다. 번호는 재사용하지 않는다.
+	void RemoveTexture(uint32_t Texture);
+
+	void SetBudget(uint64_t InBudget);
+	void SetMaxLoadsPerFrame(uint32_t Count);
+
+	// 이번 프레임에 필요한 밉. 한 프레임에 여러 번 부르면 가장 고운 쪽이 남는다.
+	void RequestMip(uint32_t Texture, uint32_t Mip);
+
+	// 모인 요청으로 이번 프레임 명령을 만든다. Evict는 바로 반영하고, Load는 CompleteLoad를 불러야 상주로 친다.
+	void Update(uint64_t Frame, std::vector<TextureStreamingCommand>& OutCommands);
+	void CompleteLoad(uint32_t Texture);
+
+public:
+	// 화면에서 ProjectedPixels 픽셀을 덮을 때 텍셀이 픽셀보다 촘촘해지지 않는 가장 거친 밉
+	static uint32_t ComputeRequiredMip(uint32_t TextureSize, float ProjectedPixels, uint32_t MipCount);
+
+public:
+	uint32_t GetResidentMip(uint32_t Texture) const;
+	uint32_t GetMipCount(uint32_t Texture) const;
+	const TextureStreamingStats& GetStats() const;
+
+private:
+	struct TextureState
+	{
+		// ChainBytes[i] = 밉 i부터 끝까지의 크기. MipCount + 1개.
+		std::vector<uint64_t> ChainBytes;
+		uint32_t MipCount = 0;
+		uint32_t TailMip = 0;
+
+		// PendingMip < ResidentMip이면 올리는 중
+		uint32_t ResidentMip = 0;
+		uint32_t PendingMip = 0;
+
+		uint32_t RequestedMip = UINT32_MAX;
+		uint32_t WantedMip = 0;
+		uint64_t LastUsedFrame = 0;
+		bool bEvicted = false;
+	};
+
+	uint64_t GetMipBytes(const TextureState& State, uint32_t Mip) const;
+
+	// MaxLastUsedFrame보다 먼저 쓰였거나 필요 이상으로 올라와 있는 텍스쳐에서 밉 하나를 내린다.
+	bool EvictOne(uint64_t MaxLastUsedFrame, uint32_t ExcludedTexture);
+
+private:
+	std::vector<TextureState> Textures;
+
+	uint64_t Budget = 64ull * 1024 * 1024;
+	uint32_t MaxLoadsPerFrame = 4;
+	uint64_t UsedBytes = 0;
+
+	std::vector<uint32_t> Candidates;
+	TextureStreamingStats Stats;
+};
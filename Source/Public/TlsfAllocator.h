@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+struct TlsfStats
+{
+	uint64_t Size = 0;
+
+	// 할당한 블록 크기의 합. 정렬 때문에 앞에 남은 틈은 빈 블록으로 돌려서 들어가지 않는다.
+	uint64_t UsedBytes = 0;
+	uint32_t AllocationCount = 0;
+	uint32_t FreeBlockCount = 0;
+};
+
+// 크기만 아는 구간 [0, Size)를 TLSF(두 단계 크기 분류 빈 목록)로 나눠준다. 메모리를 직접 건드리지 않아서 GPU 힙이든 뭐든 오프셋만 빌려 쓴다.
+// 빈 블록은 크기의 최상위 비트(1단계)와 그 아래 5비트(2단계)로 목록을 나누고 비트맵으로 찾아서 할당과 해제가 O(1)이다.
+// 블록 크기는 Granularity의 배수라서 정렬 때문에 남는 앞쪽 틈도 늘 빈 블록 하나로 돌려받는다. 이웃한 빈 블록은 바로 합친다.
+class TlsfAllocator
+{
+public:
+	static const uint32_t InvalidHandle = UINT32_MAX;
+
+	void Init(uint64_t InSize, uint64_t InGranularity);
+
+	// Alignment는 2의 거듭제곱. Granularity보다 작으면 Granularity로 본다. 자리가 없으면 InvalidHandle.
+	uint32_t Allocate(uint64_t Bytes, uint64_t Alignment);
+	void Free(uint32_t Handle);
+
+public:
+	uint64_t GetOffset(uint32_t Handle) const;
+	uint64_t GetSize(uint32_t Handle) const;
+
+	// 할당마다 하나씩 들고 있는 값. 조각 모으기에서 블록이 무엇인지 찾을 때 쓴다.
+	void SetUserData(uint32_t Handle, void* UserData);
+	void* GetUserData(uint32_t Handle) const;
+
+	// 살아 있는 할당을 오프셋이 큰 것부터
+	void GetAllocations(std::vector<uint32_t>& OutHandles) const;
+
+	uint64_t GetLargestFreeBlock() const;
+	bool IsEmpty() const;
+	const TlsfStats& GetStats() const;
+
+private:
+	static const uint32_t SecondLevelBits = 5;
+	static const uint32_t SecondLevelCount = 1 << SecondLevelBits;
+	static const uint32_t FirstLevelCount = 48;
+
+	struct Block
+	{
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+
+		uint32_t PrevPhysical = InvalidHandle;
+		uint32_t NextPhysical = InvalidHandle;
+		uint32_t PrevFree = InvalidHandle;
+		uint32_t NextFree = InvalidHandle;
+
+		bool bFree = false;
+		bool bUsed = false;
+		void* UserData = nullptr;
+	};
+
+	// 크기가 들어갈 목록. bRoundUp이면 그 목록의 어느 블록이든 Size 이상이 되도록 올려 잡는다.
+	void Map(uint64_t Size, bool bRoundUp, uint32_t& OutFirst, uint32_t& OutSecond) const;
+	uint32_t FindFree(uint64_t Size) const;
+
+	void InsertFree(uint32_t Handle);
+	void RemoveFree(uint32_t Handle);
+
+	uint32_t NewBlock();
+	void DeleteBlock(uint32_t Handle);
+
+private:
+	std::vector<Block> Blocks;
+	std::vector<uint32_t> UnusedBlocks;
+
+	uint32_t FreeHeads[FirstLevelCount][SecondLevelCount];
+	uint64_t FirstLevelBitmap = 0;
+	uint32_t SecondLevelBitmaps[FirstLevelCount] = {};
+
+	uint64_t Granularity = 1;
+	TlsfStats Stats;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <vector>
+#include "StagingRing.h"
+#include "GpuHeapAllocator.h"
+
+using Microsoft::WRL::ComPtr;
+
+// 처음 올리는 버퍼와 텍스쳐의 업로드를 큰 업로드 버퍼 하나(링)에서 나눠 쓴다. 자원마다 업로드 힙을 만들지 않는다.
+// 데이터는 부를 때 바로 링에 복사하고, 복사 명령과 상태 전환은 모아뒀다가 Update에서 한 번에 기록한다.
+// 링 자리는 그 CommandList의 펜스가 끝나면 돌아온다. 링에 안 들어가면 그것만 따로 업로드 버퍼를 만든다.
+class UploadManager
+{
+public:
+	UploadManager();
+	UploadManager(const UploadManager& Rhs) = delete;
+	UploadManager& operator=(const UploadManager& Rhs) = delete;
+	~UploadManager();
+
+public:
+	static UploadManager* Get();
+
+	static const UINT64 DefaultRingBytes = 32ull * 1024 * 1024;
+
+public:
+	// 링이 꽉 차면 Fence를 한 번 더 보고 끝난 자리를 돌려받는다.
+	void Init(ID3D12Device* InDevice, ID3D12Fence* InFence, UINT64 RingBytes = DefaultRingBytes);
+
+	// Data를 담은 기본 힙 버퍼를 GpuHeapAllocator에서 Category로 만든다. 복사가 끝나면 FinalState가 된다.
+	ComPtr<ID3D12Resource> CreateBuffer(GpuMemoryCategory Category, const void* Data, UINT64 Bytes, D3D12_RESOURCE_STATES FinalState = D3D12_RESOURCE_STATE_GENERIC_READ);
+
+	// Dest의 서브리소스 [First, First + Count)를 Data로 채운다. Dest는 COMMON 상태로 막 만든 자원이어야 한다.
+	void UploadSubresources(ID3D12Resource* Dest, UINT First, UINT Count, const D3D12_SUBRESOURCE_DATA* Data, D3D12_RESOURCE_STATES FinalState);
+
+	// SourceDesc의 SourceSubresource 모양 그대로 Data를 Dest 서브리소스의 (X, Y)에 복사한다. 아틀라스 칸처럼 일부만 채울 때 쓴다.
+	void UploadRegion(ID3D12Resource* Dest, UINT DestSubresource, UINT X, UINT Y,
+		const D3D12_RESOURCE_DESC& SourceDesc, UINT SourceSubresource, const D3D12_SUBRESOURCE_DATA& Data, D3D12_RESOURCE_STATES FinalState);
+
+	// 프레임마다 한 번. CompletedFence까지 끝난 자리를 돌려받고, 모인 복사를 SubmitFence로 끝날 CommandList에 기록한다.
+	// 올린 자원을 읽는 명령보다 먼저 불러야 한다.
+	void Update(ID3D12GraphicsCommandList* CommandList, UINT64 CompletedFence, UINT64 SubmitFence);
+
+public:
+	const StagingStats& GetStats() const;
+
+private:
+	struct Staging
+	{
+		ID3D12Resource* Resource = nullptr;
+		UINT64 Offset = 0;
+		uint8_t* Mapped = nullptr;
+	};
+
+	// 링에서 Bytes만큼 잡는다. 안 되면 따로 만든 업로드 버퍼를 준다.
+	Staging Allocate(UINT64 Bytes, UINT64 Alignment);
+
+	// 한 번 복사할 때마다 자원의 상태 전환을 앞뒤로 하나씩 모은다. 같은 자원은 한 번만 전환한다.
+	void Track(ID3D12Resource* Dest, D3D12_RESOURCE_STATES FinalState);
+
+private:
+	struct PendingCopy
+	{
+		ID3D12Resource* Dest = nullptr;
+		ID3D12Resource* Source = nullptr;
+		bool bBuffer = false;
+
+		// 버퍼 복사
+		UINT64 SourceOffset = 0;
+		UINT64 Bytes = 0;
+
+		// 텍스쳐 복사
+		UINT DestSubresource = 0;
+		UINT X = 0;
+		UINT Y = 0;
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT Footprint = {};
+	};
+
+	struct PendingTransition
+	{
+		ComPtr<ID3D12Resource> Resource;
+		D3D12_RESOURCE_STATES FinalState = D3D12_RESOURCE_STATE_COMMON;
+	};
+
+	struct RetiredResource
+	{
+		ComPtr<ID3D12Resource> Resource;
+		UINT64 Fence = 0;
+	};
+
+private:
+	static UploadManager* Manager;
+
+	ComPtr<ID3D12Device> Device;
+	ComPtr<ID3D12Fence> Fence;
+
+	ComPtr<ID3D12Resource> Ring;
+	uint8_t* RingMapped = nullptr;
+	StagingRing Allocator;
+
+	std::vector<PendingCopy> Copies;
+	std::vector<PendingTransition> Transitions;
+
+	// 아직 기록하지 않은 복사가 쓰는 따로 만든 업로드 버퍼와, 기록한 뒤 펜스를 기다리는 업로드 버퍼와 대상 자원
+	std::vector<ComPtr<ID3D12Resource>> Dedicated;
+	std::vector<RetiredResource> Retired;
+};
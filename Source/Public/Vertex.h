@@ -0,0 +1,38 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+using namespace DirectX;
+
+// D3D12나 FBX 없이도 쓸 수 있게 정점 정의만 따로 둔다.
+struct Vertex
+{
+	XMFLOAT3 Pos;
+	XMFLOAT3 Normal;
+	XMFLOAT2 TexCoord;
+	XMFLOAT4 BoneWeights;
+	// 뼈가 256개를 넘는 스켈레톤도 있어서 16비트로 둔다.
+	uint16_t BoneIndices[4];
+
+	bool operator==(const Vertex& Rhs) const
+	{
+		return (Pos.x == Rhs.Pos.x) && (Pos.y == Rhs.Pos.y) && (Pos.z == Rhs.Pos.z)
+			&& (Normal.x == Rhs.Normal.x) && (Normal.y == Rhs.Normal.y) && (Normal.z == Rhs.Normal.z)
+			&& (TexCoord.x == Rhs.TexCoord.x) && (TexCoord.y == Rhs.TexCoord.y)
+			&& (BoneWeights.x == Rhs.BoneWeights.x) && (BoneWeights.y == Rhs.BoneWeights.y)
+			&& (BoneWeights.z == Rhs.BoneWeights.z) && (BoneWeights.w == Rhs.BoneWeights.w)
+			&& (memcmp(BoneIndices, Rhs.BoneIndices, sizeof(BoneIndices)) == 0);
+	}
+};
+
+namespace std
+{
+	template <>
+	struct hash<Vertex>
+	{
+		size_t operator()(const Vertex& V) const;
+	};
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "FrameResource.h"
+
+struct VertexKey
+{
+	static const int WordCount = 15;
+
+	uint32_t Words[WordCount];
+
+	bool operator==(const VertexKey& Rhs) const
+	{
+		return 0 == memcmp(Words, Rhs.Words, sizeof(Words));
+	}
+};
+
+// Import 한 번 동안만 쓰는 Vertex 중복 제거용 테이블.
+// Vertex의 모든 속성을 키로 쓰고, Epsilon이 0보다 크면 그 격자 단위로 양자화해서 합친다.
+// Group이 다르면 속성이 같아도 합치지 않는다. 스키닝 메쉬는 무게를 채우기 전에 용접하니까 Control Point를 Group으로 넘긴다.
+class VertexWelder
+{
+public:
+	VertexWelder(std::vector<Vertex>& InVertices, float InEpsilon = 0.0f);
+	VertexWelder(const VertexWelder& Rhs) = delete;
+	VertexWelder& operator=(const VertexWelder& Rhs) = delete;
+
+public:
+	void Reserve(size_t VertexCount);
+	uint32_t Insert(const Vertex& InVertex, uint32_t Group = 0);
+
+public:
+	size_t GetMemoryUsage() const;
+	size_t GetProbeCount() const;
+
+public:
+	static VertexKey MakeKey(const Vertex& InVertex, float Epsilon, uint32_t Group = 0);
+	static uint64_t HashKey(const VertexKey& Key);
+
+private:
+	void Grow();
+
+private:
+	struct Slot
+	{
+		uint32_t Hash = 0;
+		uint32_t Index = UINT32_MAX;
+		uint32_t Group = 0;
+	};
+
+	std::vector<Vertex>& Vertices;
+	std::vector<Slot> Slots;
+
+	float Epsilon = 0.0f;
+
+	size_t Count = 0;
+	size_t ProbeCount = 0;
+};
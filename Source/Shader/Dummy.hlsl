@@ -2,6 +2,11 @@
     #define NUM_DIR_LIGHTS 3
 #endif
 
+// 메쉬에서 정점 하나가 실제로 쓰는 최대 뼈 수(1, 2, 4). 남는 슬롯은 무게가 0이라 읽지 않아도 된다.
+#ifndef MAX_BONE_INFLUENCES
+    #define MAX_BONE_INFLUENCES 4
+#endif
+
 #include "LightingUtil.hlsli"
 
 struct InstanceData
@@ -9,7 +14,7 @@ struct InstanceData
     float4x4 World;
     float4x4 TexTransform;
     uint MaterialIndex;
-    uint InstPad0;
+    uint PaletteOffset;
     uint InstPad1;
     uint InstPad2;
 };
@@ -21,16 +26,27 @@ struct MaterialData
     float Roughness;
     float4x4 MatTransform;
     uint DiffuseMapIndex;
-    uint MatPad0;
+    uint DiffuseMapSlice;
     uint MatPad1;
     uint MatPad2;
 };
 
-Texture2D gDiffuseMap[7] : register(t0);
+// 크기는 TextureManager::MaxSrvCount가 MAX_SRV_COUNT로 넘어온다. 묶이지 않은 텍스쳐도 한 장짜리 배열이다.
+Texture2DArray gDiffuseMap[MAX_SRV_COUNT] : register(t0);
 
 StructuredBuffer<InstanceData> gInstanceData : register(t0, space1);
 StructuredBuffer<MaterialData> gMaterialData : register(t1, space1);
+#ifdef SKINNING_DUAL_QUATERNION
+struct DualQuaternion
+{
+    float4 Real;
+    float4 Dual;
+};
+
+StructuredBuffer<DualQuaternion> gFinalTransforms : register(t2, space1);
+#else
 StructuredBuffer<float4x4> gFinalTransforms : register(t2, space1);
+#endif
 
 SamplerState gsamPointWrap : register(s0);
 SamplerState gsamPointClamp : register(s1);
@@ -55,10 +71,10 @@ cbuffer cbPass : register(b0)
     float gFarZ;
     float gTotalTime;
     float gDeltaTime;
-    float gFrame;
-    float gBoneCount;
+    float gPad0;
     float gPad1;
     float gPad2;
+    float gPad3;
     float4 gAmbientLight;
     
     Light gLights[MaxLights];
@@ -83,6 +99,12 @@ struct VSOut
     nointerpolation uint MatIndex : MATINDEX;
 };
 
+float3 RotateByQuaternion(float3 v, float4 q)
+{
+    float3 t = 2.0f * cross(q.xyz, v);
+    return v + q.w * t + cross(q.xyz, t);
+}
+
 VSOut skinning(VSIn vin, uint instanceID)
 {
     VSOut vout = (VSOut)0.0f;
@@ -96,13 +118,38 @@ VSOut skinning(VSIn vin, uint instanceID)
     weights[2] = vin.BoneWeights.z;
     weights[3] = vin.BoneWeights.w;
     
-    for (int i = 0; i < 4; i++)
+    InstanceData instData = gInstanceData[instanceID];
+    
+#ifdef SKINNING_DUAL_QUATERNION
+    // 첫 번째 뼈와 같은 반구로 맞춰서 섞은 뒤 정규화한다.
+    DualQuaternion first = gFinalTransforms.Load(instData.PaletteOffset + vin.BoneIndices[0]);
+    float4 blendReal = weights[0] * first.Real;
+    float4 blendDual = weights[0] * first.Dual;
+    
+    for (int i = 1; i < MAX_BONE_INFLUENCES; i++)
     {
-        posL += weights[i] * mul(float4(vin.PosL, 1.0f), gFinalTransforms.Load(gFrame * gBoneCount + vin.BoneIndices[i])).xyz;
-        normalL += weights[i] * mul(vin.NormalL, (float3x3)gFinalTransforms.Load(gFrame * gBoneCount + vin.BoneIndices[i]));
+        DualQuaternion dq = gFinalTransforms.Load(instData.PaletteOffset + vin.BoneIndices[i]);
+        float w = dot(first.Real, dq.Real) < 0.0f ? -weights[i] : weights[i];
+        blendReal += w * dq.Real;
+        blendDual += w * dq.Dual;
     }
     
-    InstanceData instData = gInstanceData[instanceID];
+    float invLength = 1.0f / length(blendReal);
+    blendReal *= invLength;
+    blendDual *= invLength;
+    
+    float3 translation = 2.0f * (blendReal.w * blendDual.xyz - blendDual.w * blendReal.xyz + cross(blendReal.xyz, blendDual.xyz));
+    posL = RotateByQuaternion(vin.PosL, blendReal) + translation;
+    normalL = RotateByQuaternion(vin.NormalL, blendReal);
+#else
+    for (int i = 0; i < MAX_BONE_INFLUENCES; i++)
+    {
+        float4x4 finalTransform = gFinalTransforms.Load(instData.PaletteOffset + vin.BoneIndices[i]);
+        posL += weights[i] * mul(float4(vin.PosL, 1.0f), finalTransform).xyz;
+        normalL += weights[i] * mul(vin.NormalL, (float3x3)finalTransform);
+    }
+#endif
+    
     float4x4 world = instData.World;
     float4x4 texTransform = instData.TexTransform;
     uint matIndex = instData.MaterialIndex;
@@ -137,7 +184,7 @@ float4 PSMain(VSOut pin) : SV_Target
     float roughness = matData.Roughness;
     uint diffuseTexIndex = matData.DiffuseMapIndex;
     
-    diffuseAlbedo *= gDiffuseMap[diffuseTexIndex].Sample(gsamLinearWrap, pin.TexCoord);
+    diffuseAlbedo *= gDiffuseMap[diffuseTexIndex].Sample(gsamLinearWrap, float3(pin.TexCoord, matData.DiffuseMapSlice));
 	
     pin.NormalW = normalize(pin.NormalW);
     
@@ -21,12 +21,13 @@ struct MaterialData
     float Roughness;
     float4x4 MatTransform;
     uint DiffuseMapIndex;
-    uint MatPad0;
+    uint DiffuseMapSlice;
     uint MatPad1;
     uint MatPad2;
 };
 
-Texture2D gDiffuseMap[7] : register(t0);
+// 크기는 TextureManager::MaxSrvCount가 MAX_SRV_COUNT로 넘어온다. 묶이지 않은 텍스쳐도 한 장짜리 배열이다.
+Texture2DArray gDiffuseMap[MAX_SRV_COUNT] : register(t0);
 
 StructuredBuffer<InstanceData> gInstanceData : register(t0, space1);
 StructuredBuffer<MaterialData> gMaterialData : register(t1, space1);
@@ -54,10 +55,10 @@ cbuffer cbPass : register(b0)
     float gFarZ;
     float gTotalTime;
     float gDeltaTime;
-    float gFrame;
     float gPad0;
     float gPad1;
     float gPad2;
+    float gPad3;
     float4 gAmbientLight;
     
     Light gLights[MaxLights];
@@ -114,7 +115,7 @@ float4 PSMain(VSOut pin) : SV_Target
     float roughness = matData.Roughness;
     uint diffuseTexIndex = matData.DiffuseMapIndex;
     
-    diffuseAlbedo *= gDiffuseMap[diffuseTexIndex].Sample(gsamLinearWrap, pin.TexCoord);
+    diffuseAlbedo *= gDiffuseMap[diffuseTexIndex].Sample(gsamLinearWrap, float3(pin.TexCoord, matData.DiffuseMapSlice));
 	
     pin.NormalW = normalize(pin.NormalW);
     
@@ -0,0 +1,157 @@
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "AnimationClip.h"
+
+// 압축한 클립이 설정한 오차 안에서 원본 포즈를 되돌리는지, 뼈 4개씩 푸는 Sample이 뼈 하나씩 푸는 기준 구현과 같은지 본다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s\n", Message);
+			++FailureCount;
+		}
+	}
+
+	float GetRotationError(const XMFLOAT4& A, const XMFLOAT4& B)
+	{
+		double Dot = (double)A.x * B.x + (double)A.y * B.y + (double)A.z * B.z + (double)A.w * B.w;
+		double Sign = Dot < 0.0 ? -1.0 : 1.0;
+		double Distance = 0.0;
+		Distance += (A.x - Sign * B.x) * (A.x - Sign * B.x);
+		Distance += (A.y - Sign * B.y) * (A.y - Sign * B.y);
+		Distance += (A.z - Sign * B.z) * (A.z - Sign * B.z);
+		Distance += (A.w - Sign * B.w) * (A.w - Sign * B.w);
+		return (float)(4.0 * asin(std::min(sqrt(Distance) * 0.5, 1.0)));
+	}
+
+	float GetDistance(const XMFLOAT3& A, const XMFLOAT3& B)
+	{
+		return sqrtf((A.x - B.x) * (A.x - B.x) + (A.y - B.y) * (A.y - B.y) + (A.z - B.z) * (A.z - B.z));
+	}
+
+	void TestQuantization()
+	{
+		std::mt19937 Random(3);
+		std::normal_distribution<float> Normal;
+
+		float MaxError = 0.0f;
+		for (int i = 0; i < 200000; i++)
+		{
+			XMFLOAT4 Source;
+			XMStoreFloat4(&Source, XMQuaternionNormalize(XMVectorSet(Normal(Random), Normal(Random), Normal(Random), Normal(Random))));
+
+			uint16_t Packed[3];
+			AnimationClip::PackRotation(XMLoadFloat4(&Source), Packed);
+
+			XMFLOAT4 Unpacked;
+			XMStoreFloat4(&Unpacked, AnimationClip::UnpackRotation(Packed));
+			MaxError = std::max(MaxError, GetRotationError(Source, Unpacked));
+		}
+
+		printf("Quantization: max error %g rad (budget %g)\n", MaxError, AnimationClip::RotationQuantizationError);
+		Check(MaxError <= AnimationClip::RotationQuantizationError, "48-bit rotation exceeds the quantization error budget");
+	}
+
+	void TestCompressedClip()
+	{
+		// 뼈 4개씩 묶이는 구간과 남는 뼈가 둘 다 나오게 4의 배수가 아닌 수로 잡는다.
+		const uint32_t BoneCount = 23;
+		const uint32_t FrameCount = 120;
+
+		std::mt19937 Random(11);
+		std::uniform_real_distribution<float> Phase(0.0f, 6.28f);
+		std::uniform_real_distribution<float> Speed(0.02f, 0.2f);
+
+		// 뼈마다 속도가 다른 사인 곡선. 일부 뼈는 가만히 두고 일부는 반구를 넘나들게 크게 돈다.
+		std::vector<BoneTransform> Poses((size_t)FrameCount * BoneCount);
+		for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+		{
+			const float RotationPhase = Phase(Random);
+			const float RotationSpeed = Bone % 5 == 0 ? 0.0f : Speed(Random) * (Bone % 3 == 0 ? 4.0f : 1.0f);
+			const float TranslationSpeed = Bone % 4 == 0 ? 0.0f : Speed(Random);
+
+			for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+			{
+				BoneTransform& Pose = Poses[(size_t)Frame * BoneCount + Bone];
+
+				const float Angle = RotationPhase + RotationSpeed * Frame;
+				XMStoreFloat4(&Pose.Rotation, XMQuaternionRotationRollPitchYaw(sinf(Angle), 0.5f * Angle, cosf(0.7f * Angle)));
+
+				Pose.Translation = { (float)Bone, 10.0f * sinf(TranslationSpeed * Frame), -3.0f * cosf(TranslationSpeed * Frame) };
+				Pose.Scale = { 1.0f, 1.0f + 0.1f * sinf(TranslationSpeed * Frame), 1.0f };
+			}
+		}
+
+		AnimationCompressionSettings Settings;
+		AnimationClipData Data;
+		AnimationClip::Compress(Poses, FrameCount, BoneCount, 30.0f, Settings, Data);
+		const AnimationClip Clip(Data);
+
+		std::vector<BoneTransform> Pose(BoneCount);
+		std::vector<BoneTransform> ScalarPose(BoneCount);
+
+		float RotationError = 0.0f;
+		float TranslationError = 0.0f;
+		float ScaleError = 0.0f;
+
+		for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+		{
+			Clip.Sample((float)Frame, Pose.data());
+			for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+			{
+				const BoneTransform& Source = Poses[(size_t)Frame * BoneCount + Bone];
+				RotationError = std::max(RotationError, GetRotationError(Pose[Bone].Rotation, Source.Rotation));
+				TranslationError = std::max(TranslationError, GetDistance(Pose[Bone].Translation, Source.Translation));
+				ScaleError = std::max(ScaleError, GetDistance(Pose[Bone].Scale, Source.Scale));
+			}
+		}
+
+		// 소수 프레임에서 두 경로는 계산 순서 차이만큼만 달라야 한다.
+		float RotationDifference = 0.0f;
+		float VectorDifference = 0.0f;
+
+		for (float Frame = -1.0f; Frame < FrameCount + 1.0f; Frame += 0.37f)
+		{
+			Clip.Sample(Frame, Pose.data());
+			Clip.SampleScalar(Frame, ScalarPose.data());
+			for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+			{
+				RotationDifference = std::max(RotationDifference, GetRotationError(Pose[Bone].Rotation, ScalarPose[Bone].Rotation));
+				VectorDifference = std::max(VectorDifference, GetDistance(Pose[Bone].Translation, ScalarPose[Bone].Translation));
+				VectorDifference = std::max(VectorDifference, GetDistance(Pose[Bone].Scale, ScalarPose[Bone].Scale));
+			}
+		}
+
+		const size_t RawBytes = Poses.size() * sizeof(BoneTransform);
+		printf("Compressed clip: %u bones x %u frames, %zu -> %zu bytes, %zu rotation / %zu translation / %zu scale keys\n",
+			BoneCount, FrameCount, RawBytes, Clip.GetByteSize(), Data.Rotations.size(), Data.Translations.size(), Data.Scales.size());
+		printf("  max error: rotation %g rad (tolerance %g), translation %g (tolerance %g), scale %g (tolerance %g)\n",
+			RotationError, Settings.RotationTolerance, TranslationError, Settings.TranslationTolerance, ScaleError, Settings.ScaleTolerance);
+		printf("  Sample vs SampleScalar: rotation %g rad, translation/scale %g\n", RotationDifference, VectorDifference);
+
+		// 키 자리의 값은 float 반올림만큼 흔들릴 수 있다.
+		Check(RotationError <= Settings.RotationTolerance + 1e-5f, "rotation error exceeds RotationTolerance");
+		Check(TranslationError <= Settings.TranslationTolerance + 1e-5f, "translation error exceeds TranslationTolerance");
+		Check(ScaleError <= Settings.ScaleTolerance + 1e-6f, "scale error exceeds ScaleTolerance");
+		Check(RotationDifference <= 1e-5f, "grouped sampling disagrees with the per-bone path on rotation");
+		Check(VectorDifference <= 1e-5f, "grouped sampling disagrees with the per-bone path on translation or scale");
+		Check(Data.Rotations.size() < Poses.size(), "key reduction did not drop any rotation keys");
+	}
+}
+
+int main()
+{
+	TestQuantization();
+	TestCompressedClip();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "BlockCompression.h"
+#include "JobSystem.h"
+
+// 2048x2048 그림을 포맷마다 인코딩하고 디코딩하는 처리량과 PSNR을 찍는다. 인코딩은 JobSystem 없이 한 번, 있을 때 한 번 돈다.
+//   cmake -S Tests -B Build/Tests -DCMAKE_BUILD_TYPE=Release && cmake --build Build/Tests --target BlockCompressionBench
+
+namespace
+{
+	const uint32_t Width = 2048;
+	const uint32_t Height = 2048;
+	const int Iterations = 3;
+
+	struct FormatCase
+	{
+		const char* Name;
+		BCFormat Format;
+	};
+
+	const FormatCase Formats[] =
+	{
+		{ "BC1", BCFormat::BC1 },
+		{ "BC3", BCFormat::BC3 },
+		{ "BC4", BCFormat::BC4 },
+		{ "BC5", BCFormat::BC5 },
+		{ "BC7", BCFormat::BC7 },
+	};
+
+	// BlockCompressionTest와 같은 모양. 그라데이션, 줄무늬, 노이즈, 색이 끊기는 사각형.
+	std::vector<uint8_t> MakeImage(uint32_t Seed)
+	{
+		std::mt19937 Random(Seed);
+
+		std::vector<uint8_t> Pixels((size_t)Width * Height * 4);
+		for (uint32_t Y = 0; Y < Height; Y++)
+		{
+			for (uint32_t X = 0; X < Width; X++)
+			{
+				const float U = (float)X / Width;
+				const float V = (float)Y / Height;
+
+				float Channels[4] =
+				{
+					255.0f * U,
+					128.0f + 100.0f * std::sin(V * 12.0f + U * 3.0f),
+					255.0f * (1.0f - U) * V,
+					160.0f + 80.0f * std::cos(U * 9.0f - V * 5.0f),
+				};
+
+				if (0 == (X / 24 + Y / 24) % 5)
+				{
+					Channels[0] = 255.0f - Channels[0];
+					Channels[2] = 30.0f;
+				}
+
+				uint8_t* Pixel = &Pixels[((size_t)Y * Width + X) * 4];
+				for (int Channel = 0; Channel < 4; Channel++)
+				{
+					Pixel[Channel] = (uint8_t)std::clamp(Channels[Channel] + (float)(Random() % 13) - 6.0f, 0.0f, 255.0f);
+				}
+			}
+		}
+		return Pixels;
+	}
+
+	double ComputePSNR(const std::vector<uint8_t>& Expected, const std::vector<uint8_t>& Actual, uint32_t ChannelCount)
+	{
+		double SquaredError = 0.0;
+		size_t Count = 0;
+		for (size_t i = 0; i < Expected.size(); i += 4)
+		{
+			for (uint32_t Channel = 0; Channel < ChannelCount; Channel++)
+			{
+				const double Difference = (double)Expected[i + Channel] - Actual[i + Channel];
+				SquaredError += Difference * Difference;
+				++Count;
+			}
+		}
+		return 0.0 == SquaredError ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / (SquaredError / Count));
+	}
+
+	template<typename Function>
+	double MeasureMilliseconds(Function&& Body)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			Body();
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() / Iterations;
+	}
+
+	double ToMegapixels(double Milliseconds)
+	{
+		return (double)Width * Height / Milliseconds / 1000.0;
+	}
+}
+
+int main()
+{
+	const std::vector<uint8_t> Pixels = MakeImage(1);
+	std::vector<uint8_t> Decoded(Pixels.size());
+
+	printf("%ux%u, average of %d runs\n", Width, Height, Iterations);
+	printf("format  encode 1 thread     encode N threads    decode N threads    PSNR\n");
+
+	for (const FormatCase& Case : Formats)
+	{
+		std::vector<uint8_t> Blocks(BlockCompression::GetSurfaceBytes(Case.Format, Width, Height));
+
+		const double SerialMs = MeasureMilliseconds([&]()
+		{
+			BlockCompression::EncodeSurface(Case.Format, Pixels.data(), Width, Height, Width * 4, Blocks.data());
+		});
+
+		double ParallelMs = 0.0;
+		double DecodeMs = 0.0;
+		uint32_t ThreadCount = 0;
+		{
+			JobSystem Jobs;
+			Jobs.Init();
+			ThreadCount = Jobs.GetThreadCount();
+
+			ParallelMs = MeasureMilliseconds([&]()
+			{
+				BlockCompression::EncodeSurface(Case.Format, Pixels.data(), Width, Height, Width * 4, Blocks.data());
+			});
+			DecodeMs = MeasureMilliseconds([&]()
+			{
+				BlockCompression::DecodeSurface(Case.Format, Blocks.data(), Width, Height, Decoded.data(), Width * 4);
+			});
+		}
+
+		printf("%-6s  %6.1f MPix/s       %6.1f MPix/s (%u)  %6.1f MPix/s       %.2f dB\n",
+			Case.Name, ToMegapixels(SerialMs), ToMegapixels(ParallelMs), ThreadCount, ToMegapixels(DecodeMs),
+			ComputePSNR(Pixels, Decoded, BlockCompression::GetChannelCount(Case.Format)));
+	}
+	return 0;
+}
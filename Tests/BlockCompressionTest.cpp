@@ -0,0 +1,307 @@
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "BlockCompression.h"
+#include "JobSystem.h"
+
+// 고정 시드로 만든 그림을 포맷마다 인코딩하고 BlockDecoder로 다시 풀어서 PSNR이 바닥값 아래로 떨어지지 않는지 본다.
+// 단색 블록, 4의 배수가 아닌 가장자리, 출력 버퍼 크기, JobSystem 유무에 따라 결과가 같은지도 본다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Name, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s: %s\n", Name, Message);
+			++FailureCount;
+		}
+	}
+
+	struct FormatCase
+	{
+		const char* Name;
+		BCFormat Format;
+
+		// MakeImage(256, 256, 1)에서 잰 값보다 0.3dB 낮게 잡았다. BC1 끝점 최소제곱 보정만 빼도 0.5dB 떨어지니 이 정도면 걸린다.
+		double MinPSNR;
+	};
+
+	const FormatCase Formats[] =
+	{
+		{ "BC1", BCFormat::BC1, 37.3 },
+		{ "BC3", BCFormat::BC3, 38.5 },
+		{ "BC4", BCFormat::BC4, 51.5 },
+		{ "BC5", BCFormat::BC5, 50.1 },
+		{ "BC7", BCFormat::BC7, 37.9 },
+	};
+
+	// 부드러운 그라데이션과 줄무늬에 노이즈를 얹고, 군데군데 색이 딱 끊기는 사각형을 넣는다. 채널마다 모양이 다르다.
+	std::vector<uint8_t> MakeImage(uint32_t Width, uint32_t Height, uint32_t Seed)
+	{
+		// 분포 클래스는 구현마다 값이 달라서 mt19937 출력을 바로 쓴다.
+		std::mt19937 Random(Seed);
+
+		std::vector<uint8_t> Pixels((size_t)Width * Height * 4);
+		for (uint32_t Y = 0; Y < Height; Y++)
+		{
+			for (uint32_t X = 0; X < Width; X++)
+			{
+				const float U = (float)X / Width;
+				const float V = (float)Y / Height;
+
+				float Channels[4] =
+				{
+					255.0f * U,
+					128.0f + 100.0f * std::sin(V * 12.0f + U * 3.0f),
+					255.0f * (1.0f - U) * V,
+					160.0f + 80.0f * std::cos(U * 9.0f - V * 5.0f),
+				};
+
+				if (0 == (X / 24 + Y / 24) % 5)
+				{
+					Channels[0] = 255.0f - Channels[0];
+					Channels[2] = 30.0f;
+				}
+
+				uint8_t* Pixel = &Pixels[((size_t)Y * Width + X) * 4];
+				for (int Channel = 0; Channel < 4; Channel++)
+				{
+					Pixel[Channel] = (uint8_t)std::clamp(Channels[Channel] + (float)(Random() % 13) - 6.0f, 0.0f, 255.0f);
+				}
+			}
+		}
+		return Pixels;
+	}
+
+	// 포맷이 담는 채널만 센다.
+	double ComputePSNR(const std::vector<uint8_t>& Expected, const std::vector<uint8_t>& Actual, uint32_t ChannelCount)
+	{
+		double SquaredError = 0.0;
+		size_t Count = 0;
+		for (size_t i = 0; i < Expected.size(); i += 4)
+		{
+			for (uint32_t Channel = 0; Channel < ChannelCount; Channel++)
+			{
+				const double Difference = (double)Expected[i + Channel] - Actual[i + Channel];
+				SquaredError += Difference * Difference;
+				++Count;
+			}
+		}
+
+		if (0.0 == SquaredError)
+		{
+			return 99.0;
+		}
+		return 10.0 * std::log10(255.0 * 255.0 / (SquaredError / Count));
+	}
+
+	// 단색 블록이 풀렸을 때 채널마다 허용하는 차이. BC1과 BC3 색은 565 끝점, BC7 모드 6은 7비트 끝점과 p비트만큼 어긋난다.
+	int GetSolidTolerance(BCFormat Format, uint32_t Channel)
+	{
+		switch (Format)
+		{
+		case BCFormat::BC1:
+			return 4;
+		case BCFormat::BC3:
+			return Channel < 3 ? 4 : 0;
+		case BCFormat::BC7:
+			return 1;
+		default:
+			return 0;
+		}
+	}
+
+	std::vector<uint8_t> RoundTrip(BCFormat Format, const std::vector<uint8_t>& Pixels, uint32_t Width, uint32_t Height)
+	{
+		std::vector<uint8_t> Blocks(BlockCompression::GetSurfaceBytes(Format, Width, Height));
+		BlockCompression::EncodeSurface(Format, Pixels.data(), Width, Height, Width * 4, Blocks.data());
+
+		std::vector<uint8_t> Decoded(Pixels.size());
+		BlockCompression::DecodeSurface(Format, Blocks.data(), Width, Height, Decoded.data(), Width * 4);
+		return Decoded;
+	}
+
+	void TestPSNR()
+	{
+		const uint32_t Width = 256;
+		const uint32_t Height = 256;
+		const std::vector<uint8_t> Pixels = MakeImage(Width, Height, 1);
+
+		for (const FormatCase& Case : Formats)
+		{
+			const std::vector<uint8_t> Decoded = RoundTrip(Case.Format, Pixels, Width, Height);
+			const double PSNR = ComputePSNR(Pixels, Decoded, BlockCompression::GetChannelCount(Case.Format));
+			Check(PSNR >= Case.MinPSNR, Case.Name, "PSNR fell below the floor");
+		}
+	}
+
+	// 단색 블록은 끝점 양자화 오차만 남는다.
+	void TestSolidBlocks()
+	{
+		const uint8_t Colors[][4] =
+		{
+			{ 0, 0, 0, 255 },
+			{ 255, 255, 255, 0 },
+			{ 17, 200, 93, 128 },
+			{ 250, 3, 129, 7 },
+		};
+
+		for (const FormatCase& Case : Formats)
+		{
+			const uint32_t ChannelCount = BlockCompression::GetChannelCount(Case.Format);
+
+			bool bMatches = true;
+			for (const uint8_t* Color : Colors)
+			{
+				uint8_t Pixels[64];
+				for (int i = 0; i < 16; i++)
+				{
+					memcpy(Pixels + i * 4, Color, 4);
+				}
+
+				uint8_t Block[16];
+				uint8_t Decoded[64];
+				BlockCompression::EncodeBlock(Case.Format, Pixels, Block);
+				BlockCompression::DecodeBlock(Case.Format, Block, Decoded);
+
+				for (int i = 0; i < 16; i++)
+				{
+					for (uint32_t Channel = 0; Channel < ChannelCount; Channel++)
+					{
+						bMatches = bMatches && std::abs((int)Decoded[i * 4 + Channel] - (int)Color[Channel]) <= GetSolidTolerance(Case.Format, Channel);
+					}
+				}
+			}
+			Check(bMatches, Case.Name, "solid block does not decode to its color");
+		}
+	}
+
+	// 4의 배수가 아닌 크기. 출력은 GetSurfaceBytes를 넘지 않고, 마지막 행과 열을 4의 배수까지 직접 늘린 그림을 인코딩한 것과 블록이 같아야 한다.
+	// 그러면 두 줄짜리 단색 띠는 가장자리 블록 전체가 띠 색이라 단색 블록처럼 풀린다.
+	void TestEdgeBlocks()
+	{
+		const uint32_t Sizes[][2] = { { 1, 1 }, { 3, 5 }, { 6, 7 }, { 13, 9 }, { 2, 33 }, { 61, 3 } };
+		const uint8_t Guard = 0xA5;
+
+		for (const FormatCase& Case : Formats)
+		{
+			const uint32_t ChannelCount = BlockCompression::GetChannelCount(Case.Format);
+
+			bool bInBounds = true;
+			bool bPadded = true;
+			for (const auto& Size : Sizes)
+			{
+				const uint32_t Width = Size[0];
+				const uint32_t Height = Size[1];
+				const std::vector<uint8_t> Pixels = MakeImage(Width, Height, Width * 100 + Height);
+
+				const size_t SurfaceBytes = BlockCompression::GetSurfaceBytes(Case.Format, Width, Height);
+				bInBounds = bInBounds && SurfaceBytes == (size_t)((Width + 3) / 4) * ((Height + 3) / 4) * BlockCompression::GetBlockBytes(Case.Format);
+
+				std::vector<uint8_t> Blocks(SurfaceBytes + 64, Guard);
+				BlockCompression::EncodeSurface(Case.Format, Pixels.data(), Width, Height, Width * 4, Blocks.data());
+				for (size_t i = SurfaceBytes; i < Blocks.size(); i++)
+				{
+					bInBounds = bInBounds && Guard == Blocks[i];
+				}
+
+				// 행 끝에 빈 공간을 둬서 DecodeSurface가 보이는 픽셀만 쓰는지도 같이 본다.
+				const size_t RowPitch = Width * 4 + 12;
+				std::vector<uint8_t> Decoded(RowPitch * Height, Guard);
+				BlockCompression::DecodeSurface(Case.Format, Blocks.data(), Width, Height, Decoded.data(), RowPitch);
+
+				for (uint32_t Y = 0; Y < Height; Y++)
+				{
+					for (size_t i = Width * 4; i < RowPitch; i++)
+					{
+						bInBounds = bInBounds && Guard == Decoded[Y * RowPitch + i];
+					}
+				}
+
+				const uint32_t PaddedWidth = (Width + 3) / 4 * 4;
+				const uint32_t PaddedHeight = (Height + 3) / 4 * 4;
+				std::vector<uint8_t> Padded((size_t)PaddedWidth * PaddedHeight * 4);
+				for (uint32_t Y = 0; Y < PaddedHeight; Y++)
+				{
+					for (uint32_t X = 0; X < PaddedWidth; X++)
+					{
+						memcpy(&Padded[((size_t)Y * PaddedWidth + X) * 4], &Pixels[((size_t)std::min(Y, Height - 1) * Width + std::min(X, Width - 1)) * 4], 4);
+					}
+				}
+
+				std::vector<uint8_t> PaddedBlocks(SurfaceBytes);
+				BlockCompression::EncodeSurface(Case.Format, Padded.data(), PaddedWidth, PaddedHeight, PaddedWidth * 4, PaddedBlocks.data());
+				bPadded = bPadded && 0 == memcmp(PaddedBlocks.data(), Blocks.data(), SurfaceBytes);
+			}
+			Check(bInBounds, Case.Name, "edge surface wrote outside its blocks or rows");
+			Check(bPadded, Case.Name, "edge blocks differ from encoding the padded image");
+
+			std::vector<uint8_t> Band = MakeImage(6, 6, 9);
+			for (uint32_t Y = 0; Y < 6; Y++)
+			{
+				for (uint32_t X = 4; X < 6; X++)
+				{
+					uint8_t* Pixel = &Band[(Y * 6 + X) * 4];
+					Pixel[0] = 40;
+					Pixel[1] = 180;
+					Pixel[2] = 220;
+					Pixel[3] = 90;
+				}
+			}
+
+			const std::vector<uint8_t> Decoded = RoundTrip(Case.Format, Band, 6, 6);
+			bool bBand = true;
+			for (uint32_t Y = 0; Y < 6; Y++)
+			{
+				for (uint32_t X = 4; X < 6; X++)
+				{
+					for (uint32_t Channel = 0; Channel < ChannelCount; Channel++)
+					{
+						bBand = bBand && std::abs((int)Decoded[(Y * 6 + X) * 4 + Channel] - (int)Band[(Y * 6 + X) * 4 + Channel]) <= GetSolidTolerance(Case.Format, Channel);
+					}
+				}
+			}
+			Check(bBand, Case.Name, "edge block padding must repeat the last column");
+		}
+	}
+
+	// 블록 행을 스레드에 나눠도 결과는 한 스레드에서 만든 것과 바이트 단위로 같아야 한다.
+	void TestJobSystemMatchesSerial()
+	{
+		const uint32_t Width = 130;
+		const uint32_t Height = 70;
+		const std::vector<uint8_t> Pixels = MakeImage(Width, Height, 5);
+
+		for (const FormatCase& Case : Formats)
+		{
+			const size_t SurfaceBytes = BlockCompression::GetSurfaceBytes(Case.Format, Width, Height);
+			std::vector<uint8_t> Serial(SurfaceBytes);
+			std::vector<uint8_t> Parallel(SurfaceBytes);
+
+			BlockCompression::EncodeSurface(Case.Format, Pixels.data(), Width, Height, Width * 4, Serial.data());
+			{
+				JobSystem Jobs;
+				Jobs.Init(3);
+				BlockCompression::EncodeSurface(Case.Format, Pixels.data(), Width, Height, Width * 4, Parallel.data());
+			}
+			Check(Serial == Parallel, Case.Name, "parallel encode differs from the serial encode");
+		}
+	}
+}
+
+int main()
+{
+	TestPSNR();
+	TestSolidBlocks();
+	TestEdgeBlocks();
+	TestJobSystemMatchesSerial();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include <cstdio>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "BlockDecoder.h"
+#include "JobSystem.h"
+
+// 2048x2048 크기의 무작위 블록을 포맷마다 푸는 처리량을 찍는다. JobSystem 없이 한 번, 있을 때 한 번 돈다.
+// BC7과 BC6H는 모드 비트를 고르게 돌려서 모든 모드가 같은 비율로 섞이게 한다. 그냥 무작위면 BC7은 절반이 모드 0이다.
+//   cmake -S Tests -B Build/Tests -DCMAKE_BUILD_TYPE=Release && cmake --build Build/Tests --target BlockDecoderBench
+
+namespace
+{
+	const uint32_t Width = 2048;
+	const uint32_t Height = 2048;
+	const int Iterations = 5;
+
+	struct FormatCase
+	{
+		const char* Name;
+		uint32_t Format;
+		bool bFloat;
+	};
+
+	// DXGI_FORMAT 값
+	const FormatCase Formats[] =
+	{
+		{ "BC1", 71, false },
+		{ "BC2", 74, false },
+		{ "BC3", 77, false },
+		{ "BC4", 80, false },
+		{ "BC4 SNORM", 81, true },
+		{ "BC5", 83, false },
+		{ "BC5 SNORM", 84, true },
+		{ "BC6H UF16", 95, true },
+		{ "BC6H SF16", 96, true },
+		{ "BC7", 98, false },
+	};
+
+	// 예약된 모드를 뺀 BC6H 모드 비트 14개
+	const uint8_t BC6HModes[] = { 0x00, 0x01, 0x02, 0x06, 0x0A, 0x0E, 0x12, 0x16, 0x1A, 0x1E, 0x03, 0x07, 0x0B, 0x0F };
+
+	std::vector<uint8_t> MakeBlocks(uint32_t Format, size_t BlockCount)
+	{
+		const uint32_t BlockBytes = BlockDecoder::GetBlockBytes(Format);
+
+		std::mt19937 Random(Format);
+		std::vector<uint8_t> Blocks(BlockCount * BlockBytes);
+		for (uint8_t& Value : Blocks)
+		{
+			Value = (uint8_t)Random();
+		}
+
+		for (size_t i = 0; i < BlockCount; i++)
+		{
+			uint8_t& First = Blocks[i * BlockBytes];
+			if (Format == 98)
+			{
+				const uint32_t Mode = i % 8;
+				First = (uint8_t)((First & ~((2u << Mode) - 1)) | (1u << Mode));
+			}
+			else if (Format == 95 || Format == 96)
+			{
+				const uint8_t Mode = BC6HModes[i % 14];
+				First = (uint8_t)((First & (Mode < 2 ? ~0x03 : ~0x1F)) | Mode);
+			}
+		}
+		return Blocks;
+	}
+
+	double Measure(const FormatCase& Case, const std::vector<uint8_t>& Blocks, std::vector<uint8_t>& Pixels, std::vector<float>& FloatPixels)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			if (Case.bFloat)
+			{
+				BlockDecoder::DecodeSurfaceFloat(Case.Format, Blocks.data(), 0, Width, Height, FloatPixels.data(), Width * 4 * sizeof(float));
+			}
+			else
+			{
+				BlockDecoder::DecodeSurface(Case.Format, Blocks.data(), 0, Width, Height, Pixels.data(), Width * 4);
+			}
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() / Iterations;
+	}
+
+	double ToMegapixels(double Milliseconds)
+	{
+		return (double)Width * Height / Milliseconds / 1000.0;
+	}
+}
+
+int main()
+{
+	const size_t BlockCount = (size_t)(Width / 4) * (Height / 4);
+
+	std::vector<uint8_t> Pixels((size_t)Width * Height * 4);
+	std::vector<float> FloatPixels((size_t)Width * Height * 4);
+
+	// 출력 버퍼 페이지를 미리 채운다.
+	BlockDecoder::DecodeSurface(71, MakeBlocks(71, BlockCount).data(), 0, Width, Height, Pixels.data(), Width * 4);
+	BlockDecoder::DecodeSurfaceFloat(95, MakeBlocks(95, BlockCount).data(), 0, Width, Height, FloatPixels.data(), Width * 4 * sizeof(float));
+
+	std::vector<std::vector<uint8_t>> Blocks;
+	for (const FormatCase& Case : Formats)
+	{
+		Blocks.push_back(MakeBlocks(Case.Format, BlockCount));
+	}
+
+	double SerialMs[sizeof(Formats) / sizeof(Formats[0])] = {};
+	for (size_t i = 0; i < Blocks.size(); i++)
+	{
+		SerialMs[i] = Measure(Formats[i], Blocks[i], Pixels, FloatPixels);
+	}
+
+	JobSystem Jobs;
+	Jobs.Init();
+
+	printf("%ux%u, average of %d runs, %u threads with JobSystem\n", Width, Height, Iterations, Jobs.GetThreadCount());
+	printf("format       output  1 thread         JobSystem\n");
+	for (size_t i = 0; i < Blocks.size(); i++)
+	{
+		const double ParallelMs = Measure(Formats[i], Blocks[i], Pixels, FloatPixels);
+		printf("%-11s  %-6s  %7.1f MPix/s   %7.1f MPix/s\n", Formats[i].Name, Formats[i].bFloat ? "float" : "unorm", ToMegapixels(SerialMs[i]), ToMegapixels(ParallelMs));
+	}
+	return 0;
+}
@@ -0,0 +1,424 @@
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include "BlockDecoder.h"
+
+// 손으로 만들거나 고정 시드로 뽑은 블록을 스펙대로 푼 값과 비트 단위로 비교한다.
+// BC1~BC5와 BC7 기대값은 Pillow의 BCn 디코더와 맞춰 봤고, BC6H 기대값은 스펙의 비트 배치와 정수 식을 그대로 옮긴 따로 만든 구현에서 뽑았다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Name, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s: %s\n", Name, Message);
+			++FailureCount;
+		}
+	}
+
+	struct UnormGolden
+	{
+		const char* Name;
+		uint32_t Format;
+		uint8_t Block[16];
+		uint8_t Pixels[64];
+	};
+
+	// BC6H는 half 비트로 적는다. 알파는 항상 1이다.
+	struct FloatGolden
+	{
+		const char* Name;
+		uint32_t Format;
+		uint8_t Block[16];
+		uint16_t Pixels[16][3];
+	};
+
+	// BC1~BC5는 버림 보간이 드러나도록 고른 끝점, BC7은 모드마다 고정 시드로 뽑은 블록 하나. 픽셀은 행 순서 RGBA8.
+	const UnormGolden UnormGoldens[] =
+	{
+		{
+			"BC1 four colors, thirds truncated", 71,
+			{ 0xFF, 0xFF, 0x41, 0x08, 0xE4, 0x1B, 0x00, 0xFF },
+			{
+				0xFF, 0xFF, 0xFF, 0xFF, 0x08, 0x08, 0x08, 0xFF, 0xAC, 0xAC, 0xAC, 0xFF, 0x5A, 0x5A, 0x5A, 0xFF,
+				0x5A, 0x5A, 0x5A, 0xFF, 0xAC, 0xAC, 0xAC, 0xFF, 0x08, 0x08, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0x5A, 0x5A, 0x5A, 0xFF, 0x5A, 0x5A, 0x5A, 0xFF, 0x5A, 0x5A, 0x5A, 0xFF, 0x5A, 0x5A, 0x5A, 0xFF,
+			},
+		},
+		{
+			"BC1 three colors and transparent", 71,
+			{ 0x41, 0x08, 0xFF, 0xFF, 0xE4, 0xE4, 0xE4, 0xE4 },
+			{
+				0x08, 0x08, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x83, 0x83, 0x83, 0xFF, 0x00, 0x00, 0x00, 0x00,
+				0x08, 0x08, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x83, 0x83, 0x83, 0xFF, 0x00, 0x00, 0x00, 0x00,
+				0x08, 0x08, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x83, 0x83, 0x83, 0xFF, 0x00, 0x00, 0x00, 0x00,
+				0x08, 0x08, 0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x83, 0x83, 0x83, 0xFF, 0x00, 0x00, 0x00, 0x00,
+			},
+		},
+		{
+			"BC2 explicit alpha, always four colors", 74,
+			{ 0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE, 0x41, 0x08, 0xFF, 0xFF, 0xE4, 0xE4, 0xE4, 0xE4 },
+			{
+				0x08, 0x08, 0x08, 0x00, 0xFF, 0xFF, 0xFF, 0x11, 0x5A, 0x5A, 0x5A, 0x22, 0xAC, 0xAC, 0xAC, 0x33,
+				0x08, 0x08, 0x08, 0x44, 0xFF, 0xFF, 0xFF, 0x55, 0x5A, 0x5A, 0x5A, 0x66, 0xAC, 0xAC, 0xAC, 0x77,
+				0x08, 0x08, 0x08, 0x88, 0xFF, 0xFF, 0xFF, 0x99, 0x5A, 0x5A, 0x5A, 0xAA, 0xAC, 0xAC, 0xAC, 0xBB,
+				0x08, 0x08, 0x08, 0xCC, 0xFF, 0xFF, 0xFF, 0xDD, 0x5A, 0x5A, 0x5A, 0xEE, 0xAC, 0xAC, 0xAC, 0xFF,
+			},
+		},
+		{
+			"BC3 eight alpha steps", 77,
+			{ 0xC8, 0x64, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA, 0x41, 0x08, 0xFF, 0xFF, 0x1B, 0x1B, 0x1B, 0x1B },
+			{
+				0xAC, 0xAC, 0xAC, 0xC8, 0x5A, 0x5A, 0x5A, 0x64, 0xFF, 0xFF, 0xFF, 0xB9, 0x08, 0x08, 0x08, 0xAB,
+				0xAC, 0xAC, 0xAC, 0x9D, 0x5A, 0x5A, 0x5A, 0x8E, 0xFF, 0xFF, 0xFF, 0x80, 0x08, 0x08, 0x08, 0x72,
+				0xAC, 0xAC, 0xAC, 0xC8, 0x5A, 0x5A, 0x5A, 0x64, 0xFF, 0xFF, 0xFF, 0xB9, 0x08, 0x08, 0x08, 0xAB,
+				0xAC, 0xAC, 0xAC, 0x9D, 0x5A, 0x5A, 0x5A, 0x8E, 0xFF, 0xFF, 0xFF, 0x80, 0x08, 0x08, 0x08, 0x72,
+			},
+		},
+		{
+			"BC4 six steps with 0 and 255", 80,
+			{ 0x0A, 0x15, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA },
+			{
+				0x0A, 0x00, 0x00, 0xFF, 0x15, 0x00, 0x00, 0xFF, 0x0C, 0x00, 0x00, 0xFF, 0x0E, 0x00, 0x00, 0xFF,
+				0x10, 0x00, 0x00, 0xFF, 0x12, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF,
+				0x0A, 0x00, 0x00, 0xFF, 0x15, 0x00, 0x00, 0xFF, 0x0C, 0x00, 0x00, 0xFF, 0x0E, 0x00, 0x00, 0xFF,
+				0x10, 0x00, 0x00, 0xFF, 0x12, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF,
+			},
+		},
+		{
+			"BC5 two channels", 83,
+			{ 0x0A, 0x15, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA, 0xC8, 0x64, 0x77, 0x39, 0x05, 0x77, 0x39, 0x05 },
+			{
+				0x0A, 0x72, 0x00, 0xFF, 0x15, 0x80, 0x00, 0xFF, 0x0C, 0x8E, 0x00, 0xFF, 0x0E, 0x9D, 0x00, 0xFF,
+				0x10, 0xAB, 0x00, 0xFF, 0x12, 0xB9, 0x00, 0xFF, 0x00, 0x64, 0x00, 0xFF, 0xFF, 0xC8, 0x00, 0xFF,
+				0x0A, 0x72, 0x00, 0xFF, 0x15, 0x80, 0x00, 0xFF, 0x0C, 0x8E, 0x00, 0xFF, 0x0E, 0x9D, 0x00, 0xFF,
+				0x10, 0xAB, 0x00, 0xFF, 0x12, 0xB9, 0x00, 0xFF, 0x00, 0x64, 0x00, 0xFF, 0xFF, 0xC8, 0x00, 0xFF,
+			},
+		},
+		{
+			"BC7 mode 0", 98,
+			{ 0x53, 0xF2, 0x26, 0x65, 0xA6, 0x0C, 0x12, 0xD2, 0x89, 0x18, 0x5D, 0x95, 0x0E, 0xE8, 0x81, 0x36 },
+			{
+				0x52, 0x31, 0x3E, 0xFF, 0x41, 0x31, 0x2A, 0xFF, 0x74, 0x31, 0x6A, 0xFF, 0x41, 0x31, 0x2A, 0xFF,
+				0x63, 0x59, 0xBB, 0xFF, 0x39, 0x6B, 0x4A, 0xFF, 0x73, 0x52, 0xE7, 0xFF, 0x73, 0x52, 0xE7, 0xFF,
+				0x63, 0x59, 0xBB, 0xFF, 0x41, 0x67, 0x60, 0xFF, 0x5B, 0x5D, 0xA5, 0xFF, 0x73, 0x52, 0xE7, 0xFF,
+				0x56, 0x5A, 0x93, 0xFF, 0x38, 0x86, 0xBA, 0xFF, 0x38, 0x86, 0xBA, 0xFF, 0x94, 0x00, 0x42, 0xFF,
+			},
+		},
+		{
+			"BC7 mode 1", 98,
+			{ 0x0A, 0x16, 0x6F, 0x6B, 0x11, 0x3D, 0x17, 0x8D, 0x6C, 0x0F, 0xD3, 0x90, 0x1F, 0xF2, 0x39, 0xA1 },
+			{
+				0x5A, 0x46, 0x36, 0xFF, 0x8A, 0x4A, 0x48, 0xFF, 0xCB, 0xB5, 0xBE, 0xFF, 0x9A, 0x64, 0x64, 0xFF,
+				0xB2, 0x98, 0x8C, 0xFF, 0x6A, 0x16, 0x0E, 0xFF, 0xAB, 0x81, 0x85, 0xFF, 0xDB, 0xCF, 0xDB, 0xFF,
+				0x70, 0x5A, 0x4B, 0xFF, 0x6A, 0x16, 0x0E, 0xFF, 0xAB, 0x81, 0x85, 0xFF, 0x7A, 0x30, 0x2B, 0xFF,
+				0x70, 0x5A, 0x4B, 0xFF, 0xCB, 0xB5, 0xBE, 0xFF, 0x9A, 0x64, 0x64, 0xFF, 0xBB, 0x9B, 0xA1, 0xFF,
+			},
+		},
+		{
+			"BC7 mode 2", 98,
+			{ 0xA4, 0x95, 0xF2, 0x0F, 0x93, 0x95, 0x65, 0x0C, 0xF9, 0x38, 0x0B, 0x8E, 0xDB, 0x22, 0x4A, 0x6B },
+			{
+				0x52, 0x80, 0x4C, 0xFF, 0x90, 0x49, 0x4C, 0xFF, 0x21, 0xCE, 0x73, 0xFF, 0x57, 0x8D, 0x60, 0xFF,
+				0x52, 0x5A, 0x39, 0xFF, 0xF7, 0x94, 0xB5, 0xFF, 0xCE, 0x91, 0x7A, 0xFF, 0xF7, 0x94, 0xB5, 0xFF,
+				0x52, 0x80, 0x4C, 0xFF, 0xCE, 0x91, 0x7A, 0xFF, 0xA4, 0x8F, 0x3B, 0xFF, 0xA4, 0x8F, 0x3B, 0xFF,
+				0x52, 0x80, 0x4C, 0xFF, 0x90, 0x49, 0x4C, 0xFF, 0x21, 0xCE, 0x73, 0xFF, 0xC6, 0x08, 0x39, 0xFF,
+			},
+		},
+		{
+			"BC7 mode 3", 98,
+			{ 0x28, 0x8A, 0x1E, 0x92, 0x4E, 0x8F, 0xD0, 0xAE, 0x2E, 0x1A, 0x94, 0x92, 0xA3, 0x30, 0x5F, 0x18 },
+			{
+				0x44, 0x7A, 0x16, 0xFF, 0x25, 0xDB, 0x29, 0xFF, 0x38, 0x55, 0x18, 0xFF, 0x2C, 0xCB, 0x34, 0xFF,
+				0x25, 0xDB, 0x29, 0xFF, 0x2B, 0x2E, 0x19, 0xFF, 0x2C, 0xCB, 0x34, 0xFF, 0x44, 0x7A, 0x16, 0xFF,
+				0x1F, 0x09, 0x1B, 0xFF, 0x3B, 0xAB, 0x4B, 0xFF, 0x38, 0x55, 0x18, 0xFF, 0x2C, 0xCB, 0x34, 0xFF,
+				0x25, 0xDB, 0x29, 0xFF, 0x2B, 0x2E, 0x19, 0xFF, 0x2C, 0xCB, 0x34, 0xFF, 0x44, 0x7A, 0x16, 0xFF,
+			},
+		},
+		{
+			"BC7 mode 4, rotation 2, index selection", 98,
+			{ 0xD0, 0x17, 0xB2, 0xD8, 0x42, 0x84, 0x5D, 0xE8, 0x2A, 0x5B, 0xC5, 0x39, 0x88, 0x8A, 0xC7, 0x80 },
+			{
+				0xAD, 0x4E, 0x4F, 0x6F, 0xBD, 0x61, 0x6B, 0x63, 0x84, 0x58, 0x08, 0x8C, 0x9C, 0x45, 0x32, 0x7B,
+				0xA5, 0x45, 0x41, 0x74, 0xBD, 0x4E, 0x6B, 0x63, 0xAD, 0x61, 0x4F, 0x6F, 0x9C, 0x4E, 0x32, 0x7B,
+				0xAD, 0x4E, 0x4F, 0x6F, 0xB5, 0x4E, 0x5D, 0x69, 0x8C, 0x4E, 0x16, 0x86, 0xA5, 0x58, 0x41, 0x74,
+				0x9C, 0x4E, 0x32, 0x7B, 0xB5, 0x61, 0x5D, 0x69, 0xBD, 0x58, 0x6B, 0x63, 0x9C, 0x58, 0x32, 0x7B,
+			},
+		},
+		{
+			"BC7 mode 5, rotation 3", 98,
+			{ 0xE0, 0x58, 0x72, 0xCE, 0xEF, 0xB9, 0xFC, 0x59, 0xF4, 0xF9, 0x5D, 0x14, 0x38, 0x1A, 0x3A, 0x78 },
+			{
+				0xB9, 0xA0, 0x7F, 0x37, 0xC1, 0xCF, 0x38, 0x33, 0xC9, 0xFD, 0x16, 0x2E, 0xC9, 0xFD, 0x7F, 0x2E,
+				0xB1, 0x72, 0x38, 0x3C, 0xC9, 0xFD, 0x38, 0x2E, 0xC9, 0xFD, 0x5D, 0x2E, 0xC9, 0xFD, 0x7F, 0x2E,
+				0xC1, 0xCF, 0x38, 0x33, 0xC9, 0xFD, 0x38, 0x2E, 0xC1, 0xCF, 0x16, 0x33, 0xB1, 0x72, 0x7F, 0x3C,
+				0xC1, 0xCF, 0x7F, 0x33, 0xC1, 0xCF, 0x38, 0x33, 0xB1, 0x72, 0x16, 0x3C, 0xB1, 0x72, 0x5D, 0x3C,
+			},
+		},
+		{
+			"BC7 mode 6", 98,
+			{ 0x40, 0x56, 0x34, 0x7B, 0x9F, 0xFC, 0xE6, 0x9C, 0xD7, 0x00, 0x7A, 0xE8, 0xA7, 0x58, 0xCC, 0xA4 },
+			{
+				0x68, 0xBF, 0x39, 0xC4, 0x99, 0xE7, 0x73, 0x51, 0x59, 0xB3, 0x27, 0xE7, 0x59, 0xB3, 0x27, 0xE7,
+				0x8B, 0xDB, 0x62, 0x72, 0x7C, 0xCF, 0x50, 0x95, 0x80, 0xD3, 0x56, 0x8B, 0x9E, 0xEB, 0x7A, 0x44,
+				0x7C, 0xCF, 0x50, 0x95, 0x8B, 0xDB, 0x62, 0x72, 0x80, 0xD3, 0x56, 0x8B, 0x71, 0xC7, 0x44, 0xAE,
+				0x94, 0xE3, 0x6D, 0x5C, 0x94, 0xE3, 0x6D, 0x5C, 0x6D, 0xC3, 0x3E, 0xB9, 0x8B, 0xDB, 0x62, 0x72,
+			},
+		},
+		{
+			"BC7 mode 7", 98,
+			{ 0x80, 0xD5, 0xA9, 0x1E, 0xE8, 0x63, 0xC8, 0xB6, 0xC0, 0x33, 0x7A, 0xE3, 0x2D, 0x6F, 0xCA, 0xA2 },
+			{
+				0x61, 0xA4, 0xD2, 0x7A, 0x61, 0xA4, 0xD2, 0x7A, 0x61, 0xA4, 0xD2, 0x7A, 0x89, 0x6F, 0xC3, 0x91,
+				0x00, 0x20, 0xF3, 0x8A, 0x61, 0xA4, 0xD2, 0x7A, 0xAE, 0x3C, 0xB6, 0xA6, 0x3C, 0xD7, 0xDF, 0x65,
+				0xA6, 0x2D, 0x52, 0xAD, 0x51, 0x27, 0xA5, 0x9B, 0x3C, 0xD7, 0xDF, 0x65, 0xAE, 0x3C, 0xB6, 0xA6,
+				0x51, 0x27, 0xA5, 0x9B, 0xF7, 0x34, 0x04, 0xBE, 0x51, 0x27, 0xA5, 0x9B, 0x89, 0x6F, 0xC3, 0x91,
+			},
+		},
+	};
+
+	// 끝점이 0, 최대값, 넘침, 음수가 되는 경우와 두 구역의 앵커 픽셀을 고루 넣었다.
+	const FloatGolden FloatGoldens[] =
+	{
+		{
+			"BC6H mode 11, raw 10-bit endpoints", 95,
+			{ 0x03, 0x80, 0xFF, 0xAB, 0xFA, 0x1F, 0x00, 0x55, 0x11, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE },
+			{
+				{ 0x0000, 0x7BFF, 0x295A }, { 0x07C0, 0x743F, 0x2BEF }, { 0x1170, 0x6A8F, 0x2F29 }, { 0x1930, 0x62CF, 0x31BD },
+				{ 0x20F0, 0x5B0F, 0x3452 }, { 0x28B0, 0x534F, 0x36E7 }, { 0x3260, 0x499F, 0x3A20 }, { 0x3A20, 0x41DF, 0x3CB5 },
+				{ 0x41DF, 0x3A20, 0x3F4A }, { 0x499F, 0x3260, 0x41DF }, { 0x534F, 0x28B0, 0x4518 }, { 0x5B0F, 0x20F0, 0x47AD },
+				{ 0x62CF, 0x1930, 0x4A42 }, { 0x6A8F, 0x1170, 0x4CD6 }, { 0x743F, 0x07C0, 0x5010 }, { 0x7BFF, 0x0000, 0x52A5 },
+			},
+		},
+		{
+			"BC6H mode 11 signed, -512 and 511 clamp to the ends", 96,
+			{ 0x03, 0xC0, 0xFF, 0xE0, 0x2F, 0xC0, 0x7F, 0x00, 0xE0, 0xCD, 0xAB, 0x89, 0x67, 0x45, 0x23, 0x01 },
+			{
+				{ 0xFBFF, 0x7BFF, 0x83FF }, { 0x8680, 0x072E, 0x803F }, { 0x904A, 0x10EA, 0x808F }, { 0x981F, 0x18B4, 0x80CF },
+				{ 0x9FF5, 0x207D, 0x810F }, { 0xA7CA, 0x2847, 0x814F }, { 0xB195, 0x3203, 0x819F }, { 0xB96A, 0x39CD, 0x81DF },
+				{ 0xC13F, 0x4196, 0x821F }, { 0xC914, 0x4960, 0x825F }, { 0xD2DF, 0x531C, 0x82AE }, { 0xDAB4, 0x5AE6, 0x82EE },
+				{ 0xE28A, 0x62B0, 0x832E }, { 0xEA5F, 0x6A79, 0x836E }, { 0xF429, 0x7435, 0x83BF }, { 0xFBFF, 0x7BFF, 0x83FF },
+			},
+		},
+		{
+			"BC6H mode 14, reversed high bits and wrapping delta", 95,
+			{ 0x0F, 0x00, 0x1A, 0xF9, 0x3F, 0x1E, 0x91, 0xFB, 0x71, 0x5E, 0x3C, 0x1A, 0xF8, 0xD6, 0xB4, 0x92 },
+			{
+				{ 0x1D10, 0x08D1, 0x7BFE }, { 0x1D11, 0x08CF, 0x41DF }, { 0x1D13, 0x08CD, 0x07C1 }, { 0x1D10, 0x08CF, 0x534F },
+				{ 0x1D12, 0x08CE, 0x1930 }, { 0x1D10, 0x08D0, 0x62CE }, { 0x1D12, 0x08CE, 0x28B0 }, { 0x1D10, 0x08D1, 0x743E },
+				{ 0x1D11, 0x08CF, 0x3A20 }, { 0x1D13, 0x08CD, 0x0001 }, { 0x1D11, 0x08CF, 0x499F }, { 0x1D12, 0x08CD, 0x1170 },
+				{ 0x1D10, 0x08D0, 0x5B0F }, { 0x1D12, 0x08CE, 0x20F0 }, { 0x1D10, 0x08D0, 0x6A8E }, { 0x1D11, 0x08CE, 0x3260 },
+			},
+		},
+		{
+			"BC6H mode 1, partition 17 with anchor 2", 95,
+			{ 0x1C, 0x20, 0x00, 0xFF, 0xFF, 0xFF, 0x2D, 0x38, 0x46, 0x35, 0xD2, 0x1F, 0x99, 0x47, 0x34, 0xD6 },
+			{
+				{ 0x1F0F, 0x3E0F, 0x7BFF }, { 0x2008, 0x3D11, 0x7B57 }, { 0x1FC8, 0x3D6D, 0x7AD6 }, { 0x2045, 0x3CBA, 0x7BD1 },
+				{ 0x1F0B, 0x3E50, 0x7BB7 }, { 0x1F06, 0x3E92, 0x7B6F }, { 0x1EF4, 0x3F9F, 0x7A48 }, { 0x1FE9, 0x3D3D, 0x7B1A },
+				{ 0x1EF0, 0x3FE0, 0x7A00 }, { 0x1F0F, 0x3E0F, 0x7BFF }, { 0x1F0B, 0x3E50, 0x7BB7 }, { 0x1F06, 0x3E92, 0x7B6F },
+				{ 0x1F02, 0x3ED3, 0x7B27 }, { 0x1EFD, 0x3F1C, 0x7AD8 }, { 0x1EF9, 0x3F5D, 0x7A90 }, { 0x1EF4, 0x3F9F, 0x7A48 },
+			},
+		},
+		{
+			"BC6H mode 1 signed, negative base", 96,
+			{ 0x00, 0xF0, 0x3F, 0x00, 0x84, 0xE3, 0xF5, 0xE0, 0xFF, 0xA8, 0x11, 0x8D, 0xF5, 0xEF, 0x72, 0xCA },
+			{
+				{ 0x9F1F, 0x1EE1, 0xFBFF }, { 0x9FAA, 0x1F63, 0xFBFF }, { 0xA036, 0x1FE6, 0xFBFF }, { 0xA0C1, 0x2069, 0xFBFF },
+				{ 0xA15C, 0x20FA, 0xFBFF }, { 0xA1E8, 0x217D, 0xFBFF }, { 0xA273, 0x2200, 0xFBFF }, { 0xA2FF, 0x2283, 0xFBFF },
+				{ 0xA2C1, 0x1E65, 0xFAE9 }, { 0xA246, 0x1E7F, 0xFA91 }, { 0xA1CC, 0x1E99, 0xFA3A }, { 0xA152, 0x1EB3, 0xF9E3 },
+				{ 0xA0CB, 0x1ED0, 0xF982 }, { 0xA051, 0x1EEA, 0xF92B }, { 0x9FD7, 0x1F04, 0xF8D4 }, { 0xA0CB, 0x1ED0, 0xF982 },
+			},
+		},
+		{
+			"BC6H mode 10, untransformed two subsets", 95,
+			{ 0xFE, 0x47, 0x60, 0x40, 0x0F, 0xD4, 0x3F, 0xE8, 0x2B, 0xA0, 0x71, 0x35, 0x1E, 0x11, 0x8D, 0xF5 },
+			{
+				{ 0x7BFF, 0x0000, 0x3EF8 }, { 0x02E8, 0x7918, 0x1FF8 }, { 0x59F0, 0x220E, 0x3640 }, { 0x24F6, 0x5709, 0x28B0 },
+				{ 0x6AF8, 0x1107, 0x3A9C }, { 0x13EF, 0x6810, 0x2454 }, { 0x48E9, 0x3316, 0x31E4 }, { 0x35FE, 0x4601, 0x2D0C },
+				{ 0x29A8, 0x5258, 0x7BFF }, { 0x23CC, 0x48CE, 0x79F4 }, { 0x1DF0, 0x3F45, 0x77E9 }, { 0x1815, 0x35BC, 0x75DE },
+				{ 0x1192, 0x2B23, 0x7399 }, { 0x0BB7, 0x219A, 0x718E }, { 0x05DB, 0x1811, 0x6F83 }, { 0x1815, 0x35BC, 0x75DE },
+			},
+		},
+	};
+
+	// Inf, NaN은 BC6H에서 나오지 않는다.
+	float HalfToFloat(uint16_t Half)
+	{
+		const int Exponent = (Half >> 10) & 31;
+		const int Mantissa = Half & 1023;
+		const float Magnitude = 0 == Exponent ? std::ldexp((float)Mantissa, -24) : std::ldexp((float)(Mantissa | 1024), Exponent - 25);
+		return (Half & 0x8000) ? -Magnitude : Magnitude;
+	}
+
+	void TestUnormGoldens()
+	{
+		for (const UnormGolden& Golden : UnormGoldens)
+		{
+			uint8_t Pixels[64];
+			memset(Pixels, 0xCD, sizeof(Pixels));
+			BlockDecoder::DecodeBlock(Golden.Format, Golden.Block, Pixels);
+			Check(0 == memcmp(Pixels, Golden.Pixels, sizeof(Pixels)), Golden.Name, "pixels differ from the golden block");
+
+			// UNORM 포맷의 float 출력은 같은 값을 255로 나눈 것이다.
+			float FloatPixels[64];
+			BlockDecoder::DecodeBlockFloat(Golden.Format, Golden.Block, FloatPixels);
+
+			bool bFloatMatches = true;
+			for (int i = 0; i < 64; i++)
+			{
+				bFloatMatches = bFloatMatches && FloatPixels[i] == (float)Golden.Pixels[i] * (1.0f / 255.0f);
+			}
+			Check(bFloatMatches, Golden.Name, "float output is not the unorm output over 255");
+		}
+	}
+
+	void TestFloatGoldens()
+	{
+		for (const FloatGolden& Golden : FloatGoldens)
+		{
+			float Pixels[64];
+			BlockDecoder::DecodeBlockFloat(Golden.Format, Golden.Block, Pixels);
+
+			bool bMatches = true;
+			for (int Pixel = 0; Pixel < 16; Pixel++)
+			{
+				for (int Channel = 0; Channel < 3; Channel++)
+				{
+					bMatches = bMatches && Pixels[Pixel * 4 + Channel] == HalfToFloat(Golden.Pixels[Pixel][Channel]);
+				}
+				bMatches = bMatches && Pixels[Pixel * 4 + 3] == 1.0f;
+			}
+			Check(bMatches, Golden.Name, "pixels differ from the golden block");
+		}
+	}
+
+	// SNORM은 float로 보간해서 기대값도 같은 나눗셈의 float 상수로 적는다.
+	void TestSignedChannels()
+	{
+		const char* Name = "BC4/BC5 SNORM";
+
+		// R: -128(-1로 잘림)에서 127, 여섯 단계. G: 127에서 -127, 여덟 단계. 픽셀 i는 인덱스 i % 8.
+		const uint8_t Block[16] =
+		{
+			0x80, 0x7F, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA,
+			0x7F, 0x81, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA,
+		};
+		const float Red[8] = { -1.0f, 1.0f, -3.0f / 5.0f, -1.0f / 5.0f, 1.0f / 5.0f, 3.0f / 5.0f, -1.0f, 1.0f };
+		const float Green[8] = { 1.0f, -1.0f, 5.0f / 7.0f, 3.0f / 7.0f, 1.0f / 7.0f, -1.0f / 7.0f, -3.0f / 7.0f, -5.0f / 7.0f };
+
+		float Pixels[64];
+		bool bMatches = true;
+
+		BlockDecoder::DecodeBlockFloat(81, Block, Pixels);
+		for (int Pixel = 0; Pixel < 16; Pixel++)
+		{
+			const float* Color = Pixels + Pixel * 4;
+			bMatches = bMatches && Color[0] == Red[Pixel % 8] && Color[1] == 0.0f && Color[2] == 0.0f && Color[3] == 1.0f;
+		}
+		Check(bMatches, Name, "BC4 SNORM palette");
+
+		bMatches = true;
+		BlockDecoder::DecodeBlockFloat(84, Block, Pixels);
+		for (int Pixel = 0; Pixel < 16; Pixel++)
+		{
+			const float* Color = Pixels + Pixel * 4;
+			bMatches = bMatches && Color[0] == Red[Pixel % 8] && Color[1] == Green[Pixel % 8] && Color[2] == 0.0f && Color[3] == 1.0f;
+		}
+		Check(bMatches, Name, "BC5 SNORM palette");
+	}
+
+	// 모드 비트가 없는 BC7 블록과 예약된 BC6H 모드는 스펙대로 0이다.
+	void TestInvalidBlocks()
+	{
+		const char* Name = "Invalid blocks";
+
+		uint8_t Block[16];
+		memset(Block, 0xFF, sizeof(Block));
+		Block[0] = 0;
+
+		uint8_t Pixels[64];
+		memset(Pixels, 0xCD, sizeof(Pixels));
+		BlockDecoder::DecodeBlock(98, Block, Pixels);
+
+		bool bZero = true;
+		for (uint8_t Value : Pixels)
+		{
+			bZero = bZero && 0 == Value;
+		}
+		Check(bZero, Name, "BC7 block without a mode bit must decode to zero");
+
+		const uint8_t ReservedModes[] = { 0x13, 0x17, 0x1B, 0x1F };
+		for (uint8_t Mode : ReservedModes)
+		{
+			Block[0] = (uint8_t)(0xE0 | Mode);
+
+			float FloatPixels[64];
+			memset(FloatPixels, 0xCD, sizeof(FloatPixels));
+			BlockDecoder::DecodeBlockFloat(95, Block, FloatPixels);
+
+			bZero = true;
+			for (float Value : FloatPixels)
+			{
+				bZero = bZero && 0.0f == Value;
+			}
+			Check(bZero, Name, "reserved BC6H mode must decode to zero");
+		}
+	}
+
+	// 표면 함수가 블록을 제자리에 놓고, 4의 배수가 아닌 가장자리와 행 사이 빈 공간은 건드리지 않는지
+	void TestSurface()
+	{
+		const char* Name = "DecodeSurface";
+
+		// BC7 모드 0, 1 블록을 나란히 놓는다.
+		const UnormGolden& Left = UnormGoldens[6];
+		const UnormGolden& Right = UnormGoldens[7];
+
+		uint8_t Blocks[32];
+		memcpy(Blocks, Left.Block, 16);
+		memcpy(Blocks + 16, Right.Block, 16);
+
+		const uint32_t Width = 6;
+		const uint32_t Height = 3;
+		const size_t RowPitch = Width * 4 + 8;
+
+		std::vector<uint8_t> Pixels(RowPitch * Height, 0xCD);
+		Check(BlockDecoder::DecodeSurface(98, Blocks, 0, Width, Height, Pixels.data(), RowPitch), Name, "BC7 surface must decode");
+
+		bool bMatches = true;
+		for (uint32_t Y = 0; Y < Height; Y++)
+		{
+			for (uint32_t X = 0; X < Width; X++)
+			{
+				const UnormGolden& Golden = X < 4 ? Left : Right;
+				bMatches = bMatches && 0 == memcmp(&Pixels[Y * RowPitch + X * 4], Golden.Pixels + (Y * 4 + X % 4) * 4, 4);
+			}
+
+			for (size_t i = Width * 4; i < RowPitch; i++)
+			{
+				bMatches = bMatches && 0xCD == Pixels[Y * RowPitch + i];
+			}
+		}
+		Check(bMatches, Name, "surface pixels differ from the golden blocks");
+
+		Check(false == BlockDecoder::DecodeSurface(28, Blocks, 0, Width, Height, Pixels.data(), RowPitch), Name, "uncompressed format must be refused");
+	}
+}
+
+int main()
+{
+	TestUnormGoldens();
+	TestFloatGoldens();
+	TestSignedChannels();
+	TestInvalidBlocks();
+	TestSurface();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
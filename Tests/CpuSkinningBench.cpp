@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "CpuSkinning.h"
+#include "JobSystem.h"
+
+// 뼈 64개짜리 가짜 리그로 CpuSkinning의 초당 정점 수를 잰다. SkinRange 한 스레드와 JobSystem으로 나눈 Skin을 같은 입력으로 돌린다.
+//   cmake -S Tests -B Build/Tests -DCMAKE_BUILD_TYPE=Release -DDIRECTXMATH_INCLUDE_DIR=<path> && cmake --build Build/Tests --target CpuSkinningBench
+
+namespace
+{
+	const uint32_t BoneCount = 64;
+	const int Iterations = 100;
+
+	std::vector<XMMATRIX> BuildPalette(std::mt19937& Random)
+	{
+		std::uniform_real_distribution<float> Angle(-3.0f, 3.0f);
+		std::uniform_real_distribution<float> Offset(-1.0f, 1.0f);
+
+		std::vector<XMMATRIX> Palette(BoneCount);
+		for (XMMATRIX& Bone : Palette)
+		{
+			const XMVECTOR Rotation = XMQuaternionRotationRollPitchYaw(Angle(Random), Angle(Random), Angle(Random));
+			Bone = XMMatrixAffineTransformation(XMVectorSplatOne(), XMVectorZero(), Rotation, XMVectorSet(Offset(Random), Offset(Random), Offset(Random), 1.0f));
+		}
+		return Palette;
+	}
+
+	// 사람 모델처럼 영향은 대부분 2~4개, 가까운 번호의 뼈끼리 묶인다.
+	std::vector<Vertex> BuildVertices(std::mt19937& Random, size_t Count)
+	{
+		std::uniform_real_distribution<float> Coordinate(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> Weight(0.1f, 1.0f);
+
+		std::vector<Vertex> Vertices(Count);
+		for (Vertex& V : Vertices)
+		{
+			V.Pos = { Coordinate(Random), Coordinate(Random), Coordinate(Random) };
+			V.Normal = { Coordinate(Random), Coordinate(Random), Coordinate(Random) };
+			V.TexCoord = { 0.0f, 0.0f };
+
+			const uint32_t InfluenceCount = 1 + Random() % 4;
+			const uint32_t FirstBone = Random() % (BoneCount - 4);
+			float Weights[4] = {};
+			float Sum = 0.0f;
+			for (uint32_t k = 0; k < 4; k++)
+			{
+				Weights[k] = k < InfluenceCount ? Weight(Random) : 0.0f;
+				Sum += Weights[k];
+				V.BoneIndices[k] = (uint16_t)(FirstBone + k);
+			}
+			V.BoneWeights = { Weights[0] / Sum, Weights[1] / Sum, Weights[2] / Sum, Weights[3] / Sum };
+		}
+		return Vertices;
+	}
+
+	void Report(const char* Name, size_t VertexCount, double Milliseconds)
+	{
+		const double Skinned = (double)VertexCount * Iterations;
+		printf("%-24s %8.1f ms  %6.2f ns/vertex  %7.1f M vertices/s\n", Name, Milliseconds, Milliseconds * 1e6 / Skinned, Skinned / Milliseconds / 1000.0);
+	}
+
+	void Run(size_t VertexCount)
+	{
+		std::mt19937 Random(7);
+		const std::vector<XMMATRIX> Palette = BuildPalette(Random);
+		const std::vector<Vertex> Vertices = BuildVertices(Random, VertexCount);
+
+		SkinnedVertexStream Out;
+		Out.Resize(Vertices.size());
+
+		printf("%zu vertices, %u bones, %d iterations\n", VertexCount, BoneCount, Iterations);
+
+		auto Start = std::chrono::steady_clock::now();
+		for (int Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			CpuSkinning::SkinRange(Vertices, Palette.data(), BoneCount, 0, Vertices.size(), Out);
+		}
+		Report("SkinRange, 1 thread", VertexCount, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count());
+
+		Start = std::chrono::steady_clock::now();
+		for (int Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			CpuSkinning::Skin(Vertices, Palette.data(), BoneCount, Out);
+		}
+
+		char Name[32];
+		snprintf(Name, sizeof(Name), "Skin, %u threads", JobSystem::Get()->GetThreadCount());
+		Report(Name, VertexCount, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count());
+	}
+}
+
+int main()
+{
+	JobSystem Jobs;
+	Jobs.Init();
+
+	// 캐릭터 한 벌 크기와 캐시를 넘는 크기
+	Run(20000);
+	Run(1000000);
+	return 0;
+}
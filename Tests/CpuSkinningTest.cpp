@@ -0,0 +1,254 @@
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "CpuSkinning.h"
+#include "JobSystem.h"
+
+// CpuSkinning 결과를 double로 한 정점씩 계산한 값과 비교한다.
+// 4개씩 묶는 경로와 남은 꼬리, 4의 배수가 아닌 시작점, 범위 밖 뼈 번호, 길이 0 노멀, JobSystem으로 나눈 Skin을 본다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Name, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s: %s\n", Name, Message);
+			++FailureCount;
+		}
+	}
+
+	const uint32_t BoneCount = 24;
+	const float Sentinel = -12345.0f;
+
+	std::vector<XMMATRIX> BuildPalette(std::mt19937& Random)
+	{
+		std::uniform_real_distribution<float> Angle(-3.0f, 3.0f);
+		std::uniform_real_distribution<float> Scale(0.5f, 2.0f);
+		std::uniform_real_distribution<float> Offset(-10.0f, 10.0f);
+
+		std::vector<XMMATRIX> Palette(BoneCount);
+		for (XMMATRIX& Bone : Palette)
+		{
+			const XMVECTOR Rotation = XMQuaternionRotationRollPitchYaw(Angle(Random), Angle(Random), Angle(Random));
+			Bone = XMMatrixAffineTransformation(XMVectorSet(Scale(Random), Scale(Random), Scale(Random), 0.0f), XMVectorZero(), Rotation,
+				XMVectorSet(Offset(Random), Offset(Random), Offset(Random), 1.0f));
+		}
+		return Palette;
+	}
+
+	// 영향 개수는 1~4개. 빈 슬롯은 가중치 0에 아무 뼈 번호나 넣는다. 범위 밖 번호도 섞는다.
+	std::vector<Vertex> BuildVertices(std::mt19937& Random, size_t Count)
+	{
+		std::uniform_real_distribution<float> Coordinate(-5.0f, 5.0f);
+		std::uniform_real_distribution<float> Weight(0.05f, 1.0f);
+
+		std::vector<Vertex> Vertices(Count);
+		for (Vertex& V : Vertices)
+		{
+			V.Pos = { Coordinate(Random), Coordinate(Random), Coordinate(Random) };
+			V.Normal = { Coordinate(Random), Coordinate(Random), Coordinate(Random) };
+			V.TexCoord = { 0.0f, 0.0f };
+
+			const uint32_t InfluenceCount = 1 + Random() % 4;
+			float Weights[4] = {};
+			float Sum = 0.0f;
+			for (uint32_t k = 0; k < 4; k++)
+			{
+				Weights[k] = k < InfluenceCount ? Weight(Random) : 0.0f;
+				Sum += Weights[k];
+				V.BoneIndices[k] = (uint16_t)(0 == Random() % 16 ? BoneCount + Random() % 1000 : Random() % BoneCount);
+			}
+			V.BoneWeights = { Weights[0] / Sum, Weights[1] / Sum, Weights[2] / Sum, Weights[3] / Sum };
+		}
+		return Vertices;
+	}
+
+	struct ReferenceVertex
+	{
+		double Position[3];
+		double Normal[3];
+	};
+
+	// 행 벡터 규약. 범위 밖 뼈 번호는 0번 뼈로 본다.
+	ReferenceVertex SkinReference(const Vertex& V, const std::vector<XMMATRIX>& Palette)
+	{
+		const float Weights[4] = { V.BoneWeights.x, V.BoneWeights.y, V.BoneWeights.z, V.BoneWeights.w };
+
+		double Blended[4][4] = {};
+		for (int k = 0; k < 4; k++)
+		{
+			XMFLOAT4X4 Bone;
+			XMStoreFloat4x4(&Bone, Palette[V.BoneIndices[k] < BoneCount ? V.BoneIndices[k] : 0]);
+			for (int Row = 0; Row < 4; Row++)
+			{
+				for (int Column = 0; Column < 4; Column++)
+				{
+					Blended[Row][Column] += (double)Weights[k] * Bone.m[Row][Column];
+				}
+			}
+		}
+
+		const double Position[3] = { V.Pos.x, V.Pos.y, V.Pos.z };
+		const double Normal[3] = { V.Normal.x, V.Normal.y, V.Normal.z };
+
+		ReferenceVertex Result;
+		double LengthSq = 0.0;
+		for (int Column = 0; Column < 3; Column++)
+		{
+			Result.Position[Column] = Blended[3][Column];
+			Result.Normal[Column] = 0.0;
+			for (int Row = 0; Row < 3; Row++)
+			{
+				Result.Position[Column] += Position[Row] * Blended[Row][Column];
+				Result.Normal[Column] += Normal[Row] * Blended[Row][Column];
+			}
+			LengthSq += Result.Normal[Column] * Result.Normal[Column];
+		}
+
+		const double InvLength = LengthSq > 0.0 ? 1.0 / std::sqrt(LengthSq) : 0.0;
+		for (int Column = 0; Column < 3; Column++)
+		{
+			Result.Normal[Column] *= InvLength;
+		}
+		return Result;
+	}
+
+	bool Near(float Value, double Expected, double Tolerance)
+	{
+		return std::fabs(Value - Expected) <= Tolerance * (1.0 + std::fabs(Expected));
+	}
+
+	bool MatchesReference(const std::vector<Vertex>& Vertices, const std::vector<XMMATRIX>& Palette, const SkinnedVertexStream& Out, size_t Index)
+	{
+		const ReferenceVertex Expected = SkinReference(Vertices[Index], Palette);
+
+		return Near(Out.PositionX[Index], Expected.Position[0], 1e-5) && Near(Out.PositionY[Index], Expected.Position[1], 1e-5) && Near(Out.PositionZ[Index], Expected.Position[2], 1e-5)
+			&& Near(Out.NormalX[Index], Expected.Normal[0], 1e-5) && Near(Out.NormalY[Index], Expected.Normal[1], 1e-5) && Near(Out.NormalZ[Index], Expected.Normal[2], 1e-5);
+	}
+
+	bool IsUntouched(const SkinnedVertexStream& Out, size_t Index)
+	{
+		return Sentinel == Out.PositionX[Index] && Sentinel == Out.PositionY[Index] && Sentinel == Out.PositionZ[Index]
+			&& Sentinel == Out.NormalX[Index] && Sentinel == Out.NormalY[Index] && Sentinel == Out.NormalZ[Index];
+	}
+
+	void FillSentinel(SkinnedVertexStream& Out, size_t Count)
+	{
+		Out.PositionX.assign(Count, Sentinel);
+		Out.PositionY.assign(Count, Sentinel);
+		Out.PositionZ.assign(Count, Sentinel);
+		Out.NormalX.assign(Count, Sentinel);
+		Out.NormalY.assign(Count, Sentinel);
+		Out.NormalZ.assign(Count, Sentinel);
+	}
+
+	// 모든 시작점과 길이 조합으로 SkinRange를 돌린다. 범위 안은 기준값과 같고 범위 밖은 그대로여야 한다.
+	void TestRanges()
+	{
+		const char* Name = "range";
+
+		std::mt19937 Random(3);
+		const std::vector<XMMATRIX> Palette = BuildPalette(Random);
+		const std::vector<Vertex> Vertices = BuildVertices(Random, 24);
+
+		SkinnedVertexStream Out;
+		bool bMatches = true;
+		bool bUntouched = true;
+
+		for (size_t Begin = 0; Begin < 8; Begin++)
+		{
+			for (size_t End = Begin; End <= Vertices.size(); End++)
+			{
+				FillSentinel(Out, Vertices.size());
+				CpuSkinning::SkinRange(Vertices, Palette.data(), BoneCount, Begin, End, Out);
+
+				for (size_t i = 0; i < Vertices.size(); i++)
+				{
+					if (i >= Begin && i < End)
+					{
+						bMatches = bMatches && MatchesReference(Vertices, Palette, Out, i);
+					}
+					else
+					{
+						bUntouched = bUntouched && IsUntouched(Out, i);
+					}
+				}
+			}
+		}
+
+		Check(bMatches, Name, "skinned vertices differ from the scalar reference");
+		Check(bUntouched, Name, "vertices outside the range were written");
+	}
+
+	// 길이 0인 노멀은 4개 묶음에서도 꼬리에서도 0으로 남는다.
+	void TestZeroNormals()
+	{
+		const char* Name = "zero normal";
+
+		std::mt19937 Random(5);
+		const std::vector<XMMATRIX> Palette = BuildPalette(Random);
+		std::vector<Vertex> Vertices = BuildVertices(Random, 7);
+		for (size_t i = 0; i < Vertices.size(); i += 2)
+		{
+			Vertices[i].Normal = { 0.0f, 0.0f, 0.0f };
+		}
+
+		SkinnedVertexStream Out;
+		FillSentinel(Out, Vertices.size());
+		CpuSkinning::SkinRange(Vertices, Palette.data(), BoneCount, 0, Vertices.size(), Out);
+
+		bool bZero = true;
+		bool bMatches = true;
+		for (size_t i = 0; i < Vertices.size(); i++)
+		{
+			if (0 == i % 2)
+			{
+				bZero = bZero && 0.0f == Out.NormalX[i] && 0.0f == Out.NormalY[i] && 0.0f == Out.NormalZ[i];
+			}
+			bMatches = bMatches && MatchesReference(Vertices, Palette, Out, i);
+		}
+		Check(bZero, Name, "zero-length normal must stay zero");
+		Check(bMatches, Name, "skinned vertices differ from the scalar reference");
+	}
+
+	// 잡 하나 크기의 배수도, 4의 배수도 아닌 개수로 Skin을 돌린다. Out 크기는 Skin이 맞춘다.
+	void TestParallel()
+	{
+		const char* Name = "parallel";
+
+		std::mt19937 Random(11);
+		const std::vector<XMMATRIX> Palette = BuildPalette(Random);
+		const std::vector<Vertex> Vertices = BuildVertices(Random, 3 * 4096 + 1003);
+
+		SkinnedVertexStream Out;
+		CpuSkinning::Skin(Vertices, Palette.data(), BoneCount, Out);
+		Check(Vertices.size() == Out.Size(), Name, "output is resized to the vertex count");
+
+		bool bMatches = Vertices.size() == Out.Size();
+		for (size_t i = 0; i < Vertices.size() && bMatches; i++)
+		{
+			bMatches = MatchesReference(Vertices, Palette, Out, i);
+		}
+		Check(bMatches, Name, "skinned vertices differ from the scalar reference");
+
+		CpuSkinning::Skin(ArrayView<Vertex>(), Palette.data(), BoneCount, Out);
+		Check(0 == Out.Size(), Name, "empty input must give an empty output");
+	}
+}
+
+int main()
+{
+	JobSystem Jobs;
+	Jobs.Init();
+
+	TestRanges();
+	TestZeroNormals();
+	TestParallel();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
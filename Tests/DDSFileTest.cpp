@@ -0,0 +1,397 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <string>
+#include "DDSFile.h"
+
+// 손으로 만든 DDS 헤더로 레거시/DX10 헤더, 큐브맵, 볼륨, 잘린 파일을 파싱하고 서브리소스 배치와 실패 이유를 확인한다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Name, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s: %s\n", Name, Message);
+			++FailureCount;
+		}
+	}
+
+	const char* ToString(DDSResult Result)
+	{
+		switch (Result)
+		{
+		case DDSResult::Ok:
+			return "Ok";
+		case DDSResult::FileNotFound:
+			return "FileNotFound";
+		case DDSResult::InvalidData:
+			return "InvalidData";
+		case DDSResult::Truncated:
+			return "Truncated";
+		case DDSResult::NotSupported:
+			return "NotSupported";
+		}
+		return "?";
+	}
+
+	// DDS 파일 안 위치. 앞의 4바이트 매직을 포함한다.
+	enum : size_t
+	{
+		OffsetFlags = 8,
+		OffsetHeight = 12,
+		OffsetWidth = 16,
+		OffsetDepth = 24,
+		OffsetMipMapCount = 28,
+		OffsetPixelFormatFlags = 80,
+		OffsetFourCC = 84,
+		OffsetRGBBitCount = 88,
+		OffsetRBitMask = 92,
+		OffsetGBitMask = 96,
+		OffsetBBitMask = 100,
+		OffsetABitMask = 104,
+		OffsetCaps = 108,
+		OffsetCaps2 = 112,
+		HeaderBytes = 128,
+		DX10HeaderBytes = 20
+	};
+
+	const uint32_t FlagsRequired = 0x1 | 0x2 | 0x4 | 0x1000;
+	const uint32_t FlagMipMapCount = 0x20000;
+	const uint32_t FlagVolume = 0x800000;
+	const uint32_t PixelFormatFourCC = 0x4;
+	const uint32_t PixelFormatRGB = 0x40;
+	const uint32_t Caps2CubeMapAllFaces = 0xFE00;
+
+	const uint32_t FormatR8G8B8A8Unorm = 28;
+	const uint32_t FormatBC1Unorm = 71;
+	const uint32_t FormatBC3Unorm = 77;
+	const uint32_t FormatBC7Unorm = 98;
+
+	uint32_t FourCC(const char* Code)
+	{
+		return (uint32_t)(uint8_t)Code[0] | ((uint32_t)(uint8_t)Code[1] << 8) | ((uint32_t)(uint8_t)Code[2] << 16) | ((uint32_t)(uint8_t)Code[3] << 24);
+	}
+
+	void Write(std::vector<uint8_t>& Bytes, size_t Offset, uint32_t Value)
+	{
+		memcpy(Bytes.data() + Offset, &Value, sizeof(Value));
+	}
+
+	std::vector<uint8_t> MakeHeader(uint32_t Width, uint32_t Height, uint32_t MipCount)
+	{
+		std::vector<uint8_t> Bytes(HeaderBytes, 0);
+		Write(Bytes, 0, FourCC("DDS "));
+		Write(Bytes, 4, 124);
+		Write(Bytes, OffsetFlags, FlagsRequired | (MipCount > 1 ? FlagMipMapCount : 0));
+		Write(Bytes, OffsetHeight, Height);
+		Write(Bytes, OffsetWidth, Width);
+		Write(Bytes, OffsetMipMapCount, MipCount);
+		Write(Bytes, 76, 32);
+		Write(Bytes, OffsetCaps, 0x1000);
+		return Bytes;
+	}
+
+	void SetFourCC(std::vector<uint8_t>& Bytes, const char* Code)
+	{
+		Write(Bytes, OffsetPixelFormatFlags, PixelFormatFourCC);
+		Write(Bytes, OffsetFourCC, FourCC(Code));
+	}
+
+	void AppendDX10(std::vector<uint8_t>& Bytes, uint32_t Format, uint32_t Dimension, uint32_t MiscFlag, uint32_t ArraySize)
+	{
+		SetFourCC(Bytes, "DX10");
+
+		const size_t Offset = Bytes.size();
+		Bytes.resize(Offset + DX10HeaderBytes, 0);
+		Write(Bytes, Offset, Format);
+		Write(Bytes, Offset + 4, Dimension);
+		Write(Bytes, Offset + 8, MiscFlag);
+		Write(Bytes, Offset + 12, ArraySize);
+	}
+
+	void AppendPixels(std::vector<uint8_t>& Bytes, size_t Count)
+	{
+		const size_t Offset = Bytes.size();
+		Bytes.resize(Offset + Count);
+		for (size_t i = 0; i < Count; i++)
+		{
+			Bytes[Offset + i] = (uint8_t)(i * 7 + 3);
+		}
+	}
+
+	DDSResult Parse(const std::vector<uint8_t>& Bytes, std::unique_ptr<DDSFile>& OutFile)
+	{
+		DDSResult Result = DDSResult::Ok;
+		OutFile = DDSFile::FromMemory(Bytes.data(), Bytes.size(), &Result);
+		return Result;
+	}
+
+	void ExpectResult(const char* Name, const std::vector<uint8_t>& Bytes, DDSResult Expected)
+	{
+		std::unique_ptr<DDSFile> File;
+		DDSResult Result = Parse(Bytes, File);
+		if (Result != Expected || (Expected == DDSResult::Ok) != (nullptr != File))
+		{
+			printf("FAIL: %s: expected %s, got %s\n", Name, ToString(Expected), ToString(Result));
+			++FailureCount;
+		}
+	}
+
+	void ExpectSubresource(const char* Name, const DDSFile& File, uint32_t Mip, uint32_t Slice, size_t Offset, uint32_t Width, uint32_t Height, uint32_t RowBytes, uint32_t RowCount)
+	{
+		const DDSSubresource& Subresource = File.GetSubresource(Mip, Slice);
+		if (Subresource.Offset != Offset || Subresource.Width != Width || Subresource.Height != Height || Subresource.RowBytes != RowBytes || Subresource.RowCount != RowCount)
+		{
+			printf("FAIL: %s: mip %u slice %u is at %zu, %ux%u, %u bytes x %u rows (expected %zu, %ux%u, %u x %u)\n",
+				Name, Mip, Slice, Subresource.Offset, Subresource.Width, Subresource.Height, Subresource.RowBytes, Subresource.RowCount,
+				Offset, Width, Height, RowBytes, RowCount);
+			++FailureCount;
+		}
+	}
+
+	void TestLegacyBlockCompressed()
+	{
+		const char* Name = "legacy DXT1";
+
+		// 8x8 BC1 밉 4개: 블록 4개, 1개, 1개, 1개
+		std::vector<uint8_t> Bytes = MakeHeader(8, 8, 4);
+		SetFourCC(Bytes, "DXT1");
+		AppendPixels(Bytes, 32 + 8 + 8 + 8);
+
+		std::unique_ptr<DDSFile> File;
+		Check(Parse(Bytes, File) == DDSResult::Ok && File, Name, "failed to parse");
+		if (nullptr == File)
+		{
+			return;
+		}
+
+		Check(File->GetFormat() == FormatBC1Unorm, Name, "format");
+		Check(File->GetDimension() == DDSDimension::Texture2D, Name, "dimension");
+		Check(File->GetMipCount() == 4 && File->GetArraySize() == 1 && File->GetDepth() == 1, Name, "mip, array, depth");
+		Check(false == File->IsCubeMap(), Name, "not a cube map");
+
+		ExpectSubresource(Name, *File, 0, 0, HeaderBytes, 8, 8, 16, 2);
+		ExpectSubresource(Name, *File, 1, 0, HeaderBytes + 32, 4, 4, 8, 1);
+		ExpectSubresource(Name, *File, 2, 0, HeaderBytes + 40, 2, 2, 8, 1);
+		ExpectSubresource(Name, *File, 3, 0, HeaderBytes + 48, 1, 1, 8, 1);
+
+		Check(File->GetSubresourceData(1, 0) == Bytes.data() + HeaderBytes + 32, Name, "pixel pointer");
+		Check(File->GetFirstMipWithin(2) == 2, Name, "first mip within 2 pixels");
+	}
+
+	void TestLegacyBitMask()
+	{
+		const char* Name = "legacy RGBA8";
+
+		std::vector<uint8_t> Bytes = MakeHeader(5, 3, 1);
+		Write(Bytes, OffsetPixelFormatFlags, PixelFormatRGB | 0x1);
+		Write(Bytes, OffsetRGBBitCount, 32);
+		Write(Bytes, OffsetRBitMask, 0x000000ff);
+		Write(Bytes, OffsetGBitMask, 0x0000ff00);
+		Write(Bytes, OffsetBBitMask, 0x00ff0000);
+		Write(Bytes, OffsetABitMask, 0xff000000);
+		AppendPixels(Bytes, 5 * 4 * 3);
+
+		std::unique_ptr<DDSFile> File;
+		Check(Parse(Bytes, File) == DDSResult::Ok && File, Name, "failed to parse");
+		if (nullptr == File)
+		{
+			return;
+		}
+
+		Check(File->GetFormat() == FormatR8G8B8A8Unorm, Name, "format");
+		ExpectSubresource(Name, *File, 0, 0, HeaderBytes, 5, 3, 20, 3);
+	}
+
+	void TestDX10Header()
+	{
+		const char* Name = "DX10 BC7";
+
+		// 12x12 BC7 밉 3개와 2장짜리 배열: 장마다 블록 9 + 4 + 1개
+		std::vector<uint8_t> Bytes = MakeHeader(12, 12, 3);
+		AppendDX10(Bytes, FormatBC7Unorm, 3, 0, 2);
+		const size_t SliceBytes = (9 + 4 + 1) * 16;
+		AppendPixels(Bytes, SliceBytes * 2);
+
+		std::unique_ptr<DDSFile> File;
+		Check(Parse(Bytes, File) == DDSResult::Ok && File, Name, "failed to parse");
+		if (nullptr == File)
+		{
+			return;
+		}
+
+		const size_t Start = HeaderBytes + DX10HeaderBytes;
+		Check(File->GetFormat() == FormatBC7Unorm, Name, "format");
+		Check(File->GetArraySize() == 2 && File->GetMipCount() == 3, Name, "array and mip count");
+
+		ExpectSubresource(Name, *File, 0, 0, Start, 12, 12, 48, 3);
+		ExpectSubresource(Name, *File, 1, 0, Start + 144, 6, 6, 32, 2);
+		ExpectSubresource(Name, *File, 2, 0, Start + 208, 3, 3, 16, 1);
+
+		// 배열 원소마다 밉 체인이 통째로 이어진다.
+		ExpectSubresource(Name, *File, 0, 1, Start + SliceBytes, 12, 12, 48, 3);
+		ExpectSubresource(Name, *File, 2, 1, Start + SliceBytes + 208, 3, 3, 16, 1);
+	}
+
+	void TestCubeMaps()
+	{
+		{
+			const char* Name = "DX10 cube";
+
+			std::vector<uint8_t> Bytes = MakeHeader(4, 4, 1);
+			AppendDX10(Bytes, FormatBC3Unorm, 3, 0x4, 1);
+			AppendPixels(Bytes, 6 * 16);
+
+			std::unique_ptr<DDSFile> File;
+			Check(Parse(Bytes, File) == DDSResult::Ok && File, Name, "failed to parse");
+			if (File)
+			{
+				Check(File->IsCubeMap() && File->GetArraySize() == 6, Name, "six faces");
+				ExpectSubresource(Name, *File, 0, 5, HeaderBytes + DX10HeaderBytes + 5 * 16, 4, 4, 16, 1);
+			}
+
+			// 면 하나가 모자라면 잘린 파일이다.
+			Bytes.resize(Bytes.size() - 16);
+			ExpectResult(Name, Bytes, DDSResult::Truncated);
+		}
+
+		{
+			const char* Name = "legacy cube";
+
+			std::vector<uint8_t> Bytes = MakeHeader(4, 4, 1);
+			SetFourCC(Bytes, "DXT1");
+			Write(Bytes, OffsetCaps2, Caps2CubeMapAllFaces);
+			AppendPixels(Bytes, 6 * 8);
+
+			std::unique_ptr<DDSFile> File;
+			Check(Parse(Bytes, File) == DDSResult::Ok && File, Name, "failed to parse");
+			if (File)
+			{
+				Check(File->IsCubeMap() && File->GetArraySize() == 6, Name, "six faces");
+				ExpectSubresource(Name, *File, 0, 3, HeaderBytes + 3 * 8, 4, 4, 8, 1);
+			}
+
+			// +X만 있는 큐브맵은 D3D에서 만들 수 없다.
+			Write(Bytes, OffsetCaps2, 0x200 | 0x400);
+			ExpectResult("partial legacy cube", Bytes, DDSResult::NotSupported);
+		}
+	}
+
+	void TestVolume()
+	{
+		const char* Name = "legacy volume";
+
+		// 4x4x4 RGBA8 밉 3개: 깊이도 같이 반으로 준다.
+		std::vector<uint8_t> Bytes = MakeHeader(4, 4, 3);
+		Write(Bytes, OffsetFlags, FlagsRequired | FlagMipMapCount | FlagVolume);
+		Write(Bytes, OffsetDepth, 4);
+		Write(Bytes, OffsetPixelFormatFlags, PixelFormatRGB);
+		Write(Bytes, OffsetRGBBitCount, 32);
+		Write(Bytes, OffsetRBitMask, 0x000000ff);
+		Write(Bytes, OffsetGBitMask, 0x0000ff00);
+		Write(Bytes, OffsetBBitMask, 0x00ff0000);
+		Write(Bytes, OffsetABitMask, 0xff000000);
+		AppendPixels(Bytes, 4 * 4 * 4 * 4 + 2 * 2 * 2 * 4 + 4);
+
+		std::unique_ptr<DDSFile> File;
+		Check(Parse(Bytes, File) == DDSResult::Ok && File, Name, "failed to parse");
+		if (nullptr == File)
+		{
+			return;
+		}
+
+		Check(File->GetDimension() == DDSDimension::Texture3D && File->GetDepth() == 4, Name, "3D with depth 4");
+		Check(File->GetSubresource(1, 0).Depth == 2 && File->GetSubresource(1, 0).SliceBytes == 16, Name, "mip 1 depth and slice size");
+		ExpectSubresource(Name, *File, 2, 0, HeaderBytes + 256 + 32, 1, 1, 4, 1);
+	}
+
+	void TestInvalidFiles()
+	{
+		std::vector<uint8_t> Valid = MakeHeader(8, 8, 1);
+		AppendDX10(Valid, FormatBC1Unorm, 3, 0, 1);
+		AppendPixels(Valid, 32);
+		ExpectResult("valid reference", Valid, DDSResult::Ok);
+
+		ExpectResult("empty", std::vector<uint8_t>(), DDSResult::InvalidData);
+
+		std::vector<uint8_t> Bytes = Valid;
+		Bytes[0] = 'X';
+		ExpectResult("bad magic", Bytes, DDSResult::InvalidData);
+
+		Bytes = Valid;
+		Write(Bytes, 4, 100);
+		ExpectResult("bad header size", Bytes, DDSResult::InvalidData);
+
+		Bytes.assign(Valid.begin(), Valid.begin() + 60);
+		ExpectResult("cut inside header", Bytes, DDSResult::Truncated);
+
+		Bytes.assign(Valid.begin(), Valid.begin() + HeaderBytes + 10);
+		ExpectResult("cut inside DX10 header", Bytes, DDSResult::Truncated);
+
+		Bytes.assign(Valid.begin(), Valid.end() - 1);
+		ExpectResult("one byte short", Bytes, DDSResult::Truncated);
+
+		Bytes = Valid;
+		Write(Bytes, OffsetWidth, 0);
+		ExpectResult("zero width", Bytes, DDSResult::InvalidData);
+
+		Bytes = Valid;
+		Write(Bytes, HeaderBytes, 0);
+		ExpectResult("unknown format", Bytes, DDSResult::NotSupported);
+
+		Bytes = Valid;
+		Write(Bytes, HeaderBytes + 4, 7);
+		ExpectResult("unknown dimension", Bytes, DDSResult::NotSupported);
+
+		Bytes = Valid;
+		Write(Bytes, HeaderBytes + 12, 0);
+		ExpectResult("zero array size", Bytes, DDSResult::InvalidData);
+
+		Bytes = Valid;
+		Write(Bytes, OffsetWidth, 32768);
+		ExpectResult("wider than D3D12 allows", Bytes, DDSResult::NotSupported);
+	}
+
+	void TestFiles()
+	{
+		const char* Name = "file";
+		const std::string Path = "DDSFileTest.dds";
+
+		// Save와 Open을 한 바퀴 돌린다. 8x4 BC1 밉 2개.
+		std::vector<std::vector<uint8_t>> Mips(2);
+		Mips[0].assign(16, 0x5A);
+		Mips[1].assign(8, 0xA5);
+		Check(DDSFile::Save(Path.c_str(), FormatBC1Unorm, 8, 4, Mips), Name, "save");
+
+		DDSResult Result = DDSResult::InvalidData;
+		std::unique_ptr<DDSFile> File = DDSFile::Open(Path.c_str(), &Result);
+		Check(Result == DDSResult::Ok && File, Name, "open saved file");
+		if (File)
+		{
+			Check(File->GetWidth() == 8 && File->GetHeight() == 4 && File->GetMipCount() == 2, Name, "saved size");
+			Check(0 == memcmp(File->GetSubresourceData(1, 0), Mips[1].data(), Mips[1].size()), Name, "saved pixels");
+		}
+		File.reset();
+		std::remove(Path.c_str());
+
+		File = DDSFile::Open("DDSFileTest_missing.dds", &Result);
+		Check(nullptr == File && Result == DDSResult::FileNotFound, Name, "missing file must report FileNotFound");
+	}
+}
+
+int main()
+{
+	TestLegacyBlockCompressed();
+	TestLegacyBitMask();
+	TestDX10Header();
+	TestCubeMaps();
+	TestVolume();
+	TestInvalidFiles();
+	TestFiles();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
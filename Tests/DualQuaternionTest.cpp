@@ -0,0 +1,252 @@
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "DualQuaternion.h"
+#include "Skeleton.h"
+
+// 행렬 팔레트로 섞은 선형 블렌드 스키닝과 듀얼 쿼터니언 스키닝을 CPU에서 비교한다.
+// 뼈 하나에만 붙은 정점은 두 방식이 같아야 하고, 여러 뼈에 걸친 정점은 블렌딩 방식 차이만큼만 벌어져야 한다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s\n", Message);
+			++FailureCount;
+		}
+	}
+
+	struct SkinnedPoint
+	{
+		XMFLOAT3 Position = { 0.0f, 0.0f, 0.0f };
+		uint32_t BoneIndices[4] = {};
+		float Weights[4] = {};
+		uint32_t InfluenceCount = 0;
+	};
+
+	XMVECTOR SkinLinear(const SkinnedPoint& Point, const XMMATRIX* Palette)
+	{
+		XMVECTOR Position = XMLoadFloat3(&Point.Position);
+		XMVECTOR Result = XMVectorZero();
+		for (uint32_t k = 0; k < Point.InfluenceCount; k++)
+		{
+			Result = XMVectorMultiplyAdd(XMVector3Transform(Position, Palette[Point.BoneIndices[k]]), XMVectorReplicate(Point.Weights[k]), Result);
+		}
+		return Result;
+	}
+
+	XMVECTOR SkinDualQuaternion(const SkinnedPoint& Point, const XMVECTOR* Reals, const XMVECTOR* Duals)
+	{
+		XMVECTOR InfluenceReals[4];
+		XMVECTOR InfluenceDuals[4];
+		for (uint32_t k = 0; k < Point.InfluenceCount; k++)
+		{
+			InfluenceReals[k] = Reals[Point.BoneIndices[k]];
+			InfluenceDuals[k] = Duals[Point.BoneIndices[k]];
+		}
+
+		XMVECTOR Real;
+		XMVECTOR Dual;
+		DualQuaternion::Blend(InfluenceReals, InfluenceDuals, Point.Weights, Point.InfluenceCount, Real, Dual);
+		return DualQuaternion::TransformPoint(Real, Dual, XMLoadFloat3(&Point.Position));
+	}
+
+	// 척추 4개에 팔 두 개가 달린 뼈대. 부모가 항상 앞에 온다.
+	SkeletonData BuildSkeleton()
+	{
+		SkeletonData Data;
+		Data.ParentIndices = { -1, 0, 1, 2, 3, 4, 3, 6 };
+		Data.BindPose.resize(Data.ParentIndices.size());
+
+		const XMFLOAT3 Offsets[] =
+		{
+			{ 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f },
+			{ 1.0f, 0.0f, 0.0f },
+			{ 1.0f, 0.0f, 0.0f },
+			{ -1.0f, 0.0f, 0.0f },
+			{ -1.0f, 0.0f, 0.0f },
+		};
+		for (size_t Bone = 0; Bone < Data.BindPose.size(); Bone++)
+		{
+			Data.BindPose[Bone].Translation = Offsets[Bone];
+		}
+
+		std::vector<XMMATRIX> ModelPose(Data.ParentIndices.size());
+		Data.InverseBindPose.resize(Data.ParentIndices.size());
+
+		Skeleton Skel(Data.ParentIndices, Data.InverseBindPose, Data.BindPose);
+		Skel.ComposeModelSpace(Data.BindPose.data(), ModelPose.data());
+		for (size_t Bone = 0; Bone < ModelPose.size(); Bone++)
+		{
+			Data.InverseBindPose[Bone] = XMMatrixInverse(nullptr, ModelPose[Bone]);
+		}
+
+		return Data;
+	}
+
+	void TestRandomPoses()
+	{
+		const SkeletonData Data = BuildSkeleton();
+		const Skeleton Skel(Data);
+		const uint32_t BoneCount = Skel.GetBoneCount();
+
+		std::mt19937 Random(7);
+		std::uniform_real_distribution<float> Coordinate(-1.5f, 1.5f);
+		std::uniform_real_distribution<float> Angle(-0.5f, 0.5f);
+		std::uniform_real_distribution<float> Weight(0.05f, 1.0f);
+		std::uniform_int_distribution<uint32_t> PickBone(0, BoneCount - 1);
+		std::uniform_int_distribution<uint32_t> PickInfluenceCount(1, 4);
+
+		// 절반은 뼈 하나, 나머지는 실제 리그처럼 뼈와 그 조상 2~4개에 걸친다.
+		std::vector<SkinnedPoint> Points(4096);
+		for (size_t i = 0; i < Points.size(); i++)
+		{
+			SkinnedPoint& Point = Points[i];
+			Point.Position = { Coordinate(Random), Coordinate(Random) + 1.5f, Coordinate(Random) };
+
+			const uint32_t MaxInfluenceCount = i % 2 == 0 ? 1 : PickInfluenceCount(Random);
+
+			float WeightSum = 0.0f;
+			for (int32_t Bone = (int32_t)PickBone(Random); Bone >= 0 && Point.InfluenceCount < MaxInfluenceCount; Bone = Skel.GetParentIndex(Bone))
+			{
+				Point.BoneIndices[Point.InfluenceCount] = (uint32_t)Bone;
+				Point.Weights[Point.InfluenceCount] = Weight(Random);
+				WeightSum += Point.Weights[Point.InfluenceCount];
+				++Point.InfluenceCount;
+			}
+
+			for (uint32_t k = 0; k < Point.InfluenceCount; k++)
+			{
+				Point.Weights[k] /= WeightSum;
+			}
+		}
+
+		std::vector<BoneTransform> Pose(Data.BindPose);
+		std::vector<XMMATRIX> ModelPose(BoneCount);
+		std::vector<XMMATRIX> Palette(BoneCount);
+		std::vector<XMVECTOR> Reals(BoneCount);
+		std::vector<XMVECTOR> Duals(BoneCount);
+
+		float RigidMaxError = 0.0f;
+		float BlendedMaxError = 0.0f;
+		double BlendedErrorSum = 0.0;
+		size_t BlendedCount = 0;
+
+		const uint32_t FrameCount = 64;
+		for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+		{
+			for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+			{
+				XMStoreFloat4(&Pose[Bone].Rotation, XMQuaternionRotationRollPitchYaw(Angle(Random), Angle(Random), Angle(Random)));
+			}
+
+			// 루트는 움직여서 팔레트에 이동도 섞는다.
+			Pose[0].Translation = { Coordinate(Random), Coordinate(Random), Coordinate(Random) };
+
+			Skel.ComposePalette(Pose.data(), ModelPose.data(), Palette.data());
+			for (uint32_t Bone = 0; Bone < BoneCount; Bone++)
+			{
+				DualQuaternion::FromMatrix(Palette[Bone], Reals[Bone], Duals[Bone]);
+			}
+
+			for (const SkinnedPoint& Point : Points)
+			{
+				const XMVECTOR Reference = SkinLinear(Point, Palette.data());
+				const XMVECTOR Skinned = SkinDualQuaternion(Point, Reals.data(), Duals.data());
+				const float Error = XMVectorGetX(XMVector3Length(XMVectorSubtract(Skinned, Reference)));
+
+				if (Point.InfluenceCount < 2)
+				{
+					RigidMaxError = std::max(RigidMaxError, Error);
+				}
+				else
+				{
+					BlendedMaxError = std::max(BlendedMaxError, Error);
+					BlendedErrorSum += Error;
+					++BlendedCount;
+				}
+			}
+		}
+
+		// 점들이 들어 있는 상자의 반지름 기준
+		const float Radius = 1.5f * sqrtf(3.0f) + 3.0f;
+		const float RigidTolerance = 1e-4f * Radius;
+
+		// 선형 블렌드가 관절 쪽으로 오그라드는 만큼만 벌어진다. 관절마다 축당 0.5 라디안 안이라
+		// 평균은 반지름의 1~2%, 네 뼈에 걸친 먼 정점도 20%를 넘지 않는다.
+		const float BlendedMaxTolerance = 0.2f * Radius;
+		const double BlendedAverageTolerance = 0.02 * Radius;
+		const double BlendedAverageError = BlendedCount > 0 ? BlendedErrorSum / BlendedCount : 0.0;
+
+		printf("Random poses: rigid max error %g (tolerance %g), blended max %g (tolerance %g) avg %g (tolerance %g)\n",
+			RigidMaxError, RigidTolerance, BlendedMaxError, BlendedMaxTolerance, BlendedAverageError, BlendedAverageTolerance);
+
+		Check(RigidMaxError <= RigidTolerance, "single-bone vertices must match matrix skinning");
+		Check(BlendedMaxError <= BlendedMaxTolerance, "blended vertices drifted too far from matrix skinning");
+		Check(BlendedAverageError <= BlendedAverageTolerance, "blended vertices drifted too far from matrix skinning on average");
+	}
+
+	// 같은 축으로 170도 비튼 두 뼈를 반씩 섞으면 선형 블렌드는 축 쪽으로 꺼지고 듀얼 쿼터니언은 반지름을 지킨다.
+	void TestTwistKeepsVolume()
+	{
+		XMVECTOR Reals[2];
+		XMVECTOR Duals[2];
+		DualQuaternion::FromMatrix(XMMatrixIdentity(), Reals[0], Duals[0]);
+		DualQuaternion::FromMatrix(XMMatrixRotationX(XMConvertToRadians(170.0f)), Reals[1], Duals[1]);
+
+		XMMATRIX Palette[2] = { XMMatrixIdentity(), XMMatrixRotationX(XMConvertToRadians(170.0f)) };
+
+		SkinnedPoint Point;
+		Point.Position = { 0.5f, 1.0f, 0.0f };
+		Point.BoneIndices[0] = 0;
+		Point.BoneIndices[1] = 1;
+		Point.Weights[0] = 0.5f;
+		Point.Weights[1] = 0.5f;
+		Point.InfluenceCount = 2;
+
+		XMFLOAT3 Linear;
+		XMFLOAT3 Blended;
+		XMStoreFloat3(&Linear, SkinLinear(Point, Palette));
+		XMStoreFloat3(&Blended, SkinDualQuaternion(Point, Reals, Duals));
+
+		const float LinearRadius = sqrtf(Linear.y * Linear.y + Linear.z * Linear.z);
+		const float BlendedRadius = sqrtf(Blended.y * Blended.y + Blended.z * Blended.z);
+
+		printf("Twist 170 degrees: distance from axis %g with matrices, %g with dual quaternions (bind 1)\n", LinearRadius, BlendedRadius);
+
+		Check(fabsf(BlendedRadius - 1.0f) <= 1e-4f, "dual quaternion blend must keep the distance from the twist axis");
+		Check(fabsf(Blended.x - 0.5f) <= 1e-4f, "twisting about X must not move the point along X");
+		Check(LinearRadius < 0.5f, "matrix blend is expected to collapse toward the twist axis");
+	}
+
+	void ReportPaletteSize()
+	{
+		// 팔레트 하나에 뼈마다 4x4 행렬 대신 쿼터니언 두 개를 올린다.
+		const size_t MatrixBytes = sizeof(XMFLOAT4X4);
+		const size_t DualQuaternionBytes = 2 * sizeof(XMFLOAT4);
+
+		printf("Palette per bone: %zu -> %zu bytes (%.0f%% less upload and shader read bandwidth)\n",
+			MatrixBytes, DualQuaternionBytes, 100.0 * (1.0 - (double)DualQuaternionBytes / MatrixBytes));
+
+		Check(DualQuaternionBytes * 2 == MatrixBytes, "dual quaternion palette should be half the size of a matrix palette");
+	}
+}
+
+int main()
+{
+	TestRandomPoses();
+	TestTwistKeepsVolume();
+	ReportPaletteSize();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
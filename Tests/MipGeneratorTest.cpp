@@ -0,0 +1,216 @@
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "MipGenerator.h"
+#include "JobSystem.h"
+
+// 밉 개수와 크기, 2의 거듭제곱이 아닌 크기, 단색이 모든 밉에서 그대로 나오는지, 상자 필터 평균, 가장자리 감싸기를 본다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Name, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s: %s\n", Name, Message);
+			++FailureCount;
+		}
+	}
+
+	MipGenerationOptions MakeOptions(MipFilter Filter, bool bSRGB, bool bWrap)
+	{
+		MipGenerationOptions Options;
+		Options.Filter = Filter;
+		Options.bSRGB = bSRGB;
+		Options.bWrap = bWrap;
+		return Options;
+	}
+
+	std::vector<uint8_t> MakeNoise(uint32_t Width, uint32_t Height, uint32_t Seed)
+	{
+		std::mt19937 Random(Seed);
+		std::vector<uint8_t> Pixels((size_t)Width * Height * 4);
+		for (uint8_t& Value : Pixels)
+		{
+			Value = (uint8_t)Random();
+		}
+		return Pixels;
+	}
+
+	void TestMipCount()
+	{
+		const char* Name = "mip count";
+
+		Check(1 == MipGenerator::GetMipCount(1, 1), Name, "1x1");
+		Check(9 == MipGenerator::GetMipCount(256, 256), Name, "256x256");
+		Check(9 == MipGenerator::GetMipCount(300, 7), Name, "300x7 follows the longer side");
+		Check(11 == MipGenerator::GetMipCount(1, 1024), Name, "1x1024");
+		Check(13 == MipGenerator::GetMipCount(4096, 3), Name, "4096x3");
+	}
+
+	// 밉 i는 max(1, 크기 >> i)이고 밉 0은 행 사이 빈 공간을 뺀 원본이다.
+	void TestNonPowerOfTwo()
+	{
+		const char* Name = "non power of two";
+
+		const uint32_t Sizes[][2] = { { 300, 7 }, { 5, 3 }, { 1, 17 }, { 33, 1 }, { 97, 61 } };
+		const MipFilter Filters[] = { MipFilter::Box, MipFilter::Kaiser };
+
+		for (const auto& Size : Sizes)
+		{
+			const uint32_t Width = Size[0];
+			const uint32_t Height = Size[1];
+			const size_t RowPitch = Width * 4 + 20;
+
+			std::vector<uint8_t> Source(RowPitch * Height, 0xEE);
+			const std::vector<uint8_t> Pixels = MakeNoise(Width, Height, Width * 1000 + Height);
+			for (uint32_t Y = 0; Y < Height; Y++)
+			{
+				memcpy(&Source[Y * RowPitch], &Pixels[(size_t)Y * Width * 4], Width * 4);
+			}
+
+			for (MipFilter Filter : Filters)
+			{
+				std::vector<std::vector<uint8_t>> Mips;
+				MipGenerator::Generate(Source.data(), Width, Height, RowPitch, MakeOptions(Filter, true, false), Mips);
+
+				bool bSizes = Mips.size() == MipGenerator::GetMipCount(Width, Height);
+				for (size_t Mip = 0; Mip < Mips.size() && bSizes; Mip++)
+				{
+					const size_t MipWidth = std::max<uint32_t>(1, Width >> Mip);
+					const size_t MipHeight = std::max<uint32_t>(1, Height >> Mip);
+					bSizes = Mips[Mip].size() == MipWidth * MipHeight * 4;
+				}
+				Check(bSizes, Name, "mip sizes");
+				Check(bSizes && Mips[0] == Pixels, Name, "mip 0 is the source without row padding");
+			}
+		}
+	}
+
+	// 가중치 합이 1이니 단색은 어느 필터, 어느 가장자리 방식에서도 모든 밉에서 같은 값이어야 한다. sRGB는 선형으로 풀었다 다시 담아도 같은 칸으로 돌아와야 한다.
+	void TestSolidColor()
+	{
+		const char* Name = "solid color";
+
+		const uint32_t Width = 37;
+		const uint32_t Height = 20;
+		const MipFilter Filters[] = { MipFilter::Box, MipFilter::Kaiser };
+
+		for (int bSRGB = 0; bSRGB < 2; bSRGB++)
+		{
+			for (MipFilter Filter : Filters)
+			{
+				for (int bWrap = 0; bWrap < 2; bWrap++)
+				{
+					bool bMatches = true;
+					for (int Value = 0; Value < 256; Value++)
+					{
+						const uint8_t Color[4] = { (uint8_t)Value, (uint8_t)(255 - Value), (uint8_t)(Value * 7), (uint8_t)(Value ^ 0x5A) };
+
+						std::vector<uint8_t> Pixels((size_t)Width * Height * 4);
+						for (size_t i = 0; i < Pixels.size(); i += 4)
+						{
+							memcpy(&Pixels[i], Color, 4);
+						}
+
+						std::vector<std::vector<uint8_t>> Mips;
+						MipGenerator::Generate(Pixels.data(), Width, Height, Width * 4, MakeOptions(Filter, 1 == bSRGB, 1 == bWrap), Mips);
+
+						for (const std::vector<uint8_t>& Mip : Mips)
+						{
+							for (size_t i = 0; i < Mip.size(); i += 4)
+							{
+								bMatches = bMatches && 0 == memcmp(&Mip[i], Color, 4);
+							}
+						}
+					}
+					Check(bMatches, Name, bSRGB ? "sRGB solid color changed in a mip" : "unorm solid color changed in a mip");
+				}
+			}
+		}
+	}
+
+	// 짝수 크기 상자 필터는 2x2 평균이다. 2x2 합은 4의 배수, 전체 합은 8의 배수가 되도록 골라서 반올림이 끼지 않게 한다.
+	void TestBoxAverage()
+	{
+		const char* Name = "box average";
+
+		const uint32_t Width = 4;
+		const uint32_t Height = 2;
+		const uint8_t Pixels[Width * Height * 4] =
+		{
+			0, 40, 200, 255,	8, 40, 100, 255,	255, 1, 2, 3,		255, 3, 2, 5,
+			4, 0, 100, 255,		12, 0, 0, 255,		253, 5, 6, 7,		253, 7, 6, 5,
+		};
+
+		std::vector<std::vector<uint8_t>> Mips;
+		MipGenerator::Generate(Pixels, Width, Height, Width * 4, MakeOptions(MipFilter::Box, false, false), Mips);
+
+		const uint8_t Expected[] = { 6, 20, 100, 255, 254, 4, 4, 5 };
+		Check(3 == Mips.size() && 0 == memcmp(Mips[1].data(), Expected, sizeof(Expected)), Name, "2x1 mip is the average of each 2x2 block");
+
+		// 마지막 1x1은 4x2 전체 평균
+		const uint8_t Last[] = { 130, 12, 52, 130 };
+		Check(3 == Mips.size() && 0 == memcmp(Mips[2].data(), Last, sizeof(Last)), Name, "1x1 mip is the average of the whole image");
+	}
+
+	// 왼쪽 절반이 검고 오른쪽 절반이 흰 그림. 감싸면 0번 열이 반대편 흰 쪽을 읽고, 늘리면 검은 채로 남는다.
+	void TestWrap()
+	{
+		const char* Name = "wrap";
+
+		const uint32_t Width = 64;
+		const uint32_t Height = 8;
+		std::vector<uint8_t> Pixels((size_t)Width * Height * 4, 255);
+		for (uint32_t Y = 0; Y < Height; Y++)
+		{
+			memset(&Pixels[(size_t)Y * Width * 4], 0, Width * 2);
+		}
+
+		std::vector<std::vector<uint8_t>> Clamped;
+		std::vector<std::vector<uint8_t>> Wrapped;
+		MipGenerator::Generate(Pixels.data(), Width, Height, Width * 4, MakeOptions(MipFilter::Kaiser, false, false), Clamped);
+		MipGenerator::Generate(Pixels.data(), Width, Height, Width * 4, MakeOptions(MipFilter::Kaiser, false, true), Wrapped);
+
+		Check(0 == Clamped[1][0], Name, "clamped edge must not read the far side");
+		Check(Wrapped[1][0] > 0, Name, "wrapped edge must read the far side");
+		Check(255 == Clamped[1][(Width / 2 - 1) * 4], Name, "clamped right edge stays white");
+	}
+
+	// 출력 행 묶음을 스레드에 나눠도 결과는 한 스레드에서 만든 것과 같아야 한다. 묶음이 여러 개가 되도록 넓게 잡는다.
+	void TestJobSystemMatchesSerial()
+	{
+		const char* Name = "parallel";
+
+		const uint32_t Width = 1030;
+		const uint32_t Height = 300;
+		const std::vector<uint8_t> Pixels = MakeNoise(Width, Height, 3);
+
+		std::vector<std::vector<uint8_t>> Serial;
+		std::vector<std::vector<uint8_t>> Parallel;
+		MipGenerator::Generate(Pixels.data(), Width, Height, Width * 4, MakeOptions(MipFilter::Kaiser, true, true), Serial);
+		{
+			JobSystem Jobs;
+			Jobs.Init(3);
+			MipGenerator::Generate(Pixels.data(), Width, Height, Width * 4, MakeOptions(MipFilter::Kaiser, true, true), Parallel);
+		}
+		Check(Serial == Parallel, Name, "parallel mips differ from the serial mips");
+	}
+}
+
+int main()
+{
+	TestMipCount();
+	TestNonPowerOfTwo();
+	TestSolidColor();
+	TestBoxAverage();
+	TestWrap();
+	TestJobSystemMatchesSerial();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
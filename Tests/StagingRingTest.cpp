@@ -0,0 +1,266 @@
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <vector>
+#include "StagingRing.h"
+
+// 가짜 펜스로 StagingRing을 돌린다. 끝에서 버린 꼬리, 묶음이 돌아오는 순서, 꽉 찬 링의 거절, 다 돌려받았을 때 처음으로 돌아가는 길을 본다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Name, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s: %s\n", Name, Message);
+			++FailureCount;
+		}
+	}
+
+	// 큐에 넣은 순서대로 끝나는 GPU 펜스 흉내
+	struct FakeFence
+	{
+		uint64_t LastSignaled = 0;
+		uint64_t Completed = 0;
+		std::deque<uint64_t> InFlight;
+
+		uint64_t Signal()
+		{
+			InFlight.push_back(++LastSignaled);
+			return LastSignaled;
+		}
+
+		void CompleteOne()
+		{
+			if (false == InFlight.empty())
+			{
+				Completed = InFlight.front();
+				InFlight.pop_front();
+			}
+		}
+
+		void CompleteAll()
+		{
+			while (false == InFlight.empty())
+			{
+				CompleteOne();
+			}
+		}
+	};
+
+	void TestWrapDiscardsTail()
+	{
+		const char* Name = "wrap";
+
+		StagingRing Ring;
+		Ring.Init(1024);
+		FakeFence Fence;
+
+		Check(0 == Ring.Allocate(576, 16), Name, "first allocation starts at 0");
+		Ring.Submit(Fence.Signal());
+		Check(576 == Ring.Allocate(320, 16), Name, "second allocation follows the first");
+		Ring.Submit(Fence.Signal());
+
+		Fence.CompleteOne();
+		Ring.Retire(Fence.Completed);
+		Check(320 == Ring.GetStats().RingBytes, Name, "first batch returned");
+
+		// 896 뒤 128바이트에는 200이 안 들어가서 꼬리를 버리고 0부터 잡는다. 버린 꼬리도 쓰는 중으로 센다.
+		Check(0 == Ring.Allocate(200, 16), Name, "allocation that does not fit the tail wraps to 0");
+		Check(320 + 128 + 200 == Ring.GetStats().RingBytes, Name, "discarded tail counts as used");
+		Ring.Submit(Fence.Signal());
+
+		// 두 번째 묶음이 돌아오면 버린 꼬리는 세 번째 묶음과 같이 남는다.
+		Fence.CompleteOne();
+		Ring.Retire(Fence.Completed);
+		Check(128 + 200 == Ring.GetStats().RingBytes, Name, "discarded tail stays with the wrapping batch");
+
+		// 정렬해서 생긴 빈칸은 건너뛴다. 정렬한 자리가 끝에 닿으면 0으로 넘어가는데, 거기는 아직 세 번째 묶음이 쓰고 있다.
+		Check(256 == Ring.Allocate(512, 256), Name, "aligned allocation after the wrap");
+		Check(StagingRing::InvalidOffset == Ring.Allocate(1, 512), Name, "aligned allocation must not overlap the wrapping batch");
+	}
+
+	void TestRetirementOrder()
+	{
+		const char* Name = "retire";
+
+		StagingRing Ring;
+		Ring.Init(4096);
+		FakeFence Fence;
+
+		uint64_t Fences[3];
+		for (int i = 0; i < 3; i++)
+		{
+			Ring.Allocate(1024, 16);
+			Ring.AddDedicated(10000);
+			Fences[i] = Fence.Signal();
+			Ring.Submit(Fences[i]);
+		}
+
+		// 아무것도 안 잡았으면 묶음을 만들지 않는다.
+		Ring.Submit(Fence.Signal());
+		Check(3 == Ring.GetStats().BatchCount, Name, "empty submit must not make a batch");
+		Check(30000 == Ring.GetStats().DedicatedBytes, Name, "dedicated bytes are in flight");
+
+		Ring.Retire(Fences[0] - 1);
+		Check(3072 == Ring.GetStats().RingBytes && 30000 == Ring.GetStats().DedicatedBytes, Name, "nothing returns before the first fence");
+
+		Ring.Retire(Fences[1]);
+		Check(1024 == Ring.GetStats().RingBytes && 10000 == Ring.GetStats().DedicatedBytes, Name, "batches up to the completed fence return in order");
+
+		// 링 끝에 남은 1024와 돌아온 앞의 2048까지만 잡을 수 있다.
+		Check(3072 == Ring.Allocate(1024, 8), Name, "allocation fills the end of the ring");
+		Check(0 == Ring.Allocate(2048, 8), Name, "allocation reuses the returned front");
+		Check(StagingRing::InvalidOffset == Ring.Allocate(8, 8), Name, "ring is full up to the live batch");
+		Ring.Submit(Fence.Signal());
+
+		Ring.Retire(Fences[2]);
+		Check(1024 + 2048 == Ring.GetStats().RingBytes && 0 == Ring.GetStats().DedicatedBytes, Name, "third batch returned");
+	}
+
+	void TestFullRingRefuses()
+	{
+		const char* Name = "full";
+
+		StagingRing Ring;
+		Ring.Init(1024);
+		FakeFence Fence;
+
+		Check(StagingRing::InvalidOffset == Ring.Allocate(1025, 16), Name, "allocation larger than the ring");
+
+		Check(0 == Ring.Allocate(512, 16), Name, "first half");
+		Ring.Submit(Fence.Signal());
+		Check(512 == Ring.Allocate(384, 16), Name, "second batch");
+		Ring.Submit(Fence.Signal());
+
+		Fence.CompleteOne();
+		Ring.Retire(Fence.Completed);
+
+		// 꼬리 128을 버리고 0부터 200. 남은 자리는 200~512 사이 312바이트뿐이다.
+		Check(0 == Ring.Allocate(200, 16), Name, "wrap into the returned half");
+		Check(StagingRing::InvalidOffset == Ring.Allocate(400, 16), Name, "allocation that would overrun the live batch");
+		Check(200 == Ring.Allocate(312, 8), Name, "allocation that exactly fills the gap");
+		Check(StagingRing::InvalidOffset == Ring.Allocate(1, 1), Name, "ring is full");
+		Check(1024 == Ring.GetStats().RingBytes && 1024 == Ring.GetStats().PeakRingBytes, Name, "full ring accounting");
+
+		// 거절된 요청은 통계에 들어가지 않는다.
+		Check(4 == Ring.GetStats().AllocationCount && 512 + 384 + 200 + 312 == Ring.GetStats().TotalBytes, Name, "refused allocations are not counted");
+	}
+
+	void TestRetireResetsToStart()
+	{
+		const char* Name = "reset";
+
+		StagingRing Ring;
+		Ring.Init(1024);
+		FakeFence Fence;
+
+		Ring.Allocate(700, 16);
+		Ring.Submit(Fence.Signal());
+		Fence.CompleteAll();
+		Ring.Retire(Fence.Completed);
+
+		// 다 돌려받았으니 700에서 잘리지 않고 처음부터 통째로 잡힌다.
+		Check(0 == Ring.GetStats().RingBytes, Name, "everything returned");
+		Check(0 == Ring.Allocate(1000, 16), Name, "after a full retire the next allocation starts at 0");
+		Ring.Submit(Fence.Signal());
+
+		// 제출 안 한 자리가 남아 있으면 처음으로 돌아가지 않는다.
+		Fence.CompleteAll();
+		Ring.Retire(Fence.Completed);
+		Check(0 == Ring.Allocate(16, 16), Name, "reset again before the unsubmitted allocation");
+		Ring.Retire(Fence.Completed);
+		Check(16 == Ring.GetStats().RingBytes, Name, "unsubmitted allocation must not be reset away");
+		Check(16 == Ring.Allocate(16, 16), Name, "unsubmitted allocation keeps its place");
+	}
+
+	// 무작위로 잡고 제출하면서 살아 있는 자리끼리 겹치지 않고 끝나면 다 돌아오는지
+	void TestRandomFrames()
+	{
+		const char* Name = "random";
+
+		struct LiveRange
+		{
+			uint64_t Offset;
+			uint64_t Bytes;
+			uint64_t Fence;
+		};
+
+		for (uint32_t Seed = 0; Seed < 100; Seed++)
+		{
+			std::mt19937_64 Random(Seed);
+			const uint64_t Capacity = 512ull << (Random() % 8);
+			const size_t Lag = 1 + Random() % 3;
+
+			StagingRing Ring;
+			Ring.Init(Capacity);
+			FakeFence Fence;
+
+			std::vector<LiveRange> Live;
+			bool bValid = true;
+
+			for (uint32_t Frame = 0; Frame < 1000 && bValid; Frame++)
+			{
+				while (Fence.InFlight.size() > Lag || (false == Fence.InFlight.empty() && 0 == Random() % 4))
+				{
+					Fence.CompleteOne();
+				}
+				Ring.Retire(Fence.Completed);
+
+				std::vector<LiveRange> Kept;
+				for (const LiveRange& Range : Live)
+				{
+					if (Range.Fence > Fence.Completed)
+					{
+						Kept.push_back(Range);
+					}
+				}
+				Live.swap(Kept);
+
+				const uint64_t NextFence = Fence.LastSignaled + 1;
+				const uint32_t AllocationCount = (uint32_t)(Random() % 6);
+				for (uint32_t i = 0; i < AllocationCount; i++)
+				{
+					const uint64_t Bytes = 0 == Random() % 20 ? Capacity + 1 : 1 + Random() % (Capacity / 2);
+					const uint64_t Alignment = Random() % 2 ? 512 : 16;
+
+					const uint64_t Offset = Ring.Allocate(Bytes, Alignment);
+					if (Offset == StagingRing::InvalidOffset)
+					{
+						Ring.AddDedicated(Bytes);
+						continue;
+					}
+
+					bValid = bValid && 0 == Offset % Alignment && Offset + Bytes <= Capacity;
+					for (const LiveRange& Range : Live)
+					{
+						bValid = bValid && (Offset + Bytes <= Range.Offset || Range.Offset + Range.Bytes <= Offset);
+					}
+					Live.push_back({ Offset, Bytes, NextFence });
+				}
+
+				Ring.Submit(Fence.Signal());
+				bValid = bValid && Ring.GetStats().RingBytes <= Capacity;
+			}
+			Check(bValid, Name, "live ranges overlapped or left the ring");
+
+			Fence.CompleteAll();
+			Ring.Retire(Fence.Completed);
+			Check(0 == Ring.GetStats().RingBytes && 0 == Ring.GetStats().DedicatedBytes, Name, "bytes left after every fence completed");
+		}
+	}
+}
+
+int main()
+{
+	TestWrapDiscardsTail();
+	TestRetirementOrder();
+	TestFullRingRefuses();
+	TestRetireResetsToStart();
+	TestRandomFrames();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "SupercompressedTexture.h"
+#include "DDSFile.h"
+#include "BlockCompression.h"
+#include "JobSystem.h"
+
+// 같은 텍스처를 DDS 그대로 읽을 때와 .sctx를 읽어 풀 때를 비교한다. 저장소의 Textures/*.dds와 큰 BC1, BC7 그림을 쓴다.
+// 둘 다 파일을 열고 업로드 버퍼에 원본 DDS를 채우는 데까지 잰다. 페이지 캐시가 데워진 상태라 디스크 읽기는 빠져 있어서,
+// 줄어든 바이트를 읽는 데 드는 시간이 풀기 시간보다 커지는 디스크 속도(손익분기)를 같이 찍는다.
+//   cmake -S Tests -B Build/Tests -DCMAKE_BUILD_TYPE=Release && cmake --build Build/Tests --target SupercompressedTextureBench
+
+namespace
+{
+	const int Iterations = 20;
+
+	const char* const RawPath = "SupercompressedTextureBench.dds";
+	const char* const CompressedPath = "SupercompressedTextureBench.sctx";
+
+	std::vector<uint8_t> LoadFile(const std::string& Path)
+	{
+		std::ifstream Stream(Path, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(Stream), std::istreambuf_iterator<char>());
+	}
+
+	void SaveFile(const char* Path, const std::vector<uint8_t>& Bytes)
+	{
+		std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+		Stream.write(reinterpret_cast<const char*>(Bytes.data()), (std::streamsize)Bytes.size());
+	}
+
+	// BlockCompressionBench와 같은 모양. 그라데이션, 줄무늬, 노이즈, 색이 끊기는 사각형.
+	std::vector<uint8_t> MakeBlockCompressed(BCFormat Format, uint32_t Width, uint32_t Height)
+	{
+		std::mt19937 Random(1);
+
+		std::vector<uint8_t> Pixels((size_t)Width * Height * 4);
+		for (uint32_t Y = 0; Y < Height; Y++)
+		{
+			for (uint32_t X = 0; X < Width; X++)
+			{
+				const float U = (float)X / Width;
+				const float V = (float)Y / Height;
+
+				float Channels[4] =
+				{
+					255.0f * U,
+					128.0f + 100.0f * std::sin(V * 12.0f + U * 3.0f),
+					255.0f * (1.0f - U) * V,
+					160.0f + 80.0f * std::cos(U * 9.0f - V * 5.0f),
+				};
+
+				if (0 == (X / 24 + Y / 24) % 5)
+				{
+					Channels[0] = 255.0f - Channels[0];
+					Channels[2] = 30.0f;
+				}
+
+				uint8_t* Pixel = &Pixels[((size_t)Y * Width + X) * 4];
+				for (int Channel = 0; Channel < 4; Channel++)
+				{
+					Pixel[Channel] = (uint8_t)std::clamp(Channels[Channel] + (float)(Random() % 13) - 6.0f, 0.0f, 255.0f);
+				}
+			}
+		}
+
+		std::vector<std::vector<uint8_t>> Mips(1);
+		Mips[0].resize(BlockCompression::GetSurfaceBytes(Format, Width, Height));
+		BlockCompression::EncodeSurface(Format, Pixels.data(), Width, Height, Width * 4, Mips[0].data());
+
+		std::unique_ptr<DDSFile> File = DDSFile::Create(BlockCompression::GetDXGIFormat(Format, false), Width, Height, Mips);
+		return std::vector<uint8_t>(File->GetData(), File->GetData() + File->GetSize());
+	}
+
+	template<typename Function>
+	double MeasureMilliseconds(Function&& Body)
+	{
+		// 첫 번째는 업로드 버퍼 페이지를 채우는 시간이 섞여서 재지 않는다.
+		Body();
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			Body();
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() / Iterations;
+	}
+
+	// TextureStreamer처럼 DDS를 매핑해 열고 업로드 버퍼로 복사한다.
+	double MeasureRaw(std::vector<uint8_t>& Staging)
+	{
+		return MeasureMilliseconds([&]()
+		{
+			std::unique_ptr<DDSFile> File = DDSFile::Open(RawPath);
+			memcpy(Staging.data(), File->GetData(), File->GetSize());
+		});
+	}
+
+	double MeasureCompressed(std::vector<uint8_t>& Staging)
+	{
+		return MeasureMilliseconds([&]()
+		{
+			std::unique_ptr<SupercompressedTexture> Texture = SupercompressedTexture::Open(CompressedPath);
+			Texture->Transcode(Staging.data());
+		});
+	}
+
+	void Report(const char* Name, const std::vector<uint8_t>& Raw)
+	{
+		std::vector<uint8_t> Encoded;
+		SupercompressedTexture::Encode(Raw.data(), Raw.size(), Encoded);
+		SaveFile(RawPath, Raw);
+		SaveFile(CompressedPath, Encoded);
+
+		std::vector<uint8_t> Staging(Raw.size());
+		const double RawMs = MeasureRaw(Staging);
+		const double SerialMs = MeasureCompressed(Staging);
+
+		double ParallelMs = 0.0;
+		{
+			JobSystem Jobs;
+			Jobs.Init();
+			ParallelMs = MeasureCompressed(Staging);
+		}
+
+		// 손익분기: 줄어든 바이트를 읽는 시간 = 늘어난 CPU 시간
+		const double SavedMB = (double)(Raw.size() - Encoded.size()) / (1024.0 * 1024.0);
+		const double ExtraMs = ParallelMs - RawMs;
+		const double RawMBps = (double)Raw.size() / (1024.0 * 1024.0) / (ParallelMs / 1000.0);
+
+		printf("%-24s %9zu -> %9zu (%5.1f%%)  %7.2f ms  %7.2f ms  %7.2f ms  %7.1f MB/s  %8.1f MB/s\n",
+			Name, Raw.size(), Encoded.size(), 100.0 * Encoded.size() / Raw.size(), RawMs, SerialMs, ParallelMs, RawMBps,
+			ExtraMs > 0.0 ? SavedMB / (ExtraMs / 1000.0) : 0.0);
+	}
+}
+
+int main()
+{
+	uint32_t ThreadCount = 0;
+	{
+		JobSystem Jobs;
+		Jobs.Init();
+		ThreadCount = Jobs.GetThreadCount();
+	}
+
+	printf("page cache warm, average of %d runs, %u threads with JobSystem\n", Iterations, ThreadCount);
+	printf("%-24s %9s -> %-9s %8s  %10s  %10s  %10s  %12s  %13s\n", "texture", "raw", "sctx", "", "raw load", "sctx 1 thr", "sctx N thr", "transcode", "break-even");
+
+	for (const char* FileName : { "base_color_texture.dds", "texture_ground.dds" })
+	{
+		Report(FileName, LoadFile(std::string(TEXTURE_DIR) + FileName));
+	}
+	Report("2048x2048 BC1", MakeBlockCompressed(BCFormat::BC1, 2048, 2048));
+	Report("1024x1024 BC7", MakeBlockCompressed(BCFormat::BC7, 1024, 1024));
+
+	std::remove(RawPath);
+	std::remove(CompressedPath);
+	return 0;
+}
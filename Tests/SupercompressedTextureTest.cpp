@@ -0,0 +1,348 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "SupercompressedTexture.h"
+#include "DDSFile.h"
+#include "JobSystem.h"
+
+// 저장소의 Textures/*.dds와 무작위(압축 안 되는) 데이터, 반복이 많은 데이터를 .sctx로 굽고 풀어서 원본과 바이트 단위로 같은지 본다.
+// 잘린 파일과 헤더, 조각 표, 스트림이 깨진 파일은 FromMemory나 Transcode가 실패를 돌려줘야 한다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Name, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s: %s\n", Name, Message);
+			++FailureCount;
+		}
+	}
+
+	// DXGI_FORMAT 값
+	const uint32_t FormatR8G8B8A8Unorm = 28;
+	const uint32_t FormatBC1Unorm = 71;
+	const uint32_t FormatBC7Unorm = 98;
+
+	const char* const ShippedTextures[] = { "base_color_texture.dds", "texture_ground.dds" };
+
+	std::vector<uint8_t> LoadFile(const std::string& Path)
+	{
+		std::ifstream Stream(Path, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(Stream), std::istreambuf_iterator<char>());
+	}
+
+	std::vector<uint8_t> MakeDDS(uint32_t Format, uint32_t Width, uint32_t Height, const std::vector<std::vector<uint8_t>>& Mips)
+	{
+		std::unique_ptr<DDSFile> File = DDSFile::Create(Format, Width, Height, Mips);
+		return File ? std::vector<uint8_t>(File->GetData(), File->GetData() + File->GetSize()) : std::vector<uint8_t>();
+	}
+
+	std::vector<uint8_t> MakeNoise(size_t Size, uint32_t Seed)
+	{
+		std::mt19937 Random(Seed);
+		std::vector<uint8_t> Bytes(Size);
+		for (uint8_t& Value : Bytes)
+		{
+			Value = (uint8_t)Random();
+		}
+		return Bytes;
+	}
+
+	// 구운 결과를 다시 읽어 풀고 원본과 비교한다.
+	bool RoundTrip(const std::vector<uint8_t>& Raw, std::vector<uint8_t>& OutEncoded)
+	{
+		OutEncoded.clear();
+		if (false == SupercompressedTexture::Encode(Raw.data(), Raw.size(), OutEncoded))
+		{
+			return false;
+		}
+
+		std::unique_ptr<SupercompressedTexture> Texture = SupercompressedTexture::FromMemory(OutEncoded.data(), OutEncoded.size());
+		if (nullptr == Texture || Texture->GetRawSize() != Raw.size() || Texture->GetSize() != OutEncoded.size())
+		{
+			return false;
+		}
+
+		std::vector<uint8_t> Decoded(Raw.size());
+		return Texture->Transcode(Decoded.data()) && Decoded == Raw;
+	}
+
+	bool Transcodes(const std::vector<uint8_t>& Encoded)
+	{
+		std::unique_ptr<SupercompressedTexture> Texture = SupercompressedTexture::FromMemory(Encoded.data(), Encoded.size());
+		if (nullptr == Texture)
+		{
+			return false;
+		}
+
+		std::vector<uint8_t> Decoded((size_t)Texture->GetRawSize());
+		return Texture->Transcode(Decoded.data());
+	}
+
+	SupercompressedHeader& GetHeader(std::vector<uint8_t>& Encoded)
+	{
+		return *reinterpret_cast<SupercompressedHeader*>(Encoded.data());
+	}
+
+	SupercompressedChunk& GetChunk(std::vector<uint8_t>& Encoded, uint32_t Chunk)
+	{
+		return reinterpret_cast<SupercompressedChunk*>(Encoded.data() + sizeof(SupercompressedHeader))[Chunk];
+	}
+
+	// 여러 조각에 걸친 무작위 RGBA. 조각마다 원본 그대로 담기는 쪽으로 간다.
+	std::vector<uint8_t> MakeNoiseDDS()
+	{
+		return MakeDDS(FormatR8G8B8A8Unorm, 300, 200, { MakeNoise(300 * 200 * 4, 1) });
+	}
+
+	void TestShippedTextures()
+	{
+		const char* Name = "shipped textures";
+
+		for (const char* FileName : ShippedTextures)
+		{
+			const std::vector<uint8_t> Raw = LoadFile(std::string(TEXTURE_DIR) + FileName);
+			Check(false == Raw.empty(), Name, FileName);
+
+			std::vector<uint8_t> Encoded;
+			Check(RoundTrip(Raw, Encoded), Name, FileName);
+			Check(Encoded.size() < Raw.size(), Name, "shipped BC textures must get smaller");
+
+			std::unique_ptr<DDSFile> Source = DDSFile::FromMemory(Raw.data(), Raw.size());
+			std::unique_ptr<SupercompressedTexture> Texture = SupercompressedTexture::FromMemory(Encoded.data(), Encoded.size());
+			std::unique_ptr<DDSFile> Decoded = Texture ? Texture->TranscodeToDDS() : nullptr;
+			Check(Source && Decoded && Texture->GetFormat() == Source->GetFormat(), Name, "format");
+			Check(Source && Decoded && Decoded->GetWidth() == Source->GetWidth() && Decoded->GetMipCount() == Source->GetMipCount(), Name, "TranscodeToDDS parses as the same texture");
+		}
+	}
+
+	void TestIncompressibleData()
+	{
+		const char* Name = "incompressible";
+
+		const std::vector<uint8_t> Raw = MakeNoiseDDS();
+		std::vector<uint8_t> Encoded;
+		Check(RoundTrip(Raw, Encoded), Name, "random RGBA over several chunks");
+
+		// 조각이 원본 그대로 담기면 늘어나는 건 헤더, 조각 표, 스트림 머리, 리터럴 길이 바이트뿐이다.
+		Check(GetHeader(Encoded).ChunkCount > 1, Name, "expected several chunks");
+		Check(Encoded.size() < Raw.size() + Raw.size() / 256, Name, "random data must not grow beyond the framing");
+
+		std::mt19937 Random(2);
+		for (uint32_t Format : { FormatBC1Unorm, FormatBC7Unorm })
+		{
+			const uint32_t Width = 256;
+			const uint32_t Height = 128;
+			const std::vector<uint8_t> Blocks = MakeNoise((size_t)Width * Height / 16 * (Format == FormatBC1Unorm ? 8 : 16), Random());
+			Check(RoundTrip(MakeDDS(Format, Width, Height, { Blocks }), Encoded), Name, "random BC blocks");
+		}
+	}
+
+	// 반복이 많은 데이터. 긴 매치, 겹치는 매치, 255를 넘는 길이, 바이트 평면, rANS 스트림을 모두 지난다.
+	void TestCompressibleData()
+	{
+		const char* Name = "compressible";
+
+		const uint32_t Width = 512;
+		const uint32_t Height = 256;
+
+		// 블록 몇 가지를 번갈아 쓰는 BC1. 인덱스만 바뀌는 블록이 섞여 바이트 평면 쪽이 이긴다.
+		std::mt19937 Random(3);
+		std::vector<uint8_t> Blocks((size_t)Width * Height / 2);
+		for (size_t i = 0; i < Blocks.size(); i += 8)
+		{
+			const uint32_t Pick = Random() % 4;
+			const uint8_t Block[8] = { 0x1F, (uint8_t)(0xF8 | Pick), 0x00, 0x07, (uint8_t)(Pick * 0x55), (uint8_t)Random(), 0xAA, 0xAA };
+			memcpy(&Blocks[i], Block, 8);
+		}
+
+		std::vector<std::vector<uint8_t>> Mips = { Blocks };
+		for (uint32_t Mip = 1; Mip < 4; Mip++)
+		{
+			Mips.push_back(std::vector<uint8_t>(Blocks.begin(), Blocks.begin() + Blocks.size() / ((size_t)1 << (2 * Mip))));
+		}
+
+		std::vector<uint8_t> Encoded;
+		const std::vector<uint8_t> Raw = MakeDDS(FormatBC1Unorm, Width, Height, Mips);
+		Check(RoundTrip(Raw, Encoded), Name, "repeating BC1 blocks with mips");
+		Check(Encoded.size() * 2 < Raw.size(), Name, "repeating blocks must compress");
+
+		bool bBytePlanes = false;
+		for (uint32_t Chunk = 0; Chunk < GetHeader(Encoded).ChunkCount; Chunk++)
+		{
+			bBytePlanes = bBytePlanes || 0 != (GetChunk(Encoded, Chunk).Flags & ChunkFlagBytePlanes);
+		}
+		Check(bBytePlanes, Name, "expected at least one byte plane chunk");
+
+		// 한 값으로 가득 찬 그림은 거의 전부 하나의 긴 겹치는 매치다.
+		const std::vector<uint8_t> Solid = MakeDDS(FormatR8G8B8A8Unorm, 300, 300, { std::vector<uint8_t>(300 * 300 * 4, 0x7C) });
+		Check(RoundTrip(Solid, Encoded), Name, "solid RGBA");
+		Check(Encoded.size() * 100 < Solid.size(), Name, "solid image must shrink to almost nothing");
+
+		// 조각보다 작은 데이터
+		Check(RoundTrip(MakeDDS(FormatR8G8B8A8Unorm, 1, 1, { { 1, 2, 3, 4 } }), Encoded), Name, "1x1 RGBA");
+		Check(RoundTrip(MakeDDS(FormatBC1Unorm, 4, 4, { MakeNoise(8, 4) }), Encoded), Name, "single BC1 block");
+	}
+
+	// 조각을 스레드에 나눠 굽고 풀어도 결과는 한 스레드와 같아야 한다.
+	void TestJobSystemMatchesSerial()
+	{
+		const char* Name = "parallel";
+
+		const std::vector<uint8_t> Raw = LoadFile(std::string(TEXTURE_DIR) + ShippedTextures[0]);
+		const std::vector<uint8_t> Noise = MakeNoiseDDS();
+
+		std::vector<uint8_t> Serial;
+		std::vector<uint8_t> SerialNoise;
+		SupercompressedTexture::Encode(Raw.data(), Raw.size(), Serial);
+		SupercompressedTexture::Encode(Noise.data(), Noise.size(), SerialNoise);
+
+		JobSystem Jobs;
+		Jobs.Init(3);
+
+		std::vector<uint8_t> Parallel;
+		Check(RoundTrip(Raw, Parallel), Name, ShippedTextures[0]);
+		Check(Serial == Parallel, Name, "parallel encode differs from the serial encode");
+
+		Check(RoundTrip(Noise, Parallel), Name, "random RGBA");
+		Check(SerialNoise == Parallel, Name, "parallel encode differs from the serial encode");
+	}
+
+	void TestNotSupercompressed()
+	{
+		const char* Name = "not supercompressed";
+
+		std::vector<uint8_t> Encoded;
+		const std::vector<uint8_t> Noise = MakeNoise(4096, 5);
+		Check(false == SupercompressedTexture::Encode(Noise.data(), Noise.size(), Encoded), Name, "Encode must reject data that is not a DDS");
+
+		const std::vector<uint8_t> Raw = MakeNoiseDDS();
+		Check(nullptr == SupercompressedTexture::FromMemory(Raw.data(), Raw.size()), Name, "a DDS is not a .sctx");
+		Check(nullptr == SupercompressedTexture::FromMemory(nullptr, 0), Name, "empty");
+
+		SupercompressedTexture::Encode(Raw.data(), Raw.size(), Encoded);
+		std::vector<uint8_t> Twice;
+		Check(false == SupercompressedTexture::Encode(Encoded.data(), Encoded.size(), Twice), Name, "Encode must reject a .sctx");
+	}
+
+	// 조각 표가 파일 끝을 가리키니, 어디서 잘리든 열 때 실패해야 한다.
+	void TestTruncated()
+	{
+		const char* Name = "truncated";
+
+		for (const std::vector<uint8_t>& Raw : { LoadFile(std::string(TEXTURE_DIR) + ShippedTextures[0]), MakeNoiseDDS() })
+		{
+			std::vector<uint8_t> Encoded;
+			SupercompressedTexture::Encode(Raw.data(), Raw.size(), Encoded);
+
+			bool bRejected = true;
+			for (size_t Size = 0; Size < Encoded.size(); Size++)
+			{
+				bRejected = bRejected && nullptr == SupercompressedTexture::FromMemory(Encoded.data(), Size);
+			}
+			Check(bRejected, Name, "a truncated file must not open");
+		}
+	}
+
+	void TestCorruptHeader()
+	{
+		const char* Name = "corrupt header";
+
+		const std::vector<uint8_t> Raw = MakeNoiseDDS();
+		std::vector<uint8_t> Encoded;
+		SupercompressedTexture::Encode(Raw.data(), Raw.size(), Encoded);
+
+		auto Expect = [&](const char* Message, auto&& Corrupt)
+		{
+			std::vector<uint8_t> Bytes = Encoded;
+			Corrupt(Bytes);
+			Check(nullptr == SupercompressedTexture::FromMemory(Bytes.data(), Bytes.size()), Name, Message);
+		};
+
+		Expect("magic", [](std::vector<uint8_t>& Bytes) { Bytes[0] ^= 1; });
+		Expect("version", [](std::vector<uint8_t>& Bytes) { GetHeader(Bytes).Version = 2; });
+		Expect("zero element bytes", [](std::vector<uint8_t>& Bytes) { GetHeader(Bytes).ElementBytes = 0; });
+		Expect("zero chunk bytes", [](std::vector<uint8_t>& Bytes) { GetHeader(Bytes).ChunkBytes = 0; });
+		Expect("chunk bytes larger than the encoder writes", [](std::vector<uint8_t>& Bytes) { GetHeader(Bytes).ChunkBytes *= 2; GetHeader(Bytes).ChunkCount = (GetHeader(Bytes).ChunkCount + 1) / 2; });
+		Expect("chunk count", [](std::vector<uint8_t>& Bytes) { GetHeader(Bytes).ChunkCount++; });
+		Expect("raw size", [](std::vector<uint8_t>& Bytes) { GetHeader(Bytes).RawBytes += GetHeader(Bytes).ChunkBytes; });
+		Expect("header bytes beyond raw size", [](std::vector<uint8_t>& Bytes) { GetHeader(Bytes).HeaderBytes = (uint32_t)GetHeader(Bytes).RawBytes + 1; });
+		Expect("chunk inside the table", [](std::vector<uint8_t>& Bytes) { GetChunk(Bytes, 1).Offset = sizeof(SupercompressedHeader); });
+		Expect("chunk past the end", [](std::vector<uint8_t>& Bytes) { GetChunk(Bytes, 0).Bytes = (uint32_t)Bytes.size(); });
+		Expect("chunk offset that wraps", [](std::vector<uint8_t>& Bytes) { GetChunk(Bytes, 0).Offset = ~0ull - 16; });
+	}
+
+	// 스트림 길이와 모드는 모두 확인하니 이런 손상은 Transcode가 false를 돌려줘야 한다.
+	// 길이를 지키는 안쪽 바이트 손상은 알아낼 수 없어서 죽지 않고 끝나는지만 본다.
+	void TestCorruptStreams()
+	{
+		const char* Name = "corrupt streams";
+
+		for (const char* FileName : ShippedTextures)
+		{
+			std::vector<uint8_t> Encoded;
+			const std::vector<uint8_t> Raw = LoadFile(std::string(TEXTURE_DIR) + FileName);
+			SupercompressedTexture::Encode(Raw.data(), Raw.size(), Encoded);
+			Check(Transcodes(Encoded), Name, FileName);
+
+			const uint32_t ChunkCount = GetHeader(Encoded).ChunkCount;
+			for (uint32_t Chunk = 0; Chunk < ChunkCount; Chunk++)
+			{
+				const size_t Offset = (size_t)GetChunk(Encoded, Chunk).Offset;
+
+				// 첫 스트림 머리: 원소 수 4바이트, 모드 1바이트
+				std::vector<uint8_t> Bytes = Encoded;
+				Bytes[Offset + 4] = 7;
+				Check(false == Transcodes(Bytes), Name, "unknown stream mode");
+
+				Bytes = Encoded;
+				memset(&Bytes[Offset], 0xFF, 4);
+				Check(false == Transcodes(Bytes), Name, "stream longer than the chunk");
+
+				Bytes = Encoded;
+				GetChunk(Bytes, Chunk).Bytes--;
+				Check(false == Transcodes(Bytes), Name, "chunk one byte short");
+
+				Bytes = Encoded;
+				GetChunk(Bytes, Chunk).Flags ^= ChunkFlagBytePlanes;
+				Transcodes(Bytes);
+			}
+
+			// 조각 안 아무 바이트나 뒤집는다.
+			std::mt19937 Random(6);
+			const size_t PayloadStart = (size_t)GetChunk(Encoded, 0).Offset;
+			for (int Trial = 0; Trial < 2000; Trial++)
+			{
+				std::vector<uint8_t> Bytes = Encoded;
+				const uint32_t FlipCount = 1 + Random() % 8;
+				for (uint32_t Flip = 0; Flip < FlipCount; Flip++)
+				{
+					Bytes[PayloadStart + Random() % (Bytes.size() - PayloadStart)] ^= (uint8_t)(1 + Random() % 255);
+				}
+				Transcodes(Bytes);
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestShippedTextures();
+	TestIncompressibleData();
+	TestCompressibleData();
+	TestJobSystemMatchesSerial();
+	TestNotSupercompressed();
+	TestTruncated();
+	TestCorruptHeader();
+	TestCorruptStreams();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
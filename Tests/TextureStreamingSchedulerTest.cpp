@@ -0,0 +1,241 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "TextureStreamingScheduler.h"
+
+// 요청, 예산, 로드 완료 시점, 텍스쳐 제거를 무작위로 섞어 돌리면서 스케줄러가 내는 명령을 따로 들고 있는 상태와 맞춰 본다.
+// 로드는 한 번에 한 단계, 올리는 중인 텍스쳐는 다시 올리지 않고, 로드를 낸 프레임은 예산을 넘지 않아야 한다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	bool Check(bool bCondition, const char* Message, uint64_t Frame)
+	{
+		if (false == bCondition)
+		{
+			// 한 번 어긋나면 뒤 프레임도 줄줄이 틀리니 처음 몇 개만 찍는다.
+			if (FailureCount < 16)
+			{
+				printf("FAIL: frame %llu: %s\n", (unsigned long long)Frame, Message);
+			}
+			++FailureCount;
+		}
+		return bCondition;
+	}
+
+	struct ShadowTexture
+	{
+		std::vector<uint64_t> MipBytes;
+		uint32_t TailMip = 0;
+		uint32_t ResidentMip = 0;
+		bool bPending = false;
+		bool bRemoved = false;
+	};
+
+	uint64_t GetChainBytes(const ShadowTexture& Texture, uint32_t Mip)
+	{
+		uint64_t Bytes = 0;
+		for (uint32_t i = Mip; i < (uint32_t)Texture.MipBytes.size(); i++)
+		{
+			Bytes += Texture.MipBytes[i];
+		}
+		return Bytes;
+	}
+
+	// 스케줄러 밖에서 본 사용량. 올리는 중인 밉까지 센다.
+	uint64_t GetUsedBytes(const std::vector<ShadowTexture>& Textures)
+	{
+		uint64_t Bytes = 0;
+		for (const ShadowTexture& Texture : Textures)
+		{
+			if (Texture.bRemoved)
+			{
+				continue;
+			}
+
+			Bytes += GetChainBytes(Texture, Texture.ResidentMip - (Texture.bPending ? 1 : 0));
+		}
+		return Bytes;
+	}
+
+	uint32_t AddTexture(TextureStreamingScheduler& Scheduler, std::vector<ShadowTexture>& Textures, std::mt19937& Random)
+	{
+		// 16 ~ 2048 크기의 BC1 체인
+		const uint32_t MipCount = 5 + Random() % 8;
+		const uint32_t TailMipCount = 1 + Random() % 4;
+
+		ShadowTexture Texture;
+		for (uint32_t Mip = 0; Mip < MipCount; Mip++)
+		{
+			const uint64_t Size = std::max<uint64_t>((1ull << (MipCount - 1 - Mip)) / 4, 1);
+			Texture.MipBytes.push_back(Size * Size * 8);
+		}
+		Texture.TailMip = MipCount - std::min(TailMipCount, MipCount);
+		Texture.ResidentMip = Texture.TailMip;
+
+		const uint32_t Index = Scheduler.AddTexture(Texture.MipBytes.data(), MipCount, TailMipCount);
+		Textures.push_back(std::move(Texture));
+		return Index;
+	}
+
+	void TestRandomFrames(uint32_t Seed)
+	{
+		std::mt19937 Random(Seed);
+
+		TextureStreamingScheduler Scheduler;
+		std::vector<ShadowTexture> Textures;
+
+		const uint32_t MaxLoadsPerFrame = 1 + Seed % 6;
+		Scheduler.SetMaxLoadsPerFrame(MaxLoadsPerFrame);
+
+		uint64_t Budget = 8ull * 1024 * 1024;
+		Scheduler.SetBudget(Budget);
+
+		for (uint32_t i = 0; i < 48; i++)
+		{
+			AddTexture(Scheduler, Textures, Random);
+		}
+
+		std::vector<TextureStreamingCommand> Commands;
+		std::vector<uint32_t> PendingLoads;
+		std::vector<bool> LoadedThisFrame;
+
+		uint32_t TotalLoads = 0;
+		uint32_t TotalEvicts = 0;
+
+		for (uint64_t Frame = 1; Frame <= 2000 && FailureCount < 16; Frame++)
+		{
+			// 가끔 예산을 크게 바꿔서 올리는 중에 예산이 줄어드는 경우도 만든다.
+			if (0 == Random() % 97)
+			{
+				Budget = (1ull + Random() % 16) * 1024 * 1024;
+				Scheduler.SetBudget(Budget);
+			}
+
+			if (0 == Random() % 53)
+			{
+				AddTexture(Scheduler, Textures, Random);
+			}
+
+			if (0 == Random() % 131)
+			{
+				const uint32_t Texture = Random() % (uint32_t)Textures.size();
+				if (false == Textures[Texture].bRemoved)
+				{
+					Scheduler.RemoveTexture(Texture);
+					Textures[Texture].bRemoved = true;
+					Textures[Texture].bPending = false;
+					PendingLoads.erase(std::remove(PendingLoads.begin(), PendingLoads.end(), Texture), PendingLoads.end());
+				}
+			}
+
+			// 보이는 텍스쳐 집합은 조금씩 바뀌고, 같은 텍스쳐를 한 프레임에 여러 번 요청하기도 한다.
+			const uint32_t VisibleStart = (uint32_t)(Frame / 40) % (uint32_t)Textures.size();
+			for (uint32_t i = 0; i < 20; i++)
+			{
+				const uint32_t Texture = (VisibleStart + i * 3) % (uint32_t)Textures.size();
+				const uint32_t Requests = 1 + Random() % 2;
+				for (uint32_t Request = 0; Request < Requests; Request++)
+				{
+					Scheduler.RequestMip(Texture, Random() % (uint32_t)Textures[Texture].MipBytes.size());
+				}
+			}
+
+			Scheduler.Update(Frame, Commands);
+
+			LoadedThisFrame.assign(Textures.size(), false);
+			uint32_t LoadCount = 0;
+
+			for (const TextureStreamingCommand& Command : Commands)
+			{
+				if (false == Check(Command.Texture < Textures.size(), "command for unknown texture", Frame))
+				{
+					continue;
+				}
+
+				ShadowTexture& Texture = Textures[Command.Texture];
+				Check(false == Texture.bRemoved, "command for removed texture", Frame);
+
+				if (Command.Action == TextureStreamingAction::Load)
+				{
+					Check(false == Texture.bPending && false == LoadedThisFrame[Command.Texture], "texture loaded twice", Frame);
+					Check(Command.Mip + 1 == Texture.ResidentMip, "load skipped a mip", Frame);
+
+					Texture.bPending = true;
+					LoadedThisFrame[Command.Texture] = true;
+					PendingLoads.push_back(Command.Texture);
+					++LoadCount;
+				}
+				else
+				{
+					Check(false == Texture.bPending, "evicted a texture that is loading", Frame);
+					Check(Command.Mip > Texture.ResidentMip && Command.Mip <= Texture.TailMip, "evict outside the streamed mips", Frame);
+
+					Texture.ResidentMip = Command.Mip;
+					++TotalEvicts;
+				}
+			}
+
+			const TextureStreamingStats& Stats = Scheduler.GetStats();
+			Check(LoadCount <= MaxLoadsPerFrame, "too many loads in one frame", Frame);
+			Check(Stats.LoadCount == LoadCount, "load count does not match commands", Frame);
+			Check(Stats.UsedBytes == GetUsedBytes(Textures), "used bytes drifted from the commands", Frame);
+			Check(Stats.PendingLoadCount == (uint32_t)PendingLoads.size(), "pending load count drifted", Frame);
+
+			// 예산을 줄인 직후에는 올리는 중인 밉을 못 내려서 넘칠 수 있지만, 그런 프레임에 새로 올리면 안 된다.
+			if (LoadCount > 0)
+			{
+				Check(Stats.UsedBytes <= Budget, "loaded while over budget", Frame);
+			}
+
+			TotalLoads += LoadCount;
+
+			// 로드는 순서와 상관없이 몇 프레임 늦게 끝난다.
+			std::shuffle(PendingLoads.begin(), PendingLoads.end(), Random);
+			const size_t CompleteCount = PendingLoads.empty() ? 0 : Random() % (PendingLoads.size() + 1);
+			for (size_t i = 0; i < CompleteCount; i++)
+			{
+				const uint32_t Texture = PendingLoads.back();
+				PendingLoads.pop_back();
+
+				Scheduler.CompleteLoad(Texture);
+				Textures[Texture].bPending = false;
+				Textures[Texture].ResidentMip--;
+			}
+
+			for (uint32_t i = 0; i < (uint32_t)Textures.size(); i++)
+			{
+				if (false == Textures[i].bRemoved)
+				{
+					Check(Scheduler.GetResidentMip(i) == Textures[i].ResidentMip, "resident mip drifted", Frame);
+				}
+			}
+		}
+
+		// 아무 일도 안 했으면 위 검사가 의미가 없다.
+		Check(TotalLoads > 100 && TotalEvicts > 10, "random run did not exercise loads and evicts", 0);
+		printf("seed %u: %u loads, %u evicts\n", Seed, TotalLoads, TotalEvicts);
+	}
+
+	void TestComputeRequiredMip()
+	{
+		Check(0 == TextureStreamingScheduler::ComputeRequiredMip(512, 600.0f, 10), "magnified texture needs mip 0", 0);
+		Check(1 == TextureStreamingScheduler::ComputeRequiredMip(512, 256.0f, 10), "half size needs mip 1", 0);
+		Check(2 == TextureStreamingScheduler::ComputeRequiredMip(512, 100.0f, 10), "100 pixels needs mip 2", 0);
+		Check(9 == TextureStreamingScheduler::ComputeRequiredMip(512, 0.5f, 10), "sub-pixel needs the last mip", 0);
+	}
+}
+
+int main()
+{
+	for (uint32_t Seed = 1; Seed <= 8; Seed++)
+	{
+		TestRandomFrames(Seed);
+	}
+	TestComputeRequiredMip();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
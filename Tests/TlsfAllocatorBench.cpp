@@ -0,0 +1,205 @@
+#include <cstdio>
+#include <map>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include "TlsfAllocator.h"
+
+// GPU 힙처럼 쓰는 경우를 흉내 내서 할당/해제를 섞어 돌리고 처리량과 남은 조각을 찍는다.
+// 비교용으로 오프셋 순 std::map에서 앞부터 찾는 first-fit을 같은 순서로 돌린다.
+//   cmake -S Tests -B Build/Tests -DCMAKE_BUILD_TYPE=Release && cmake --build Build/Tests --target TlsfAllocatorBench
+
+namespace
+{
+	const uint64_t InvalidOffset = UINT64_MAX;
+
+	class FirstFitAllocator
+	{
+	public:
+		void Init(uint64_t Size)
+		{
+			FreeBlocks.clear();
+			FreeBlocks[0] = Size;
+		}
+
+		uint64_t Allocate(uint64_t Bytes, uint64_t Alignment)
+		{
+			for (auto It = FreeBlocks.begin(); It != FreeBlocks.end(); ++It)
+			{
+				const uint64_t Start = It->first;
+				const uint64_t End = It->first + It->second;
+				const uint64_t Offset = (Start + Alignment - 1) & ~(Alignment - 1);
+				if (Offset + Bytes > End)
+				{
+					continue;
+				}
+
+				FreeBlocks.erase(It);
+				if (Offset > Start)
+				{
+					FreeBlocks[Start] = Offset - Start;
+				}
+				if (End > Offset + Bytes)
+				{
+					FreeBlocks[Offset + Bytes] = End - Offset - Bytes;
+				}
+				return Offset;
+			}
+			return InvalidOffset;
+		}
+
+		void Free(uint64_t Offset, uint64_t Bytes)
+		{
+			auto It = FreeBlocks.emplace(Offset, Bytes).first;
+
+			auto Next = std::next(It);
+			if (Next != FreeBlocks.end() && It->first + It->second == Next->first)
+			{
+				It->second += Next->second;
+				FreeBlocks.erase(Next);
+			}
+
+			if (It != FreeBlocks.begin())
+			{
+				auto Prev = std::prev(It);
+				if (Prev->first + Prev->second == It->first)
+				{
+					Prev->second += It->second;
+					FreeBlocks.erase(It);
+				}
+			}
+		}
+
+		uint64_t GetLargestFreeBlock() const
+		{
+			uint64_t Largest = 0;
+			for (const auto& Pair : FreeBlocks)
+			{
+				Largest = std::max(Largest, Pair.second);
+			}
+			return Largest;
+		}
+
+		size_t GetFreeBlockCount() const
+		{
+			return FreeBlocks.size();
+		}
+
+	private:
+		std::map<uint64_t, uint64_t> FreeBlocks;
+	};
+
+	// 256MB 힙, 4KB 단위 4KB~256KB 자원을 64KB 정렬로. 슬롯 하나를 번갈아 잡고 풀어서 살아 있는 자원이 평균 절반쯤 된다.
+	const uint64_t HeapSize = 256ull * 1024 * 1024;
+	const uint64_t Granularity = 4096;
+	const uint64_t Alignment = 65536;
+	const uint32_t SlotCount = 2000;
+	const uint32_t OperationCount = 2000000;
+
+	struct Workload
+	{
+		std::vector<uint64_t> Sizes;
+		std::vector<uint32_t> Slots;
+	};
+
+	Workload MakeWorkload(uint32_t Seed)
+	{
+		std::mt19937 Random(Seed);
+
+		Workload Result;
+		Result.Sizes.resize(OperationCount);
+		Result.Slots.resize(OperationCount);
+		for (uint32_t i = 0; i < OperationCount; i++)
+		{
+			Result.Sizes[i] = (Random() % 64 + 1) * Granularity;
+			Result.Slots[i] = Random() % SlotCount;
+		}
+		return Result;
+	}
+
+	void Report(const char* Name, double Milliseconds, uint32_t Failed, uint64_t FreeBytes, uint64_t Largest, size_t FreeBlockCount)
+	{
+		printf("%-10s %8.1f ms  %6.1f ns/op  %5.2f Mops/s  failed %6u  free blocks %5zu  largest/free %.3f\n",
+			Name, Milliseconds, Milliseconds * 1e6 / OperationCount, OperationCount / Milliseconds / 1000.0,
+			Failed, FreeBlockCount, FreeBytes ? (double)Largest / FreeBytes : 1.0);
+	}
+
+	void RunTlsf(const Workload& Work)
+	{
+		TlsfAllocator Allocator;
+		Allocator.Init(HeapSize, Granularity);
+
+		std::vector<uint32_t> Handles(SlotCount, TlsfAllocator::InvalidHandle);
+		uint32_t Failed = 0;
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < OperationCount; i++)
+		{
+			uint32_t& Handle = Handles[Work.Slots[i]];
+			if (Handle != TlsfAllocator::InvalidHandle)
+			{
+				Allocator.Free(Handle);
+				Handle = TlsfAllocator::InvalidHandle;
+			}
+			else
+			{
+				Handle = Allocator.Allocate(Work.Sizes[i], Alignment);
+				Failed += Handle == TlsfAllocator::InvalidHandle ? 1 : 0;
+			}
+		}
+		const double Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+		const TlsfStats& Stats = Allocator.GetStats();
+		Report("tlsf", Milliseconds, Failed, Stats.Size - Stats.UsedBytes, Allocator.GetLargestFreeBlock(), Stats.FreeBlockCount);
+	}
+
+	void RunFirstFit(const Workload& Work)
+	{
+		FirstFitAllocator Allocator;
+		Allocator.Init(HeapSize);
+
+		std::vector<uint64_t> Offsets(SlotCount, InvalidOffset);
+		std::vector<uint64_t> Sizes(SlotCount, 0);
+		uint64_t UsedBytes = 0;
+		uint32_t Failed = 0;
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < OperationCount; i++)
+		{
+			const uint32_t Slot = Work.Slots[i];
+			if (Offsets[Slot] != InvalidOffset)
+			{
+				Allocator.Free(Offsets[Slot], Sizes[Slot]);
+				UsedBytes -= Sizes[Slot];
+				Offsets[Slot] = InvalidOffset;
+			}
+			else
+			{
+				Offsets[Slot] = Allocator.Allocate(Work.Sizes[i], Alignment);
+				if (Offsets[Slot] == InvalidOffset)
+				{
+					++Failed;
+					continue;
+				}
+
+				Sizes[Slot] = Work.Sizes[i];
+				UsedBytes += Sizes[Slot];
+			}
+		}
+		const double Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+		Report("first-fit", Milliseconds, Failed, HeapSize - UsedBytes, Allocator.GetLargestFreeBlock(), Allocator.GetFreeBlockCount());
+	}
+}
+
+int main()
+{
+	const Workload Work = MakeWorkload(7);
+
+	printf("%u operations, %u slots, %llu MB heap\n", OperationCount, SlotCount, (unsigned long long)(HeapSize >> 20));
+	RunTlsf(Work);
+	RunFirstFit(Work);
+	return 0;
+}
@@ -0,0 +1,246 @@
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "TlsfAllocator.h"
+
+// 할당, 해제, 이웃 빈 블록 합치기, 조각난 힙에서의 실패를 손으로 짠 순서로 보고, 무작위 할당/해제를 따로 들고 있는 목록과 맞춰 본다.
+
+namespace
+{
+	int FailureCount = 0;
+
+	void Check(bool bCondition, const char* Name, const char* Message)
+	{
+		if (false == bCondition)
+		{
+			printf("FAIL: %s: %s\n", Name, Message);
+			++FailureCount;
+		}
+	}
+
+	void TestAllocateFree()
+	{
+		const char* Name = "allocate";
+
+		TlsfAllocator Allocator;
+		Allocator.Init(1024 * 1024 + 100, 256);
+		Check(1024 * 1024 == Allocator.GetStats().Size, Name, "size is rounded down to the granularity");
+
+		const uint32_t First = Allocator.Allocate(1000, 1);
+		Check(0 == Allocator.GetOffset(First) && 1024 == Allocator.GetSize(First), Name, "size is rounded up to the granularity");
+
+		const uint32_t Second = Allocator.Allocate(0, 16);
+		Check(1024 == Allocator.GetOffset(Second) && 256 == Allocator.GetSize(Second), Name, "zero bytes still takes one granule");
+
+		Check(1280 == Allocator.GetStats().UsedBytes && 2 == Allocator.GetStats().AllocationCount, Name, "used bytes");
+		Check(TlsfAllocator::InvalidHandle == Allocator.Allocate(1024 * 1024, 1), Name, "allocation larger than the free space");
+
+		int Tags[2] = {};
+		Allocator.SetUserData(First, &Tags[0]);
+		Allocator.SetUserData(Second, &Tags[1]);
+
+		std::vector<uint32_t> Handles;
+		Allocator.GetAllocations(Handles);
+		Check(2 == Handles.size() && Second == Handles[0] && First == Handles[1], Name, "allocations are listed from the highest offset");
+		Check(&Tags[0] == Allocator.GetUserData(First) && &Tags[1] == Allocator.GetUserData(Second), Name, "user data");
+
+		Allocator.Free(First);
+		Allocator.Free(Second);
+		Check(Allocator.IsEmpty() && 0 == Allocator.GetStats().UsedBytes, Name, "empty after freeing everything");
+		Check(1 == Allocator.GetStats().FreeBlockCount && 1024 * 1024 == Allocator.GetLargestFreeBlock(), Name, "free space is one block again");
+
+		// 지운 블록 번호는 다시 쓰지만 사용자 값은 넘어오지 않는다.
+		const uint32_t Reused = Allocator.Allocate(256, 1);
+		Check(nullptr == Allocator.GetUserData(Reused), Name, "reused handle must not keep old user data");
+	}
+
+	void TestAlignment()
+	{
+		const char* Name = "alignment";
+
+		TlsfAllocator Allocator;
+		Allocator.Init(1024 * 1024, 256);
+
+		Allocator.Allocate(256, 1);
+		const uint32_t Aligned = Allocator.Allocate(256, 4096);
+		Check(4096 == Allocator.GetOffset(Aligned), Name, "aligned offset");
+
+		// 256 ~ 4096 틈은 빈 블록으로 남고 사용량에 들어가지 않는다.
+		Check(512 == Allocator.GetStats().UsedBytes, Name, "alignment gap is not counted as used");
+		Check(2 == Allocator.GetStats().FreeBlockCount, Name, "alignment gap becomes a free block");
+
+		// 정렬이 Granularity보다 작으면 Granularity로 본다.
+		const uint32_t Small = Allocator.Allocate(1, 4);
+		Check(0 == Allocator.GetOffset(Small) % 256, Name, "alignment below the granularity");
+	}
+
+	void TestCoalesce()
+	{
+		const char* Name = "coalesce";
+
+		TlsfAllocator Allocator;
+		Allocator.Init(65536, 256);
+
+		uint32_t Handles[4];
+		for (int i = 0; i < 4; i++)
+		{
+			Handles[i] = Allocator.Allocate(4096, 1);
+			Check(4096ull * i == Allocator.GetOffset(Handles[i]), Name, "blocks are packed from the start");
+		}
+		Check(1 == Allocator.GetStats().FreeBlockCount && 49152 == Allocator.GetLargestFreeBlock(), Name, "only the tail is free");
+
+		Allocator.Free(Handles[0]);
+		Allocator.Free(Handles[2]);
+		Check(3 == Allocator.GetStats().FreeBlockCount, Name, "separated free blocks stay apart");
+
+		// 가운데를 풀면 앞뒤 빈 블록과 하나가 된다.
+		Allocator.Free(Handles[1]);
+		Check(2 == Allocator.GetStats().FreeBlockCount, Name, "freeing between two free blocks merges all three");
+
+		const uint32_t Merged = Allocator.Allocate(12288, 1);
+		Check(Merged != TlsfAllocator::InvalidHandle, Name, "merged block can be allocated");
+		if (Merged != TlsfAllocator::InvalidHandle)
+		{
+			Allocator.Free(Merged);
+		}
+
+		Allocator.Free(Handles[3]);
+		Check(1 == Allocator.GetStats().FreeBlockCount && 65536 == Allocator.GetLargestFreeBlock(), Name, "freeing the last block merges with the tail");
+	}
+
+	void TestFragmentation()
+	{
+		const char* Name = "fragmentation";
+
+		TlsfAllocator Allocator;
+		Allocator.Init(64 * 4096, 256);
+
+		std::vector<uint32_t> Handles;
+		for (int i = 0; i < 64; i++)
+		{
+			Handles.push_back(Allocator.Allocate(4096, 1));
+		}
+		Check(TlsfAllocator::InvalidHandle == Allocator.Allocate(1, 1), Name, "heap is full");
+
+		// 하나 걸러 풀면 절반이 비어도 두 칸짜리는 못 들어간다. 빈 블록은 모두 4096에서 8192 단위로 어긋나 있다.
+		for (int i = 1; i < 64; i += 2)
+		{
+			Allocator.Free(Handles[i]);
+		}
+		Check(32 == Allocator.GetStats().FreeBlockCount && 4096 == Allocator.GetLargestFreeBlock(), Name, "free space is split into 32 blocks");
+		Check(TlsfAllocator::InvalidHandle == Allocator.Allocate(8192, 1), Name, "no free block is large enough");
+		Check(TlsfAllocator::InvalidHandle == Allocator.Allocate(4096, 8192), Name, "no free block is 8192 aligned");
+
+		const uint32_t Fits = Allocator.Allocate(4096, 1);
+		Check(Fits != TlsfAllocator::InvalidHandle, Name, "exact-size block still fits");
+		if (Fits != TlsfAllocator::InvalidHandle)
+		{
+			Check(4096 == Allocator.GetOffset(Fits) % 8192, Name, "exact-size block comes from a freed slot");
+			Allocator.Free(Fits);
+		}
+
+		for (int i = 0; i < 64; i += 2)
+		{
+			Allocator.Free(Handles[i]);
+		}
+		Check(Allocator.IsEmpty() && 1 == Allocator.GetStats().FreeBlockCount, Name, "all blocks merge back into one");
+	}
+
+	// 살아 있는 할당 목록을 따로 들고 무작위로 할당/해제하면서 겹침, 정렬, 통계를 본다.
+	void TestRandom()
+	{
+		const char* Name = "random";
+
+		struct LiveBlock
+		{
+			uint64_t Offset;
+			uint64_t Size;
+		};
+
+		for (uint32_t Seed = 0; Seed < 200; Seed++)
+		{
+			std::mt19937_64 Random(Seed);
+			const uint64_t Granularity = 1ull << (Random() % 14);
+			const uint64_t Size = (Random() % (1 << 20) + 1) * Granularity;
+
+			TlsfAllocator Allocator;
+			Allocator.Init(Size, Granularity);
+
+			std::map<uint32_t, LiveBlock> Live;
+			bool bValid = true;
+
+			for (uint32_t Step = 0; Step < 3000 && bValid; Step++)
+			{
+				if (Live.empty() || Random() % 100 < 55)
+				{
+					const uint64_t Bytes = 0 == Random() % 4 ? Random() % (Size / 4 + 1) : Random() % (64 * Granularity) + 1;
+					const uint64_t Alignment = 1ull << (Random() % 18);
+
+					const uint32_t Handle = Allocator.Allocate(Bytes, Alignment);
+					if (Handle == TlsfAllocator::InvalidHandle)
+					{
+						continue;
+					}
+
+					const uint64_t Offset = Allocator.GetOffset(Handle);
+					const uint64_t BlockSize = Allocator.GetSize(Handle);
+
+					bValid = bValid && 0 == Live.count(Handle);
+					bValid = bValid && 0 == Offset % std::max(Alignment, Granularity) && BlockSize >= Bytes && 0 == BlockSize % Granularity && Offset + BlockSize <= Size;
+					for (const auto& Pair : Live)
+					{
+						bValid = bValid && (Offset + BlockSize <= Pair.second.Offset || Pair.second.Offset + Pair.second.Size <= Offset);
+					}
+					Live[Handle] = { Offset, BlockSize };
+				}
+				else
+				{
+					auto It = Live.begin();
+					std::advance(It, Random() % Live.size());
+					Allocator.Free(It->first);
+					Live.erase(It);
+				}
+
+				uint64_t UsedBytes = 0;
+				for (const auto& Pair : Live)
+				{
+					UsedBytes += Pair.second.Size;
+				}
+				bValid = bValid && Allocator.GetStats().UsedBytes == UsedBytes && Allocator.GetStats().AllocationCount == Live.size();
+			}
+			Check(bValid, Name, "allocations overlapped, were misaligned or stats drifted");
+
+			// 가장 큰 빈 블록은 정렬 없이 항상 잡을 수 있어야 한다.
+			const uint64_t Largest = Allocator.GetLargestFreeBlock();
+			if (Largest > 0)
+			{
+				const uint32_t Handle = Allocator.Allocate(Largest, 1);
+				Check(Handle != TlsfAllocator::InvalidHandle, Name, "largest free block must be allocatable");
+				if (Handle != TlsfAllocator::InvalidHandle)
+				{
+					Allocator.Free(Handle);
+				}
+			}
+
+			for (const auto& Pair : Live)
+			{
+				Allocator.Free(Pair.first);
+			}
+			Check(Allocator.IsEmpty() && 1 == Allocator.GetStats().FreeBlockCount && Size == Allocator.GetLargestFreeBlock(), Name, "free space did not merge back into one block");
+		}
+	}
+}
+
+int main()
+{
+	TestAllocateFree();
+	TestAlignment();
+	TestCoalesce();
+	TestFragmentation();
+	TestRandom();
+
+	printf("%s\n", 0 == FailureCount ? "PASS" : "FAILED");
+	return 0 == FailureCount ? 0 : 1;
+}
@@ -0,0 +1,518 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <fbxsdk.h>
+#include "FrameResource.h"
+#include "VertexWelder.h"
+#include "FbxLayerElementReader.h"
+#include "Skeleton.h"
+
+// FbxLoader::ProcessPolygon이 메쉬마다 하는 일을 떼어서 예전 방식과 시간을 비교한다.
+//   FbxImportBench <입력.fbx> [--repeat 횟수]
+// 코너 읽기는 코너마다 SDK에 노멀과 UV를 묻던 방식과 레이어 배열을 잠가서 바로 읽는 방식을, 용접은 VertexWelder와 std::unordered_map을 비교한다.
+// 스킨이 있는 메쉬는 위치 해시로 Vertex를 하나씩 찾아 무게를 넣던 방식과 LoadSkin처럼 Control Point -> Vertex 테이블을 도는 방식도 비교한다.
+// 큰 모델과 뼈가 많은 리그는 Tools/FbxSynth로 만든다. 전부 한 스레드로 재니까 FbxLoader가 메쉬와 삼각형 구간을 JobSystem에 나누는 효과는 빠져 있다.
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct BenchOptions
+	{
+		std::string Input;
+		int Repeat = 3;
+	};
+
+	// std::hash<Vertex>와 같은 해시. 그쪽은 FrameResource.cpp에 있어서 D3D까지 끌려오니 여기서 다시 쓴다.
+	struct VertexHash
+	{
+		size_t operator()(const Vertex& V) const
+		{
+			return (size_t)VertexWelder::HashKey(VertexWelder::MakeKey(V, 0.0f));
+		}
+	};
+
+	double ElapsedMs(Clock::time_point Start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+	}
+
+	void PrintUsage()
+	{
+		printf("FbxImportBench <input.fbx> [--repeat count]\n");
+	}
+
+	bool ParseOptions(int argc, char** argv, BenchOptions& OutOptions)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string Arg = argv[i];
+			if (Arg == "--repeat" && i + 1 < argc)
+			{
+				OutOptions.Repeat = std::max(1, atoi(argv[++i]));
+			}
+			else if (OutOptions.Input.empty() && Arg[0] != '-')
+			{
+				OutOptions.Input = Arg;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return false == OutOptions.Input.empty();
+	}
+
+	void CollectMeshes(FbxNode* Node, std::vector<FbxMesh*>& OutMeshes)
+	{
+		FbxNodeAttribute* Attribute = Node->GetNodeAttribute();
+		if (Attribute && Attribute->GetAttributeType() == FbxNodeAttribute::eMesh)
+		{
+			OutMeshes.push_back(Node->GetMesh());
+		}
+
+		for (int i = 0; i < Node->GetChildCount(); i++)
+		{
+			CollectMeshes(Node->GetChild(i), OutMeshes);
+		}
+	}
+
+	Vertex MakeCorner(const FbxVector4& Position, const FbxVector4& Normal, const FbxVector2& TexCoord)
+	{
+		Vertex Corner = {};
+		Corner.Pos = XMFLOAT3((float)Position[0], (float)Position[1], (float)Position[2]);
+		Corner.Normal = XMFLOAT3((float)Normal[0], (float)Normal[1], (float)Normal[2]);
+		Corner.TexCoord = XMFLOAT2((float)TexCoord[0], -(float)TexCoord[1]);
+		return Corner;
+	}
+
+	// 레이어 요소를 풀어두기 전처럼 코너마다 GetPolygonVertexNormal, GetUVSetNames, GetPolygonVertexUV를 부른다.
+	void ReadCornersPerQuery(FbxMesh* Mesh, std::vector<Vertex>& OutCorners)
+	{
+		const int PolygonCount = Mesh->GetPolygonCount();
+		OutCorners.resize((size_t)PolygonCount * 3);
+
+		for (int i = 0; i < PolygonCount; i++)
+		{
+			for (int j = 0; j < 3; j++)
+			{
+				const FbxVector4 Position = Mesh->GetControlPointAt(Mesh->GetPolygonVertex(i, j));
+
+				FbxVector4 Normal(0.0, 1.0, 0.0);
+				Mesh->GetPolygonVertexNormal(i, j, Normal);
+
+				FbxStringList UVNames;
+				Mesh->GetUVSetNames(UVNames);
+
+				FbxVector2 TexCoord(0.0, 0.0);
+				bool bUnmapped = false;
+				if (UVNames.GetCount() > 0)
+				{
+					Mesh->GetPolygonVertexUV(i, j, UVNames[0], TexCoord, bUnmapped);
+				}
+
+				OutCorners[i * 3 + j] = MakeCorner(Position, Normal, TexCoord);
+			}
+		}
+	}
+
+	// ProcessPolygon과 같은 방식. 배열을 잠그고 매핑은 메쉬마다 한 번만 푼다.
+	void ReadCornersBulk(FbxMesh* Mesh, std::vector<Vertex>& OutCorners, std::vector<int>& OutCornerControlPoints)
+	{
+		const int PolygonCount = Mesh->GetPolygonCount();
+		OutCorners.resize((size_t)PolygonCount * 3);
+		OutCornerControlPoints.resize((size_t)PolygonCount * 3);
+
+		const FbxVector4* ControlPoints = Mesh->GetControlPoints();
+		const int* PolygonVertices = Mesh->GetPolygonVertices();
+
+		LayerElementReader<FbxVector4> Normals(Mesh->GetElementNormal(0));
+		LayerElementReader<FbxVector2> TexCoords(Mesh->GetElementUV(0));
+
+		for (int i = 0; i < PolygonCount; i++)
+		{
+			const int PolygonStart = Mesh->GetPolygonVertexIndex(i);
+
+			for (int j = 0; j < 3; j++)
+			{
+				const int ControlPoint = PolygonVertices[PolygonStart + j];
+				const FbxVector4 Normal = Normals.IsValid() ? Normals.Get(ControlPoint, i, PolygonStart + j) : FbxVector4(0.0, 1.0, 0.0);
+				const FbxVector2 TexCoord = TexCoords.IsValid() ? TexCoords.Get(ControlPoint, i, PolygonStart + j) : FbxVector2(0.0, 0.0);
+
+				OutCorners[i * 3 + j] = MakeCorner(ControlPoints[ControlPoint], Normal, TexCoord);
+				OutCornerControlPoints[i * 3 + j] = ControlPoint;
+			}
+		}
+	}
+
+	struct WeldResult
+	{
+		double Ms = 0.0;
+		size_t VertexCount = 0;
+		size_t Bytes = 0;
+		size_t ProbeCount = 0;
+	};
+
+	WeldResult WeldOpenAddressing(const std::vector<Vertex>& Corners)
+	{
+		WeldResult Result;
+		std::vector<Vertex> Vertices;
+
+		const Clock::time_point Start = Clock::now();
+		VertexWelder Welder(Vertices);
+		Welder.Reserve(Corners.size());
+		for (const Vertex& Corner : Corners)
+		{
+			Welder.Insert(Corner);
+		}
+		Result.Ms = ElapsedMs(Start);
+
+		Result.VertexCount = Vertices.size();
+		Result.Bytes = Welder.GetMemoryUsage();
+		Result.ProbeCount = Welder.GetProbeCount();
+		return Result;
+	}
+
+	WeldResult WeldNodeMap(const std::vector<Vertex>& Corners)
+	{
+		WeldResult Result;
+		std::vector<Vertex> Vertices;
+
+		const Clock::time_point Start = Clock::now();
+		std::unordered_map<Vertex, uint32_t, VertexHash> NodeMap;
+		NodeMap.reserve(Corners.size());
+		for (const Vertex& Corner : Corners)
+		{
+			if (NodeMap.emplace(Corner, (uint32_t)Vertices.size()).second)
+			{
+				Vertices.push_back(Corner);
+			}
+		}
+		Result.Ms = ElapsedMs(Start);
+
+		// 노드 하나 = 값 + next 포인터 + 캐시된 해시, 버킷 하나 = 포인터
+		Result.VertexCount = Vertices.size();
+		Result.Bytes = NodeMap.size() * (sizeof(std::pair<const Vertex, uint32_t>) + 2 * sizeof(void*)) + NodeMap.bucket_count() * sizeof(void*);
+		return Result;
+	}
+
+	struct ClusterView
+	{
+		const int* ControlPoints = nullptr;
+		const double* Weights = nullptr;
+		int Count = 0;
+	};
+
+	// ProcessPolygon처럼 Control Point를 Group으로 넘겨 용접하고 Control Point -> Vertex 역참조 테이블을 CSR로 만든다.
+	struct SkinnedMesh
+	{
+		std::vector<Vertex> Vertices;
+		std::vector<XMFLOAT3> ControlPointPositions;
+		std::vector<uint32_t> ControlPointVertexOffsets;
+		std::vector<uint32_t> ControlPointVertices;
+		std::vector<ClusterView> Clusters;
+	};
+
+	void BuildSkinnedMesh(const std::vector<Vertex>& Corners, const std::vector<int>& CornerControlPoints, SkinnedMesh& OutMesh)
+	{
+		const size_t ControlPointCount = OutMesh.ControlPointPositions.size();
+
+		std::vector<int> VertexControlPoints;
+		VertexWelder Welder(OutMesh.Vertices);
+		Welder.Reserve(Corners.size());
+		for (size_t Corner = 0; Corner < Corners.size(); Corner++)
+		{
+			if (Welder.Insert(Corners[Corner], (uint32_t)CornerControlPoints[Corner]) == VertexControlPoints.size())
+			{
+				VertexControlPoints.push_back(CornerControlPoints[Corner]);
+			}
+		}
+
+		std::vector<uint32_t>& Offsets = OutMesh.ControlPointVertexOffsets;
+		Offsets.assign(ControlPointCount + 1, 0);
+		for (int ControlPoint : VertexControlPoints)
+		{
+			Offsets[ControlPoint + 1]++;
+		}
+		for (size_t i = 1; i < Offsets.size(); i++)
+		{
+			Offsets[i] += Offsets[i - 1];
+		}
+
+		std::vector<uint32_t> FillOffsets(Offsets.begin(), Offsets.end() - 1);
+		OutMesh.ControlPointVertices.resize(VertexControlPoints.size());
+		for (uint32_t i = 0; i < (uint32_t)VertexControlPoints.size(); i++)
+		{
+			OutMesh.ControlPointVertices[FillOffsets[VertexControlPoints[i]]++] = i;
+		}
+	}
+
+	struct PositionKey
+	{
+		XMFLOAT3 Pos;
+
+		bool operator==(const PositionKey& Rhs) const
+		{
+			return Pos.x == Rhs.Pos.x && Pos.y == Rhs.Pos.y && Pos.z == Rhs.Pos.z;
+		}
+	};
+
+	struct PositionKeyHash
+	{
+		size_t operator()(const PositionKey& Key) const
+		{
+			std::hash<float> Hasher;
+			return Hasher(Key.Pos.x) ^ (Hasher(Key.Pos.y) << 1) ^ (Hasher(Key.Pos.z) << 2);
+		}
+	};
+
+	// 예전 LoadAnimation처럼 클러스터의 Control Point마다 위치로 Vertex 하나를 찾아 빈 슬롯에 무게를 넣는다.
+	// 위치 테이블은 예전에는 Import 중에 이미 있던 것이라 시간에서 뺀다. 찾지 못해 무게가 하나도 없는 Vertex 수를 돌려준다.
+	size_t AssignByPositionHash(const SkinnedMesh& Mesh, std::vector<Vertex>& OutVertices, double& OutMs)
+	{
+		std::unordered_map<PositionKey, uint32_t, PositionKeyHash> PositionMap;
+		PositionMap.reserve(Mesh.Vertices.size());
+		for (uint32_t i = 0; i < (uint32_t)Mesh.Vertices.size(); i++)
+		{
+			PositionMap.emplace(PositionKey{ Mesh.Vertices[i].Pos }, i);
+		}
+
+		OutVertices = Mesh.Vertices;
+		std::vector<uint8_t> SlotCounts(OutVertices.size(), 0);
+
+		const Clock::time_point Start = Clock::now();
+		for (size_t i = 0; i < Mesh.Clusters.size(); i++)
+		{
+			const ClusterView& Cluster = Mesh.Clusters[i];
+			for (int j = 0; j < Cluster.Count; j++)
+			{
+				auto Found = PositionMap.find(PositionKey{ Mesh.ControlPointPositions[Cluster.ControlPoints[j]] });
+				if (Found == PositionMap.end() || SlotCounts[Found->second] >= 4)
+				{
+					continue;
+				}
+
+				Vertex& Target = OutVertices[Found->second];
+				const uint8_t Slot = SlotCounts[Found->second]++;
+				Target.BoneIndices[Slot] = (uint16_t)i;
+				(&Target.BoneWeights.x)[Slot] = (float)Cluster.Weights[j];
+			}
+		}
+		OutMs = ElapsedMs(Start);
+
+		return (size_t)std::count(SlotCounts.begin(), SlotCounts.end(), (uint8_t)0);
+	}
+
+	// FbxLoader::LoadSkin과 같은 방식. Control Point마다 영향을 모아 가지치기하고 갈라진 Vertex 전부에 넣는다.
+	double AssignByControlPoint(const SkinnedMesh& Mesh, const SkinImportSettings& Settings, std::vector<Vertex>& OutVertices)
+	{
+		OutVertices = Mesh.Vertices;
+		const size_t ControlPointCount = Mesh.ControlPointPositions.size();
+
+		const Clock::time_point Start = Clock::now();
+		std::vector<uint32_t> InfluenceOffsets(ControlPointCount + 1, 0);
+		for (const ClusterView& Cluster : Mesh.Clusters)
+		{
+			for (int j = 0; j < Cluster.Count; j++)
+			{
+				InfluenceOffsets[Cluster.ControlPoints[j] + 1]++;
+			}
+		}
+
+		for (size_t i = 0; i < ControlPointCount; i++)
+		{
+			InfluenceOffsets[i + 1] += InfluenceOffsets[i];
+		}
+
+		std::vector<BoneInfluence> Influences(InfluenceOffsets[ControlPointCount]);
+		std::vector<uint32_t> InfluenceCursors(InfluenceOffsets.begin(), InfluenceOffsets.end() - 1);
+		for (size_t i = 0; i < Mesh.Clusters.size(); i++)
+		{
+			const ClusterView& Cluster = Mesh.Clusters[i];
+			for (int j = 0; j < Cluster.Count; j++)
+			{
+				BoneInfluence& Influence = Influences[InfluenceCursors[Cluster.ControlPoints[j]]++];
+				Influence.Bone = (uint16_t)i;
+				Influence.Weight = (float)Cluster.Weights[j];
+			}
+		}
+
+		for (size_t ControlPoint = 0; ControlPoint < ControlPointCount; ControlPoint++)
+		{
+			const uint32_t Begin = InfluenceOffsets[ControlPoint];
+			const uint32_t Kept = PruneInfluences(&Influences[Begin], InfluenceOffsets[ControlPoint + 1] - Begin, Settings);
+
+			for (uint32_t k = Mesh.ControlPointVertexOffsets[ControlPoint]; k < Mesh.ControlPointVertexOffsets[ControlPoint + 1]; k++)
+			{
+				Vertex& Target = OutVertices[Mesh.ControlPointVertices[k]];
+				float Weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (uint32_t Slot = 0; Slot < 4; Slot++)
+				{
+					Target.BoneIndices[Slot] = Slot < Kept ? Influences[Begin + Slot].Bone : 0;
+					Weights[Slot] = Slot < Kept ? Influences[Begin + Slot].Weight : 0.0f;
+				}
+				Target.BoneWeights = XMFLOAT4(Weights[0], Weights[1], Weights[2], Weights[3]);
+			}
+		}
+
+		return ElapsedMs(Start);
+	}
+
+	struct MeshTimes
+	{
+		double PerQueryMs = 0.0;
+		double BulkMs = 0.0;
+		WeldResult OpenAddressing;
+		WeldResult NodeMap;
+
+		int BoneCount = 0;
+		double PositionHashMs = 0.0;
+		double ControlPointMs = 0.0;
+		size_t MissedCount = 0;
+	};
+
+	// 반복해서 제일 빠른 값을 쓴다. 코너 읽기는 리더가 배열을 잠그기 전에 돌려야 해서 예전 방식부터 한다.
+	MeshTimes MeasureMesh(FbxMesh* Mesh, int Repeat)
+	{
+		MeshTimes Best;
+		Best.PerQueryMs = Best.BulkMs = Best.OpenAddressing.Ms = Best.NodeMap.Ms = 1e30;
+
+		std::vector<Vertex> PerQueryCorners;
+		std::vector<Vertex> BulkCorners;
+		std::vector<int> CornerControlPoints;
+
+		for (int r = 0; r < Repeat; r++)
+		{
+			Clock::time_point Start = Clock::now();
+			ReadCornersPerQuery(Mesh, PerQueryCorners);
+			Best.PerQueryMs = std::min(Best.PerQueryMs, ElapsedMs(Start));
+
+			Start = Clock::now();
+			ReadCornersBulk(Mesh, BulkCorners, CornerControlPoints);
+			Best.BulkMs = std::min(Best.BulkMs, ElapsedMs(Start));
+
+			WeldResult OpenAddressing = WeldOpenAddressing(BulkCorners);
+			if (OpenAddressing.Ms < Best.OpenAddressing.Ms)
+			{
+				Best.OpenAddressing = OpenAddressing;
+			}
+
+			WeldResult NodeMap = WeldNodeMap(BulkCorners);
+			if (NodeMap.Ms < Best.NodeMap.Ms)
+			{
+				Best.NodeMap = NodeMap;
+			}
+		}
+
+		if (PerQueryCorners.size() != BulkCorners.size() || 0 != memcmp(PerQueryCorners.data(), BulkCorners.data(), BulkCorners.size() * sizeof(Vertex)))
+		{
+			printf("  warning: per-query and bulk corners differ\n");
+		}
+
+		FbxSkin* Skin = reinterpret_cast<FbxSkin*>(Mesh->GetDeformer(0, FbxDeformer::eSkin));
+		if (nullptr == Skin)
+		{
+			return Best;
+		}
+
+		SkinnedMesh Skinned;
+		for (int i = 0; i < Mesh->GetControlPointsCount(); i++)
+		{
+			const FbxVector4 Position = Mesh->GetControlPointAt(i);
+			Skinned.ControlPointPositions.push_back(XMFLOAT3((float)Position[0], (float)Position[1], (float)Position[2]));
+		}
+		for (int i = 0; i < Skin->GetClusterCount(); i++)
+		{
+			FbxCluster* Cluster = Skin->GetCluster(i);
+			Skinned.Clusters.push_back({ Cluster->GetControlPointIndices(), Cluster->GetControlPointWeights(), Cluster->GetControlPointIndicesCount() });
+		}
+		BuildSkinnedMesh(BulkCorners, CornerControlPoints, Skinned);
+
+		Best.BoneCount = Skin->GetClusterCount();
+		Best.PositionHashMs = Best.ControlPointMs = 1e30;
+
+		std::vector<Vertex> Assigned;
+		for (int r = 0; r < Repeat; r++)
+		{
+			double HashMs = 0.0;
+			Best.MissedCount = AssignByPositionHash(Skinned, Assigned, HashMs);
+			Best.PositionHashMs = std::min(Best.PositionHashMs, HashMs);
+			Best.ControlPointMs = std::min(Best.ControlPointMs, AssignByControlPoint(Skinned, SkinImportSettings(), Assigned));
+		}
+
+		return Best;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions Options;
+	if (false == ParseOptions(argc, argv, Options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	FbxManager* Manager = FbxManager::Create();
+	Manager->SetIOSettings(FbxIOSettings::Create(Manager, IOSROOT));
+
+	FbxImporter* Importer = FbxImporter::Create(Manager, "");
+	if (false == Importer->Initialize(Options.Input.c_str(), -1, Manager->GetIOSettings()))
+	{
+		printf("failed to open %s: %s\n", Options.Input.c_str(), Importer->GetStatus().GetErrorString());
+		Manager->Destroy();
+		return 1;
+	}
+
+	FbxScene* Scene = FbxScene::Create(Manager, "Bench Scene");
+	Importer->Import(Scene);
+	Importer->Destroy();
+
+	FbxGeometryConverter Converter(Manager);
+	Converter.Triangulate(Scene, true);
+
+	std::vector<FbxMesh*> Meshes;
+	CollectMeshes(Scene->GetRootNode(), Meshes);
+
+	printf("%s: %zu meshes, best of %d\n", Options.Input.c_str(), Meshes.size(), Options.Repeat);
+	printf("%-16s %9s | %10s %10s %6s | %9s %9s %9s %11s %11s\n",
+		"mesh", "corners", "query ms", "bulk ms", "x", "vertices", "weld ms", "map ms", "weld bytes", "map bytes");
+
+	MeshTimes Total;
+	size_t TotalCorners = 0;
+	for (FbxMesh* Mesh : Meshes)
+	{
+		const MeshTimes Times = MeasureMesh(Mesh, Options.Repeat);
+		const size_t CornerCount = (size_t)Mesh->GetPolygonCount() * 3;
+
+		printf("%-16.16s %9zu | %10.2f %10.2f %6.1f | %9zu %9.2f %9.2f %11zu %11zu\n",
+			Mesh->GetNode()->GetName(), CornerCount,
+			Times.PerQueryMs, Times.BulkMs, Times.PerQueryMs / std::max(Times.BulkMs, 0.001),
+			Times.OpenAddressing.VertexCount, Times.OpenAddressing.Ms, Times.NodeMap.Ms, Times.OpenAddressing.Bytes, Times.NodeMap.Bytes);
+
+		if (Times.BoneCount > 0)
+		{
+			printf("  skin: %d bones, position hash %.2f ms (%zu vertices missed), control point table %.2f ms (%.1fx)\n",
+				Times.BoneCount, Times.PositionHashMs, Times.MissedCount, Times.ControlPointMs, Times.PositionHashMs / std::max(Times.ControlPointMs, 0.001));
+		}
+
+		TotalCorners += CornerCount;
+		Total.PerQueryMs += Times.PerQueryMs;
+		Total.BulkMs += Times.BulkMs;
+		Total.OpenAddressing.Ms += Times.OpenAddressing.Ms;
+		Total.NodeMap.Ms += Times.NodeMap.Ms;
+	}
+
+	printf("total: %zu corners, read %.2f -> %.2f ms (%.1fx), weld %.2f ms vs unordered_map %.2f ms (%.1fx)\n",
+		TotalCorners, Total.PerQueryMs, Total.BulkMs, Total.PerQueryMs / std::max(Total.BulkMs, 0.001),
+		Total.OpenAddressing.Ms, Total.NodeMap.Ms, Total.NodeMap.Ms / std::max(Total.OpenAddressing.Ms, 0.001));
+
+	Manager->Destroy();
+	return 0;
+}
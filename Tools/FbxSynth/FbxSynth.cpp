@@ -0,0 +1,516 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// FbxLoader Import 시간을 재려고 큰 ASCII FBX를 만든다. FBX SDK 없이 돌아가니 어느 플랫폼에서든 만들 수 있다.
+//   FbxSynth <출력.fbx> [--meshes 개수] [--grid 한 변의 사각형 수] [--bones 개수] [--frames 개수] [--seam 간격]
+// 메쉬는 XZ 평면의 격자고, 노멀은 ByPolygonVertex/Direct, UV는 ByPolygonVertex/IndexToDirect로 쓴다.
+// --seam 간격마다 UV를 끊어서 Control Point 하나가 Vertex 여러 개로 갈라지게 한다.
+// --bones가 있으면 첫 메쉬를 격자 모양 뼈에 스키닝하고, 정점마다 주변 뼈 4개에 무게를 나눠준다. 뼈는 --frames 동안 Z축으로 흔들린다.
+
+namespace
+{
+	// FBX 시간 단위. 1초 = 46186158000
+	const int64_t TicksPerFrame = 46186158000ll / 24;
+
+	const double MeshSize = 100.0;
+	const double MeshGap = 10.0;
+
+	struct SynthOptions
+	{
+		std::string Output;
+		uint32_t MeshCount = 8;
+		uint32_t Grid = 256;
+		uint32_t BoneCount = 0;
+		uint32_t FrameCount = 48;
+		uint32_t SeamSpacing = 16;
+	};
+
+	struct Bone
+	{
+		int32_t Parent = -1;
+		double Position[3] = {};
+		int64_t ModelId = 0;
+		int64_t AttributeId = 0;
+		int64_t ClusterId = 0;
+		int64_t CurveNodeId = 0;
+		int64_t CurveId = 0;
+
+		// 이 뼈에 묶인 Control Point와 무게
+		std::vector<uint32_t> ControlPoints;
+		std::vector<double> Weights;
+	};
+
+	struct MeshIds
+	{
+		int64_t Geometry = 0;
+		int64_t Model = 0;
+	};
+
+	double MathClamp(double Value, double Low, double High)
+	{
+		return std::min(std::max(Value, Low), High);
+	}
+
+	void PrintUsage()
+	{
+		printf("usage: FbxSynth <output.fbx> [--meshes N] [--grid N] [--bones N] [--frames N] [--seam N]\n");
+		printf("  writes N grid meshes of grid x grid quads side by side; --bones skins the first mesh\n");
+	}
+
+	bool ParseArguments(int Argc, char** Argv, SynthOptions& Out)
+	{
+		for (int i = 1; i < Argc; i++)
+		{
+			const std::string Argument = Argv[i];
+
+			if (Argument == "--meshes" && i + 1 < Argc)
+			{
+				Out.MeshCount = (uint32_t)atoi(Argv[++i]);
+			}
+			else if (Argument == "--grid" && i + 1 < Argc)
+			{
+				Out.Grid = (uint32_t)atoi(Argv[++i]);
+			}
+			else if (Argument == "--bones" && i + 1 < Argc)
+			{
+				Out.BoneCount = (uint32_t)atoi(Argv[++i]);
+			}
+			else if (Argument == "--frames" && i + 1 < Argc)
+			{
+				Out.FrameCount = (uint32_t)atoi(Argv[++i]);
+			}
+			else if (Argument == "--seam" && i + 1 < Argc)
+			{
+				Out.SeamSpacing = (uint32_t)atoi(Argv[++i]);
+			}
+			else if (Argument.compare(0, 2, "--") == 0 || false == Out.Output.empty())
+			{
+				return false;
+			}
+			else
+			{
+				Out.Output = Argument;
+			}
+		}
+
+		return false == Out.Output.empty() && Out.MeshCount > 0 && Out.Grid > 0 && Out.FrameCount > 0;
+	}
+
+	class AsciiWriter
+	{
+	public:
+		explicit AsciiWriter(FILE* InFile)
+			:
+			File(InFile)
+		{
+		}
+
+		int64_t NewId()
+		{
+			return NextId++;
+		}
+
+		// 큰 배열은 한 줄에 다 쓰지 않고 끊어서 쓴다. SDK 익스포터도 이렇게 쓴다.
+		template<typename Getter>
+		void Array(const char* Indent, const char* Name, size_t Count, bool bInteger, Getter Get)
+		{
+			fprintf(File, "%s%s: *%zu {\n%s\ta: ", Indent, Name, Count, Indent);
+			for (size_t i = 0; i < Count; i++)
+			{
+				if (bInteger)
+				{
+					fprintf(File, "%lld", (long long)Get(i));
+				}
+				else
+				{
+					fprintf(File, "%.7g", (double)Get(i));
+				}
+
+				if (i + 1 < Count)
+				{
+					fputc(',', File);
+					if ((i + 1) % 24 == 0)
+					{
+						fputc('\n', File);
+					}
+				}
+			}
+			fprintf(File, "\n%s}\n", Indent);
+		}
+
+		void Matrix(const char* Indent, const char* Name, const double Translation[3])
+		{
+			const double Values[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, Translation[0], Translation[1], Translation[2], 1 };
+			Array(Indent, Name, 16, false, [&Values](size_t i) { return Values[i]; });
+		}
+
+	public:
+		FILE* File = nullptr;
+
+	private:
+		int64_t NextId = 1000000;
+	};
+
+	void WriteMesh(AsciiWriter& Writer, const SynthOptions& Options, uint32_t MeshIndex, const MeshIds& Ids)
+	{
+		FILE* File = Writer.File;
+		const uint32_t Grid = Options.Grid;
+		const uint32_t Row = Grid + 1;
+		const size_t ControlPointCount = (size_t)Row * Row;
+		const size_t QuadCount = (size_t)Grid * Grid;
+		const double Step = MeshSize / Grid;
+
+		// 이음새 열에 있는 Control Point는 오른쪽 사각형에서 쓸 UV를 하나 더 갖는다.
+		std::vector<double> UVs;
+		std::vector<uint32_t> SeamUV(ControlPointCount, UINT32_MAX);
+		UVs.reserve(ControlPointCount * 2);
+		for (uint32_t z = 0; z < Row; z++)
+		{
+			for (uint32_t x = 0; x < Row; x++)
+			{
+				UVs.push_back((double)x / Grid);
+				UVs.push_back((double)z / Grid);
+			}
+		}
+		for (uint32_t z = 0; z < Row; z++)
+		{
+			for (uint32_t x = 1; Options.SeamSpacing > 0 && x < Grid; x++)
+			{
+				if (x % Options.SeamSpacing == 0)
+				{
+					SeamUV[z * Row + x] = (uint32_t)(UVs.size() / 2);
+					UVs.push_back((double)x / Grid + 0.5);
+					UVs.push_back((double)z / Grid);
+				}
+			}
+		}
+
+		// 사각형마다 네 코너, 마지막 인덱스는 FBX 규칙대로 비트를 뒤집어서 다각형 끝을 표시한다.
+		std::vector<int64_t> PolygonVertices(QuadCount * 4);
+		std::vector<uint32_t> CornerUVs(QuadCount * 4);
+		for (uint32_t z = 0; z < Grid; z++)
+		{
+			for (uint32_t x = 0; x < Grid; x++)
+			{
+				const size_t Quad = (size_t)z * Grid + x;
+				const uint32_t Corners[4] = { z * Row + x, (z + 1) * Row + x, (z + 1) * Row + x + 1, z * Row + x + 1 };
+				for (int k = 0; k < 4; k++)
+				{
+					const uint32_t ControlPoint = Corners[k];
+					const bool bLeftEdge = (k < 2);
+					PolygonVertices[Quad * 4 + k] = k == 3 ? -(int64_t)ControlPoint - 1 : (int64_t)ControlPoint;
+					CornerUVs[Quad * 4 + k] = (bLeftEdge && SeamUV[ControlPoint] != UINT32_MAX) ? SeamUV[ControlPoint] : ControlPoint;
+				}
+			}
+		}
+
+		fprintf(File, "\tGeometry: %lld, \"Geometry::Mesh%u\", \"Mesh\" {\n", (long long)Ids.Geometry, MeshIndex);
+		Writer.Array("\t\t", "Vertices", ControlPointCount * 3, false, [&](size_t i)
+		{
+			const size_t ControlPoint = i / 3;
+			const uint32_t Axis = (uint32_t)(i % 3);
+			const double X = (ControlPoint % Row) * Step;
+			const double Z = (ControlPoint / Row) * Step;
+			return Axis == 0 ? X : (Axis == 1 ? 0.5 * sin(X * 0.1) * cos(Z * 0.1) : Z);
+		});
+		Writer.Array("\t\t", "PolygonVertexIndex", PolygonVertices.size(), true, [&](size_t i) { return PolygonVertices[i]; });
+		fprintf(File, "\t\tGeometryVersion: 124\n");
+
+		fprintf(File, "\t\tLayerElementNormal: 0 {\n\t\t\tVersion: 102\n\t\t\tName: \"\"\n");
+		fprintf(File, "\t\t\tMappingInformationType: \"ByPolygonVertex\"\n\t\t\tReferenceInformationType: \"Direct\"\n");
+		Writer.Array("\t\t\t", "Normals", PolygonVertices.size() * 3, false, [](size_t i) { return i % 3 == 1 ? 1.0 : 0.0; });
+		fprintf(File, "\t\t}\n");
+
+		fprintf(File, "\t\tLayerElementUV: 0 {\n\t\t\tVersion: 101\n\t\t\tName: \"UVMap\"\n");
+		fprintf(File, "\t\t\tMappingInformationType: \"ByPolygonVertex\"\n\t\t\tReferenceInformationType: \"IndexToDirect\"\n");
+		Writer.Array("\t\t\t", "UV", UVs.size(), false, [&](size_t i) { return UVs[i]; });
+		Writer.Array("\t\t\t", "UVIndex", CornerUVs.size(), true, [&](size_t i) { return CornerUVs[i]; });
+		fprintf(File, "\t\t}\n");
+
+		fprintf(File, "\t\tLayerElementMaterial: 0 {\n\t\t\tVersion: 101\n\t\t\tName: \"\"\n");
+		fprintf(File, "\t\t\tMappingInformationType: \"AllSame\"\n\t\t\tReferenceInformationType: \"IndexToDirect\"\n");
+		fprintf(File, "\t\t\tMaterials: *1 {\n\t\t\t\ta: 0\n\t\t\t}\n\t\t}\n");
+
+		fprintf(File, "\t\tLayer: 0 {\n\t\t\tVersion: 100\n");
+		fprintf(File, "\t\t\tLayerElement:  {\n\t\t\t\tType: \"LayerElementNormal\"\n\t\t\t\tTypedIndex: 0\n\t\t\t}\n");
+		fprintf(File, "\t\t\tLayerElement:  {\n\t\t\t\tType: \"LayerElementUV\"\n\t\t\t\tTypedIndex: 0\n\t\t\t}\n");
+		fprintf(File, "\t\t\tLayerElement:  {\n\t\t\t\tType: \"LayerElementMaterial\"\n\t\t\t\tTypedIndex: 0\n\t\t\t}\n");
+		fprintf(File, "\t\t}\n\t}\n");
+
+		// 스키닝 메쉬는 원점에, 나머지는 옆으로 늘어놓는다.
+		const double OffsetX = MeshIndex * (MeshSize + MeshGap);
+		fprintf(File, "\tModel: %lld, \"Model::Mesh%u\", \"Mesh\" {\n\t\tVersion: 232\n\t\tProperties70:  {\n", (long long)Ids.Model, MeshIndex);
+		fprintf(File, "\t\t\tP: \"Lcl Translation\", \"Lcl Translation\", \"\", \"A\",%g,0,0\n", OffsetX);
+		fprintf(File, "\t\t}\n\t\tShading: T\n\t\tCulling: \"CullingOff\"\n\t}\n");
+	}
+
+	// 뼈를 메쉬 위에 격자로 깔고, 정점마다 둘러싼 뼈 4개에 쌍선형 무게를 준다.
+	void BuildSkeleton(const SynthOptions& Options, std::vector<Bone>& OutBones)
+	{
+		const uint32_t Columns = std::max<uint32_t>(1, (uint32_t)ceil(sqrt((double)Options.BoneCount)));
+		const uint32_t Rows = (Options.BoneCount + Columns - 1) / Columns;
+
+		OutBones.resize(Options.BoneCount);
+		for (uint32_t i = 0; i < Options.BoneCount; i++)
+		{
+			const uint32_t Column = i % Columns;
+			const uint32_t BoneRow = i / Columns;
+
+			Bone& Current = OutBones[i];
+			Current.Position[0] = (Column + 0.5) * MeshSize / Columns;
+			Current.Position[2] = (BoneRow + 0.5) * MeshSize / Rows;
+
+			// 행의 첫 뼈는 윗 행의 첫 뼈에, 나머지는 왼쪽 뼈에 붙는다.
+			Current.Parent = Column > 0 ? (int32_t)i - 1 : (BoneRow > 0 ? (int32_t)(i - Columns) : -1);
+		}
+
+		const uint32_t Row = Options.Grid + 1;
+		const double Step = MeshSize / Options.Grid;
+		for (uint32_t ControlPoint = 0; ControlPoint < Row * Row; ControlPoint++)
+		{
+			const double FX = MathClamp((ControlPoint % Row) * Step / MeshSize * Columns - 0.5, 0.0, Columns - 1.0);
+			const double FZ = MathClamp((ControlPoint / Row) * Step / MeshSize * Rows - 0.5, 0.0, Rows - 1.0);
+			const uint32_t X0 = (uint32_t)FX;
+			const uint32_t Z0 = (uint32_t)FZ;
+			const uint32_t X1 = std::min(X0 + 1, Columns - 1);
+			const uint32_t Z1 = std::min(Z0 + 1, Rows - 1);
+			const double TX = FX - X0;
+			const double TZ = FZ - Z0;
+
+			const uint32_t Candidates[4] = { Z0 * Columns + X0, Z0 * Columns + X1, Z1 * Columns + X0, Z1 * Columns + X1 };
+			const double CandidateWeights[4] = { (1 - TX) * (1 - TZ), TX * (1 - TZ), (1 - TX) * TZ, TX * TZ };
+
+			// 가장자리에서는 같은 뼈가 겹치니 합쳐서 클러스터에 한 번만 넣는다. 마지막 행이 덜 찼으면 없는 뼈는 버린다.
+			for (int k = 0; k < 4; k++)
+			{
+				const uint32_t Target = Candidates[k];
+				if (Target >= Options.BoneCount || CandidateWeights[k] <= 0.0)
+				{
+					continue;
+				}
+
+				Bone& Influenced = OutBones[Target];
+				if (false == Influenced.ControlPoints.empty() && Influenced.ControlPoints.back() == ControlPoint)
+				{
+					Influenced.Weights.back() += CandidateWeights[k];
+				}
+				else
+				{
+					Influenced.ControlPoints.push_back(ControlPoint);
+					Influenced.Weights.push_back(CandidateWeights[k]);
+				}
+			}
+		}
+	}
+
+	void WriteSkeleton(AsciiWriter& Writer, const SynthOptions& Options, std::vector<Bone>& Bones, int64_t MeshModelId, int64_t SkinId)
+	{
+		FILE* File = Writer.File;
+		const size_t KeyCount = Options.FrameCount / 6 + 1;
+
+		fprintf(File, "\tDeformer: %lld, \"Deformer::Skin\", \"Skin\" {\n\t\tVersion: 101\n\t\tLink_DeformAcuracy: 50\n\t}\n", (long long)SkinId);
+
+		for (size_t i = 0; i < Bones.size(); i++)
+		{
+			Bone& Current = Bones[i];
+			const double* ParentPosition = Current.Parent < 0 ? nullptr : Bones[Current.Parent].Position;
+			const double Local[3] =
+			{
+				Current.Position[0] - (ParentPosition ? ParentPosition[0] : 0.0),
+				Current.Position[1] - (ParentPosition ? ParentPosition[1] : 0.0),
+				Current.Position[2] - (ParentPosition ? ParentPosition[2] : 0.0),
+			};
+
+			fprintf(File, "\tNodeAttribute: %lld, \"NodeAttribute::Bone%zu\", \"LimbNode\" {\n\t\tTypeFlags: \"Skeleton\"\n\t}\n", (long long)Current.AttributeId, i);
+
+			fprintf(File, "\tModel: %lld, \"Model::Bone%zu\", \"LimbNode\" {\n\t\tVersion: 232\n\t\tProperties70:  {\n", (long long)Current.ModelId, i);
+			fprintf(File, "\t\t\tP: \"Lcl Translation\", \"Lcl Translation\", \"\", \"A\",%.7g,%.7g,%.7g\n", Local[0], Local[1], Local[2]);
+			fprintf(File, "\t\t}\n\t\tShading: Y\n\t\tCulling: \"CullingOff\"\n\t}\n");
+
+			fprintf(File, "\tDeformer: %lld, \"SubDeformer::Cluster%zu\", \"Cluster\" {\n\t\tVersion: 100\n\t\tUserData: \"\", \"\"\n", (long long)Current.ClusterId, i);
+			Writer.Array("\t\t", "Indexes", Current.ControlPoints.size(), true, [&Current](size_t k) { return Current.ControlPoints[k]; });
+			Writer.Array("\t\t", "Weights", Current.Weights.size(), false, [&Current](size_t k) { return Current.Weights[k]; });
+			const double Origin[3] = { 0.0, 0.0, 0.0 };
+			Writer.Matrix("\t\t", "Transform", Origin);
+			Writer.Matrix("\t\t", "TransformLink", Current.Position);
+			fprintf(File, "\t}\n");
+
+			fprintf(File, "\tAnimationCurveNode: %lld, \"AnimCurveNode::R\", \"\" {\n\t\tProperties70:  {\n", (long long)Current.CurveNodeId);
+			fprintf(File, "\t\t\tP: \"d|X\", \"Number\", \"\", \"A\",0\n\t\t\tP: \"d|Y\", \"Number\", \"\", \"A\",0\n\t\t\tP: \"d|Z\", \"Number\", \"\", \"A\",0\n");
+			fprintf(File, "\t\t}\n\t}\n");
+
+			fprintf(File, "\tAnimationCurve: %lld, \"AnimCurve::\", \"\" {\n\t\tDefault: 0\n\t\tKeyVer: 4009\n", (long long)Current.CurveId);
+			Writer.Array("\t\t", "KeyTime", KeyCount, true, [&Options](size_t k) { return std::min<int64_t>((int64_t)k * 6, Options.FrameCount) * TicksPerFrame; });
+			Writer.Array("\t\t", "KeyValueFloat", KeyCount, false, [i](size_t k) { return 10.0 * sin(k * 0.7 + i * 0.3); });
+			fprintf(File, "\t\tKeyAttrFlags: *1 {\n\t\t\ta: 24836\n\t\t}\n");
+			fprintf(File, "\t\tKeyAttrDataFloat: *4 {\n\t\t\ta: 0,0,255790911,0\n\t\t}\n");
+			fprintf(File, "\t\tKeyAttrRefCount: *1 {\n\t\t\ta: %zu\n\t\t}\n\t}\n", KeyCount);
+		}
+
+		fprintf(File, "\tPose: %lld, \"Pose::BindPose\", \"BindPose\" {\n\t\tType: \"BindPose\"\n\t\tVersion: 100\n\t\tNbPoseNodes: %zu\n",
+			(long long)Writer.NewId(), Bones.size() + 1);
+		const double Origin[3] = { 0.0, 0.0, 0.0 };
+		fprintf(File, "\t\tPoseNode:  {\n\t\t\tNode: %lld\n", (long long)MeshModelId);
+		Writer.Matrix("\t\t\t", "Matrix", Origin);
+		fprintf(File, "\t\t}\n");
+		for (const Bone& Current : Bones)
+		{
+			fprintf(File, "\t\tPoseNode:  {\n\t\t\tNode: %lld\n", (long long)Current.ModelId);
+			Writer.Matrix("\t\t\t", "Matrix", Current.Position);
+			fprintf(File, "\t\t}\n");
+		}
+		fprintf(File, "\t}\n");
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	SynthOptions Options;
+	if (false == ParseArguments(Argc, Argv, Options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	FILE* File = nullptr;
+#ifdef _MSC_VER
+	fopen_s(&File, Options.Output.c_str(), "wb");
+#else
+	File = fopen(Options.Output.c_str(), "wb");
+#endif
+	if (nullptr == File)
+	{
+		fprintf(stderr, "%s: can't open for writing\n", Options.Output.c_str());
+		return 1;
+	}
+
+	AsciiWriter Writer(File);
+
+	std::vector<MeshIds> Meshes(Options.MeshCount);
+	for (MeshIds& Ids : Meshes)
+	{
+		Ids.Geometry = Writer.NewId();
+		Ids.Model = Writer.NewId();
+	}
+
+	const int64_t MaterialId = Writer.NewId();
+	const int64_t SkinId = Writer.NewId();
+	const int64_t StackId = Writer.NewId();
+	const int64_t LayerId = Writer.NewId();
+
+	std::vector<Bone> Bones;
+	if (Options.BoneCount > 0)
+	{
+		BuildSkeleton(Options, Bones);
+		for (Bone& Current : Bones)
+		{
+			Current.ModelId = Writer.NewId();
+			Current.AttributeId = Writer.NewId();
+			Current.ClusterId = Writer.NewId();
+			Current.CurveNodeId = Writer.NewId();
+			Current.CurveId = Writer.NewId();
+		}
+	}
+
+	const int64_t StopTime = (int64_t)Options.FrameCount * TicksPerFrame;
+	const size_t BoneCount = Bones.size();
+
+	fprintf(File, "; FBX 7.4.0 project file\n; generated by FbxSynth\n\n");
+	fprintf(File, "FBXHeaderExtension:  {\n\tFBXHeaderVersion: 1003\n\tFBXVersion: 7400\n\tCreator: \"FbxSynth\"\n}\n");
+
+	fprintf(File, "GlobalSettings:  {\n\tVersion: 1000\n\tProperties70:  {\n");
+	fprintf(File, "\t\tP: \"UpAxis\", \"int\", \"Integer\", \"\",1\n\t\tP: \"UpAxisSign\", \"int\", \"Integer\", \"\",1\n");
+	fprintf(File, "\t\tP: \"FrontAxis\", \"int\", \"Integer\", \"\",2\n\t\tP: \"FrontAxisSign\", \"int\", \"Integer\", \"\",1\n");
+	fprintf(File, "\t\tP: \"CoordAxis\", \"int\", \"Integer\", \"\",0\n\t\tP: \"CoordAxisSign\", \"int\", \"Integer\", \"\",1\n");
+	fprintf(File, "\t\tP: \"UnitScaleFactor\", \"double\", \"Number\", \"\",1\n");
+	fprintf(File, "\t\tP: \"TimeMode\", \"enum\", \"\", \"\",11\n");
+	fprintf(File, "\t\tP: \"TimeSpanStart\", \"KTime\", \"Time\", \"\",0\n\t\tP: \"TimeSpanStop\", \"KTime\", \"Time\", \"\",%lld\n", (long long)StopTime);
+	fprintf(File, "\t}\n}\n");
+
+	const size_t ModelCount = Meshes.size() + BoneCount;
+	const size_t DeformerCount = BoneCount > 0 ? BoneCount + 1 : 0;
+
+	// GlobalSettings, Material, AnimationStack, AnimationLayer 하나씩. 뼈마다 NodeAttribute, 커브 노드, 커브. 스킨이 있으면 BindPose 하나.
+	const size_t ObjectCount = 4 + ModelCount + Meshes.size() + DeformerCount + 3 * BoneCount + (BoneCount > 0 ? 1 : 0);
+	fprintf(File, "Definitions:  {\n\tVersion: 100\n\tCount: %zu\n", ObjectCount);
+	fprintf(File, "\tObjectType: \"GlobalSettings\" {\n\t\tCount: 1\n\t}\n");
+	fprintf(File, "\tObjectType: \"Model\" {\n\t\tCount: %zu\n\t}\n", ModelCount);
+	fprintf(File, "\tObjectType: \"Geometry\" {\n\t\tCount: %zu\n\t}\n", Meshes.size());
+	fprintf(File, "\tObjectType: \"Material\" {\n\t\tCount: 1\n\t}\n");
+	fprintf(File, "\tObjectType: \"AnimationStack\" {\n\t\tCount: 1\n\t}\n");
+	fprintf(File, "\tObjectType: \"AnimationLayer\" {\n\t\tCount: 1\n\t}\n");
+	if (BoneCount > 0)
+	{
+		fprintf(File, "\tObjectType: \"NodeAttribute\" {\n\t\tCount: %zu\n\t}\n", BoneCount);
+		fprintf(File, "\tObjectType: \"Deformer\" {\n\t\tCount: %zu\n\t}\n", DeformerCount);
+		fprintf(File, "\tObjectType: \"Pose\" {\n\t\tCount: 1\n\t}\n");
+		fprintf(File, "\tObjectType: \"AnimationCurveNode\" {\n\t\tCount: %zu\n\t}\n", BoneCount);
+		fprintf(File, "\tObjectType: \"AnimationCurve\" {\n\t\tCount: %zu\n\t}\n", BoneCount);
+	}
+	fprintf(File, "}\n");
+
+	fprintf(File, "Objects:  {\n");
+	for (uint32_t i = 0; i < Options.MeshCount; i++)
+	{
+		WriteMesh(Writer, Options, i, Meshes[i]);
+	}
+
+	fprintf(File, "\tMaterial: %lld, \"Material::Synth\", \"\" {\n\t\tVersion: 102\n\t\tShadingModel: \"lambert\"\n\t\tMultiLayer: 0\n", (long long)MaterialId);
+	fprintf(File, "\t\tProperties70:  {\n\t\t\tP: \"DiffuseColor\", \"Color\", \"\", \"A\",0.8,0.8,0.8\n\t\t}\n\t}\n");
+
+	if (BoneCount > 0)
+	{
+		WriteSkeleton(Writer, Options, Bones, Meshes[0].Model, SkinId);
+	}
+
+	fprintf(File, "\tAnimationStack: %lld, \"AnimStack::Take 001\", \"\" {\n\t\tProperties70:  {\n", (long long)StackId);
+	fprintf(File, "\t\t\tP: \"LocalStop\", \"KTime\", \"Time\", \"\",%lld\n\t\t\tP: \"ReferenceStop\", \"KTime\", \"Time\", \"\",%lld\n", (long long)StopTime, (long long)StopTime);
+	fprintf(File, "\t\t}\n\t}\n");
+	fprintf(File, "\tAnimationLayer: %lld, \"AnimLayer::BaseLayer\", \"\" {\n\t}\n", (long long)LayerId);
+	fprintf(File, "}\n");
+
+	fprintf(File, "Connections:  {\n");
+	for (const MeshIds& Ids : Meshes)
+	{
+		fprintf(File, "\tC: \"OO\",%lld,0\n", (long long)Ids.Model);
+		fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)Ids.Geometry, (long long)Ids.Model);
+		fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)MaterialId, (long long)Ids.Model);
+	}
+
+	if (BoneCount > 0)
+	{
+		fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)SkinId, (long long)Meshes[0].Geometry);
+	}
+
+	for (const Bone& Current : Bones)
+	{
+		const int64_t ParentId = Current.Parent < 0 ? 0 : Bones[Current.Parent].ModelId;
+		fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)Current.ModelId, (long long)ParentId);
+		fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)Current.AttributeId, (long long)Current.ModelId);
+		fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)Current.ClusterId, (long long)SkinId);
+		fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)Current.ModelId, (long long)Current.ClusterId);
+		fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)Current.CurveNodeId, (long long)LayerId);
+		fprintf(File, "\tC: \"OP\",%lld,%lld, \"Lcl Rotation\"\n", (long long)Current.CurveNodeId, (long long)Current.ModelId);
+		fprintf(File, "\tC: \"OP\",%lld,%lld, \"d|Z\"\n", (long long)Current.CurveId, (long long)Current.CurveNodeId);
+	}
+
+	fprintf(File, "\tC: \"OO\",%lld,%lld\n", (long long)LayerId, (long long)StackId);
+	fprintf(File, "}\n");
+
+	fprintf(File, "Takes:  {\n\tCurrent: \"Take 001\"\n\tTake: \"Take 001\" {\n\t\tFileName: \"Take_001.tak\"\n");
+	fprintf(File, "\t\tLocalTime: 0,%lld\n\t\tReferenceTime: 0,%lld\n\t}\n}\n", (long long)StopTime, (long long)StopTime);
+
+	const long Bytes = ftell(File);
+	fclose(File);
+
+	const size_t QuadCount = (size_t)Options.Grid * Options.Grid;
+	printf("%s: %u meshes x %zu triangles, %zu bones, %u frames, %.1f MB\n", Options.Output.c_str(), Options.MeshCount, QuadCount * 2,
+		BoneCount, Options.FrameCount, Bytes / (1024.0 * 1024.0));
+
+	return 0;
+}
@@ -0,0 +1,434 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include "BlockCompression.h"
+#include "MipGenerator.h"
+#include "DDSFile.h"
+#include "MappedFile.h"
+#include "JobSystem.h"
+#include "SupercompressedTexture.h"
+
+// 압축하지 않은 DDS나 RGBA8 raw 파일을 BCn DDS로 굽는다. 결과는 DDSTextureLoader가 그대로 읽는다.
+//   TextureCooker <입력> <출력.dds> [--format bc1|bc3|bc4|bc5|bc7] [--srgb] [--raw 가로x세로] [--threads 개수]
+//                 [--mips box|kaiser] [--clamp]
+// 입력에 밉이 하나뿐이거나 --mips를 주면 가장 고운 밉에서 사슬을 새로 만든다.
+// 출력이 .sctx면 구운 DDS를 SupercompressedTexture로 한 번 더 싼다. 이미 BC인 DDS는 다시 굽지 않고 그대로 싼다.
+
+namespace
+{
+	struct CookOptions
+	{
+		std::string Input;
+		std::string Output;
+		BCFormat Format = BCFormat::BC7;
+		bool bSRGB = false;
+		uint32_t RawWidth = 0;
+		uint32_t RawHeight = 0;
+		uint32_t ThreadCount = 0;
+
+		bool bRegenerateMips = false;
+		MipFilter Filter = MipFilter::Kaiser;
+		bool bWrap = true;
+	};
+
+	// 밉마다 RGBA8, 행 사이 빈 공간 없음
+	struct SourceImage
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		bool bSRGB = false;
+		std::vector<std::vector<uint8_t>> Mips;
+	};
+
+	// 읽을 수 있는 DXGI_FORMAT
+	enum : uint32_t
+	{
+		FormatR8G8B8A8Unorm = 28,
+		FormatR8G8B8A8UnormSrgb = 29,
+		FormatB8G8R8A8Unorm = 87,
+		FormatB8G8R8X8Unorm = 88,
+		FormatB8G8R8A8UnormSrgb = 91,
+		FormatB8G8R8X8UnormSrgb = 93,
+	};
+
+	const char* GetFormatName(BCFormat Format)
+	{
+		static const char* Names[] = { "BC1", "BC3", "BC4", "BC5", "BC7" };
+		return Names[(uint32_t)Format];
+	}
+
+	void PrintUsage()
+	{
+		printf("usage: TextureCooker <input> <output.dds|output.sctx> [--format bc1|bc3|bc4|bc5|bc7] [--srgb] [--raw WxH] [--threads N]\n");
+		printf("                     [--mips box|kaiser] [--clamp]\n");
+		printf("  input is an uncompressed R8G8B8A8/B8G8R8A8/B8G8R8X8 DDS, or raw RGBA8 with --raw\n");
+		printf("  a single-level input, or --mips, gets a full mip chain built from the top level\n");
+		printf("  a .sctx output is supercompressed; a block-compressed DDS input is then packed as-is\n");
+	}
+
+	bool ParseArguments(int Argc, char** Argv, CookOptions& Out)
+	{
+		std::vector<std::string> Positional;
+
+		for (int i = 1; i < Argc; i++)
+		{
+			const std::string Argument = Argv[i];
+
+			if (Argument == "--srgb")
+			{
+				Out.bSRGB = true;
+			}
+			else if (Argument == "--format" && i + 1 < Argc)
+			{
+				std::string Name = Argv[++i];
+				std::transform(Name.begin(), Name.end(), Name.begin(), [](char Character) { return (char)tolower(Character); });
+
+				static const char* Names[] = { "bc1", "bc3", "bc4", "bc5", "bc7" };
+				auto It = std::find_if(std::begin(Names), std::end(Names), [&Name](const char* Candidate) { return Name == Candidate; });
+				if (It == std::end(Names))
+				{
+					return false;
+				}
+
+				Out.Format = (BCFormat)(It - std::begin(Names));
+			}
+			else if (Argument == "--raw" && i + 1 < Argc)
+			{
+				char* Separator = nullptr;
+				char* End = nullptr;
+				Out.RawWidth = (uint32_t)strtoul(Argv[++i], &Separator, 10);
+				if (*Separator != 'x')
+				{
+					return false;
+				}
+
+				Out.RawHeight = (uint32_t)strtoul(Separator + 1, &End, 10);
+				if (*End != '\0' || 0 == Out.RawWidth || 0 == Out.RawHeight)
+				{
+					return false;
+				}
+			}
+			else if (Argument == "--mips" && i + 1 < Argc)
+			{
+				const std::string Name = Argv[++i];
+				if (Name != "box" && Name != "kaiser")
+				{
+					return false;
+				}
+
+				Out.bRegenerateMips = true;
+				Out.Filter = Name == "box" ? MipFilter::Box : MipFilter::Kaiser;
+			}
+			else if (Argument == "--clamp")
+			{
+				Out.bWrap = false;
+			}
+			else if (Argument == "--threads" && i + 1 < Argc)
+			{
+				Out.ThreadCount = (uint32_t)atoi(Argv[++i]);
+			}
+			else if (Argument.compare(0, 2, "--") == 0)
+			{
+				return false;
+			}
+			else
+			{
+				Positional.push_back(Argument);
+			}
+		}
+
+		if (Positional.size() != 2)
+		{
+			return false;
+		}
+
+		Out.Input = Positional[0];
+		Out.Output = Positional[1];
+		return true;
+	}
+
+	bool HasExtension(const std::string& Path, const char* Extension)
+	{
+		const size_t Length = strlen(Extension);
+		if (Path.size() < Length)
+		{
+			return false;
+		}
+
+		return std::equal(Path.end() - Length, Path.end(), Extension, [](char Lhs, char Rhs) { return tolower(Lhs) == tolower(Rhs); });
+	}
+
+	// 싼 결과를 다시 풀어서 원본과 같은지 확인하고 쓴다.
+	bool SaveSupercompressed(const std::string& Output, const uint8_t* DDSData, size_t DDSSize)
+	{
+		std::vector<uint8_t> Packed;
+
+		const auto EncodeBegin = std::chrono::high_resolution_clock::now();
+		if (false == SupercompressedTexture::Encode(DDSData, DDSSize, Packed))
+		{
+			fprintf(stderr, "cannot supercompress %s\n", Output.c_str());
+			return false;
+		}
+		const double EncodeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - EncodeBegin).count();
+
+		std::unique_ptr<SupercompressedTexture> Texture = SupercompressedTexture::FromMemory(Packed.data(), Packed.size());
+		std::vector<uint8_t> Restored(DDSSize);
+
+		const auto TranscodeBegin = std::chrono::high_resolution_clock::now();
+		const bool bTranscoded = Texture && Texture->Transcode(Restored.data());
+		const double TranscodeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - TranscodeBegin).count();
+
+		if (false == bTranscoded || memcmp(Restored.data(), DDSData, DDSSize) != 0)
+		{
+			fprintf(stderr, "%s: supercompressed data does not round-trip\n", Output.c_str());
+			return false;
+		}
+
+		std::ofstream Stream(Output, std::ios::binary | std::ios::trunc);
+		Stream.write((const char*)Packed.data(), Packed.size());
+		if (false == Stream.good())
+		{
+			fprintf(stderr, "cannot write %s\n", Output.c_str());
+			return false;
+		}
+
+		printf("  supercompressed %zu -> %zu bytes (%.1f%%) in %.2f ms, transcodes in %.2f ms (%.0f MB/s)\n",
+			DDSSize, Packed.size(), 100.0 * Packed.size() / DDSSize, EncodeSeconds * 1000.0,
+			TranscodeSeconds * 1000.0, DDSSize / std::max(TranscodeSeconds, 1e-9) / 1e6);
+		return true;
+	}
+
+	bool LoadRaw(const CookOptions& Options, SourceImage& Out)
+	{
+		MappedFile File;
+		if (false == File.Open(Options.Input.c_str()))
+		{
+			fprintf(stderr, "cannot open %s\n", Options.Input.c_str());
+			return false;
+		}
+
+		const size_t Bytes = (size_t)Options.RawWidth * Options.RawHeight * 4;
+		if (File.GetSize() != Bytes)
+		{
+			fprintf(stderr, "%s is %zu bytes, expected %zu for %ux%u RGBA8\n",
+				Options.Input.c_str(), File.GetSize(), Bytes, Options.RawWidth, Options.RawHeight);
+			return false;
+		}
+
+		Out.Width = Options.RawWidth;
+		Out.Height = Options.RawHeight;
+		Out.Mips.emplace_back(File.GetData(), File.GetData() + Bytes);
+		return true;
+	}
+
+	bool LoadDDS(const CookOptions& Options, SourceImage& Out)
+	{
+		std::unique_ptr<DDSFile> File = DDSFile::Open(Options.Input.c_str());
+		if (nullptr == File)
+		{
+			fprintf(stderr, "cannot read %s as DDS\n", Options.Input.c_str());
+			return false;
+		}
+
+		if (File->GetDimension() != DDSDimension::Texture2D || File->GetArraySize() != 1)
+		{
+			fprintf(stderr, "%s: only single 2D textures can be cooked\n", Options.Input.c_str());
+			return false;
+		}
+
+		const uint32_t Format = File->GetFormat();
+		const bool bBGR = Format == FormatB8G8R8A8Unorm || Format == FormatB8G8R8X8Unorm || Format == FormatB8G8R8A8UnormSrgb || Format == FormatB8G8R8X8UnormSrgb;
+		const bool bOpaque = Format == FormatB8G8R8X8Unorm || Format == FormatB8G8R8X8UnormSrgb;
+		if (false == bBGR && Format != FormatR8G8B8A8Unorm && Format != FormatR8G8B8A8UnormSrgb)
+		{
+			fprintf(stderr, "%s: DXGI format %u is not an uncompressed 8-bit RGBA format\n", Options.Input.c_str(), Format);
+			return false;
+		}
+
+		Out.Width = File->GetWidth();
+		Out.Height = File->GetHeight();
+		Out.bSRGB = Format == FormatR8G8B8A8UnormSrgb || Format == FormatB8G8R8A8UnormSrgb || Format == FormatB8G8R8X8UnormSrgb;
+
+		for (uint32_t Mip = 0; Mip < File->GetMipCount(); Mip++)
+		{
+			const DDSSubresource& Subresource = File->GetSubresource(Mip, 0);
+			const uint8_t* Source = File->GetSubresourceData(Mip, 0);
+
+			std::vector<uint8_t> Pixels((size_t)Subresource.Width * Subresource.Height * 4);
+			for (uint32_t Y = 0; Y < Subresource.Height; Y++)
+			{
+				memcpy(Pixels.data() + (size_t)Y * Subresource.Width * 4, Source + (size_t)Y * Subresource.RowBytes, (size_t)Subresource.Width * 4);
+			}
+
+			for (size_t i = 0; i < Pixels.size(); i += 4)
+			{
+				if (bBGR)
+				{
+					std::swap(Pixels[i], Pixels[i + 2]);
+				}
+				if (bOpaque)
+				{
+					Pixels[i + 3] = 255;
+				}
+			}
+
+			Out.Mips.push_back(std::move(Pixels));
+		}
+
+		return true;
+	}
+
+	double ComputeSquaredError(const std::vector<uint8_t>& Source, const std::vector<uint8_t>& Decoded, uint32_t ChannelCount)
+	{
+		double Error = 0.0;
+		for (size_t i = 0; i < Source.size(); i += 4)
+		{
+			for (uint32_t Channel = 0; Channel < ChannelCount; Channel++)
+			{
+				const double Difference = (double)Source[i + Channel] - Decoded[i + Channel];
+				Error += Difference * Difference;
+			}
+		}
+		return Error;
+	}
+
+	double ComputePSNR(double SquaredError, double SampleCount)
+	{
+		if (SquaredError <= 0.0)
+		{
+			return INFINITY;
+		}
+
+		return 10.0 * std::log10(255.0 * 255.0 * SampleCount / SquaredError);
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	CookOptions Options;
+	if (false == ParseArguments(Argc, Argv, Options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	JobSystem Jobs;
+	Jobs.Init(Options.ThreadCount);
+
+	const bool bSupercompress = HasExtension(Options.Output, ".sctx");
+
+	if (bSupercompress && 0 == Options.RawWidth)
+	{
+		std::unique_ptr<DDSFile> File = DDSFile::Open(Options.Input.c_str());
+		if (File && DDSFile::IsBlockCompressed(File->GetFormat()))
+		{
+			printf("%s -> %s  already block-compressed, %u threads\n", Options.Input.c_str(), Options.Output.c_str(), Jobs.GetThreadCount());
+			return SaveSupercompressed(Options.Output, File->GetData(), File->GetSize()) ? 0 : 1;
+		}
+	}
+
+	SourceImage Image;
+	const bool bLoaded = Options.RawWidth > 0 ? LoadRaw(Options, Image) : LoadDDS(Options, Image);
+	if (false == bLoaded)
+	{
+		return 1;
+	}
+
+	// D3D12는 BC 텍스쳐의 가장 고운 밉이 4의 배수여야 만들어준다.
+	if (Image.Width % 4 != 0 || Image.Height % 4 != 0)
+	{
+		fprintf(stderr, "%s: %ux%u is not a multiple of 4\n", Options.Input.c_str(), Image.Width, Image.Height);
+		return 1;
+	}
+
+	const BCFormat Format = Options.Format;
+	const bool bSRGB = Options.bSRGB || Image.bSRGB;
+
+	if (Options.bRegenerateMips || Image.Mips.size() == 1)
+	{
+		// BC4, BC5는 색이 아니라 데이터라서 선형 그대로 거른다.
+		MipGenerationOptions MipOptions;
+		MipOptions.Filter = Options.Filter;
+		MipOptions.bSRGB = bSRGB && Format != BCFormat::BC4 && Format != BCFormat::BC5;
+		MipOptions.bWrap = Options.bWrap;
+
+		const std::vector<uint8_t> Top = std::move(Image.Mips[0]);
+
+		const auto Begin = std::chrono::high_resolution_clock::now();
+		MipGenerator::Generate(Top.data(), Image.Width, Image.Height, (size_t)Image.Width * 4, MipOptions, Image.Mips);
+		const double Seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - Begin).count();
+
+		printf("  generated %u mips (%s%s) in %.2f ms\n", (uint32_t)Image.Mips.size(),
+			Options.Filter == MipFilter::Box ? "box" : "kaiser", MipOptions.bSRGB ? ", sRGB" : "", Seconds * 1000.0);
+	}
+
+	const uint32_t ChannelCount = BlockCompression::GetChannelCount(Format);
+
+	std::vector<std::vector<uint8_t>> Blocks;
+	double EncodeSeconds = 0.0;
+	double SquaredError = 0.0;
+	double SampleCount = 0.0;
+	uint64_t PixelCount = 0;
+	uint64_t SourceBytes = 0;
+	uint64_t CookedBytes = 0;
+
+	for (uint32_t Mip = 0; Mip < (uint32_t)Image.Mips.size(); Mip++)
+	{
+		const uint32_t Width = std::max<uint32_t>(1, Image.Width >> Mip);
+		const uint32_t Height = std::max<uint32_t>(1, Image.Height >> Mip);
+		const std::vector<uint8_t>& Pixels = Image.Mips[Mip];
+
+		std::vector<uint8_t> Encoded(BlockCompression::GetSurfaceBytes(Format, Width, Height));
+
+		const auto Begin = std::chrono::high_resolution_clock::now();
+		BlockCompression::EncodeSurface(Format, Pixels.data(), Width, Height, (size_t)Width * 4, Encoded.data());
+		const double Seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - Begin).count();
+
+		std::vector<uint8_t> Decoded(Pixels.size());
+		BlockCompression::DecodeSurface(Format, Encoded.data(), Width, Height, Decoded.data(), (size_t)Width * 4);
+
+		const double MipError = ComputeSquaredError(Pixels, Decoded, ChannelCount);
+		const double MipSamples = (double)Width * Height * ChannelCount;
+
+		printf("  mip %2u %5ux%-5u %8.2f ms  PSNR %6.2f dB\n", Mip, Width, Height, Seconds * 1000.0, ComputePSNR(MipError, MipSamples));
+
+		EncodeSeconds += Seconds;
+		SquaredError += MipError;
+		SampleCount += MipSamples;
+		PixelCount += (uint64_t)Width * Height;
+		SourceBytes += Pixels.size();
+		CookedBytes += Encoded.size();
+
+		Blocks.push_back(std::move(Encoded));
+	}
+
+	const uint32_t DXGIFormat = BlockCompression::GetDXGIFormat(Format, bSRGB);
+	if (bSupercompress)
+	{
+		std::unique_ptr<DDSFile> Cooked = DDSFile::Create(DXGIFormat, Image.Width, Image.Height, Blocks);
+		if (nullptr == Cooked || false == SaveSupercompressed(Options.Output, Cooked->GetData(), Cooked->GetSize()))
+		{
+			return 1;
+		}
+	}
+	else if (false == DDSFile::Save(Options.Output.c_str(), DXGIFormat, Image.Width, Image.Height, Blocks))
+	{
+		fprintf(stderr, "cannot write %s\n", Options.Output.c_str());
+		return 1;
+	}
+
+	printf("%s -> %s  %s, %u threads\n", Options.Input.c_str(), Options.Output.c_str(), GetFormatName(Format), Jobs.GetThreadCount());
+	printf("  %.1f MPix/s  PSNR %.2f dB  %llu -> %llu bytes (%.1fx smaller)\n",
+		PixelCount / std::max(EncodeSeconds, 1e-9) / 1e6,
+		ComputePSNR(SquaredError, SampleCount),
+		(unsigned long long)SourceBytes, (unsigned long long)CookedBytes, (double)SourceBytes / CookedBytes);
+
+	return 0;
+}